@@ -0,0 +1,67 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_util.hpp"
+#include "messages.hpp"
+#include "orderbook/orderbook.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Number of pregenerated quotes cycled through by each benchmark.
+ */
+static constexpr std::size_t NUM_QUOTES = 1 << 16;
+
+static std::vector<QuoteMessage> makeQuotes(std::size_t numSymbols) {
+    const auto symbols = randomSymbols(NUM_QUOTES, numSymbols);
+    std::vector<QuoteMessage> quotes(NUM_QUOTES);
+    for (std::size_t i = 0; i < NUM_QUOTES; ++i) {
+        quotes[i] = {MessageType::Quote, i, symbols[i], 15'000 + i % 100, 100, 15'100, 200, {}};
+    }
+    return quotes;
+}
+
+/**
+ * @brief `upsertEntry` keyed by raw symbol over a warmed-up book of `range(0)` symbols, so every
+ * call hashes the symbol through the book's table.
+ */
+static void BM_OrderBookUpsertEntry(benchmark::State& state) {
+    const auto quotes = makeQuotes(static_cast<std::size_t>(state.range(0)));
+    OrderBook book{static_cast<std::size_t>(state.range(0))};
+    for (const auto& quote : quotes) {
+        book.upsertEntry(quote.symbol, quote);
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto& quote = quotes[i++ & (NUM_QUOTES - 1)];
+        book.upsertEntry(quote.symbol, quote);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief `upsertEntryById` with symbols interned up front, the consumer's path in `main.cpp`.
+ */
+static void BM_OrderBookUpsertEntryById(benchmark::State& state) {
+    const auto quotes = makeQuotes(static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols{static_cast<std::size_t>(state.range(0))};
+    OrderBook book{symbols, static_cast<std::size_t>(state.range(0))};
+    std::vector<SymbolId> ids(NUM_QUOTES);
+    for (std::size_t i = 0; i < NUM_QUOTES; ++i) {
+        ids[i] = symbols.intern(quotes[i].symbol);
+        book.upsertEntryById(ids[i], quotes[i]);
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto idx = i++ & (NUM_QUOTES - 1);
+        book.upsertEntryById(ids[idx], quotes[idx]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderBookUpsertEntry)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_OrderBookUpsertEntryById)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
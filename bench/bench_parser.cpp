@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_util.hpp"
+#include "feed/compact_feed.hpp"
+#include "feed/feed_merger.hpp"
+#include "feed/feed_scan.hpp"
+#include "feed/mapped_feed.hpp"
+#include "feed/parser.hpp"
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Number of messages in the in-memory feed parsed per iteration.
+ */
+static constexpr std::size_t NUM_MESSAGES = 1 << 16;
+
+/**
+ * @brief Slots the parse loop writes into, standing in for one producer batch of queue slots.
+ */
+static constexpr std::size_t NUM_SLOTS = 64;
+
+/**
+ * @brief The producer's loop from `main.cpp` without the queue: walk the feed with `MappedFeed`,
+ * intern each symbol and fill a `Slot`. One iteration parses the whole feed.
+ */
+template <typename Slot> void BM_ParseFeed(benchmark::State& state) {
+    const auto feed = makeFeed(NUM_MESSAGES, static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols{static_cast<std::size_t>(state.range(0))};
+    Slot slots[NUM_SLOTS];
+
+    for (auto _ : state) {
+        MappedFeed source{feed.data(), feed.size()};
+        std::size_t i = 0;
+        while (const std::uint8_t* data = source.next()) {
+            parseInto(data, slots[i++ & (NUM_SLOTS - 1)], symbols);
+        }
+        benchmark::DoNotOptimize(slots);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_MESSAGES);
+    state.SetBytesProcessed(state.iterations() * feed.size());
+}
+
+/**
+ * @brief The boundary scan that splits a feed for `--jobs` replay, which has to run sequentially
+ * before any chunk can start. Compare against `BM_ParseFeed` for the serial fraction it adds.
+ */
+void BM_ScanFeed(benchmark::State& state) {
+    const auto feed = makeFeed(NUM_MESSAGES, 1'000);
+    const auto numChunks = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        const auto scan = scanFeed(feed.data(), feed.size(), NUM_MESSAGES, numChunks);
+        benchmark::DoNotOptimize(scan.chunks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_MESSAGES);
+    state.SetBytesProcessed(state.iterations() * feed.size());
+}
+
+/**
+ * @brief The producer's loop over a compact feed: decode each message with `CompactFeed`, intern
+ * its symbol and fill a slot. Bytes are those of the raw feed, to compare against `BM_ParseFeed`
+ * and against the rate a raw feed file can be read from disk.
+ */
+void BM_DecodeCompactFeed(benchmark::State& state) {
+    const auto feed = makeFeed(NUM_MESSAGES, static_cast<std::size_t>(state.range(0)));
+    char path[] = "/tmp/bench_compact_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd == -1) {
+        state.SkipWithError("mkstemp failed");
+        return;
+    }
+    close(fd);
+    CompactEncoder encoder;
+    encoder.open(path);
+    for (std::size_t offset = 0; offset < feed.size();
+         offset += messageSize(static_cast<MessageType>(feed[offset]))) {
+        encoder.add(feed.data() + offset);
+    }
+    encoder.close();
+    std::ifstream in{path, std::ios::binary | std::ios::ate};
+    const auto size = static_cast<std::size_t>(in.tellg());
+    std::vector<std::uint64_t> file((size + 7) / 8); /// the decoder needs 8-byte alignment
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(file.data()), static_cast<std::streamsize>(size));
+    unlink(path);
+
+    SymbolTable symbols{static_cast<std::size_t>(state.range(0))};
+    InternedMessage slots[NUM_SLOTS];
+    for (auto _ : state) {
+        CompactFeed source;
+        source.open(reinterpret_cast<const std::uint8_t*>(file.data()), size);
+        std::size_t i = 0;
+        while (const std::uint8_t* data = source.next()) {
+            parseInto(data, slots[i++ & (NUM_SLOTS - 1)], symbols);
+        }
+        benchmark::DoNotOptimize(slots);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_MESSAGES);
+    state.SetBytesProcessed(state.iterations() * feed.size());
+    state.counters["ratio"] = static_cast<double>(size) / static_cast<double>(feed.size());
+}
+
+/**
+ * @brief The producer's loop over the feeds of several venues, merged by timestamp with
+ * `FeedMerger`. The total message count is that of `BM_ParseFeed`, split evenly across the
+ * venues, whose timestamps interleave message by message.
+ */
+void BM_MergeFeeds(benchmark::State& state) {
+    const auto numVenues = static_cast<std::size_t>(state.range(0));
+    std::vector<std::vector<std::uint8_t>> feeds;
+    std::size_t bytes = 0;
+    for (std::size_t venue = 0; venue < numVenues; ++venue) {
+        feeds.push_back(makeFeed(NUM_MESSAGES / numVenues, 1'000,
+                                 static_cast<std::uint32_t>(42 + venue)));
+        bytes += feeds.back().size();
+    }
+    SymbolTable symbols{1'000};
+    InternedMessage slots[NUM_SLOTS];
+
+    for (auto _ : state) {
+        std::vector<MergeInput> inputs;
+        for (const auto& feed : feeds) {
+            inputs.push_back({MappedFeed{feed.data(), feed.size()}, NUM_MESSAGES});
+        }
+        FeedMerger source{std::move(inputs)};
+        std::size_t i = 0;
+        while (const std::uint8_t* data = source.next()) {
+            parseInto(data, slots[i++ & (NUM_SLOTS - 1)], symbols, source.venue());
+        }
+        benchmark::DoNotOptimize(slots);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (NUM_MESSAGES / numVenues * numVenues));
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+BENCHMARK(BM_ParseFeed<InternedMessage>)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_ParseFeed<MessageDescriptor>)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_DecodeCompactFeed)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_MergeFeeds)->ArgName("venues")->Arg(2)->Arg(4)->Arg(16);
+BENCHMARK(BM_ScanFeed)->ArgName("chunks")->Arg(8)->Arg(64);
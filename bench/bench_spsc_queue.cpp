@@ -0,0 +1,310 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_util.hpp"
+#include "messages.hpp"
+#include "ringbuffer/multicast_ring.hpp"
+#include "ringbuffer/spsc_queue.hpp"
+#include "ringbuffer/wait_strategy.hpp"
+
+/**
+ * @brief A queue element of `Size` bytes.
+ */
+template <std::size_t Size> struct Payload {
+    std::uint8_t bytes[Size];
+};
+
+/**
+ * @brief Messages per bulk claim in the bulk throughput benchmark, as in `main.cpp`.
+ */
+static constexpr std::size_t BATCH_SIZE = 64;
+
+/**
+ * @brief One element per iteration from the benchmark thread to a consumer thread through
+ * `enqueue`/`dequeue`. Reports the sustained transfer rate.
+ */
+template <typename T, std::size_t N> void BM_SPSCThroughput(benchmark::State& state) {
+    auto queue = std::make_unique<SPSCQueue<T, N>>();
+    std::atomic<bool> done{false};
+
+    std::thread consumer{[&queue, &done, cpu = static_cast<int>(state.range(1))]() {
+        pinThisThread(cpu);
+        T item;
+        std::uint32_t spins = 0;
+        while (true) {
+            if (queue->dequeue(item)) {
+                benchmark::DoNotOptimize(item);
+                continue;
+            }
+            if (done.load(std::memory_order_acquire) && queue->isEmpty()) {
+                break;
+            }
+            backoff(spins);
+        }
+    }};
+    pinThisThread(static_cast<int>(state.range(0)));
+
+    T item{};
+    std::uint32_t spins = 0;
+    for (auto _ : state) {
+        while (!queue->enqueue(item)) {
+            backoff(spins);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(T));
+}
+
+/**
+ * @brief Like `BM_SPSCThroughput`, but both sides move up to `BATCH_SIZE` elements per
+ * `claimWrite`/`claimRead`, publishing their index once per batch.
+ */
+template <typename T, std::size_t N> void BM_SPSCBulkThroughput(benchmark::State& state) {
+    auto queue = std::make_unique<SPSCQueue<T, N>>();
+    std::atomic<bool> done{false};
+
+    std::thread consumer{[&queue, &done, cpu = static_cast<int>(state.range(1))]() {
+        pinThisThread(cpu);
+        T* slots;
+        std::uint32_t spins = 0;
+        while (true) {
+            const auto claimed = queue->claimRead(slots, BATCH_SIZE);
+            if (claimed > 0) {
+                benchmark::DoNotOptimize(slots[claimed - 1]);
+                queue->commitRead(claimed);
+                continue;
+            }
+            if (done.load(std::memory_order_acquire) && queue->isEmpty()) {
+                break;
+            }
+            backoff(spins);
+        }
+    }};
+    pinThisThread(static_cast<int>(state.range(0)));
+
+    T* slots;
+    std::uint32_t spins = 0;
+    std::size_t pending = 0; /// elements of the current batch still to write
+    for (auto _ : state) {
+        if (pending == 0) {
+            while ((pending = queue->claimWrite(slots, BATCH_SIZE)) == 0) {
+                backoff(spins);
+            }
+            for (std::size_t i = 0; i < pending; ++i) {
+                slots[i] = T{};
+            }
+            queue->commitWrite(pending);
+        }
+        --pending;
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(T));
+}
+
+/**
+ * @brief `BM_SPSCBulkThroughput` with `state.range(0)` consumer threads that each read every
+ * element, either from one `MulticastRing` or, with `Copies`, from an `SPSCQueue` per consumer
+ * that the benchmark thread writes every element into. Threads are left unpinned.
+ */
+template <typename T, std::size_t N, bool Copies>
+void BM_FanOutThroughput(benchmark::State& state) {
+    const auto numConsumers = static_cast<std::size_t>(state.range(0));
+    std::vector<std::unique_ptr<SPSCQueue<T, N>>> queues;
+    std::unique_ptr<MulticastRing<T, N>> ring;
+    if constexpr (Copies) {
+        for (std::size_t i = 0; i < numConsumers; ++i) {
+            queues.push_back(std::make_unique<SPSCQueue<T, N>>());
+        }
+    } else {
+        ring = std::make_unique<MulticastRing<T, N>>(std::vector<std::uint32_t>(numConsumers, 0));
+    }
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> consumers;
+    for (std::size_t c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            T* slots;
+            std::uint32_t spins = 0;
+            while (true) {
+                const auto claimed = Copies ? queues[c]->claimRead(slots, BATCH_SIZE)
+                                            : ring->claimRead(c, slots, BATCH_SIZE);
+                if (claimed > 0) {
+                    benchmark::DoNotOptimize(slots[claimed - 1]);
+                    Copies ? queues[c]->commitRead(claimed) : ring->commitRead(c, claimed);
+                    continue;
+                }
+                if (done.load(std::memory_order_acquire) &&
+                    (Copies ? queues[c]->isEmpty() : ring->drained(c))) {
+                    break;
+                }
+                backoff(spins);
+            }
+        });
+    }
+
+    std::uint32_t spins = 0;
+    std::size_t pending = 0; /// elements of the current batch still to count off
+    for (auto _ : state) {
+        if (pending == 0) {
+            T* slots;
+            if constexpr (Copies) {
+                for (auto& queue : queues) { /// every consumer gets its own copy of the batch
+                    while (queue->claimWrite(slots, BATCH_SIZE) < BATCH_SIZE) {
+                        backoff(spins);
+                    }
+                    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+                        slots[i] = T{};
+                    }
+                    queue->commitWrite(BATCH_SIZE);
+                }
+                pending = BATCH_SIZE;
+            } else {
+                while ((pending = ring->claimWrite(slots, BATCH_SIZE)) == 0) {
+                    backoff(spins);
+                }
+                for (std::size_t i = 0; i < pending; ++i) {
+                    slots[i] = T{};
+                }
+                ring->commitWrite(pending);
+            }
+        }
+        --pending;
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(T));
+}
+
+/**
+ * @brief One round trip per iteration: the benchmark thread sends an element through one queue and
+ * waits for a second thread to echo it back through another. The reported time per iteration is
+ * the round-trip latency.
+ */
+template <typename T, std::size_t N> void BM_SPSCPingPong(benchmark::State& state) {
+    auto ping = std::make_unique<SPSCQueue<T, N>>();
+    auto pong = std::make_unique<SPSCQueue<T, N>>();
+    std::atomic<bool> done{false};
+
+    std::thread echo{[&ping, &pong, &done, cpu = static_cast<int>(state.range(1))]() {
+        pinThisThread(cpu);
+        T item;
+        std::uint32_t spins = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            if (ping->dequeue(item)) {
+                while (!pong->enqueue(item)) {
+                    backoff(spins);
+                }
+                continue;
+            }
+            backoff(spins);
+        }
+    }};
+    pinThisThread(static_cast<int>(state.range(0)));
+
+    T item{};
+    std::uint32_t spins = 0;
+    for (auto _ : state) {
+        while (!ping->enqueue(item)) {
+            backoff(spins);
+        }
+        while (!pong->dequeue(item)) {
+            backoff(spins);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    echo.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief `BM_SPSCPingPong` with both threads waiting through `Wait` and notifying after each
+ * enqueue, the way the pipeline in `main.cpp` does. Compares the wake-up latency of the wait
+ * strategies; run it pinned and unpinned, since spinning on a shared core behaves very differently.
+ */
+template <typename Wait> void BM_SPSCPingPongWait(benchmark::State& state) {
+    using Queue = SPSCQueue<std::uint64_t, 1024>;
+    auto ping = std::make_unique<Queue>();
+    auto pong = std::make_unique<Queue>();
+    auto pingReady = std::make_unique<Wait>();
+    auto pongReady = std::make_unique<Wait>();
+    std::atomic<bool> done{false};
+
+    std::thread echo{[&, cpu = static_cast<int>(state.range(1))]() {
+        pinThisThread(cpu);
+        std::uint64_t item;
+        while (true) {
+            bool got = false;
+            pingReady->waitUntil([&]() {
+                got = ping->dequeue(item);
+                return got || done.load(std::memory_order_acquire);
+            });
+            if (!got) {
+                break;
+            }
+            pong->enqueue(item); /// one element in flight, never full
+            pongReady->notify();
+        }
+    }};
+    pinThisThread(static_cast<int>(state.range(0)));
+
+    std::uint64_t item{};
+    for (auto _ : state) {
+        ping->enqueue(item);
+        pingReady->notify();
+        pongReady->waitUntil([&]() { return pong->dequeue(item); });
+    }
+    done.store(true, std::memory_order_release);
+    pingReady->notify();
+    echo.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SPSCThroughput<std::uint64_t, 1024>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCThroughput<std::uint64_t, 8192>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCThroughput<std::uint64_t, 65536>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCThroughput<Payload<64>, 8192>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCThroughput<InternedMessage, 8192>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCThroughput<MessageDescriptor, 8192>)->Apply(corePairs)->UseRealTime();
+
+BENCHMARK(BM_SPSCBulkThroughput<std::uint64_t, 8192>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCBulkThroughput<InternedMessage, 8192>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCBulkThroughput<MessageDescriptor, 8192>)->Apply(corePairs)->UseRealTime();
+
+BENCHMARK(BM_FanOutThroughput<InternedMessage, 8192, false>)
+    ->ArgName("consumers")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+BENCHMARK(BM_FanOutThroughput<InternedMessage, 8192, true>)
+    ->ArgName("consumers")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+BENCHMARK(BM_SPSCPingPong<std::uint64_t, 1024>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCPingPong<Payload<64>, 1024>)->Apply(corePairs)->UseRealTime();
+
+BENCHMARK(BM_SPSCPingPongWait<BusySpinWait>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCPingPongWait<SpinYieldWait>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCPingPongWait<BackoffWait>)->Apply(corePairs)->UseRealTime();
+BENCHMARK(BM_SPSCPingPongWait<FutexWait>)->Apply(corePairs)->UseRealTime();
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <immintrin.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "messages.hpp"
+
+/**
+ * @brief Returns a distinct, ASCII-packed 8-byte ticker for index `i`, e.g. "SAAAAB".
+ */
+inline std::uint64_t benchSymbol(std::size_t i) {
+    char name[8] = {'S'};
+    for (std::size_t pos = 5; pos > 0; --pos, i /= 26) {
+        name[pos] = static_cast<char>('A' + i % 26);
+    }
+    std::uint64_t symbol;
+    std::memcpy(&symbol, name, sizeof(symbol));
+    return symbol;
+}
+
+/**
+ * @brief Returns `count` symbols drawn uniformly from a universe of `numSymbols`.
+ */
+inline std::vector<std::uint64_t> randomSymbols(std::size_t count, std::size_t numSymbols,
+                                                std::uint32_t seed = 42) {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<std::size_t> pick{0, numSymbols - 1};
+    std::vector<std::uint64_t> symbols(count);
+    for (auto& symbol : symbols) {
+        symbol = benchSymbol(pick(rng));
+    }
+    return symbols;
+}
+
+/**
+ * @brief Builds an in-memory feed body (no count header) of `numMessages` quotes and trades over
+ * `numSymbols` symbols, in the 70/30 mix of `test_generator.py`.
+ */
+inline std::vector<std::uint8_t> makeFeed(std::size_t numMessages, std::size_t numSymbols,
+                                          std::uint32_t seed = 42) {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> percent{0, 99};
+    const auto symbols = randomSymbols(numMessages, numSymbols, seed);
+
+    std::vector<std::uint8_t> feed;
+    feed.reserve(numMessages * MAX_MESSAGE_SIZE);
+    for (std::size_t i = 0; i < numMessages; ++i) {
+        MarketDataMessage msg{};
+        if (percent(rng) < 70) {
+            msg.quote = {MessageType::Quote, i, symbols[i], 15'000, 100, 15'010, 200, {0, 0, 0}};
+        } else {
+            msg.trade = {MessageType::Trade, i, symbols[i], 15'005, 100, {0, 0, 0}};
+        }
+        const auto size = messageSize(msg.type);
+        feed.resize(feed.size() + size);
+        std::memcpy(feed.data() + feed.size() - size, &msg, size);
+    }
+    return feed;
+}
+
+/**
+ * @brief Waits a little before the caller retries: a short run of `pause`s, then a yield so the
+ * peer thread can make progress even when both share a core.
+ *
+ * @param spins The caller's retry counter, reset on every yield.
+ */
+inline void backoff(std::uint32_t& spins) {
+    if (++spins < 64) {
+        _mm_pause();
+    } else {
+        spins = 0;
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Pins the calling thread to `cpu`. Negative values leave the thread unpinned.
+ */
+inline void pinThisThread(int cpu) {
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * @brief Registers `{producerCpu, consumerCpu}` argument pairs for two-thread benchmarks: unpinned,
+ * then neighbouring cores, cores half the machine apart (often another socket or CCX) and the
+ * first and last core, as far as the machine has them.
+ */
+inline void corePairs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"producer_cpu", "consumer_cpu"});
+    bench->Args({-1, -1});
+
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus >= 2) {
+        bench->Args({0, 1});
+    }
+    if (cpus >= 4) {
+        bench->Args({0, static_cast<int>(cpus / 2)});
+        bench->Args({0, static_cast<int>(cpus - 1)});
+    }
+}
@@ -0,0 +1,94 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_util.hpp"
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/rolling_vwap.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+/**
+ * @brief Number of pregenerated trades cycled through by each benchmark.
+ */
+static constexpr std::size_t NUM_TRADES = 1 << 16;
+
+static std::vector<TradeMessage> makeTrades(std::size_t numSymbols) {
+    const auto symbols = randomSymbols(NUM_TRADES, numSymbols);
+    std::vector<TradeMessage> trades(NUM_TRADES);
+    for (std::size_t i = 0; i < NUM_TRADES; ++i) {
+        trades[i] = {MessageType::Trade, i, symbols[i], 15'000 + i % 100, 100, {}};
+    }
+    return trades;
+}
+
+/**
+ * @brief `upsertVWAP` keyed by raw symbol over a warmed-up tracker of `range(0)` symbols.
+ */
+static void BM_VWAPTrackerUpsertVWAP(benchmark::State& state) {
+    const auto trades = makeTrades(static_cast<std::size_t>(state.range(0)));
+    VWAPTracker tracker{static_cast<std::size_t>(state.range(0))};
+    for (const auto& trade : trades) {
+        tracker.upsertVWAP(trade.symbol, trade);
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto& trade = trades[i++ & (NUM_TRADES - 1)];
+        tracker.upsertVWAP(trade.symbol, trade);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief `upsertVWAPById` with symbols interned up front, the consumer's path in `main.cpp`.
+ */
+static void BM_VWAPTrackerUpsertVWAPById(benchmark::State& state) {
+    const auto trades = makeTrades(static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols{static_cast<std::size_t>(state.range(0))};
+    VWAPTracker tracker{symbols, static_cast<std::size_t>(state.range(0))};
+    std::vector<SymbolId> ids(NUM_TRADES);
+    for (std::size_t i = 0; i < NUM_TRADES; ++i) {
+        ids[i] = symbols.intern(trades[i].symbol);
+        tracker.upsertVWAPById(ids[i], trades[i]);
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto idx = i++ & (NUM_TRADES - 1);
+        tracker.upsertVWAPById(ids[idx], trades[idx]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief `addTradeById` into 1s, 1m and 5m windows of 60 buckets each. Timestamps advance one unit
+ * per trade, so buckets expire at a steady rate as they would in a live feed.
+ */
+static void BM_RollingVWAPAddTradeById(benchmark::State& state) {
+    auto trades = makeTrades(static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols{static_cast<std::size_t>(state.range(0))};
+    RollingVWAP rolling{symbols,
+                        {{"1s", 1'000'000, 60}, {"1m", 60'000'000, 60}, {"5m", 300'000'000, 60}},
+                        static_cast<std::size_t>(state.range(0))};
+    std::vector<SymbolId> ids(NUM_TRADES);
+    for (std::size_t i = 0; i < NUM_TRADES; ++i) {
+        ids[i] = symbols.intern(trades[i].symbol);
+        rolling.addTradeById(ids[i], trades[i]);
+    }
+
+    std::size_t i = 0;
+    std::uint64_t now = NUM_TRADES;
+    for (auto _ : state) {
+        const auto idx = i++ & (NUM_TRADES - 1);
+        trades[idx].timestamp = now++;
+        rolling.addTradeById(ids[idx], trades[idx]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_VWAPTrackerUpsertVWAP)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_VWAPTrackerUpsertVWAPById)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_RollingVWAPAddTradeById)->ArgName("symbols")->Arg(4)->Arg(1'000)->Arg(100'000);
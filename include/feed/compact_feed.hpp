@@ -0,0 +1,359 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * The compact feed file format, for archived captures. All fields are little-endian:
+ *
+ *     CompactHeader
+ *     blocks                              encoded messages, `blockMessages` per block
+ *     zero padding                        at least `COMPACT_PADDING` bytes, aligning the index
+ *     CompactBlockIndex index[blocks]     where each block starts
+ *     std::uint64_t symbols[symbolCount]  the symbol dictionary, in first-seen order
+ *
+ * A block stores its messages column by column: a `std::uint32_t` byte length per column, then
+ * the columns in `CompactColumn` order. The type column has one byte per message, its type with
+ * the side of depth and add-order messages in bit 3. The other columns hold varints (LEB128):
+ * timestamps as zigzag deltas from the previous message, symbols as their index in the dictionary,
+ * prices as zigzag deltas from the last price of the same symbol (a quote's bid counts as its
+ * price; its ask is a delta from the bid), quantities as they are and order IDs as zigzag deltas
+ * from the previous order ID. Padding is not stored and decodes as zero.
+ *
+ * Keeping each field in its own column lets a decoder walk the columns independently, instead of
+ * finding each field only once the one before it is decoded. Delta state starts from zero in
+ * every block, so any block can be decoded on its own: the index lets a reader start at any
+ * message by decoding only part of one block. Any change to the layout must bump
+ * `COMPACT_VERSION`; readers reject other versions.
+ */
+
+static constexpr std::uint64_t COMPACT_MAGIC = 0x504D4F4346444D; /// "MDFCOMP" read as bytes
+static constexpr std::uint32_t COMPACT_VERSION = 1;
+
+/**
+ * @brief Zero bytes after the last block. Varints are loaded 8 bytes at a time and a corrupt
+ * message is only caught after it is decoded, so reads may run this far past a column.
+ */
+static constexpr std::size_t COMPACT_PADDING = 32;
+
+struct CompactHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t blockMessages; /// messages per block; the last block may hold fewer
+    std::uint64_t messages;
+    std::uint64_t blocks;
+    std::uint64_t symbolCount;
+    std::uint64_t indexOffset;   /// file offset of the block index
+    std::uint64_t rawSize;       /// size of the raw feed the file was encoded from, with header
+    std::uint8_t padding[8];
+};
+
+struct CompactBlockIndex {
+    std::uint64_t offset;       /// file offset of the block
+    std::uint64_t firstMessage; /// number of messages in the blocks before it
+    std::uint64_t feedOffset;   /// offset of its first message in the raw feed, with header
+    std::uint32_t bytes;        /// encoded size of the block, with its column lengths
+    std::uint32_t messages;
+};
+
+/**
+ * @brief The columns of a block, in the order they are stored.
+ */
+enum CompactColumn : std::size_t {
+    TYPE_COLUMN,
+    TIMESTAMP_COLUMN,
+    SYMBOL_COLUMN,
+    PRICE_COLUMN,
+    QUANTITY_COLUMN,
+    ORDER_ID_COLUMN,
+    COMPACT_COLUMNS
+};
+
+/**
+ * @brief Maps a signed delta to an unsigned value that is small when the delta is near zero.
+ */
+inline std::uint64_t zigzag(const std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t unzigzag(const std::uint64_t value) {
+    return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/**
+ * @brief Reads a varint at `p` and advances past it. Varints of up to 8 bytes, which covers every
+ * field but the first timestamp of a block, are extracted from one unaligned load without
+ * branching on their length, so at least 8 bytes must be readable at `p`. Stops after 10 bytes,
+ * so corrupt input cannot run on.
+ */
+inline std::uint64_t readVarint(const std::uint8_t*& p) {
+#ifdef __BMI2__
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    const std::uint64_t ends = ~word & 0x8080808080808080;
+    if (ends != 0) {
+        const unsigned bits = static_cast<unsigned>(__builtin_ctzll(ends)) + 1;
+        p += bits / 8;
+        return _pext_u64(word, 0x7F7F7F7F7F7F7F7F >> (64 - bits));
+    }
+#endif
+    std::uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        const std::uint64_t byte = *p++;
+        value |= (byte & 0x7F) << shift;
+        if (byte < 0x80 || shift >= 63) {
+            return value;
+        }
+    }
+}
+
+/**
+ * @brief Encodes a raw feed into the compact format, one message at a time, writing each block to
+ * the file as it fills. Not thread-safe. This data structure cannot and should not be moved or
+ * copied.
+ */
+class CompactEncoder {
+  public:
+    static constexpr std::uint32_t DEFAULT_BLOCK_MESSAGES = 4096;
+
+    /**
+     * @brief Constructor for CompactEncoder.
+     *
+     * @param blockMessages The number of messages per block, the granularity of seeking.
+     */
+    explicit CompactEncoder(std::uint32_t blockMessages = DEFAULT_BLOCK_MESSAGES);
+
+    /**
+     * @brief Closes the file if it is open, see `close`.
+     */
+    ~CompactEncoder();
+
+    /**
+     * @brief Creates or replaces the compact feed at `path`.
+     *
+     * @return 0 on success, or -1 with `errno` set.
+     */
+    int open(const char* path);
+
+    /**
+     * @brief Encodes the raw message at `data`.
+     *
+     * @return 0 on success, or -1 with `errno` set: `EINVAL` if the message is not of a
+     * registered type or has a side other than bid or ask, or the error of writing a full block.
+     */
+    int add(const std::uint8_t* data);
+
+    /**
+     * @brief Writes the last block, the index and the dictionary, then the header.
+     *
+     * @return 0 on success, or -1 with `errno` set.
+     */
+    int close();
+
+    /**
+     * @brief Returns the number of messages encoded.
+     */
+    std::uint64_t size() const {
+        return messages_;
+    }
+
+    /**
+     * @brief Returns the number of bytes written to the file so far.
+     */
+    std::uint64_t bytesWritten() const {
+        return fileOffset_;
+    }
+
+    CompactEncoder(const CompactEncoder& ce) = delete;
+    CompactEncoder(CompactEncoder&& ce) = delete;
+    void operator=(const CompactEncoder& ce) = delete;
+    void operator=(CompactEncoder&& ce) = delete;
+
+  private:
+    /**
+     * @brief The last price of a dictionary symbol, valid within block `block` only.
+     */
+    struct SymbolState {
+        std::uint64_t price{0};
+        std::uint64_t block{0};
+    };
+
+    /**
+     * @brief Writes the current block to the file and starts the next one.
+     */
+    int flushBlock();
+
+    std::uint32_t blockMessages_;
+    int fd_{-1};
+    SymbolTable symbols_; /// the dictionary: symbol index is its `SymbolId`
+    std::vector<SymbolState> state_;
+    std::vector<CompactBlockIndex> index_;
+
+    std::vector<std::uint8_t> columns_[COMPACT_COLUMNS]; /// the current block
+    std::vector<std::uint8_t> block_;                    /// the current block as written
+    std::uint32_t blockCount_{0};                        /// messages in the current block
+    std::uint64_t epoch_{1};     /// numbers blocks, so `SymbolState`s from older ones are stale
+    std::uint64_t timestamp_{0}; /// delta bases of the current block
+    std::uint64_t orderId_{0};
+
+    std::uint64_t messages_{0};
+    std::uint64_t rawOffset_{sizeof(std::uint64_t)}; /// raw feed position, after its count header
+    std::uint64_t fileOffset_{0};
+};
+
+/**
+ * @brief Decodes a compact feed that is entirely in memory, such as a mapped file, one message at
+ * a time. Shares its interface with `StreamReader` so the pipeline can run over it.
+ *
+ * Each message is decoded into a buffer owned by the reader, so pointers returned by `next` are
+ * only valid until the next call and messages must be copied out (zero-copy descriptors cannot be
+ * used). This data structure cannot and should not be moved or copied.
+ */
+class CompactFeed {
+  public:
+    /**
+     * @brief Messages decoded at a time. Decoding in batches keeps the column cursors in
+     * registers across messages, where they would otherwise be reloaded after every store.
+     */
+    static constexpr std::size_t DECODE_BATCH = 256;
+
+    CompactFeed() = default;
+
+    /**
+     * @brief Returns `true` if the `size` bytes at `data` start like a compact feed.
+     */
+    static bool matches(const std::uint8_t* data, const std::size_t size) {
+        std::uint64_t magic = 0;
+        if (size >= sizeof(magic)) {
+            std::memcpy(&magic, data, sizeof(magic));
+        }
+        return magic == COMPACT_MAGIC;
+    }
+
+    /**
+     * @brief Validates the compact feed of `size` bytes at `data`, which must be 8-byte aligned
+     * and outlive the reader, and positions the reader at its first message.
+     *
+     * @return 0 on success, or -1 with `errno` set to `EPROTO` if the data is not a compact feed
+     * of this version or its index is inconsistent.
+     */
+    int open(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Returns the next message, decoded into the reader's buffer.
+     *
+     * @return A pointer to the message, or `nullptr` at the end of the feed or if a block is
+     * corrupt.
+     */
+    const std::uint8_t* next() {
+        if (batchNext_ == batchSize_ && !refill()) {
+            return nullptr;
+        }
+        const MarketDataMessage& msg = batch_[batchNext_++];
+        offset_ += messageSize(msg.type);
+        return reinterpret_cast<const std::uint8_t*>(&msg);
+    }
+
+    /**
+     * @brief Positions the reader at message `message`, counting from 0, by decoding the part of
+     * its block before it.
+     *
+     * @return `false` if the feed has fewer messages or the block is corrupt.
+     */
+    bool seekToMessage(std::uint64_t message);
+
+    /**
+     * @brief Returns the number of messages in the feed.
+     */
+    std::uint64_t size() const {
+        return messages_;
+    }
+
+    /**
+     * @brief Returns the offset the next message has in the raw feed the file was encoded from,
+     * counting its header, so positions match those of the raw feed.
+     */
+    std::uint64_t offset() const {
+        return offset_;
+    }
+
+    /**
+     * @brief Returns `true` if decoding stopped at a corrupt block.
+     */
+    bool truncated() const {
+        return truncated_;
+    }
+
+    CompactFeed(const CompactFeed& cf) = delete;
+    CompactFeed(CompactFeed&& cf) = delete;
+    void operator=(const CompactFeed& cf) = delete;
+    void operator=(CompactFeed&& cf) = delete;
+
+  private:
+    /**
+     * @brief The last price of a dictionary symbol, valid within block `block` only.
+     */
+    struct SymbolState {
+        std::uint64_t price{0};
+        std::uint64_t block{0};
+    };
+
+    /**
+     * @brief Moves to block `block`, resetting the delta state.
+     *
+     * @return `false` if its column lengths don't add up to its size.
+     */
+    bool enterBlock(std::uint64_t block);
+
+    /**
+     * @brief Moves to the next block that has messages.
+     *
+     * @return `false` at the end of the feed or at a corrupt block.
+     */
+    bool nextBlock();
+
+    /**
+     * @brief Marks the feed as corrupt and ends it.
+     */
+    void stop() {
+        truncated_ = true;
+        remaining_ = 0;
+        nextBlock_ = blocks_;
+    }
+
+    /**
+     * @brief Decodes the next messages of the current block, moving to the next block first if
+     * it is done, into `batch_`.
+     *
+     * @return `false` at the end of the feed or if the first message is corrupt.
+     */
+    bool refill();
+
+    const std::uint8_t* base_{nullptr};
+    const CompactBlockIndex* index_{nullptr};
+    std::uint64_t blocks_{0};
+    std::uint64_t messages_{0};
+    std::vector<std::uint64_t> symbols_;
+    std::vector<SymbolState> state_;
+
+    std::uint64_t nextBlock_{0};
+    const std::uint8_t* cursors_[COMPACT_COLUMNS]{}; /// next unread byte of each column
+    const std::uint8_t* ends_[COMPACT_COLUMNS]{};
+    std::uint32_t remaining_{0}; /// messages of the current block not decoded yet
+    std::uint64_t epoch_{0};     /// numbers blocks entered, so older `SymbolState`s are stale
+    std::uint64_t timestamp_{0}; /// delta bases of the current block
+    std::uint64_t orderId_{0};
+    std::uint64_t offset_{0};
+    bool truncated_{false};
+
+    MarketDataMessage batch_[DECODE_BATCH]; /// messages decoded ahead of `next`
+    std::size_t batchSize_{0};
+    std::size_t batchNext_{0};
+};
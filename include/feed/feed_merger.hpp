@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+
+/**
+ * @brief One venue's feed for `FeedMerger`: the mapped messages, positioned at the first one, and
+ * how many of them to merge.
+ */
+struct MergeInput {
+    MappedFeed feed;
+    std::uint64_t maxMessages;
+};
+
+/**
+ * @brief Merges the feeds of several venues, each already in memory and in timestamp order, into
+ * one feed in timestamp order, and tags every message with the venue it came from. Messages with
+ * equal timestamps are taken from the lower venue first, so the merge is deterministic.
+ *
+ * The inputs are the leaves of a loser tree: every internal node holds the input that lost the
+ * comparison there, and the root holds the overall winner. Taking a message reads the winner's
+ * next timestamp and replays just the path from its leaf to the root, one comparison per level,
+ * so each message costs O(log K) comparisons for K venues. The inputs are read in interleaved
+ * order, which sequential hardware prefetchers may lose track of, so each input also prefetches
+ * ahead of its own cursor. Returned pointers point into the inputs' memory, so they stay valid as
+ * long as it does and can be queued as `MessageDescriptor`s.
+ *
+ * Shares the `next`/`truncated`/`offset` interface of `MappedFeed`, so the pipeline can run over
+ * it. This data structure cannot and should not be moved or copied.
+ */
+class FeedMerger {
+  public:
+    /**
+     * @brief How far ahead of an input's cursor to prefetch, in bytes.
+     */
+    static constexpr std::size_t PREFETCH_DISTANCE = 256;
+
+    /**
+     * @brief Constructor for FeedMerger.
+     *
+     * @param inputs The feed of each venue, indexed by `VenueId`. Between 1 and `MAX_VENUES`.
+     */
+    explicit FeedMerger(std::vector<MergeInput> inputs);
+
+    /**
+     * @brief Returns the message with the lowest timestamp across the inputs and advances past it.
+     *
+     * @return A pointer to the message, or `nullptr` once every input has ended.
+     */
+    const std::uint8_t* next() {
+        const std::size_t winner = tree_[0];
+        const std::uint8_t* msg = heads_[winner];
+        if (msg == nullptr) {
+            return nullptr;
+        }
+        venue_ = static_cast<VenueId>(winner);
+        ++merged_[winner];
+        advance(winner);
+        replay(winner);
+        return msg;
+    }
+
+    /**
+     * @brief Returns the venue of the message last returned by `next`.
+     */
+    VenueId venue() const {
+        return venue_;
+    }
+
+    /**
+     * @brief Returns `true` if any input ended partway through a message or stopped at a byte
+     * that is not a known message type.
+     */
+    bool truncated() const {
+        for (const auto& input : inputs_) {
+            if (input.feed.truncated()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of bytes read across all inputs since they were handed over.
+     */
+    std::uint64_t offset() const {
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < inputs_.size(); ++i) {
+            total += inputs_[i].feed.offset() - startOffsets_[i];
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the number of inputs, which is one more than the highest venue.
+     */
+    std::size_t inputs() const {
+        return inputs_.size();
+    }
+
+    /**
+     * @brief Returns the number of messages returned so far from the input of `venue`.
+     */
+    std::uint64_t merged(const VenueId venue) const {
+        return merged_[venue];
+    }
+
+    FeedMerger(const FeedMerger& fm) = delete;
+    FeedMerger(FeedMerger&& fm) = delete;
+    void operator=(const FeedMerger& fm) = delete;
+    void operator=(FeedMerger&& fm) = delete;
+
+  private:
+    /**
+     * @brief Timestamp key of an input that has ended, sorting after every message.
+     */
+    static constexpr std::uint64_t ENDED = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     * @brief Reads the next message of input `i` into its head and key, ending the input once its
+     * message budget is spent.
+     */
+    void advance(const std::size_t i) {
+        MergeInput& input = inputs_[i];
+        const std::uint8_t* head = input.maxMessages > merged_[i] ? input.feed.next() : nullptr;
+        heads_[i] = head;
+        if (head == nullptr) {
+            keys_[i] = ENDED;
+            return;
+        }
+        std::memcpy(&keys_[i], head + offsetof(TradeMessage, timestamp), sizeof(keys_[i]));
+        if (const std::uint8_t* cursor = input.feed.peek(PREFETCH_DISTANCE + 1)) {
+            __builtin_prefetch(cursor + PREFETCH_DISTANCE, 0, 3);
+        }
+    }
+
+    /**
+     * @brief Returns `true` if the head of input `a` comes before the head of input `b`. An ended
+     * input loses to any message, even one stamped with the largest timestamp.
+     */
+    bool beats(const std::size_t a, const std::size_t b) const {
+        if (keys_[a] != keys_[b]) {
+            return keys_[a] < keys_[b];
+        }
+        return heads_[b] == nullptr || (heads_[a] != nullptr && a < b);
+    }
+
+    /**
+     * @brief Replays the matches on the path from the leaf of input `winner`, whose head just
+     * changed, to the root, leaving the new overall winner at the root.
+     */
+    void replay(std::size_t winner) {
+        for (std::size_t node = (winner + inputs_.size()) / 2; node > 0; node /= 2) {
+            if (beats(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+    std::vector<MergeInput> inputs_;
+    std::vector<std::uint64_t> startOffsets_;
+    std::vector<const std::uint8_t*> heads_; /// next message of each input, null once it ended
+    std::vector<std::uint64_t> keys_;        /// timestamp of each head, `ENDED` once it ended
+    std::vector<std::uint64_t> merged_;      /// messages taken from each input
+    std::vector<std::size_t> tree_;          /// [0]: the winner, [1, K): the loser of each match
+    VenueId venue_{0};
+};
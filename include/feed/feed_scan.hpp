@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "messages.hpp"
+
+/**
+ * @brief A byte range of a feed that starts and ends on message boundaries.
+ */
+struct FeedChunk {
+    std::size_t begin;      /// offset of the first message
+    std::size_t end;        /// offset one past the last message
+    std::uint64_t messages; /// number of messages in the range
+};
+
+/**
+ * @brief The message boundaries of an in-memory feed, split into chunks of roughly equal size.
+ */
+struct FeedScan {
+    std::vector<FeedChunk> chunks;
+    std::uint64_t messages{0};
+    std::uint32_t types{0}; /// bit `1 << type` is set for every message type in the scanned range
+    bool truncated{false};  /// the feed ended partway through a message or at an unknown type
+
+    /**
+     * @brief Returns `true` if a message of `type` was seen.
+     */
+    bool contains(const MessageType type) const {
+        return (types >> static_cast<std::uint8_t>(type)) & 1u;
+    }
+};
+
+/**
+ * @brief Finds the message boundaries of a feed so it can be split for parallel processing.
+ *
+ * Messages carry no sync marker, so a chunk can only start where the previous message ends. The
+ * scan walks the feed reading just the type byte of each message and adding its size from a lookup
+ * table, a running prefix sum of message sizes, and cuts a chunk whenever the offset crosses the
+ * next `size / numChunks` boundary. It touches one byte per message and no message bodies, so it is
+ * far cheaper than parsing the feed.
+ *
+ * @param data The first message of the feed.
+ * @param size The number of bytes from `data` to the end of the feed.
+ * @param maxMessages Stop after this many messages.
+ * @param numChunks The number of chunks to split into. Fewer are returned if the feed has fewer
+ * messages.
+ * @return The chunks in feed order, with the totals over all of them.
+ */
+FeedScan scanFeed(const std::uint8_t* data, std::size_t size, std::uint64_t maxMessages,
+                  std::size_t numChunks);
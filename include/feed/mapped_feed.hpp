@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "messages.hpp"
+
+/**
+ * @brief Reads messages out of a feed that is already entirely in memory, such as a mapped file.
+ *
+ * Returned pointers stay valid for as long as the underlying memory does, so they can be queued as
+ * `MessageDescriptor`s. Shares its interface with `StreamReader` so the pipeline can run over
+ * either.
+ */
+class MappedFeed {
+  public:
+    /**
+     * @brief Constructor for MappedFeed over `size` bytes starting at `data`.
+     */
+    MappedFeed(const std::uint8_t* data, std::size_t size)
+        : begin_{data}, cursor_{data}, end_{data + size} {}
+
+    /**
+     * @brief Returns a pointer to at least `size` contiguous unread bytes without consuming them.
+     *
+     * @param size The number of bytes needed.
+     * @return A pointer to the unread bytes, or `nullptr` if fewer than `size` remain.
+     */
+    const std::uint8_t* peek(std::size_t size) const {
+        return static_cast<std::size_t>(end_ - cursor_) >= size ? cursor_ : nullptr;
+    }
+
+    /**
+     * @brief Skips `size` bytes previously returned by `peek`.
+     */
+    void consume(std::size_t size) {
+        cursor_ += size;
+    }
+
+    /**
+     * @brief Returns the next complete message and advances past it.
+     *
+     * @return A pointer to the message, or `nullptr` at the end of the feed, if the remaining
+     * bytes are shorter than the message they start or if they start with an unknown type byte.
+     */
+    const std::uint8_t* next() {
+        if (cursor_ == end_) {
+            return nullptr;
+        }
+        const auto size = messageSize(static_cast<MessageType>(*cursor_));
+        if (size == 0 || static_cast<std::size_t>(end_ - cursor_) < size) {
+            truncated_ = true;
+            return nullptr;
+        }
+
+        const std::uint8_t* msg = cursor_;
+        cursor_ += size;
+        __builtin_prefetch(cursor_ + 64, 0, 3);
+        return msg;
+    }
+
+    /**
+     * @brief Returns `true` if the feed ended partway through a message or stopped at a byte that
+     * is not a known message type.
+     */
+    bool truncated() const {
+        return truncated_;
+    }
+
+    /**
+     * @brief Returns the number of bytes read or skipped since the start of the feed.
+     */
+    std::uint64_t offset() const {
+        return static_cast<std::uint64_t>(cursor_ - begin_);
+    }
+
+    /**
+     * @brief Returns the number of unread bytes.
+     */
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(end_ - cursor_);
+    }
+
+  private:
+    const std::uint8_t* begin_;
+    const std::uint8_t* cursor_;
+    const std::uint8_t* end_;
+    bool truncated_{false};
+};
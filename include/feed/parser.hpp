@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Reads the symbol of the message starting at `data`. Every message type shares the same
+ * type/timestamp/symbol header, so the symbol sits at the same offset in all of them.
+ */
+inline std::uint64_t symbolOf(const std::uint8_t* data) {
+    std::uint64_t symbol;
+    std::memcpy(&symbol, data + offsetof(TradeMessage, symbol), sizeof(symbol));
+    return symbol;
+}
+
+/**
+ * @brief Copies the message starting at `data` into a queue slot, interns its symbol and tags it
+ * with the venue it came from.
+ */
+inline void parseInto(const std::uint8_t* data, InternedMessage& slot, SymbolTable& symbols,
+                      const VenueId venue = 0) {
+    slot.symbolId = symbols.intern(symbolOf(data));
+    slot.venue = venue;
+    std::memcpy(&slot.msg, data, messageSize(static_cast<MessageType>(*data)));
+}
+
+/**
+ * @brief Records the location, type and venue of the message starting at `data` without copying
+ * it and interns its symbol.
+ */
+inline void parseInto(const std::uint8_t* data, MessageDescriptor& slot, SymbolTable& symbols,
+                      const VenueId venue = 0) {
+    slot.data = data;
+    slot.type = static_cast<MessageType>(*data);
+    slot.venue = venue;
+    slot.symbolId = symbols.intern(symbolOf(data));
+}
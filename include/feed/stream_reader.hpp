@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "messages.hpp"
+
+/**
+ * @brief Reads messages from a file descriptor that cannot be (or should not be) mapped whole,
+ * such as a pipe from `zcat` or a capture larger than RAM.
+ *
+ * A background thread `read`s the descriptor into two alternating chunks while the caller parses
+ * the other one, so I/O overlaps parsing and memory use is fixed at two chunks regardless of input
+ * size. Each chunk is preceded by `HEADROOM` spare bytes: when a message straddles the end of a
+ * chunk, its leading bytes are copied into the headroom of the next chunk so the caller always
+ * sees it contiguously. On regular files the page cache is told to expect sequential access and to
+ * drop each range once it has been copied out, so multi-hundred-gigabyte replays don't evict
+ * everything else.
+ *
+ * Pointers returned by `peek`/`next` are only valid until the next call, so messages must be
+ * copied out (zero-copy descriptors cannot be used). Not thread-safe beyond the internal reader
+ * thread: a single caller owns the parsing side. This data structure cannot and should not be
+ * moved or copied.
+ */
+class StreamReader {
+  public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    /**
+     * @brief Spare bytes in front of each chunk for carrying a split message. Also the largest
+     * `peek` the reader supports.
+     */
+    static constexpr std::size_t HEADROOM = 64;
+    static_assert(MAX_MESSAGE_SIZE <= HEADROOM, "a split message must fit in the chunk headroom");
+
+    /**
+     * @brief Constructor for StreamReader. Starts the reader thread immediately.
+     *
+     * @param fd The descriptor to read until end of input. It is not closed by the reader.
+     * @param chunkSize The number of bytes requested per chunk.
+     */
+    explicit StreamReader(int fd, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Stops and joins the reader thread. Blocks until a `read` in progress returns.
+     */
+    ~StreamReader();
+
+    /**
+     * @brief Returns a pointer to at least `size` contiguous unread bytes without consuming them,
+     * waiting for the reader thread if needed.
+     *
+     * @param size The number of bytes needed, at most `HEADROOM`.
+     * @return A pointer to the unread bytes, or `nullptr` if the input ends before `size` bytes.
+     */
+    const std::uint8_t* peek(std::size_t size) {
+        if (static_cast<std::size_t>(end_ - cursor_) >= size || refill(size)) {
+            return cursor_;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Skips `size` bytes previously returned by `peek`.
+     */
+    void consume(std::size_t size) {
+        cursor_ += size;
+        consumed_ += size;
+    }
+
+    /**
+     * @brief Returns the next complete message and advances past it.
+     *
+     * @return A pointer to the message, or `nullptr` at the end of input or if the input ends
+     * partway through a message.
+     */
+    const std::uint8_t* next() {
+        if (cursor_ == end_ && !refill(1)) {
+            return nullptr;
+        }
+        const auto size = messageSize(static_cast<MessageType>(*cursor_));
+        if (size == 0 || (static_cast<std::size_t>(end_ - cursor_) < size && !refill(size))) {
+            truncated_ = true;
+            return nullptr;
+        }
+
+        const std::uint8_t* msg = cursor_;
+        cursor_ += size;
+        consumed_ += size;
+        return msg;
+    }
+
+    /**
+     * @brief Returns `true` if the input ended partway through a message or stopped at a byte that
+     * is not a known message type.
+     */
+    bool truncated() const {
+        return truncated_;
+    }
+
+    /**
+     * @brief Returns the number of bytes read or skipped since the reader was constructed.
+     */
+    std::uint64_t offset() const {
+        return consumed_;
+    }
+
+    /**
+     * @brief Returns the `errno` of a failed `read`, or 0. A failed read ends the input early.
+     */
+    int error() const {
+        return error_.load(std::memory_order_acquire);
+    }
+
+    StreamReader(const StreamReader& sr) = delete;
+    StreamReader(StreamReader&& sr) = delete;
+    void operator=(const StreamReader& sr) = delete;
+    void operator=(StreamReader&& sr) = delete;
+
+  private:
+    /**
+     * @brief One read buffer. `full` hands the chunk from the reader thread to the parser and back.
+     */
+    struct Chunk {
+        std::unique_ptr<std::uint8_t[]> buffer; /// `HEADROOM` spare bytes, then the data
+        std::size_t size{0};                    /// bytes of data; 0 marks the end of input
+        alignas(64) std::atomic<bool> full{false};
+    };
+
+    /**
+     * @brief Moves to the next chunk, carrying over unread bytes, until `wanted` bytes are
+     * contiguous at the cursor.
+     *
+     * @return `false` if the input ends first.
+     */
+    bool refill(std::size_t wanted);
+
+    /**
+     * @brief Body of the reader thread: fills chunks alternately until end of input.
+     */
+    void readLoop();
+
+    int fd_;
+    std::size_t chunkSize_;
+    bool regularFile_{false};
+
+    Chunk chunks_[2];
+    std::size_t current_{1}; /// chunk the parser reads from; the first refill moves to chunk 0
+    bool holding_{false};    /// whether the parser still owns `chunks_[current_]`
+    bool ended_{false};
+    bool truncated_{false};
+    const std::uint8_t* cursor_{nullptr};
+    const std::uint8_t* end_{nullptr};
+    std::uint64_t consumed_{0};
+
+    std::atomic<bool> stop_{false};
+    std::atomic<int> error_{0};
+    std::thread reader_;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <sys/socket.h>
+
+#include "messages.hpp"
+
+/**
+ * @brief The header that starts every feed datagram, followed by `messageCount` packed messages.
+ * Sequence numbers count messages, not packets, so a receiver can tell exactly how many messages a
+ * gap lost.
+ */
+struct __attribute__((packed)) PacketHeader {
+    std::uint64_t sequence;     /// sequence number of the first message in the packet
+    std::uint16_t messageCount; /// messages in the packet, or `END_OF_SESSION`
+};
+
+/**
+ * @brief `PacketHeader::messageCount` of the packet that ends a session. Its `sequence` is the
+ * number the next message would have had.
+ */
+inline constexpr std::uint16_t END_OF_SESSION = 0xFFFF;
+
+/**
+ * @brief Opens a UDP socket bound to `address:port` with a large receive buffer.
+ *
+ * @param address The IPv4 address to bind, e.g. "127.0.0.1" or "0.0.0.0".
+ * @param port The port to bind, or 0 for an ephemeral port.
+ * @return The socket descriptor, or -1 with `errno` set.
+ */
+int openUdpSocket(const char* address, std::uint16_t port);
+
+/**
+ * @brief Receives feed datagrams from a bound UDP socket and hands out the messages they carry in
+ * sequence order.
+ *
+ * Datagrams are received in batches of up to `BATCH_SIZE` with one `recvmmsg` call, which is what
+ * amortizes the per-syscall cost at high packet rates. In busy-poll mode the socket is polled with
+ * `MSG_DONTWAIT` instead of sleeping in the kernel, trading a core for wake-up latency.
+ *
+ * Each packet's sequence number is checked against the next expected one: a jump forward is
+ * counted as a gap (the messages are lost, not recovered), packets that only repeat messages
+ * already seen are dropped, and a packet that partially overlaps has its seen messages skipped.
+ * The feed ends at an `END_OF_SESSION` packet, after `idleTimeoutMs` without data, or on a socket
+ * error.
+ *
+ * Pointers returned by `next` are only valid until the next batch is received, so messages must
+ * be copied out. This data structure cannot and should not be moved or copied.
+ */
+class UdpFeed {
+  public:
+    static constexpr std::size_t BATCH_SIZE = 64;
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 9000;
+    static constexpr int DEFAULT_IDLE_TIMEOUT_MS = 5000;
+
+    /**
+     * @brief Constructor for UdpFeed.
+     *
+     * @param fd A bound UDP socket. It is not closed by the feed.
+     * @param busyPoll Whether to spin on non-blocking receives instead of blocking.
+     * @param idleTimeoutMs How long to wait for data before ending the feed.
+     */
+    explicit UdpFeed(int fd, bool busyPoll = false, int idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS);
+
+    /**
+     * @brief Returns the next in-sequence message, receiving more datagrams as needed.
+     *
+     * @return A pointer to the message, or `nullptr` once the feed has ended.
+     */
+    const std::uint8_t* next() {
+        while (true) {
+            if (remaining_ > 0) {
+                const auto size = messageSize(static_cast<MessageType>(*cursor_));
+                if (size != 0 && static_cast<std::size_t>(end_ - cursor_) >= size) {
+                    const std::uint8_t* msg = cursor_;
+                    cursor_ += size;
+                    --remaining_;
+                    return msg;
+                }
+                truncated_ = true; /// malformed datagram, drop the rest of it
+                remaining_ = 0;
+            }
+            if (!nextDatagram()) {
+                return nullptr;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns `true` if any datagram ended partway through a message or held a byte that is
+     * not a known message type.
+     */
+    bool truncated() const {
+        return truncated_;
+    }
+
+    /**
+     * @brief Returns the `errno` of a failed receive, or 0. A failed receive ends the feed.
+     */
+    int error() const {
+        return error_;
+    }
+
+    /**
+     * @brief Returns `true` if the feed ended because no data arrived within the idle timeout.
+     */
+    bool timedOut() const {
+        return timedOut_;
+    }
+
+    std::uint64_t datagrams() const {
+        return datagrams_;
+    }
+
+    /**
+     * @brief Returns the number of forward jumps in the sequence.
+     */
+    std::uint64_t gaps() const {
+        return gaps_;
+    }
+
+    /**
+     * @brief Returns the number of messages skipped over by gaps.
+     */
+    std::uint64_t missedMessages() const {
+        return missedMessages_;
+    }
+
+    /**
+     * @brief Returns the number of datagrams dropped because all their messages were already seen.
+     */
+    std::uint64_t duplicates() const {
+        return duplicates_;
+    }
+
+    UdpFeed(const UdpFeed& uf) = delete;
+    UdpFeed(UdpFeed&& uf) = delete;
+    void operator=(const UdpFeed& uf) = delete;
+    void operator=(UdpFeed&& uf) = delete;
+
+  private:
+    /**
+     * @brief Moves to the next datagram that carries unseen messages, receiving a new batch when
+     * the current one is used up.
+     *
+     * @return `false` once the feed has ended.
+     */
+    bool nextDatagram();
+
+    /**
+     * @brief Receives the next batch of datagrams, waiting or spinning as configured.
+     *
+     * @return `false` on timeout or error.
+     */
+    bool receive();
+
+    int fd_;
+    bool busyPoll_;
+    int idleTimeoutMs_;
+
+    std::unique_ptr<std::uint8_t[]> buffers_; /// `BATCH_SIZE` datagrams of `MAX_DATAGRAM_SIZE`
+    iovec iovecs_[BATCH_SIZE];
+    mmsghdr headers_[BATCH_SIZE];
+    std::size_t batchSize_{0};
+    std::size_t batchIdx_{0};
+
+    const std::uint8_t* cursor_{nullptr};
+    const std::uint8_t* end_{nullptr};
+    std::uint32_t remaining_{0}; /// messages left in the current datagram
+
+    bool started_{false};
+    bool ended_{false};
+    bool truncated_{false};
+    bool timedOut_{false};
+    int error_{0};
+    std::uint64_t expected_{0}; /// sequence number of the next unseen message
+    std::uint64_t datagrams_{0};
+    std::uint64_t gaps_{0};
+    std::uint64_t missedMessages_{0};
+    std::uint64_t duplicates_{0};
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Largest symbol universe: every ticker of one to four letters.
+ */
+static constexpr std::uint32_t MAX_GENERATOR_SYMBOLS = 475'254;
+
+/**
+ * @brief The shape of a synthetic feed. The defaults give the quote/trade mix and mean gap of
+ * `test_generator.py` over a larger universe.
+ */
+struct GeneratorConfig {
+    std::uint64_t messages{1'000'000};
+    std::uint32_t symbols{1'000};
+    double zipfExponent{1.0};  /// symbol of popularity rank `r` is drawn in proportion to 1/r^s
+    double depthRatio{0.0};    /// share of depth updates; the rest are quotes and trades
+    double tradeRatio{0.3};    /// share of trades among quotes and trades
+    double meanGap{50.0};      /// mean microseconds between messages outside bursts
+    double burstGap{1.0};      /// mean microseconds between messages in a burst
+    double burstRatio{0.2};    /// share of messages sent in bursts
+    double burstLength{500.0}; /// mean messages per burst
+    std::uint64_t seed{42};
+    unsigned threads{1};
+};
+
+/**
+ * @brief A small, fast generator of uniform 64-bit values (SplitMix64). Streams seeded from
+ * different values are independent enough for synthetic data.
+ */
+class SplitMix64 {
+  public:
+    explicit SplitMix64(const std::uint64_t seed) : state_{seed} {}
+
+    std::uint64_t operator()() {
+        return mix(state_ += 0x9E3779B97F4A7C15);
+    }
+
+    /**
+     * @brief Returns a uniform value in (0, 1).
+     */
+    double uniform() {
+        return (static_cast<double>((*this)() >> 11) + 0.5) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief Returns a uniform value in [0, n).
+     */
+    std::uint32_t below(const std::uint32_t n) {
+        return static_cast<std::uint32_t>(((*this)() >> 32) * n >> 32);
+    }
+
+    /**
+     * @brief The SplitMix64 finaliser, also used to derive seeds.
+     */
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+  private:
+    std::uint64_t state_;
+};
+
+/**
+ * @brief Draws symbol popularity ranks from a Zipf distribution in constant time per draw, with
+ * Vose's alias method.
+ */
+class ZipfSampler {
+  public:
+    /**
+     * @brief Constructor for ZipfSampler.
+     *
+     * @param n The number of ranks, 0 to `n - 1`.
+     * @param exponent The Zipf exponent; 0 is uniform.
+     */
+    ZipfSampler(std::uint32_t n, double exponent);
+
+    /**
+     * @brief Returns a rank, given one uniform 64-bit value.
+     */
+    std::uint32_t operator()(const std::uint64_t random) const {
+        const auto rank = static_cast<std::uint32_t>((random >> 32) * size_ >> 32);
+        return static_cast<std::uint32_t>(random) < threshold_[rank] ? rank : alias_[rank];
+    }
+
+  private:
+    std::uint64_t size_;
+    std::vector<std::uint32_t> threshold_; /// keep `rank` when the low bits fall below this
+    std::vector<std::uint32_t> alias_;
+};
+
+/**
+ * @brief Generates a synthetic feed of quotes, trades and depth updates in the wire format, on
+ * `threads` threads, in chunks of `CHUNK_MESSAGES` messages.
+ *
+ * Symbols follow a Zipf popularity, each with a mid price that takes a random walk from its own
+ * level; quotes, trades and depth updates are drawn around the mid. Gaps between messages are
+ * exponential, switching between a quiet and a burst rate for runs of geometric length. The feed
+ * depends only on the config minus `threads`: every chunk draws from streams seeded by its index,
+ * so chunks are generated independently, and the timestamp and mid prices a chunk starts from are
+ * carried over from the chunks before it by first replaying just the draws that move them. This
+ * data structure cannot and should not be moved or copied.
+ */
+class FeedGenerator {
+  public:
+    static constexpr std::size_t CHUNK_MESSAGES = 1 << 16;
+    static constexpr std::uint64_t START_TIMESTAMP = 1'000'000;
+    static constexpr std::int64_t MIN_MID_PRICE = 200; /// mids are floored here when written
+
+    /**
+     * @brief Constructor for FeedGenerator. `config` must be valid: at least one symbol, at most
+     * `MAX_GENERATOR_SYMBOLS`, ratios in [0, 1] and positive gaps and burst length.
+     */
+    explicit FeedGenerator(const GeneratorConfig& config);
+
+    /**
+     * @brief Generates the next chunk on each thread.
+     *
+     * @return `false` once every message has been generated.
+     */
+    bool nextRound();
+
+    /**
+     * @brief Returns the number of chunks of the last round.
+     */
+    std::size_t chunks() const {
+        return roundChunks_;
+    }
+
+    /**
+     * @brief Returns the messages of chunk `i` of the last round, in the wire format and in feed
+     * order after those of chunk `i - 1`.
+     */
+    const std::vector<std::uint8_t>& chunk(const std::size_t i) const {
+        return workers_[i].out;
+    }
+
+    /**
+     * @brief Returns the symbol of popularity rank `rank`, 0 being the most popular.
+     */
+    std::uint64_t symbol(const std::uint32_t rank) const {
+        return symbols_[rank];
+    }
+
+    FeedGenerator(const FeedGenerator& fg) = delete;
+    FeedGenerator(FeedGenerator&& fg) = delete;
+    void operator=(const FeedGenerator& fg) = delete;
+    void operator=(FeedGenerator&& fg) = delete;
+
+  private:
+    /**
+     * @brief The per-thread state of one chunk of a round.
+     */
+    struct Worker {
+        std::uint64_t chunk{0};
+        std::size_t messages{0};
+        std::uint64_t duration{0};          /// sum of the chunk's gaps
+        std::vector<std::uint32_t> touched; /// ranks drawn in the chunk, in first-draw order
+        std::vector<std::int64_t> walk;     /// net mid move of each touched rank, then its start
+        std::vector<std::int64_t> mids;     /// by rank, valid for touched ranks only
+        std::vector<std::uint32_t> slots;   /// by rank, index into `touched` plus 1, or 0
+        std::vector<std::uint8_t> out;
+    };
+
+    /**
+     * @brief The draws that move the timestamp and mid prices, from one stream per chunk.
+     */
+    struct Spine {
+        std::uint32_t rank;
+        std::uint64_t gap;
+        std::int64_t step;
+    };
+
+    /**
+     * @brief Returns the seed of stream `stream` of chunk `chunk`.
+     */
+    std::uint64_t streamSeed(std::uint64_t chunk, std::uint64_t stream) const;
+
+    /**
+     * @brief Draws the spine of the next message and advances the burst state.
+     */
+    Spine nextSpine(SplitMix64& rng, bool& burst) const;
+
+    /**
+     * @brief First pass over a chunk: its duration and the net mid move of each rank it draws.
+     */
+    void measure(Worker& worker) const;
+
+    /**
+     * @brief Second pass: writes the chunk's messages, starting at `timestamp`, with the start
+     * mids of its touched ranks in `worker.walk`.
+     */
+    void emit(Worker& worker, std::uint64_t timestamp) const;
+
+    GeneratorConfig config_;
+    ZipfSampler zipf_;
+    std::vector<std::uint64_t> symbols_; /// by rank
+    std::vector<std::int64_t> carry_;    /// by rank, mid price after the chunks generated
+    std::vector<Worker> workers_;
+    std::uint64_t chunkCount_;
+    std::uint64_t nextChunk_{0};
+    std::uint64_t timestamp_{START_TIMESTAMP};
+    std::size_t roundChunks_{0};
+    std::uint32_t enterBurst_; /// chance per message out of 2^32, from quiet to burst
+    std::uint32_t leaveBurst_;
+};
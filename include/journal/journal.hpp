@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "messages.hpp"
+#include "ringbuffer/spsc_queue.hpp"
+
+/**
+ * The journal file format. All fields are little-endian; the file is a header followed by
+ * fixed-size records in the order the consumer applied their messages:
+ *
+ *     JournalHeader
+ *     JournalRecord records[header.records]
+ *
+ * The file is preallocated and grown in large steps while it is written, and truncated to its
+ * records when closed. A journal whose writer died before closing has `records == 0`; readers
+ * then take every leading record with consecutive sequence numbers, since unwritten space is
+ * zero. Any change to the layout must bump `JOURNAL_VERSION`; readers reject other versions.
+ */
+
+static constexpr std::uint64_t JOURNAL_MAGIC = 0x4C4E524A46444D; /// "MDFJRNL" read as bytes
+static constexpr std::uint32_t JOURNAL_VERSION = 1;
+
+struct JournalHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t recordSize; /// `sizeof(JournalRecord)`, a cross-check of the version
+    std::uint64_t records;    /// number of records, set when the journal is closed
+    std::uint64_t openedAt;   /// wall-clock time the journal was created, in ns since the epoch
+    std::uint8_t padding[32];
+};
+
+/**
+ * @brief Returns the wall-clock time in ns since the epoch, the clock of the journal's timestamps.
+ */
+inline std::uint64_t wallClockNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count());
+}
+
+/**
+ * @brief One applied message and the state of its symbol right after it was applied.
+ */
+struct JournalRecord {
+    std::uint64_t sequence;   /// position in apply order, from 1
+    std::uint64_t receivedAt; /// wall-clock time the consumer dequeued the message, in ns
+    MarketDataMessage msg;    /// the message as received, normalized to its struct
+    std::uint8_t padding[4];
+    std::uint64_t bidPrice;
+    std::uint64_t askPrice;
+    std::uint32_t bidQuantity;
+    std::uint32_t askQuantity;
+    std::uint64_t totalPriceByQuantity;
+    std::uint64_t totalQuantity;
+    std::uint32_t totalTrades;
+    std::uint8_t padding2[4];
+};
+
+/**
+ * @brief Appends records to a memory-mapped journal file. Not thread-safe: owned by the thread
+ * that records, see `JournalRecorder`.
+ */
+class JournalWriter {
+  public:
+    /**
+     * @brief Number of records the file is preallocated for, and grown by when full.
+     */
+    static constexpr std::uint64_t GROWTH_RECORDS = 1 << 20;
+
+    JournalWriter() = default;
+
+    /**
+     * @brief Closes the journal if it is open.
+     */
+    ~JournalWriter();
+
+    /**
+     * @brief Creates or replaces the journal at `path` and preallocates room for
+     * `GROWTH_RECORDS` records.
+     *
+     * @return 0 on success, or -1 with `errno` set.
+     */
+    int open(const char* path);
+
+    /**
+     * @brief Appends `record`, growing the file if it is full.
+     *
+     * @return 0 on success, or -1 with `errno` set if the file could not grow.
+     */
+    int append(const JournalRecord& record);
+
+    /**
+     * @brief Records the final count in the header, truncates the file to its records and unmaps
+     * it.
+     *
+     * @return 0 on success, or -1 with `errno` set.
+     */
+    int close();
+
+    /**
+     * @brief Returns the number of records appended.
+     */
+    std::uint64_t size() const {
+        return size_;
+    }
+
+    JournalWriter(const JournalWriter& jw) = delete;
+    JournalWriter(JournalWriter&& jw) = delete;
+    void operator=(const JournalWriter& jw) = delete;
+    void operator=(JournalWriter&& jw) = delete;
+
+  private:
+    /**
+     * @brief Extends the file and the mapping to hold `capacity` records.
+     */
+    int reserve(const std::uint64_t capacity);
+
+    int fd_{-1};
+    std::uint8_t* base_{nullptr}; /// the mapped file, starting with its `JournalHeader`
+    std::uint64_t capacity_{0};   /// records the mapping has room for
+    std::uint64_t size_{0};
+};
+
+/**
+ * @brief Maps a journal file for reading.
+ */
+class JournalReader {
+  public:
+    JournalReader() = default;
+    ~JournalReader();
+
+    /**
+     * @brief Maps the journal at `path` and validates its header.
+     *
+     * @return 0 on success, or -1 with `errno` set; `EPROTO` if the file is not a journal of this
+     * version.
+     */
+    int open(const char* path);
+
+    const JournalHeader& header() const {
+        return *reinterpret_cast<const JournalHeader*>(base_);
+    }
+
+    /**
+     * @brief Returns the first record. Records are contiguous, in apply order.
+     */
+    const JournalRecord* records() const {
+        return reinterpret_cast<const JournalRecord*>(base_ + sizeof(JournalHeader));
+    }
+
+    /**
+     * @brief Returns the number of complete records, recovered from the sequence numbers if the
+     * writer did not close the journal.
+     */
+    std::uint64_t size() const {
+        return size_;
+    }
+
+    JournalReader(const JournalReader& jr) = delete;
+    JournalReader(JournalReader&& jr) = delete;
+    void operator=(const JournalReader& jr) = delete;
+    void operator=(JournalReader&& jr) = delete;
+
+  private:
+    const std::uint8_t* base_{nullptr};
+    std::size_t length_{0};
+    std::uint64_t size_{0};
+};
+
+/**
+ * @brief The recorder stage: takes records from the consumer through an `SPSCQueue` and appends
+ * them to a `JournalWriter` on its own thread, so file writes, page faults and file growth stay
+ * off the consumer's path. The consumer only waits if the recorder falls a full queue behind.
+ */
+class JournalRecorder {
+  public:
+    static constexpr std::size_t QUEUE_SIZE = 8192;
+
+    /**
+     * @brief Starts the recorder thread, appending to `writer`, which must be open and must
+     * outlive the recorder.
+     */
+    explicit JournalRecorder(JournalWriter& writer);
+
+    /**
+     * @brief Stops the recorder if it is still running.
+     */
+    ~JournalRecorder();
+
+    /**
+     * @brief Hands `record` to the recorder thread. Called from the consumer thread only.
+     */
+    void record(const JournalRecord& record) {
+        JournalRecord* slot;
+        while (queue_.claimWrite(slot, 1) == 0) {
+            std::this_thread::yield();
+        }
+        *slot = record;
+        queue_.commitWrite(1);
+    }
+
+    /**
+     * @brief Appends every record handed over so far and stops the recorder thread.
+     *
+     * @return 0 on success, or the `errno` of the first failed append, after which later records
+     * were discarded.
+     */
+    int stop();
+
+    JournalRecorder(const JournalRecorder& jr) = delete;
+    JournalRecorder(JournalRecorder&& jr) = delete;
+    void operator=(const JournalRecorder& jr) = delete;
+    void operator=(JournalRecorder&& jr) = delete;
+
+  private:
+    /**
+     * @brief The recorder thread: drains the queue into the writer until stopped.
+     */
+    void run();
+
+    SPSCQueue<JournalRecord, QUEUE_SIZE> queue_;
+    JournalWriter& writer_;
+    std::atomic<bool> stopping_{false};
+    int error_{0};
+    std::thread thread_;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A log-linear histogram of 64-bit values in the style of HdrHistogram.
+ *
+ * Values below `SUB_BUCKETS` get exact buckets; above that, every power of two is split into
+ * `SUB_BUCKETS` linear buckets, so any recorded value is known to within 1/`SUB_BUCKETS` (about
+ * 3%) over the full 64-bit range in a fixed 15 KiB of counters. Recording is a count-leading-zeros,
+ * two shifts and an increment, cheap enough to run for every message on the hot path. The exact
+ * maximum is tracked separately.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKETS = std::uint64_t{1} << SUB_BUCKET_BITS;
+    static constexpr std::size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    LatencyHistogram() : counts_(NUM_BUCKETS, 0) {}
+
+    /**
+     * @brief Adds one occurrence of `value`.
+     */
+    void record(const std::uint64_t value) {
+        ++counts_[bucketOf(value)];
+        ++count_;
+        max_ = std::max(max_, value);
+    }
+
+    /**
+     * @brief Returns the value at quantile `q`: the smallest bucket bound that at least a `q`
+     * fraction of the recorded values fall at or below, capped at the exact maximum.
+     *
+     * @param q The quantile, in [0, 1].
+     * @return The value at `q`, or 0 if nothing was recorded.
+     */
+    std::uint64_t percentile(const double q) const;
+
+    /**
+     * @brief Adds every value recorded in `other` to this histogram.
+     */
+    void mergeFrom(const LatencyHistogram& other);
+
+    std::uint64_t count() const {
+        return count_;
+    }
+
+    std::uint64_t max() const {
+        return max_;
+    }
+
+    /**
+     * @brief Returns the bucket `value` is counted in.
+     */
+    static std::size_t bucketOf(const std::uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        const unsigned shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        return ((shift + 1) << SUB_BUCKET_BITS) + ((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    /**
+     * @brief Returns the largest value counted in `bucket`.
+     */
+    static std::uint64_t highestValueIn(const std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const unsigned shift = (bucket >> SUB_BUCKET_BITS) - 1;
+        const std::uint64_t lowest = (SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << shift;
+        return lowest + ((std::uint64_t{1} << shift) - 1);
+    }
+
+  private:
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_{0};
+    std::uint64_t max_{0};
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "latency/latency_histogram.hpp"
+#include "messages.hpp"
+
+/**
+ * @brief A queue slot together with the TSC stamps taken as it moved through the pipeline. The
+ * pipeline carries these instead of plain slots when latency measurement is on, so runs without it
+ * pay nothing.
+ *
+ * @tparam Slot The wrapped element, `InternedMessage` or `MessageDescriptor`.
+ */
+template <typename Slot> struct Timestamped {
+    Slot slot;
+    std::uint64_t parsedAt;   /// before the producer parsed the message
+    std::uint64_t enqueuedAt; /// when the producer published the batch holding it
+};
+
+template <typename Slot> inline constexpr bool isTimestamped = false;
+template <typename Slot> inline constexpr bool isTimestamped<Timestamped<Slot>> = true;
+
+/**
+ * @brief Per-stage and per-message-type latency histograms for one consumer, in TSC ticks.
+ *
+ * Each message contributes its time from parse to enqueue (producer batching), enqueue to dequeue
+ * (time spent queued), dequeue to apply (waiting behind its batch plus its own update) and parse
+ * to apply (end to end). The end-to-end latency is also recorded per message type.
+ */
+class LatencyStats {
+  public:
+    enum Stage : std::size_t { ParseToEnqueue = 0, EnqueueToDequeue, DequeueToApply, EndToEnd };
+    static constexpr std::size_t NUM_STAGES = 4;
+    static constexpr std::size_t NUM_TYPES = 8; /// indexed by `MessageType` value
+
+    /**
+     * @brief Records the stamps of one message. A stamp earlier than its predecessor, e.g. from
+     * TSC skew between cores, counts as zero.
+     */
+    void record(const MessageType type, const std::uint64_t parsedAt,
+                const std::uint64_t enqueuedAt, const std::uint64_t dequeuedAt,
+                const std::uint64_t appliedAt) {
+        stages_[ParseToEnqueue].record(elapsed(parsedAt, enqueuedAt));
+        stages_[EnqueueToDequeue].record(elapsed(enqueuedAt, dequeuedAt));
+        stages_[DequeueToApply].record(elapsed(dequeuedAt, appliedAt));
+
+        const auto endToEnd = elapsed(parsedAt, appliedAt);
+        stages_[EndToEnd].record(endToEnd);
+        types_[static_cast<std::size_t>(type) & (NUM_TYPES - 1)].record(endToEnd);
+    }
+
+    /**
+     * @brief Adds every sample recorded in `other`.
+     */
+    void mergeFrom(const LatencyStats& other);
+
+    const LatencyHistogram& stage(const Stage stage) const {
+        return stages_[stage];
+    }
+
+    const LatencyHistogram& type(const MessageType type) const {
+        return types_[static_cast<std::size_t>(type) & (NUM_TYPES - 1)];
+    }
+
+    /**
+     * @brief Prints p50/p99/p99.9/max in nanoseconds per stage and per message type.
+     *
+     * @param ticksPerNs The TSC rate used to convert ticks to nanoseconds.
+     */
+    void showStats(const double ticksPerNs) const;
+
+  private:
+    static std::uint64_t elapsed(const std::uint64_t from, const std::uint64_t to) {
+        return to > from ? to - from : 0;
+    }
+
+    LatencyHistogram stages_[NUM_STAGES];
+    LatencyHistogram types_[NUM_TYPES];
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include <x86intrin.h>
+
+/**
+ * @brief Reads the CPU timestamp counter. This costs a few nanoseconds, far less than a clock
+ * syscall, and on CPUs with an invariant TSC (every x86 server of the last decade) the counter
+ * ticks at a constant rate and is synchronized across cores, so stamps taken on the producer and
+ * consumer threads can be subtracted. No fence is issued: a stamp may be reordered with a few
+ * neighbouring instructions, which is noise at the microsecond scale being measured.
+ */
+inline std::uint64_t readTsc() {
+    return __rdtsc();
+}
+
+/**
+ * @brief Measures the TSC rate against `std::chrono::steady_clock` by sleeping for
+ * `calibrationMs`.
+ *
+ * @param calibrationMs How long to measure for; longer is more accurate.
+ * @return The number of TSC ticks per nanosecond.
+ */
+double calibrateTscTicksPerNs(unsigned calibrationMs = 50);
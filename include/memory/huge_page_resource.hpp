@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_set>
+
+/**
+ * @brief A memory resource for large, long-lived hot storage: queue rings and the book and tracker
+ * columns. It keeps page faults and TLB misses out of the timed run.
+ *
+ * Allocations of at least `MIN_MAPPED_SIZE` bytes get their own anonymous mapping rounded up to
+ * whole 2 MiB pages. Each such mapping:
+ *  - comes from the explicit huge page pool (`MAP_HUGETLB`) when pages are reserved in
+ *    `/proc/sys/vm/nr_hugepages`;
+ *  - otherwise is 2 MiB aligned and marked `MADV_HUGEPAGE` so transparent huge pages can back it;
+ *  - is faulted in before being returned either way.
+ *
+ * Smaller allocations go to `upstream`, aligned to at least a cache line so neighbouring
+ * allocations never share one.
+ *
+ * Thread-safe, as long as `upstream` is.
+ */
+class HugePageResource : public std::pmr::memory_resource {
+  public:
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+    static constexpr std::size_t MIN_MAPPED_SIZE = std::size_t{64} << 10;
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Constructor for HugePageResource.
+     *
+     * @param upstream Serves the allocations too small to map on their own.
+     */
+    explicit HugePageResource(
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_{upstream} {}
+
+    /**
+     * @brief Gets the number of bytes currently mapped from the explicit huge page pool.
+     */
+    std::size_t hugeTlbBytes() const {
+        return hugeTlbBytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the number of bytes currently mapped with regular pages, which transparent huge
+     * pages may back.
+     */
+    std::size_t transparentBytes() const {
+        return transparentBytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the most bytes mapped from the explicit huge page pool at any one time.
+     */
+    std::size_t peakHugeTlbBytes() const {
+        return peakHugeTlbBytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the most bytes mapped with regular pages at any one time.
+     */
+    std::size_t peakTransparentBytes() const {
+        return peakTransparentBytes_.load(std::memory_order_relaxed);
+    }
+
+    HugePageResource(const HugePageResource&) = delete;
+    void operator=(const HugePageResource&) = delete;
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    /**
+     * @brief Maps `size` bytes, a multiple of `HUGE_PAGE_SIZE`, with regular pages aligned to
+     * `HUGE_PAGE_SIZE`, or returns `nullptr`.
+     */
+    static void* mapAligned(std::size_t size);
+
+    /**
+     * @brief Adds `size` to the `bytes` counter and raises `peak` to match if it is now higher.
+     */
+    static void count(std::atomic<std::size_t>& bytes, std::atomic<std::size_t>& peak,
+                      std::size_t size);
+
+    std::pmr::memory_resource* upstream_;
+    std::mutex mappingsMutex_;
+    std::unordered_set<void*> hugeTlbMappings_; /// which live mappings came from the pool
+    std::atomic<std::size_t> hugeTlbBytes_{0};
+    std::atomic<std::size_t> transparentBytes_{0};
+    std::atomic<std::size_t> peakHugeTlbBytes_{0};
+    std::atomic<std::size_t> peakTransparentBytes_{0};
+};
@@ -1,12 +1,45 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 /**
  * @brief The enumeration of exchange message types. This is needed to correctly interpret message
  * size and contents.
  */
-enum class MessageType : std::uint8_t { Trade = 1, Quote };
+enum class MessageType : std::uint8_t {
+    Trade = 1,
+    Quote,
+    Depth,
+    AddOrder,
+    ModifyOrder,
+    CancelOrder,
+    ExecuteOrder
+};
+
+/**
+ * @brief The side of the book a price level belongs to.
+ */
+enum class Side : std::uint8_t { Bid = 0, Ask };
+
+/**
+ * @brief Dense identifier assigned to a symbol the first time the parser sees it. IDs start at 0
+ * and increase by one per new symbol, so per-symbol state can be kept in arrays indexed by ID.
+ */
+using SymbolId = std::uint32_t;
+
+/**
+ * @brief Index of the venue a message was received from, in the order the venues' feeds are
+ * merged. Messages of a single feed all come from venue 0.
+ */
+using VenueId = std::uint8_t;
+
+/**
+ * @brief The most venues whose feeds can be merged, and whose quotes the consolidated book keeps.
+ */
+inline constexpr std::size_t MAX_VENUES = 16;
 
 /**
  * @brief The struct representation of a `TradeMessage` as sent by the exchange. This struct is
@@ -36,6 +69,238 @@ struct __attribute__((packed)) QuoteMessage {
     std::uint8_t padding[3];
 };
 
+/**
+ * @brief The struct representation of a `DepthMessage` as sent by the exchange. Each message sets
+ * the aggregate quantity resting at one price level on one side of the book; a quantity of zero
+ * removes the level. This struct is packed to match the exact binary layout of a `DepthMessage`.
+ */
+struct __attribute__((packed)) DepthMessage {
+    MessageType type;
+    std::uint64_t timestamp;
+    std::uint64_t symbol;
+    std::uint64_t price;
+    std::uint32_t quantity;
+    Side side;
+    std::uint8_t padding[2];
+};
+
+/**
+ * @brief The struct representation of an `AddOrderMessage` as sent by the exchange. A new order
+ * joins the back of the queue at its price level. This struct is packed to match the exact binary
+ * layout of an `AddOrderMessage`.
+ */
+struct __attribute__((packed)) AddOrderMessage {
+    MessageType type;
+    std::uint64_t timestamp;
+    std::uint64_t symbol;
+    std::uint64_t orderId;
+    std::uint64_t price;
+    std::uint32_t quantity;
+    Side side;
+    std::uint8_t padding[2];
+};
+
+/**
+ * @brief The struct representation of a `ModifyOrderMessage` as sent by the exchange. Replaces the
+ * price and quantity of a resting order; the order keeps its queue position only if the price is
+ * unchanged and the quantity does not increase. This struct is packed to match the exact binary
+ * layout of a `ModifyOrderMessage`.
+ */
+struct __attribute__((packed)) ModifyOrderMessage {
+    MessageType type;
+    std::uint64_t timestamp;
+    std::uint64_t symbol;
+    std::uint64_t orderId;
+    std::uint64_t price;
+    std::uint32_t quantity;
+    std::uint8_t padding[3];
+};
+
+/**
+ * @brief The struct representation of a `CancelOrderMessage` as sent by the exchange. Removes a
+ * resting order entirely. This struct is packed to match the exact binary layout of a
+ * `CancelOrderMessage`.
+ */
+struct __attribute__((packed)) CancelOrderMessage {
+    MessageType type;
+    std::uint64_t timestamp;
+    std::uint64_t symbol;
+    std::uint64_t orderId;
+    std::uint8_t padding[7];
+};
+
+/**
+ * @brief The struct representation of an `ExecuteOrderMessage` as sent by the exchange. Fills part
+ * or all of a resting order at its price. This struct is packed to match the exact binary layout
+ * of an `ExecuteOrderMessage`.
+ */
+struct __attribute__((packed)) ExecuteOrderMessage {
+    MessageType type;
+    std::uint64_t timestamp;
+    std::uint64_t symbol;
+    std::uint64_t orderId;
+    std::uint32_t quantity;
+    std::uint8_t padding[3];
+};
+
+/**
+ * @brief Describes the registered message type tagged `Tag`: the packed struct it is read as and
+ * its name in reports. Adding a message type takes a `MessageType` tag, its struct, a
+ * specialization here and an entry in `RegisteredMessages`; sizes, names, validation and dispatch
+ * are derived from them at compile time.
+ */
+template <MessageType Tag> struct MessageTraits;
+
+template <> struct MessageTraits<MessageType::Trade> {
+    using Type = TradeMessage;
+    static constexpr const char* NAME = "Trade";
+};
+
+template <> struct MessageTraits<MessageType::Quote> {
+    using Type = QuoteMessage;
+    static constexpr const char* NAME = "Quote";
+};
+
+template <> struct MessageTraits<MessageType::Depth> {
+    using Type = DepthMessage;
+    static constexpr const char* NAME = "Depth";
+};
+
+template <> struct MessageTraits<MessageType::AddOrder> {
+    using Type = AddOrderMessage;
+    static constexpr const char* NAME = "AddOrder";
+};
+
+template <> struct MessageTraits<MessageType::ModifyOrder> {
+    using Type = ModifyOrderMessage;
+    static constexpr const char* NAME = "ModifyOrder";
+};
+
+template <> struct MessageTraits<MessageType::CancelOrder> {
+    using Type = CancelOrderMessage;
+    static constexpr const char* NAME = "CancelOrder";
+};
+
+template <> struct MessageTraits<MessageType::ExecuteOrder> {
+    using Type = ExecuteOrderMessage;
+    static constexpr const char* NAME = "ExecuteOrder";
+};
+
+/**
+ * @brief A list of message type tags.
+ */
+template <MessageType... Tags> struct MessageTypeList {};
+
+/**
+ * @brief Every message type the feed may contain. A type byte not listed here is invalid.
+ */
+using RegisteredMessages =
+    MessageTypeList<MessageType::Trade, MessageType::Quote, MessageType::Depth,
+                    MessageType::AddOrder, MessageType::ModifyOrder, MessageType::CancelOrder,
+                    MessageType::ExecuteOrder>;
+
+/**
+ * @brief Checks the layout every message shares at compile time: readers take the type from the
+ * first byte and the symbol from a fixed offset, and sizes must fit the size table.
+ */
+template <MessageType Tag> constexpr bool hasMessageHeader() {
+    using Type = typename MessageTraits<Tag>::Type;
+    static_assert(offsetof(Type, type) == 0, "the type byte must come first");
+    static_assert(offsetof(Type, timestamp) == offsetof(TradeMessage, timestamp) &&
+                      offsetof(Type, symbol) == offsetof(TradeMessage, symbol),
+                  "every message starts with the type/timestamp/symbol header");
+    static_assert(sizeof(Type) < 256, "message sizes are stored in a byte");
+    return true;
+}
+
+/**
+ * @brief Builds the table of wire sizes indexed by type byte, 0 for unregistered bytes.
+ */
+template <MessageType... Tags>
+constexpr std::array<std::uint8_t, 256> makeMessageSizes(MessageTypeList<Tags...>) {
+    static_assert((hasMessageHeader<Tags>() && ...));
+    std::array<std::uint8_t, 256> sizes{};
+    ((sizes[static_cast<std::uint8_t>(Tags)] = sizeof(typename MessageTraits<Tags>::Type)), ...);
+    return sizes;
+}
+
+/**
+ * @brief The wire size of every possible type byte, 0 for bytes that are not a registered type.
+ * Readers look sizes up here instead of branching on the type.
+ */
+inline constexpr std::array<std::uint8_t, 256> MESSAGE_SIZES =
+    makeMessageSizes(RegisteredMessages{});
+
+/**
+ * @brief Returns the wire size of a message of type `type`, or 0 if `type` is not registered.
+ */
+inline constexpr std::size_t messageSize(const MessageType type) {
+    return MESSAGE_SIZES[static_cast<std::uint8_t>(type)];
+}
+
+/**
+ * @brief Returns `true` if `type` is the type byte of a registered message.
+ */
+inline constexpr bool isKnownMessageType(const std::uint8_t type) {
+    return MESSAGE_SIZES[type] != 0;
+}
+
+/**
+ * @brief Builds the table of names indexed by type byte, "Unknown" for unregistered bytes.
+ */
+template <MessageType... Tags>
+constexpr std::array<const char*, 256> makeMessageNames(MessageTypeList<Tags...>) {
+    std::array<const char*, 256> names{};
+    for (auto& name : names) {
+        name = "Unknown";
+    }
+    ((names[static_cast<std::uint8_t>(Tags)] = MessageTraits<Tags>::NAME), ...);
+    return names;
+}
+
+/**
+ * @brief Returns a human-readable name for `type`, for reports.
+ */
+inline const char* messageTypeName(const MessageType type) {
+    static constexpr auto NAMES = makeMessageNames(RegisteredMessages{});
+    return NAMES[static_cast<std::uint8_t>(type)];
+}
+
+/**
+ * @brief The wire size of the largest message type, i.e. the most bytes a reader needs contiguous
+ * to parse any one message.
+ */
+template <MessageType... Tags> constexpr std::size_t maxMessageSize(MessageTypeList<Tags...>) {
+    return std::max({sizeof(typename MessageTraits<Tags>::Type)...});
+}
+
+inline constexpr std::size_t MAX_MESSAGE_SIZE = maxMessageSize(RegisteredMessages{});
+
+/**
+ * @brief Calls `handler` with the message at `data` as the struct registered for its type byte.
+ * Expands to one comparison per registered type, which the compiler lowers to a jump table like a
+ * hand-written `switch`, and inlines the handler for each type.
+ *
+ * @param handler Callable with a `const` reference to every registered message struct, e.g. a
+ * generic lambda forwarding to an overload set. A registered type without an overload fails to
+ * compile rather than being silently mishandled.
+ * @return `false`, without calling `handler`, if the type byte is not registered.
+ */
+template <typename Handler, MessageType... Tags>
+inline bool dispatchMessage(const std::uint8_t* data, Handler&& handler, MessageTypeList<Tags...>) {
+    const auto type = static_cast<MessageType>(*data);
+    return ((type == Tags
+                 ? (handler(*reinterpret_cast<const typename MessageTraits<Tags>::Type*>(data)),
+                    true)
+                 : false) ||
+            ...);
+}
+
+template <typename Handler>
+inline bool dispatchMessage(const std::uint8_t* data, Handler&& handler) {
+    return dispatchMessage(data, handler, RegisteredMessages{});
+}
+
 /**
  * @brief Helper union to allow for reinterpretation of messages based on `type` field.
  */
@@ -43,4 +308,33 @@ union MarketDataMessage {
     MessageType type;
     TradeMessage trade;
     QuoteMessage quote;
+    DepthMessage depth;
+    AddOrderMessage addOrder;
+    ModifyOrderMessage modifyOrder;
+    CancelOrderMessage cancelOrder;
+    ExecuteOrderMessage executeOrder;
+};
+
+static_assert(sizeof(MarketDataMessage) >= MAX_MESSAGE_SIZE, "add new message types to the union");
+
+/**
+ * @brief A `MarketDataMessage` copied out of the feed together with the ID the parser assigned to
+ * its symbol and the venue it came from.
+ */
+struct InternedMessage {
+    MarketDataMessage msg;
+    SymbolId symbolId;
+    VenueId venue;
+};
+
+/**
+ * @brief A compact handle to a message that still lives in the mapped feed. Passing these through
+ * the queue instead of `MarketDataMessage` copies lets the consumer read the packed struct in
+ * place, so the payload is only touched once. The referenced memory must outlive the descriptor.
+ */
+struct MessageDescriptor {
+    const std::uint8_t* data;
+    MessageType type;
+    VenueId venue; /// fits in the padding before `symbolId`
+    SymbolId symbolId;
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A preallocated pool of `T` addressed by 32-bit indices.
+ *
+ * All storage is allocated up front and released slots are recycled through a free list, so
+ * `acquire`/`release` never touch the heap while the pool stays within its initial capacity.
+ * Indices rather than pointers are handed out so callers can link elements intrusively with 4-byte
+ * handles; if the pool does run out it grows, which keeps indices valid but moves elements, so
+ * references into the pool must not be held across `acquire`.
+ *
+ * @tparam T The element type. Must be default-constructible.
+ */
+template <typename T> class IndexPool {
+  public:
+    static constexpr std::uint32_t NONE = ~std::uint32_t{0};
+
+    /**
+     * @brief Constructor for IndexPool that preallocates `capacity` elements.
+     *
+     * @param capacity The number of elements available before the pool has to grow.
+     */
+    explicit IndexPool(std::size_t capacity) : items_(capacity) {
+        free_.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; --i) { /// hand out low indices first
+            free_.push_back(static_cast<std::uint32_t>(i - 1));
+        }
+    }
+
+    /**
+     * @brief Takes an unused element out of the pool. Its contents are whatever was left by the
+     * previous owner.
+     *
+     * @return The index of the element.
+     */
+    std::uint32_t acquire() {
+        ++live_;
+        if (free_.empty()) {
+            items_.emplace_back();
+            return static_cast<std::uint32_t>(items_.size() - 1);
+        }
+        const auto idx = free_.back();
+        free_.pop_back();
+        return idx;
+    }
+
+    /**
+     * @brief Returns an element to the pool.
+     *
+     * @param idx An index previously returned by `acquire`.
+     */
+    void release(const std::uint32_t idx) {
+        --live_;
+        free_.push_back(idx);
+    }
+
+    T& operator[](const std::uint32_t idx) {
+        return items_[idx];
+    }
+
+    const T& operator[](const std::uint32_t idx) const {
+        return items_[idx];
+    }
+
+    /**
+     * @brief Returns the number of elements currently acquired.
+     */
+    std::size_t size() const {
+        return live_;
+    }
+
+    std::size_t capacity() const {
+        return items_.size();
+    }
+
+  private:
+    std::vector<T> items_;
+    std::vector<std::uint32_t> free_; /// stack of released indices
+    std::size_t live_{0};
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "messages.hpp"
+#include "orderbook/index_pool.hpp"
+#include "orderbook/orderbook.hpp"
+#include "symbol_map/flat_symbol_map.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+/**
+ * @brief An order-by-order (L3) book that tracks every resting order by its exchange order ID.
+ *
+ * Orders and price levels live in preallocated `IndexPool`s; each level holds an intrusive,
+ * doubly-linked FIFO of its orders in time priority, a flat order-ID index maps IDs to pool
+ * slots and a flat index per symbol maps prices to levels. All of them are sized up front from
+ * the constructor's hints, so adds, modifies, cancels and executions never call `new`/`delete`
+ * while the resting orders, the symbols and each symbol's live levels stay within them. Every
+ * change to a level's aggregate quantity is published to the attached `OrderBook`'s depth ladder,
+ * and executions are recorded as trades in the attached `VWAPTracker`. This data structure cannot
+ * and should not be moved or copied.
+ *
+ * Messages that reference unknown order IDs, and adds that reuse a live ID, are ignored. The ID
+ * `INVALID_ORDER_ID` is the order index's reserved key and can never be resting, so messages
+ * carrying it are dropped up front and counted in `rejected`.
+ */
+class L3OrderBook {
+  public:
+    /**
+     * @brief The state of a single resting order.
+     */
+    struct Order {
+        std::uint64_t orderId;
+        std::uint64_t price;
+        std::uint32_t quantity;
+        SymbolId symbolId;
+        std::uint32_t level; /// index of the order's price level in the level pool
+        std::uint32_t prev;  /// previous order in the level's FIFO, or `IndexPool::NONE`
+        std::uint32_t next;  /// next order in the level's FIFO, or `IndexPool::NONE`
+        Side side;
+    };
+
+    static constexpr std::size_t DEFAULT_EXPECTED_ORDERS = 1 << 16;
+    static constexpr std::size_t DEFAULT_EXPECTED_SYMBOLS = 1 << 10;
+    static constexpr std::size_t DEFAULT_LEVELS_PER_SYMBOL = 32;
+
+    /// The order ID reserved by the order index, see `FlatSymbolMap::EMPTY_KEY`.
+    static constexpr std::uint64_t INVALID_ORDER_ID = FlatSymbolMap<std::uint32_t>::EMPTY_KEY;
+
+    /**
+     * @brief Constructor for L3OrderBook. All references must outlive the book, and `book` and
+     * `vwap` must resolve symbols through `symbols`.
+     *
+     * @param symbols The table used to intern symbols of new orders.
+     * @param book The book that receives aggregated price levels.
+     * @param vwap The tracker that receives executions.
+     * @param expectedOrders The number of simultaneously resting orders to preallocate for.
+     * @param expectedSymbols The number of symbols to preallocate level indexes for.
+     * @param levelsPerSymbol The number of live price levels each symbol's level index holds
+     * before it grows.
+     */
+    L3OrderBook(SymbolTable& symbols, OrderBook& book, VWAPTracker& vwap,
+                std::size_t expectedOrders = DEFAULT_EXPECTED_ORDERS,
+                std::size_t expectedSymbols = DEFAULT_EXPECTED_SYMBOLS,
+                std::size_t levelsPerSymbol = DEFAULT_LEVELS_PER_SYMBOL);
+
+    /**
+     * @brief Adds a new order to the back of the queue at its price level.
+     *
+     * @param msg The data of the incoming order.
+     */
+    void addOrder(const AddOrderMessage& msg);
+
+    /**
+     * @brief Same as `addOrder` for a symbol that has already been interned.
+     *
+     * @param id The ID of the order's symbol.
+     * @param msg The data of the incoming order.
+     */
+    void addOrderById(const SymbolId id, const AddOrderMessage& msg);
+
+    /**
+     * @brief Replaces the price and quantity of a resting order. The order keeps its queue
+     * position only if its price is unchanged and its quantity does not increase.
+     *
+     * @param msg The data of the modification.
+     */
+    void modifyOrder(const ModifyOrderMessage& msg);
+
+    /**
+     * @brief Removes a resting order.
+     *
+     * @param msg The data of the cancellation.
+     */
+    void cancelOrder(const CancelOrderMessage& msg);
+
+    /**
+     * @brief Fills part or all of a resting order at its price and records the trade.
+     *
+     * @param msg The data of the execution.
+     */
+    void executeOrder(const ExecuteOrderMessage& msg);
+
+    /**
+     * @brief Attempts to retrieve a resting order.
+     *
+     * @param orderId The exchange ID of the order.
+     * @return An optional containing a copy of the order if it is resting.
+     */
+    std::optional<Order> getOrder(const std::uint64_t orderId) const;
+
+    /**
+     * @brief Copies the IDs of up to `maxOrders` orders resting at one price level, in time
+     * priority.
+     *
+     * @param id The ID of the symbol.
+     * @param side The side of the level.
+     * @param price The price of the level.
+     * @param orderIds The output array, which must have room for `maxOrders` IDs.
+     * @param maxOrders The maximum number of IDs to copy.
+     * @return The number of IDs copied.
+     */
+    std::size_t ordersAt(const SymbolId id, const Side side, const std::uint64_t price,
+                         std::uint64_t* orderIds, const std::size_t maxOrders) const;
+
+    /**
+     * @brief Calls `fn(order)` for every resting order. The orders of each price level are visited
+     * one after another, in time priority.
+     */
+    template <typename Fn> void forEachOrder(Fn&& fn) const {
+        for (const auto& levels : levelIndex_) {
+            levels.forEach([&](std::uint64_t, const std::uint32_t levelIdx) {
+                for (auto orderIdx = levels_[levelIdx].head; orderIdx != IndexPool<Order>::NONE;
+                     orderIdx = orders_[orderIdx].next) {
+                    fn(orders_[orderIdx]);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Puts back a resting order saved by a snapshot, behind the orders already restored at
+     * its price. The book's levels are restored on their own, so they are not updated. Orders
+     * that could not be added by `addOrderById` are ignored.
+     *
+     * @param id The ID of the order's symbol.
+     * @param orderId The exchange ID of the order.
+     * @param side The side of the order.
+     * @param price The price of the order.
+     * @param quantity The remaining quantity of the order.
+     */
+    void restoreOrderById(const SymbolId id, const std::uint64_t orderId, const Side side,
+                          const std::uint64_t price, const std::uint32_t quantity);
+
+    /**
+     * @brief Returns the number of resting orders.
+     */
+    std::size_t size() const {
+        return orders_.size();
+    }
+
+    /**
+     * @brief Returns the number of messages dropped because they carried `INVALID_ORDER_ID`.
+     */
+    std::uint64_t rejected() const {
+        return rejected_;
+    }
+
+    L3OrderBook(const L3OrderBook& ob) = delete;
+    L3OrderBook(L3OrderBook&& ob) = delete;
+    void operator=(const L3OrderBook& ob) = delete;
+    void operator=(L3OrderBook&& ob) = delete;
+
+  private:
+    /**
+     * @brief A price level: the FIFO of its orders and their aggregate quantity.
+     */
+    struct Level {
+        std::uint32_t head;
+        std::uint32_t tail;
+        std::uint32_t quantity;
+    };
+
+    static std::uint64_t levelKey(const Side side, const std::uint64_t price) {
+        return (price << 1) | static_cast<std::uint64_t>(side);
+    }
+
+    /**
+     * @brief Takes a pool slot for a new order and indexes it under `orderId`.
+     *
+     * @return The pool index of the order, or `IndexPool::NONE` if `orderId` is already resting.
+     */
+    std::uint32_t insertOrder(const SymbolId id, const std::uint64_t orderId, const Side side,
+                              const std::uint64_t price, const std::uint32_t quantity);
+
+    /**
+     * @brief Appends an order to the tail of the level at its price, creating the level if needed,
+     * and publishes the level unless `publish` is `false`.
+     */
+    void appendToLevel(const std::uint32_t orderIdx, const std::uint64_t timestamp,
+                       const bool publish = true);
+
+    /**
+     * @brief Unlinks an order from its level, releasing the level if it empties, and publishes
+     * the level.
+     */
+    void removeFromLevel(const std::uint32_t orderIdx, const std::uint64_t timestamp);
+
+    /**
+     * @brief Removes an order from its level, the order-ID index and the pool.
+     */
+    void removeOrder(const std::uint32_t orderIdx, const std::uint64_t timestamp);
+
+    SymbolTable& symbols_;
+    OrderBook& book_;
+    VWAPTracker& vwap_;
+
+    IndexPool<Order> orders_;
+    IndexPool<Level> levels_;
+    FlatSymbolMap<std::uint32_t> orderIndex_;              /// order ID -> order pool index
+    std::vector<FlatSymbolMap<std::uint32_t>> levelIndex_; /// per symbol: levelKey -> level index
+    std::size_t levelsPerSymbol_;                          /// presize for each level index
+    std::uint64_t rejected_{0};
+};
@@ -1,15 +1,33 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <unordered_map>
+#include <vector>
 
 #include "messages.hpp"
+#include "orderbook/price_ladder.hpp"
+#include "symbol_map/symbol_table.hpp"
 
 /**
  * @brief A class for storing symbols mapped to their current best bid/ask prices and quantities.
  * Supports insertion of a symbol/entry pair and updating the entry for an existing symbol. This
  * data structure cannot and should not be moved or copied.
+ *
+ * State is stored as a struct of arrays indexed by `SymbolId`, so the `...ById` operations are a
+ * bounds check and a handful of array stores, and scans over all symbols walk contiguous columns.
+ * The symbol-keyed operations intern through the book's `SymbolTable` first. A book either owns a
+ * private table or shares one with the parser that assigns IDs.
+ *
+ * Symbols fed by `DepthMessage`s additionally get a full-depth `PriceLadder`, created on their
+ * first depth update; their top-of-book entry is refreshed from the ladder's best levels. Symbols
+ * fed only by `QuoteMessage`s never allocate a ladder, so the top-of-book path is unchanged.
+ *
+ * A book told to `trackVenues` also keeps the latest quote of each venue for every symbol, and the
+ * consolidated best bid and offer (NBBO) across them. Each venue quote updates the NBBO in
+ * constant time, except when the venue was the only one at the best price and backs off, which
+ * rescans the symbol's venues.
  */
 class OrderBook {
   public:
@@ -25,18 +43,57 @@ class OrderBook {
     };
 
     /**
-     * @brief Default constructor for OrderBook that instantiates all member variables.
+     * @brief The consolidated best bid and offer of a symbol across the venues quoting it.
      */
-    OrderBook() = default;
+    struct NbboEntry {
+        std::uint64_t updatedAt;
+        std::uint64_t bidPrice;    /// highest bid of any venue, 0 if none bids
+        std::uint64_t askPrice;    /// lowest ask of any venue, 0 if none offers
+        std::uint32_t bidQuantity; /// summed over the venues at the best bid
+        std::uint32_t askQuantity; /// summed over the venues at the best ask
+        std::uint16_t bidVenues;   /// bit `v` is set if venue `v` is at the best bid
+        std::uint16_t askVenues;   /// bit `v` is set if venue `v` is at the best ask
+        std::uint16_t venues;      /// bit `v` is set if venue `v` has quoted the symbol
+    };
+    static_assert(MAX_VENUES <= 16, "NbboEntry keeps a 16-bit mask of venues");
+
+    /**
+     * @brief Constructor for OrderBook with a private symbol table and room for `expectedSymbols`
+     * symbols.
+     *
+     * @param expectedSymbols The number of symbols the book can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns.
+     */
+    explicit OrderBook(std::size_t expectedSymbols = 0,
+                       std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Constructor for OrderBook that resolves symbols through a shared table, so IDs handed
+     * out by the parser can be used with the `...ById` operations. `symbols` must outlive the book.
+     *
+     * @param symbols The table that assigns IDs to symbols.
+     * @param expectedSymbols The number of symbols the book can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns.
+     */
+    explicit OrderBook(SymbolTable& symbols, std::size_t expectedSymbols = 0,
+                       std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     /**
-     * @brief Attempts to retrieve the order metadata object associated with the input symbol.
+     * @brief Attempts to retrieve the order metadata associated with the input symbol.
      *
      * @param key The symbol of the instrument stored as the key.
-     * @return An optional containing a const pointer to the `OrderBookEntry` associated with `key`
-     * if it exists.
+     * @return An optional containing a copy of the `OrderBookEntry` associated with `key` if it
+     * exists.
+     */
+    std::optional<OrderBookEntry> getEntry(const std::uint64_t key) const;
+
+    /**
+     * @brief Attempts to retrieve the order metadata associated with the input symbol ID.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @return An optional containing a copy of the `OrderBookEntry` for `id` if it exists.
      */
-    std::optional<const OrderBookEntry*> getEntry(const std::uint64_t key) const;
+    std::optional<OrderBookEntry> getEntryById(const SymbolId id) const;
 
     /**
      * @brief Creates a new symbol-to-quote mapping using the symbol and `QuoteMessage` object
@@ -45,15 +102,166 @@ class OrderBook {
      * @param key The symbol to update or insert.
      * @param msg The data of the incoming quote.
      */
-    void upsertEntry(const std::uint64_t, const QuoteMessage& msg);
+    void upsertEntry(const std::uint64_t key, const QuoteMessage& msg);
+
+    /**
+     * @brief Same as `upsertEntry` for a symbol that has already been interned.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @param msg The data of the incoming quote.
+     */
+    void upsertEntryById(const SymbolId id, const QuoteMessage& msg);
+
+    /**
+     * @brief Keeps a quote per venue and the NBBO of every symbol for `venues` venues, numbered
+     * from 0. Must be called before the first venue quote.
+     *
+     * @param venues The number of venues, at most `MAX_VENUES`.
+     */
+    void trackVenues(const std::size_t venues);
+
+    /**
+     * @brief Returns the number of venues the book keeps quotes for, 0 unless `trackVenues` was
+     * called.
+     */
+    std::size_t venues() const {
+        return venues_;
+    }
+
+    /**
+     * @brief Same as `upsertEntryById`, and also replaces the quote of `venue` for the symbol and
+     * updates the symbol's NBBO. The book must track venues.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @param venue The venue the quote came from, below `venues()`.
+     * @param msg The data of the incoming quote.
+     */
+    void upsertVenueQuoteById(const SymbolId id, const VenueId venue, const QuoteMessage& msg);
+
+    /**
+     * @brief Attempts to retrieve the latest quote of `venue` for the input symbol ID.
+     *
+     * @return An optional containing a copy of the quote if the venue has quoted the symbol.
+     */
+    std::optional<OrderBookEntry> getVenueQuoteById(const SymbolId id, const VenueId venue) const;
+
+    /**
+     * @brief Attempts to retrieve the NBBO of the input symbol.
+     *
+     * @param key The symbol of the instrument stored as the key.
+     * @return An optional containing a copy of the `NbboEntry` if any venue has quoted `key`.
+     */
+    std::optional<NbboEntry> getNbbo(const std::uint64_t key) const;
+
+    /**
+     * @brief Same as `getNbbo` for a symbol that has already been interned.
+     */
+    std::optional<NbboEntry> getNbboById(const SymbolId id) const;
+
+    /**
+     * @brief Applies a price-level update to the depth ladder of `key` and refreshes its top of
+     * book from the ladder's new best bid and ask.
+     *
+     * @param key The symbol to update.
+     * @param msg The data of the incoming level update.
+     */
+    void applyDepth(const std::uint64_t key, const DepthMessage& msg);
+
+    /**
+     * @brief Same as `applyDepth` for a symbol that has already been interned.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @param msg The data of the incoming level update.
+     */
+    void applyDepthById(const SymbolId id, const DepthMessage& msg);
+
+    /**
+     * @brief Sets the aggregate quantity of one price level in the depth ladder of `id` and
+     * refreshes its top of book. This is what `applyDepthById` does with a decoded message; order
+     * level books use it to publish their aggregated levels.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @param side The side of the level.
+     * @param price The price of the level.
+     * @param quantity The new aggregate quantity, or 0 to remove the level.
+     * @param timestamp The exchange time of the update.
+     */
+    void setLevelById(const SymbolId id, const Side side, const std::uint64_t price,
+                      const std::uint32_t quantity, const std::uint64_t timestamp);
+
+    /**
+     * @brief Attempts to retrieve the depth ladder of the input symbol.
+     *
+     * @param key The symbol of the instrument stored as the key.
+     * @return An optional containing a const pointer to the symbol's `PriceLadder` if it has
+     * received any depth updates. The pointer stays valid for the lifetime of the book.
+     */
+    std::optional<const PriceLadder*> getLadder(const std::uint64_t key) const;
+
+    /**
+     * @brief Same as `getLadder` for a symbol that has already been interned.
+     */
+    std::optional<const PriceLadder*> getLadderById(const SymbolId id) const;
+
+    /**
+     * @brief Calls `fn(id, entry, ladder)` for every symbol in the book, in ID order. `ladder` is
+     * `nullptr` for symbols without depth updates.
+     */
+    template <typename Fn> void forEachEntry(Fn&& fn) const {
+        for (SymbolId id = 0; id < present_.size(); ++id) {
+            if (present_[id]) {
+                fn(id,
+                   OrderBookEntry{updatedAt_[id], bidPrice_[id], askPrice_[id], bidQuantity_[id],
+                                  askQuantity_[id]},
+                   static_cast<const PriceLadder*>(ladders_[id].get()));
+            }
+        }
+    }
+
+    /**
+     * @brief Sets the entry and depth ladder of `id` as they were saved, e.g. from a snapshot,
+     * replacing any existing state for the symbol.
+     *
+     * @param id The ID of the symbol in the book's symbol table.
+     * @param entry The top of book.
+     * @param ladder The depth ladder to copy, or `nullptr` if the symbol has none.
+     */
+    void restoreEntryById(const SymbolId id, const OrderBookEntry& entry,
+                          const PriceLadder* ladder);
+
+    /**
+     * @brief Folds the entries of `other` into this book. For symbols present in both books the
+     * entry with the most recent update time wins, so books built from disjoint or overlapping
+     * slices of a feed whose timestamps never go backwards merge into the state of a single
+     * sequential pass. Venue quotes are merged the same way, per venue, if both books track the
+     * same venues.
+     *
+     * @param other The book to merge from.
+     */
+    void mergeFrom(const OrderBook& other);
+
+    /**
+     * @brief Folds the entries of `other`, built from a later slice of the same feed, into this
+     * book. For symbols present in both books the entry of `other` wins whatever its update time,
+     * as it would in a sequential pass, so feeds whose timestamps go backwards merge correctly
+     * too. Venue quotes are merged the same way, per venue.
+     *
+     * @param other The book to merge from.
+     */
+    void mergeLaterFrom(const OrderBook& other);
 
     /**
      * @brief Displays the state of the book.
      */
     void showState() const;
 
+    /**
+     * @brief Displays the NBBO of every symbol a venue has quoted.
+     */
+    void showNbbo() const;
+
     std::size_t size() const {
-        return book_.size();
+        return size_;
     }
 
     OrderBook(const OrderBook& ob) = delete;
@@ -62,5 +270,34 @@ class OrderBook {
     void operator=(OrderBook&& ob) = delete;
 
   private:
-    std::unordered_map<std::uint64_t, OrderBookEntry> book_;
+    /**
+     * @brief Grows every column so that `id` is a valid index.
+     */
+    void ensureCapacity(const SymbolId id);
+
+    /**
+     * @brief Rebuilds the NBBO of `id` from the quotes of every venue.
+     */
+    void rescanNbbo(const SymbolId id);
+
+    /**
+     * @brief Implements `mergeFrom` and, if `laterWins`, `mergeLaterFrom`.
+     */
+    void merge(const OrderBook& other, bool laterWins);
+
+    std::unique_ptr<SymbolTable> ownedSymbols_; /// only set when no table was shared
+    SymbolTable* symbols_;
+    std::size_t size_{0};
+
+    std::pmr::vector<std::uint8_t> present_;
+    std::pmr::vector<std::uint64_t> updatedAt_;
+    std::pmr::vector<std::uint64_t> bidPrice_;
+    std::pmr::vector<std::uint64_t> askPrice_;
+    std::pmr::vector<std::uint32_t> bidQuantity_;
+    std::pmr::vector<std::uint32_t> askQuantity_;
+    std::pmr::vector<std::unique_ptr<PriceLadder>> ladders_; /// null until the first depth update
+
+    std::size_t venues_{0};
+    std::pmr::vector<OrderBookEntry> venueQuotes_; /// `venues_` per symbol, by `id * venues_ + v`
+    std::pmr::vector<NbboEntry> nbbo_;             /// by `SymbolId` while venues are tracked
 };
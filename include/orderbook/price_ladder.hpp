@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "messages.hpp"
+
+/**
+ * @brief A full-depth, per-symbol view of one instrument's price levels on both sides of the book.
+ *
+ * Each side keeps a window of `windowTicks` contiguous quantity slots indexed by tick offset from a
+ * reference price, placed so the best price sits near the front of the window with room for it to
+ * improve. Updating a level inside the window is an array store, the best price is tracked
+ * incrementally, and top-N depth is a forward scan from the best slot. Levels that fall outside
+ * the window (deep, far-from-touch orders) are kept in an ordered fallback map. When the best
+ * price moves out of the window, or drifts past its middle as the book trends to worse prices,
+ * the window is re-centred in place, which costs O(window) but is rare. A side's window is only
+ * allocated once it gets its first level.
+ *
+ * Prices must be multiples of `tickSize`.
+ */
+class PriceLadder {
+  public:
+    /**
+     * @brief A single aggregated price level.
+     */
+    struct Level {
+        std::uint64_t price;
+        std::uint32_t quantity;
+    };
+
+    static constexpr std::size_t DEFAULT_WINDOW_TICKS = 256;
+
+    /**
+     * @brief Constructor for PriceLadder.
+     *
+     * @param tickSize The minimum price increment, in the same units as message prices.
+     * @param windowTicks The number of contiguous levels each side keeps in its array.
+     */
+    explicit PriceLadder(std::uint64_t tickSize = 1,
+                         std::size_t windowTicks = DEFAULT_WINDOW_TICKS);
+
+    /**
+     * @brief Sets the quantity resting at `price` on `side`. A quantity of zero removes the level.
+     *
+     * @param side The side of the book to update.
+     * @param price The price of the level.
+     * @param quantity The new aggregate quantity of the level.
+     */
+    void update(const Side side, const std::uint64_t price, const std::uint32_t quantity);
+
+    /**
+     * @brief Returns the best level on `side`, if any: the highest bid or the lowest ask.
+     */
+    std::optional<Level> best(const Side side) const;
+
+    /**
+     * @brief Copies up to `maxLevels` levels on `side` into `out`, best first.
+     *
+     * @param side The side of the book to read.
+     * @param out The output array, which must have room for `maxLevels` levels.
+     * @param maxLevels The maximum number of levels to copy.
+     * @return The number of levels copied.
+     */
+    std::size_t depth(const Side side, Level* out, const std::size_t maxLevels) const;
+
+    /**
+     * @brief Returns the quantity resting at `price` on `side`, or 0 if there is no such level.
+     */
+    std::uint32_t quantityAt(const Side side, const std::uint64_t price) const;
+
+    /**
+     * @brief Returns the number of non-empty levels on `side`.
+     */
+    std::size_t levelCount(const Side side) const;
+
+  private:
+    /**
+     * @brief One side of the ladder. Prices are converted to ranks so that both sides order the
+     * same way: a lower rank is always a better price (asks use +ticks, bids use -ticks).
+     */
+    class LadderSide {
+      public:
+        explicit LadderSide(std::size_t windowTicks) : windowTicks_{windowTicks} {}
+
+        void set(const std::int64_t rank, const std::uint32_t quantity);
+        std::uint32_t at(const std::int64_t rank) const;
+
+        /**
+         * @brief Calls `fn(rank, quantity)` for up to `maxLevels` levels, best first.
+         *
+         * @return The number of levels visited.
+         */
+        template <typename Fn> std::size_t walk(const std::size_t maxLevels, Fn&& fn) const {
+            std::size_t count = 0;
+            if (empty()) {
+                return count;
+            }
+            for (auto idx = static_cast<std::size_t>(best_ - base_);
+                 idx < quantities_.size() && count < maxLevels; ++idx) {
+                if (quantities_[idx] != 0) {
+                    fn(base_ + static_cast<std::int64_t>(idx), quantities_[idx]);
+                    ++count;
+                }
+            }
+            for (auto it = outliers_.begin(); it != outliers_.end() && count < maxLevels; ++it) {
+                fn(it->first, it->second);
+                ++count;
+            }
+            return count;
+        }
+
+        bool empty() const {
+            return inWindow_ == 0;
+        }
+
+        std::int64_t bestRank() const {
+            return best_;
+        }
+
+        std::uint32_t bestQuantity() const {
+            return quantities_[best_ - base_];
+        }
+
+        std::size_t levelCount() const {
+            return inWindow_ + outliers_.size();
+        }
+
+      private:
+        /**
+         * @brief Moves the window so that `newBest`, which must be at least as good as every
+         * level, lands a quarter of the way in. Levels are shifted within the array; only those
+         * leaving or entering the window touch the outlier map.
+         */
+        void recenter(const std::int64_t newBest);
+
+        std::size_t windowTicks_;
+        std::vector<std::uint32_t> quantities_;          /// indexed by rank - base_, lazily sized
+        std::map<std::int64_t, std::uint32_t> outliers_; /// levels beyond the end of the window
+        std::int64_t base_{0};                           /// rank of quantities_[0]
+        std::int64_t best_{0};    /// valid only when the window is non-empty
+        std::size_t inWindow_{0}; /// non-empty slots in quantities_
+    };
+
+    std::int64_t toRank(const Side side, const std::uint64_t price) const {
+        const auto ticks = static_cast<std::int64_t>(price / tickSize_);
+        return side == Side::Ask ? ticks : -ticks;
+    }
+
+    std::uint64_t toPrice(const Side side, const std::int64_t rank) const {
+        return static_cast<std::uint64_t>(side == Side::Ask ? rank : -rank) * tickSize_;
+    }
+
+    const LadderSide& sideOf(const Side side) const {
+        return side == Side::Bid ? bids_ : asks_;
+    }
+
+    std::uint64_t tickSize_;
+    LadderSide bids_;
+    LadderSide asks_;
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "feed/feed_merger.hpp"
+#include "feed/parser.hpp"
+#include "journal/journal.hpp"
+#include "latency/latency_stats.hpp"
+#include "latency/tsc_clock.hpp"
+#include "messages.hpp"
+#include "pipeline/market_state.hpp"
+#include "ringbuffer/shm_spsc_queue.hpp"
+#include "ringbuffer/spsc_queue.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Number of slots in the queue between the producer and consumer threads.
+ */
+inline constexpr std::size_t QUEUE_SIZE = 8192;
+
+/**
+ * @brief Maximum number of messages the producer parses, or the consumer applies, per claim on the
+ * queue. Indices are published once per batch, so this bounds both the cross-core traffic and how
+ * long the other side waits to see new work.
+ */
+inline constexpr std::uint64_t BATCH_SIZE = 64;
+
+/**
+ * @brief Message limit used when the feed header is absent or holds a count of 0: the pipeline
+ * runs until the input ends.
+ */
+inline constexpr std::uint64_t NO_MESSAGE_LIMIT = std::numeric_limits<std::uint64_t>::max();
+
+/**
+ * @brief The cores the pipeline threads are pinned to. -1 or an empty list leaves the scheduler
+ * free to place the thread.
+ */
+struct CpuPlacement {
+    int producer{-1};
+    std::vector<int> consumers; /// consumer `i` runs on `consumers[i % consumers.size()]`
+
+    int consumerCpu(const std::size_t i) const {
+        return consumers.empty() ? -1 : consumers[i % consumers.size()];
+    }
+};
+
+/**
+ * @brief What a pipeline run reports back for the final metrics.
+ */
+struct RunResult {
+    std::uint64_t messages;
+    double elapsedMs;
+    std::uint64_t conflated{0};  /// quotes superseded by a newer quote before they were queued
+    std::uint64_t boardReads{0}; /// consistent board entries read by the `--publish` pollers
+};
+
+/**
+ * @brief Pins the calling thread to `cpu`. Failing to pin only costs performance, so it is
+ * reported as a warning and the thread keeps running wherever the scheduler put it.
+ *
+ * @param cpu The core to run on, or -1 to leave the thread unpinned.
+ * @param role The thread's name for the warning.
+ */
+void pinCurrentThread(int cpu, const char* role);
+
+/**
+ * @brief The queue between pipeline threads, with its ring allocated from a `MarketState`'s memory.
+ */
+template <typename Slot>
+using PipelineQueue = SPSCQueue<Slot, QUEUE_SIZE, std::pmr::polymorphic_allocator<Slot>>;
+
+/**
+ * @brief Stamps the parse time on a timestamped slot and parses into the slot it wraps.
+ */
+template <typename Slot>
+inline void parseInto(const std::uint8_t* data, Timestamped<Slot>& slot, SymbolTable& symbols,
+                      const VenueId venue) {
+    slot.parsedAt = readTsc();
+    parseInto(data, slot.slot, symbols, venue);
+}
+
+/**
+ * @brief Returns the venue of the message `source` returned last: the merged input it came from
+ * for a `FeedMerger`, and venue 0 for any single feed.
+ */
+template <typename Source> inline VenueId venueOf(const Source&) {
+    return 0;
+}
+
+inline VenueId venueOf(const FeedMerger& source) {
+    return source.venue();
+}
+
+/**
+ * @brief Stamps the enqueue time on a batch of slots the producer is about to commit. Does nothing
+ * unless the slots are timestamped.
+ */
+template <typename Slot> inline void stampEnqueued(Slot* slots, const std::size_t count) {
+    if constexpr (isTimestamped<Slot>) {
+        const auto now = readTsc();
+        for (std::size_t i = 0; i < count; ++i) {
+            slots[i].enqueuedAt = now;
+        }
+    }
+}
+
+/**
+ * @brief Returns the type of the message held by a queue slot.
+ */
+inline MessageType typeOf(const InternedMessage& slot) {
+    return slot.msg.type;
+}
+
+inline MessageType typeOf(const MessageDescriptor& slot) {
+    return slot.type;
+}
+
+/**
+ * @brief Returns the packed message held by, or pointed to by, a queue slot.
+ */
+inline const std::uint8_t* dataOf(const InternedMessage& slot) {
+    return reinterpret_cast<const std::uint8_t*>(&slot.msg);
+}
+
+inline const std::uint8_t* dataOf(const MessageDescriptor& slot) {
+    return slot.data;
+}
+
+/**
+ * @brief Returns the message a queue slot carries, looking through a `Timestamped` wrapper.
+ */
+template <typename Slot> inline const auto& messageOf(const Slot& slot) {
+    if constexpr (isTimestamped<Slot>) {
+        return slot.slot;
+    } else {
+        return slot;
+    }
+}
+
+/**
+ * @brief Copies the message of a queue slot into a slot of the `--shm` queue.
+ */
+inline void copyMessage(const InternedMessage& slot, MarketDataMessage& out) {
+    out = slot.msg;
+}
+
+/**
+ * @brief Same as above for a zero-copy descriptor, copying only the message's own bytes.
+ */
+inline void copyMessage(const MessageDescriptor& slot, MarketDataMessage& out) {
+    std::memcpy(&out, slot.data, messageSize(slot.type));
+}
+
+/**
+ * @brief Forwards a batch of applied messages to `state.shmOut`. While a reader is attached, a
+ * full queue holds up the consumer like the in-process queue holds up the producer. Without one,
+ * messages that don't fit are dropped and counted, so a missing strategy never stalls the feed.
+ */
+template <typename Slot>
+void forwardBatch(const Slot* slots, const std::size_t count, MarketState& state) {
+    auto& out = *state.shmOut;
+    std::size_t sent = 0;
+    while (sent < count) {
+        MarketDataMessage* dest;
+        const auto claimed = out.claimWrite(dest, count - sent);
+        if (claimed == 0) {
+            if (out.peerState() != PeerState::Attached) {
+                state.shmDropped += count - sent;
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        for (std::size_t i = 0; i < claimed; ++i) {
+            copyMessage(messageOf(slots[sent + i]), dest[i]);
+        }
+        out.commitWrite(claimed);
+        sent += claimed;
+    }
+}
+
+/**
+ * @brief Applies a batch of slots claimed by a consumer, recording the latency of each message if
+ * the slots are timestamped, then forwards the batch if `state` has a `--shm` queue.
+ */
+template <typename Slot>
+inline void applyBatch(const Slot* slots, const std::size_t count, MarketState& state) {
+    if (state.journal != nullptr) {
+        state.batchReceivedAt = wallClockNs();
+    }
+    if constexpr (isTimestamped<Slot>) {
+        const auto dequeuedAt = readTsc();
+        for (std::size_t i = 0; i < count; ++i) {
+            applyMessage(slots[i].slot, state);
+            state.latency.record(typeOf(slots[i].slot), slots[i].parsedAt, slots[i].enqueuedAt,
+                                 dequeuedAt, readTsc());
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            applyMessage(slots[i], state);
+        }
+    }
+    if (state.shmOut != nullptr) {
+        forwardBatch(slots, count, state);
+    }
+}
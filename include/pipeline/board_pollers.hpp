@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "publish/quote_board.hpp"
+
+/**
+ * @brief Threads standing in for strategies that read the `--publish` board while the consumers
+ * write it. Each one repeatedly sweeps every cell and reads a consistent snapshot of each
+ * published symbol, counting the reads.
+ */
+class BoardPollers {
+  public:
+    /**
+     * @brief Starts `count` pollers on `board`. Starts none if `board` is null.
+     */
+    BoardPollers(const QuoteBoard* board, std::size_t count);
+
+    /**
+     * @brief Stops and joins the pollers.
+     *
+     * @return The number of entries they read.
+     */
+    std::uint64_t stop();
+
+    ~BoardPollers() {
+        stop();
+    }
+
+    BoardPollers(const BoardPollers&) = delete;
+    void operator=(const BoardPollers&) = delete;
+
+  private:
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+    std::atomic<std::uint64_t> reads_{0};
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "messages.hpp"
+#include "pipeline/batch.hpp"
+#include "ringbuffer/conflation_buffer.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief The producer side of `--conflate`. Instead of waiting on a full queue, it reads ahead and
+ * parks each quote in its symbol's latest-value slot, overwriting the quote parked before it: a
+ * quote replaces the symbol's top of book outright, so only the newest one needs to be applied.
+ * Trades don't touch the book and are kept in full, in order, in a backlog. Any other message
+ * stops the read-ahead and is queued after everything parked, which keeps every book-changing
+ * message for a symbol in feed order.
+ *
+ * Not thread-safe: it is driven by the producer thread alone, which owns the queue's write side.
+ *
+ * @tparam Slot The element carried by the queue: `InternedMessage` or `MessageDescriptor`, possibly
+ * `Timestamped`.
+ * @tparam Source The feed to parse, `MappedFeed`, `StreamReader` or `FeedMerger`.
+ */
+template <typename Slot, typename Source> class ConflatingProducer {
+  public:
+    /**
+     * @brief The most trades kept while the queue is full. Reading ahead stops once it is reached.
+     */
+    static constexpr std::size_t BACKLOG_CAPACITY = QUEUE_SIZE;
+
+    /**
+     * @brief Constructor for ConflatingProducer.
+     *
+     * @param source The feed, positioned at the first message.
+     * @param symbols The table symbols are interned into.
+     * @param maxMessages The most messages to read, or `NO_MESSAGE_LIMIT`.
+     */
+    ConflatingProducer(Source& source, SymbolTable& symbols, const std::uint64_t maxMessages)
+        : source_{source}, symbols_{symbols}, maxMessages_{maxMessages} {
+        backlog_.reserve(BACKLOG_CAPACITY);
+    }
+
+    /**
+     * @brief Reads one message ahead while the queue is full, parking it, adding it to the
+     * backlog, or holding it back if it is neither a quote nor a trade.
+     *
+     * @return `false` if nothing could be read: a message is held back, the feed ended, the message
+     * limit was reached or the backlog is full. The caller then waits for queue space.
+     */
+    bool readAhead() {
+        if (holding_ || ended_ || parsed_ == maxMessages_ || backlog_.size() >= BACKLOG_CAPACITY) {
+            return false;
+        }
+        const std::uint8_t* data = source_.next();
+        if (data == nullptr) {
+            ended_ = true;
+            return true;
+        }
+        parseInto(data, held_, symbols_, venueOf(source_));
+        ++parsed_;
+        const auto& msg = messageOf(held_);
+        if (typeOf(msg) == MessageType::Quote) {
+            conflated_ += parked_.put(msg.symbolId, held_);
+        } else if (typeOf(msg) == MessageType::Trade) {
+            backlog_.push_back(held_);
+        } else {
+            holding_ = true;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Fills claimed queue slots: the parked quotes first, then the trade backlog, then the
+     * held-back message once everything before it is out, then messages read from the feed.
+     *
+     * @param slots The slots claimed on the queue.
+     * @param count The number of slots claimed.
+     * @return The number of slots filled.
+     */
+    std::size_t fill(Slot* slots, const std::size_t count) {
+        std::size_t used = parked_.drain(slots, count);
+        while (used < count && backlogHead_ < backlog_.size()) {
+            slots[used++] = backlog_[backlogHead_++];
+        }
+        if (backlogHead_ == backlog_.size()) {
+            backlog_.clear();
+            backlogHead_ = 0;
+        }
+        if (holding_ && used < count) {
+            slots[used++] = held_;
+            holding_ = false;
+        }
+        while (!holding_ && used < count && !ended_ && parsed_ < maxMessages_) {
+            const std::uint8_t* data = source_.next();
+            if (data == nullptr) {
+                ended_ = true;
+                break;
+            }
+            parseInto(data, slots[used++], symbols_, venueOf(source_));
+            ++parsed_;
+        }
+        return used;
+    }
+
+    /**
+     * @brief Returns `true` once the feed is exhausted and every message read has been handed out.
+     */
+    bool done() const {
+        return (ended_ || parsed_ == maxMessages_) && !holding_ && parked_.empty() &&
+               backlogHead_ == backlog_.size();
+    }
+
+    /**
+     * @brief Gets the number of messages read from the feed so far.
+     */
+    std::uint64_t parsed() const {
+        return parsed_;
+    }
+
+    /**
+     * @brief Gets the number of quotes overwritten by a newer quote before they were queued.
+     */
+    std::uint64_t conflated() const {
+        return conflated_;
+    }
+
+    ConflatingProducer(const ConflatingProducer&) = delete;
+    void operator=(const ConflatingProducer&) = delete;
+
+  private:
+    Source& source_;
+    SymbolTable& symbols_;
+    std::uint64_t maxMessages_;
+    std::uint64_t parsed_{0};
+    std::uint64_t conflated_{0};
+
+    ConflationBuffer<Slot> parked_;
+    std::vector<Slot> backlog_;
+    std::size_t backlogHead_{0};
+    Slot held_;            /// the message read last, kept if it must wait for everything parked
+    bool holding_{false};
+    bool ended_{false};
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#include "feed/parser.hpp"
+#include "journal/journal.hpp"
+#include "latency/latency_stats.hpp"
+#include "messages.hpp"
+#include "orderbook/l3_order_book.hpp"
+#include "orderbook/orderbook.hpp"
+#include "publish/quote_board.hpp"
+#include "ringbuffer/shm_spsc_queue.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/rolling_vwap.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+/**
+ * @brief Everything a consumer updates: the top-of-book and depth view, the cumulative and rolling
+ * VWAP statistics, the order-by-order book that feeds them and, when measured, the latency of the
+ * messages it applied.
+ */
+struct MarketState {
+    explicit MarketState(SymbolTable& symbols,
+                         std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                         const std::vector<RollingVWAP::Window>& vwapWindows = {})
+        : memory{memory}, book{symbols, 0, memory}, vwapTracker{symbols, 0, memory},
+          rollingVwap{symbols, vwapWindows, 0, memory}, orders{symbols, book, vwapTracker} {}
+
+    /**
+     * @brief Folds the book and VWAP state of `other` into this state. Individual orders are not
+     * merged; their aggregate effect is already part of the book's levels.
+     */
+    void mergeFrom(const MarketState& other) {
+        book.mergeFrom(other.book);
+        vwapTracker.mergeFrom(other.vwapTracker);
+        rollingVwap.mergeFrom(other.rollingVwap);
+        latency.mergeFrom(other.latency);
+        unpublished += other.unpublished;
+    }
+
+    /**
+     * @brief Folds the state `other` built from a later slice of the same feed into this state.
+     * As `mergeFrom`, except book entries and VWAP update times come from `other` whatever their
+     * timestamps, as they would in a sequential pass.
+     */
+    void mergeLaterFrom(const MarketState& other) {
+        book.mergeLaterFrom(other.book);
+        vwapTracker.mergeLaterFrom(other.vwapTracker);
+        rollingVwap.mergeFrom(other.rollingVwap);
+        latency.mergeFrom(other.latency);
+        unpublished += other.unpublished;
+    }
+
+    /// `boardCells` value of a symbol that has not been published yet.
+    static constexpr std::uint32_t NO_CELL = std::numeric_limits<std::uint32_t>::max();
+    /// `boardCells` value of a symbol that found the board full.
+    static constexpr std::uint32_t BOARD_FULL = NO_CELL - 1;
+
+    std::pmr::memory_resource* memory; /// backs the columns, and the queues feeding this state
+    OrderBook book;
+    VWAPTracker vwapTracker;
+    RollingVWAP rollingVwap;
+    L3OrderBook orders;
+    LatencyStats latency;
+
+    QuoteBoard* board{nullptr};           /// receives every update if set, see `publishSymbol`
+    std::vector<std::uint32_t> boardCells; /// board cell of each `SymbolId` this state published
+    std::uint64_t unpublished{0};          /// symbols left off the board because it was full
+
+    ShmSPSCQueue<MarketDataMessage>* shmOut{nullptr}; /// receives every message if set
+    std::uint64_t shmDropped{0};                      /// dropped while no reader was attached
+
+    JournalRecorder* journal{nullptr}; /// receives a record of every message if set
+    std::uint64_t journalSequence{0};  /// records handed to `journal` so far
+    std::uint64_t batchReceivedAt{0};  /// wall-clock ns the batch being applied was dequeued
+};
+
+/**
+ * @brief Copies the top of book and cumulative VWAP of symbol `id` into `out`, a board entry or
+ * journal record. Fields the symbol has no value for yet are left as they are.
+ */
+template <typename Out>
+inline void copySymbolState(const SymbolId id, const MarketState& state, Out& out) {
+    if (const auto top = state.book.getEntryById(id)) {
+        out.bidPrice = top->bidPrice;
+        out.askPrice = top->askPrice;
+        out.bidQuantity = top->bidQuantity;
+        out.askQuantity = top->askQuantity;
+    }
+    if (const auto vwap = state.vwapTracker.getVWAPById(id)) {
+        out.totalPriceByQuantity = vwap->totalPriceByQuantity;
+        out.totalQuantity = vwap->totalQuantity;
+        out.totalTrades = vwap->totalTrades;
+    }
+}
+
+/**
+ * @brief Publishes the current top of book and VWAP of symbol `id` to `state.board`, claiming the
+ * symbol's cell the first time. Runs on the consumer that owns the symbol, so each cell has a
+ * single writer. The symbol is read from the message rather than the symbol table, which the
+ * producer may be growing concurrently.
+ *
+ * @param data The message that just updated the symbol, for its symbol and timestamp.
+ */
+inline void publishSymbol(const std::uint8_t* data, const SymbolId id, MarketState& state) {
+    if (id >= state.boardCells.size()) {
+        state.boardCells.resize(id + 1, MarketState::NO_CELL);
+    }
+    std::uint32_t& cell = state.boardCells[id];
+    if (cell == MarketState::NO_CELL) {
+        const auto claimed = state.board->claim(symbolOf(data));
+        cell = claimed.has_value() ? static_cast<std::uint32_t>(*claimed) : MarketState::BOARD_FULL;
+        state.unpublished += !claimed.has_value();
+    }
+    if (cell == MarketState::BOARD_FULL) {
+        return;
+    }
+
+    QuoteBoard::Entry entry{};
+    std::memcpy(&entry.updatedAt, data + offsetof(TradeMessage, timestamp),
+                sizeof(entry.updatedAt));
+    copySymbolState(id, state, entry);
+    state.board->publish(cell, entry);
+}
+
+/**
+ * @brief Hands the message at `data` and the state it left symbol `id` in to `state.journal`.
+ * Only the copy happens here; the recorder thread writes it out.
+ */
+inline void journalMessage(const std::uint8_t* data, const SymbolId id, MarketState& state) {
+    JournalRecord record{};
+    record.sequence = ++state.journalSequence;
+    record.receivedAt = state.batchReceivedAt;
+    std::memcpy(&record.msg, data, messageSize(static_cast<MessageType>(*data)));
+    copySymbolState(id, state, record);
+    state.journal->record(record);
+}
+
+/**
+ * @brief The handlers `applyMessage` dispatches to, one overload per registered message type. Each
+ * applies a message whose symbol was interned as `id` and that came from `venue` to the component
+ * of `state` that owns it. Only quotes are kept per venue, for the NBBO; everything else is
+ * applied the same whichever venue it came from.
+ */
+inline void handleMessage(const TradeMessage& trade, const SymbolId id, VenueId,
+                          MarketState& state) {
+    state.vwapTracker.upsertVWAPById(id, trade);
+    state.rollingVwap.addTradeById(id, trade);
+}
+
+inline void handleMessage(const QuoteMessage& quote, const SymbolId id, const VenueId venue,
+                          MarketState& state) {
+    if (state.book.venues() != 0) {
+        state.book.upsertVenueQuoteById(id, venue, quote);
+    } else {
+        state.book.upsertEntryById(id, quote);
+    }
+}
+
+inline void handleMessage(const DepthMessage& depth, const SymbolId id, VenueId,
+                          MarketState& state) {
+    state.book.applyDepthById(id, depth);
+}
+
+inline void handleMessage(const AddOrderMessage& add, const SymbolId id, VenueId,
+                          MarketState& state) {
+    state.orders.addOrderById(id, add);
+}
+
+inline void handleMessage(const ModifyOrderMessage& modify, SymbolId, VenueId,
+                          MarketState& state) {
+    state.orders.modifyOrder(modify);
+}
+
+inline void handleMessage(const CancelOrderMessage& cancel, SymbolId, VenueId,
+                          MarketState& state) {
+    state.orders.cancelOrder(cancel);
+}
+
+inline void handleMessage(const ExecuteOrderMessage& execute, SymbolId, VenueId,
+                          MarketState& state) {
+    state.orders.executeOrder(execute);
+}
+
+/**
+ * @brief Applies the packed message at `data`, whose symbol was interned as `id` and that came
+ * from `venue`, through the `handleMessage` overload for its type, then publishes the symbol if
+ * `state` has a board and journals the message if it has a journal. The feed readers only hand
+ * out registered types, so every message has a handler.
+ */
+inline void applyMessage(const std::uint8_t* data, const SymbolId id, const VenueId venue,
+                         MarketState& state) {
+    dispatchMessage(data,
+                    [id, venue, &state](const auto& msg) { handleMessage(msg, id, venue, state); });
+    if (state.board != nullptr) {
+        publishSymbol(data, id, state);
+    }
+    if (state.journal != nullptr) {
+        journalMessage(data, id, state);
+    }
+}
+
+/**
+ * @brief Applies a copied message to the consumer's state.
+ */
+inline void applyMessage(const InternedMessage& slot, MarketState& state) {
+    applyMessage(reinterpret_cast<const std::uint8_t*>(&slot.msg), slot.symbolId, slot.venue,
+                 state);
+}
+
+/**
+ * @brief Applies a message read in place from the mapped feed to the consumer's state.
+ */
+inline void applyMessage(const MessageDescriptor& msg, MarketState& state) {
+    applyMessage(msg.data, msg.symbolId, msg.venue, state);
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "latency/latency_stats.hpp"
+#include "messages.hpp"
+#include "pipeline/batch.hpp"
+#include "pipeline/market_state.hpp"
+#include "ringbuffer/multicast_ring.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+/**
+ * @brief The consumers of the `--multicast` ring. Each one applies the messages of one component
+ * of the market state, so none of them shares state with another and they run side by side.
+ */
+enum class Stage {
+    Book,        /// quotes, depth and orders into the book; executions into the cumulative VWAP
+    Vwap,        /// trades into a cumulative VWAP of its own, added to the book's after the run
+    RollingVwap, /// trades into the rolling VWAP windows, when there are any
+    Forward,     /// every message to the `--shm` queue, once all of the above have applied it
+};
+
+/**
+ * @brief The stages a `--multicast` run starts and what each one waits for.
+ */
+struct StagePlan {
+    std::vector<Stage> stages;
+    std::vector<std::uint32_t> upstream; /// bit `j` of `upstream[i]` gates stage `i` on stage `j`
+};
+
+/**
+ * @brief Chooses the stages for `state`: `Book` and `Vwap` always, `RollingVwap` if it has rolling
+ * windows, and `Forward` if it has a `--shm` queue. `Forward` is gated on every other stage; the
+ * rest only wait for the producer.
+ */
+StagePlan planStages(const MarketState& state);
+
+/**
+ * @brief Applies the messages of a batch that belong to `stage`, recording the latency of each
+ * one the stage applies if the slots are timestamped. Trades only count for the `Vwap` stage, so
+ * every message is recorded once.
+ *
+ * @param trades The cumulative VWAP of the `Vwap` stage.
+ * @param latency The latency samples of the stage.
+ */
+template <typename Slot>
+void applyStage(const Stage stage, const Slot* slots, const std::size_t count, MarketState& state,
+                VWAPTracker& trades, LatencyStats& latency) {
+    if (stage == Stage::Forward) {
+        forwardBatch(slots, count, state);
+        return;
+    }
+    [[maybe_unused]] std::uint64_t dequeuedAt = 0;
+    if constexpr (isTimestamped<Slot>) {
+        dequeuedAt = readTsc();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& msg = messageOf(slots[i]);
+        const bool isTrade = typeOf(msg) == MessageType::Trade;
+        if (isTrade == (stage == Stage::Book)) { /// the book takes all but trades, the rest trades
+            continue;
+        }
+        const std::uint8_t* data = dataOf(msg);
+        switch (stage) {
+        case Stage::Book:
+            dispatchMessage(data, [&msg, &state](const auto& m) {
+                handleMessage(m, msg.symbolId, msg.venue, state);
+            });
+            break;
+        case Stage::Vwap:
+            trades.upsertVWAPById(msg.symbolId, *reinterpret_cast<const TradeMessage*>(data));
+            break;
+        case Stage::RollingVwap:
+            state.rollingVwap.addTradeById(msg.symbolId,
+                                           *reinterpret_cast<const TradeMessage*>(data));
+            continue;
+        case Stage::Forward:
+            continue;
+        }
+        if constexpr (isTimestamped<Slot>) {
+            latency.record(typeOf(msg), slots[i].parsedAt, slots[i].enqueuedAt, dequeuedAt,
+                           readTsc());
+        }
+    }
+}
+
+/**
+ * @brief Runs one producer that parses the feed into a `MulticastRing` and one consumer thread
+ * per `Stage`, each reading every message in place and applying its share of it. The `Forward`
+ * stage, if `state` has a `--shm` queue, is gated on the others, so it only forwards messages
+ * that have been applied. The stages share one `Wait`: every commit, by the producer or by a
+ * stage, may let any of the others move on.
+ *
+ * @tparam Slot The element carried by the ring: `InternedMessage` or `MessageDescriptor`,
+ * possibly `Timestamped`.
+ * @tparam Wait What each thread does while it has nothing to read or write.
+ * @tparam Source The feed to parse.
+ * @param source The feed, positioned at the first message.
+ * @param maxMessages The most messages to process, or `NO_MESSAGE_LIMIT`.
+ * @param symbols The table the producer interns symbols into.
+ * @param state The book and tracker state updated by the stages.
+ * @param cpus The cores to pin the producer and the stages to.
+ * @return The number of messages processed and the elapsed wall time.
+ */
+template <typename Slot, typename Wait, typename Source>
+RunResult runMulticastPipeline(Source& source, const std::uint64_t maxMessages,
+                               SymbolTable& symbols, MarketState& state,
+                               const CpuPlacement& cpus) {
+    const StagePlan plan = planStages(state);
+    const std::vector<Stage>& stages = plan.stages;
+    MulticastRing<Slot, QUEUE_SIZE, std::pmr::polymorphic_allocator<Slot>> ring{plan.upstream,
+                                                                               state.memory};
+    VWAPTracker trades{symbols, 0, state.memory};
+    std::vector<LatencyStats> latencies(stages.size());
+    Wait progress; /// notified after every commit, by the producer and by each stage
+    std::atomic<bool> producerDone{false};
+    std::uint64_t parsed{0};
+
+    const auto producerFunctor = [&]() {
+        Slot* slots;
+        const std::uint8_t* data = nullptr;
+
+        while (parsed < maxMessages) {
+            std::size_t claimed = 0;
+            progress.waitUntil([&]() { /// the ring is full, wait for the slowest stage
+                claimed = ring.claimWrite(slots, std::min(BATCH_SIZE, maxMessages - parsed));
+                return claimed != 0;
+            });
+
+            std::size_t used = 0;
+            while (used < claimed && (data = source.next()) != nullptr) {
+                parseInto(data, slots[used++], symbols, venueOf(source));
+            }
+            stampEnqueued(slots, used);
+            ring.commitWrite(used);
+            progress.notify();
+            parsed += used;
+            if (used < claimed) { /// the feed ended
+                break;
+            }
+        }
+        producerDone.store(true, std::memory_order_release);
+        progress.notify();
+    };
+
+    const auto stageFunctor = [&](const std::size_t consumer) {
+        Slot* slots;
+
+        while (true) {
+            std::size_t claimed = 0;
+            progress.waitUntil([&]() { /// nothing new from the producer or the upstream stages
+                claimed = ring.claimRead(consumer, slots, BATCH_SIZE);
+                return claimed != 0 ||
+                       (producerDone.load(std::memory_order_acquire) && ring.drained(consumer));
+            });
+            if (claimed == 0) {
+                break;
+            }
+
+            applyStage(stages[consumer], slots, claimed, state, trades, latencies[consumer]);
+            ring.commitRead(consumer, claimed);
+            progress.notify();
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&]() {
+        pinCurrentThread(cpus.producer, "producer");
+        producerFunctor();
+    });
+    std::vector<std::thread> consumers;
+    for (std::size_t i = 0; i < stages.size(); ++i) {
+        consumers.emplace_back([&, i]() {
+            pinCurrentThread(cpus.consumerCpu(i), "consumer");
+            stageFunctor(i);
+        });
+    }
+
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    state.vwapTracker.mergeFrom(trades);
+    for (const auto& latency : latencies) {
+        state.latency.mergeFrom(latency);
+    }
+    return {parsed, duration.count()};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+#include "pipeline/batch.hpp"
+#include "pipeline/market_state.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Message types whose effect depends only on the message itself, so a chunk of the feed
+ * can be applied without the state built by the chunks before it.
+ */
+inline constexpr std::uint32_t CHUNKABLE_TYPES =
+    (1u << static_cast<std::uint8_t>(MessageType::Trade)) |
+    (1u << static_cast<std::uint8_t>(MessageType::Quote));
+
+/**
+ * @brief Replays a mapped feed on `numJobs` threads with no queues: the feed is split into
+ * chunks on message boundaries, each thread applies one chunk to its own symbol table, book and
+ * tracker, and the results are merged in feed order. VWAP sums add up and each later chunk's
+ * book entries replace the earlier ones, so the merged state matches a sequential pass even where
+ * timestamps go backwards. Rolling windows are placed by timestamp, as they are sequentially.
+ *
+ * Depth and order messages modify state built by earlier messages (ladder levels, resting orders)
+ * and can't be applied from the middle of the feed. Feeds containing them are left untouched, for
+ * the caller to run through a regular pipeline instead.
+ *
+ * @param feed The feed, positioned at the first message. Left positioned after the last message
+ * replayed.
+ * @param maxMessages The most messages to replay, or `NO_MESSAGE_LIMIT`.
+ * @param numJobs The number of chunks and threads.
+ * @param symbols The table the merged state interns symbols into.
+ * @param state Receives the merged book and tracker state.
+ * @param cpus The cores to pin the chunk threads to, as consumers.
+ * @return The number of messages processed and the elapsed wall time, including the boundary scan
+ * and the merge, or `std::nullopt` if the feed holds depth or order messages.
+ */
+std::optional<RunResult> runParallelReplay(MappedFeed& feed, std::uint64_t maxMessages,
+                                           std::size_t numJobs, SymbolTable& symbols,
+                                           MarketState& state, const CpuPlacement& cpus);
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "pipeline/batch.hpp"
+#include "pipeline/conflating_producer.hpp"
+#include "pipeline/market_state.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Runs the producer and consumer threads over the feed until it ends or `maxMessages`
+ * messages have been applied.
+ *
+ * @tparam Slot The element carried by the queue: `InternedMessage` or `MessageDescriptor`, possibly
+ * `Timestamped`.
+ * @tparam Wait What each thread does while the queue is full or empty, see `wait_strategy.hpp`.
+ * @tparam Source The feed to parse, `MappedFeed` or `StreamReader`.
+ * @param source The feed, positioned at the first message.
+ * @param maxMessages The most messages to process, or `NO_MESSAGE_LIMIT`.
+ * @param symbols The table the producer interns symbols into.
+ * @param state The book and tracker state updated by the consumer.
+ * @param cpus The cores to pin the producer and consumer to.
+ * @param conflate Whether the producer reads ahead while the queue is full, keeping only the
+ * latest quote per symbol, see `ConflatingProducer`.
+ * @return The number of messages processed, the elapsed wall time and the number of quotes
+ * conflated away.
+ */
+template <typename Slot, typename Wait, typename Source>
+RunResult runPipeline(Source& source, const std::uint64_t maxMessages, SymbolTable& symbols,
+                      MarketState& state, const CpuPlacement& cpus, const bool conflate) {
+    PipelineQueue<Slot> queue{state.memory};
+    Wait notEmpty; /// the consumer waits on this, the producer notifies it after each commit
+    Wait notFull;  /// and the other way round
+    std::atomic<bool> producerDone{false};
+    std::uint64_t parsed{0};
+    std::uint64_t conflated{0};
+
+    const auto producerFunctor = [&queue, &source, &symbols, &producerDone, &parsed, &notEmpty,
+                                  &notFull, maxMessages]() {
+        Slot* slots;
+        const std::uint8_t* data = nullptr;
+
+        while (parsed < maxMessages) {
+            std::size_t claimed = 0;
+            notFull.waitUntil([&]() { /// SPSCQueue is full, wait for consumer to dequeue
+                claimed = queue.claimWrite(slots, std::min(BATCH_SIZE, maxMessages - parsed));
+                return claimed != 0;
+            });
+
+            std::size_t used = 0;
+            while (used < claimed && (data = source.next()) != nullptr) {
+                parseInto(data, slots[used++], symbols, venueOf(source));
+            }
+            stampEnqueued(slots, used);
+            queue.commitWrite(used);
+            notEmpty.notify();
+            parsed += used;
+            if (used < claimed) { /// the feed ended
+                break;
+            }
+        }
+        producerDone.store(true, std::memory_order_release);
+        notEmpty.notify();
+    };
+
+    const auto conflatingProducerFunctor = [&queue, &source, &symbols, &producerDone, &parsed,
+                                            &conflated, &notEmpty, &notFull, maxMessages]() {
+        ConflatingProducer<Slot, Source> producer{source, symbols, maxMessages};
+        while (!producer.done()) {
+            Slot* slots;
+            std::size_t claimed = queue.claimWrite(slots, BATCH_SIZE);
+            if (claimed == 0) {
+                if (producer.readAhead()) {
+                    continue;
+                }
+                notFull.waitUntil([&]() { /// nothing left to read ahead, wait for the consumer
+                    claimed = queue.claimWrite(slots, BATCH_SIZE);
+                    return claimed != 0;
+                });
+            }
+
+            const std::size_t used = producer.fill(slots, claimed);
+            stampEnqueued(slots, used);
+            queue.commitWrite(used);
+            notEmpty.notify();
+        }
+        parsed = producer.parsed();
+        conflated = producer.conflated();
+        producerDone.store(true, std::memory_order_release);
+        notEmpty.notify();
+    };
+
+    const auto consumerFunctor = [&queue, &state, &producerDone, &notEmpty, &notFull]() {
+        Slot* slots;
+
+        while (true) {
+            std::size_t claimed = 0;
+            notEmpty.waitUntil([&]() { /// SPSCQueue is empty, wait for producer to enqueue
+                claimed = queue.claimRead(slots, BATCH_SIZE);
+                return claimed != 0 ||
+                       (producerDone.load(std::memory_order_acquire) && queue.isEmpty());
+            });
+            if (claimed == 0) {
+                break;
+            }
+
+            applyBatch(slots, claimed, state);
+            queue.commitRead(claimed);
+            notFull.notify();
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&]() {
+        pinCurrentThread(cpus.producer, "producer");
+        if (conflate) {
+            conflatingProducerFunctor();
+        } else {
+            producerFunctor();
+        }
+    });
+    std::thread consumer([&]() {
+        pinCurrentThread(cpus.consumerCpu(0), "consumer");
+        consumerFunctor();
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return {parsed, duration.count(), conflated};
+}
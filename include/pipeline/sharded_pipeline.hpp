@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "feed/parser.hpp"
+#include "pipeline/batch.hpp"
+#include "pipeline/market_state.hpp"
+#include "symbol_map/flat_symbol_map.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Maps a symbol to one of `numShards` consumers. Uses the high half of the symbol hash since
+ * each shard's tables index with the low bits.
+ */
+inline std::size_t shardOf(const std::uint64_t symbol, const std::size_t numShards) {
+    return (hashSymbol(symbol) >> 32) % numShards;
+}
+
+/**
+ * @brief The state owned by a single consumer in sharded mode: its input queue and the market
+ * state for the symbols routed to it.
+ */
+template <typename Slot, typename Wait> struct Shard {
+    Shard(SymbolTable& symbols, const MarketState& parent)
+        : queue{parent.memory}, state{symbols, parent.memory, parent.rollingVwap.windows()} {
+        state.board = parent.board; /// each symbol is routed to one shard, so cells keep one writer
+        if (parent.book.venues() != 0) {
+            state.book.trackVenues(parent.book.venues());
+        }
+    }
+
+    PipelineQueue<Slot> queue;
+    Wait notEmpty;
+    Wait notFull;
+    MarketState state;
+};
+
+/**
+ * @brief Runs one producer that routes each message by symbol to one of `numShards` queues, each
+ * drained by its own consumer thread. All messages for a symbol go through the same queue, so
+ * per-symbol ordering is preserved. Shard state is merged into `state` after the threads join.
+ *
+ * @tparam Slot The element carried by the queues: `InternedMessage` or `MessageDescriptor`,
+ * possibly `Timestamped`.
+ * @tparam Wait What each thread does while a queue is full or empty, see `wait_strategy.hpp`.
+ * @tparam Source The feed to parse, `MappedFeed` or `StreamReader`.
+ * @param source The feed, positioned at the first message.
+ * @param maxMessages The most messages to process, or `NO_MESSAGE_LIMIT`.
+ * @param numShards The number of consumer threads.
+ * @param symbols The table the producer interns symbols into, shared by every shard.
+ * @param state Receives the merged book and tracker state.
+ * @param cpus The cores to pin the producer and the consumers to.
+ * @return The number of messages processed and the elapsed wall time, excluding the merge.
+ */
+template <typename Slot, typename Wait, typename Source>
+RunResult runShardedPipeline(Source& source, const std::uint64_t maxMessages,
+                             const std::size_t numShards, SymbolTable& symbols, MarketState& state,
+                             const CpuPlacement& cpus) {
+    using ShardType = Shard<Slot, Wait>;
+    std::vector<std::unique_ptr<ShardType>> shards;
+    for (std::size_t i = 0; i < numShards; ++i) {
+        shards.push_back(std::make_unique<ShardType>(symbols, state));
+    }
+    std::atomic<bool> producerDone{false};
+    std::uint64_t parsed{0};
+
+    const auto producerFunctor = [&shards, &source, &producerDone, &symbols, &parsed, maxMessages,
+                                  numShards]() {
+        /// A claimed but not yet committed span of slots in one shard's queue.
+        struct PendingSpan {
+            Slot* slots{nullptr};
+            std::size_t claimed{0};
+            std::size_t used{0};
+        };
+        std::vector<PendingSpan> pending(numShards);
+
+        const auto flush = [&shards](PendingSpan& span, std::size_t shard) {
+            if (span.used > 0) {
+                stampEnqueued(span.slots, span.used);
+                shards[shard]->queue.commitWrite(span.used);
+                shards[shard]->notEmpty.notify();
+            }
+            span.claimed = span.used = 0;
+        };
+
+        const std::uint8_t* data;
+        while (parsed < maxMessages && (data = source.next()) != nullptr) {
+            const auto shard = shardOf(symbolOf(data), numShards);
+            PendingSpan& span = pending[shard];
+
+            if (span.used == span.claimed) {
+                flush(span, shard);
+                auto& target = *shards[shard];
+                target.notFull.waitUntil([&]() { /// shard queue is full, wait for its consumer
+                    span.claimed = target.queue.claimWrite(span.slots, BATCH_SIZE);
+                    return span.claimed != 0;
+                });
+            }
+            parseInto(data, span.slots[span.used++], symbols, venueOf(source));
+
+            if (++parsed % BATCH_SIZE == 0) { /// don't let quiet shards sit on partial spans
+                for (std::size_t s = 0; s < numShards; ++s) {
+                    flush(pending[s], s);
+                }
+            }
+        }
+        for (std::size_t s = 0; s < numShards; ++s) {
+            flush(pending[s], s);
+        }
+        producerDone.store(true, std::memory_order_release);
+        for (auto& shard : shards) {
+            shard->notEmpty.notify();
+        }
+    };
+
+    const auto consumerFunctor = [&producerDone](ShardType& shard) {
+        Slot* slots;
+
+        while (true) {
+            std::size_t claimed = 0;
+            shard.notEmpty.waitUntil([&]() { /// SPSCQueue is empty, wait for producer to enqueue
+                claimed = shard.queue.claimRead(slots, BATCH_SIZE);
+                return claimed != 0 ||
+                       (producerDone.load(std::memory_order_acquire) && shard.queue.isEmpty());
+            });
+            if (claimed == 0) {
+                break;
+            }
+
+            applyBatch(slots, claimed, shard.state);
+            shard.queue.commitRead(claimed);
+            shard.notFull.notify();
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&]() {
+        pinCurrentThread(cpus.producer, "producer");
+        producerFunctor();
+    });
+    std::vector<std::thread> consumers;
+    for (std::size_t i = 0; i < numShards; ++i) {
+        consumers.emplace_back([&, i]() {
+            pinCurrentThread(cpus.consumerCpu(i), "consumer");
+            consumerFunctor(*shards[i]);
+        });
+    }
+
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    for (const auto& shard : shards) {
+        state.mergeFrom(shard->state);
+    }
+    return {parsed, duration.count()};
+}
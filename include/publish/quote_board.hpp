@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "publish/seqlock.hpp"
+
+/**
+ * @brief Publishes the top of book and running VWAP of each symbol so that other threads, such as
+ * strategies, can read consistent snapshots while the consumer keeps updating them. This data
+ * structure cannot and should not be moved or copied.
+ *
+ * `OrderBook` and `VWAPTracker` keep their state in columns that grow and are owned by the
+ * consumer thread, so they cannot be read from elsewhere. The board instead allocates a fixed
+ * number of cells once, each holding one symbol's `Entry` behind a `Seqlock` on its own cache line.
+ * Cells are found by symbol through an open-addressing index that is lock-free for readers.
+ *
+ * Each symbol's cell is claimed once and then updated by a single writer thread. Different writer
+ * threads, e.g. the consumers of a sharded pipeline, may claim and update the cells of different
+ * symbols concurrently.
+ */
+class QuoteBoard {
+  public:
+    /**
+     * @brief One symbol's published state: its top of book and its VWAP totals since the start of
+     * the feed.
+     */
+    struct Entry {
+        std::uint64_t updatedAt; /// timestamp of the message that last changed the symbol
+        std::uint64_t bidPrice;
+        std::uint64_t askPrice;
+        std::uint32_t bidQuantity;
+        std::uint32_t askQuantity;
+        std::uint64_t totalPriceByQuantity;
+        std::uint64_t totalQuantity;
+        std::uint32_t totalTrades;
+    };
+
+    /**
+     * @brief Constructor for QuoteBoard with room for `capacity` symbols.
+     */
+    explicit QuoteBoard(std::size_t capacity);
+
+    /**
+     * @brief Finds the cell of `symbol`, claiming a free one if the symbol has none yet. Writers
+     * should call this once per symbol and keep the cell.
+     *
+     * @return The index of the symbol's cell, or `std::nullopt` if the board is full.
+     */
+    std::optional<std::size_t> claim(const std::uint64_t symbol);
+
+    /**
+     * @brief Publishes `entry` in a cell returned by `claim`. Only one thread may publish to a
+     * given cell.
+     */
+    void publish(const std::size_t cell, const Entry& entry) {
+        cells_[cell].entry.store(entry);
+    }
+
+    /**
+     * @brief Finds the cell of `symbol` without claiming one. Readers can keep the cell to skip
+     * the lookup on later reads.
+     */
+    std::optional<std::size_t> find(const std::uint64_t symbol) const;
+
+    /**
+     * @brief Attempts to read the latest entry published for `symbol`.
+     *
+     * @return An optional containing the entry, or `std::nullopt` if none has been published.
+     */
+    std::optional<Entry> get(const std::uint64_t symbol) const;
+
+    /**
+     * @brief Same as `get` for a cell returned by `find` or `claim`, or any cell below `cells()`
+     * when scanning the board.
+     */
+    std::optional<Entry> getCell(const std::size_t cell) const {
+        const Cell& c = cells_[cell];
+        if (c.entry.version() == 0) {
+            return std::nullopt;
+        }
+        return c.entry.load();
+    }
+
+    /**
+     * @brief Returns the symbol that owns `cell`, or 0 if the cell is free.
+     */
+    std::uint64_t symbolAt(const std::size_t cell) const {
+        return cells_[cell].symbol.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the number of cells, which is more than the capacity to keep probes short.
+     */
+    std::size_t cells() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * @brief Returns the number of symbols that have claimed a cell.
+     */
+    std::size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    QuoteBoard(const QuoteBoard& qb) = delete;
+    QuoteBoard(QuoteBoard&& qb) = delete;
+    void operator=(const QuoteBoard& qb) = delete;
+    void operator=(QuoteBoard&& qb) = delete;
+
+  private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> symbol{0}; /// 0 while the cell is free
+        Seqlock<Entry> entry;
+    };
+
+    std::size_t capacity_;
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<std::size_t> size_{0};
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <type_traits>
+
+/**
+ * @brief A single value published by one writer thread and read by any number of reader threads
+ * without locks. Readers never block the writer; a read that overlaps a write is detected and
+ * retried, so readers always see a value exactly as it was stored.
+ *
+ * The writer makes the sequence number odd, stores the value, then makes it even again. A reader
+ * copies the value between two loads of the sequence number and keeps the copy only if both loads
+ * returned the same even number. The value is held as relaxed atomic words, so a copy racing with
+ * a store is well-defined and merely discarded.
+ *
+ * @tparam T The type of value to publish. This type must be trivially copyable.
+ */
+template <typename T> class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied as raw words");
+
+  public:
+    /**
+     * @brief Publishes `value`. Must only be called from one thread at a time.
+     */
+    void store(const T& value) {
+        const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release); /// odd before any word changes
+
+        std::uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Makes one attempt to copy the published value into `out`.
+     *
+     * @return `false` if a store was in progress, in which case `out` is unchanged.
+     */
+    bool tryLoad(T& out) const {
+        const std::uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        std::uint64_t words[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire); /// words before the second check
+        if (seq_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Returns a consistent copy of the published value, retrying while stores overlap.
+     */
+    T load() const {
+        T out{};
+        while (!tryLoad(out)) {
+            _mm_pause();
+        }
+        return out;
+    }
+
+    /**
+     * @brief Returns the number of completed stores; 0 means nothing has been published yet.
+     */
+    std::uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+  private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) /
+                                         sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[WORDS] = {};
+};
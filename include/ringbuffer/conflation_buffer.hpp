@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Holds the latest undelivered value per key, for producers that may drop intermediate
+ * values of a key when the consumer falls behind, such as successive quotes for one symbol.
+ *
+ * Each key has a latest-value slot; a key is appended to a dirty queue the first time it receives
+ * a value after being drained, and further values only overwrite its slot. Draining therefore
+ * yields at most one value per key, in the order the keys first became dirty, and `put` and
+ * `drain` are O(1) per value. Keys are dense indices such as `SymbolId`s; storage grows to the
+ * largest key seen. Not thread-safe: owned by the producing thread.
+ *
+ * @tparam T The type of value to hold. This type must be copyable.
+ */
+template <typename T> class ConflationBuffer {
+  public:
+    /**
+     * @brief Constructor for ConflationBuffer with room for keys below `expectedKeys`.
+     */
+    explicit ConflationBuffer(std::size_t expectedKeys = 0)
+        : latest_(expectedKeys), dirty_(expectedKeys) {}
+
+    /**
+     * @brief Makes `value` the pending value of `key`, replacing any value not yet drained.
+     *
+     * @return `true` if an older pending value was replaced.
+     */
+    bool put(const std::uint32_t key, const T& value) {
+        if (key >= dirty_.size()) {
+            latest_.resize(key + 1);
+            dirty_.resize(key + 1);
+        }
+        latest_[key] = value;
+        if (dirty_[key]) {
+            return true;
+        }
+        dirty_[key] = 1;
+        order_.push_back(key);
+        return false;
+    }
+
+    /**
+     * @brief Moves up to `count` pending values into `out`, oldest dirty key first.
+     *
+     * @return The number of values moved.
+     */
+    std::size_t drain(T* out, const std::size_t count) {
+        std::size_t moved = 0;
+        while (moved < count && head_ < order_.size()) {
+            const std::uint32_t key = order_[head_++];
+            dirty_[key] = 0;
+            out[moved++] = latest_[key];
+        }
+        if (head_ == order_.size()) {
+            order_.clear();
+            head_ = 0;
+        }
+        return moved;
+    }
+
+    bool empty() const {
+        return head_ == order_.size();
+    }
+
+    /**
+     * @brief Returns the number of keys with a pending value.
+     */
+    std::size_t size() const {
+        return order_.size() - head_;
+    }
+
+  private:
+    std::vector<T> latest_;
+    std::vector<std::uint8_t> dirty_;
+    std::vector<std::uint32_t> order_; /// dirty keys in the order they became dirty
+    std::size_t head_{0};              /// first key of `order_` not yet drained
+};
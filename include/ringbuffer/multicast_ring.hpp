@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief A ring buffer with a single producer and several consumers that each see every element,
+ * in the style of the LMAX Disruptor.
+ *
+ * Elements are written once and stay in their slot; each consumer keeps its own cursor over the
+ * same slots instead of the producer copying every element into a queue per consumer. A consumer
+ * can be gated on other consumers (its upstream), in which case it only reads slots they have all
+ * released, and sees whatever they did to those slots or to state of their own before releasing
+ * them. Consumers without upstream read slots as soon as the producer publishes them. The producer
+ * reuses a slot only once every consumer has released it, which it checks through the consumers
+ * no other consumer waits for: every consumer is at or behind its upstream, so those are the
+ * slowest.
+ *
+ * Cursors are sequence numbers that only grow, so unlike `SPSCQueue` all `N` slots can be in use.
+ * Like `SPSCQueue`, the producer and each consumer keep a private copy of the cursors they wait on
+ * and reload the shared atomics only when that copy shows too little room, and slots are claimed
+ * and committed in contiguous runs so the cursor cache lines move once per batch.
+ *
+ * @tparam T The type of element to store. Must be default constructible; slots are overwritten
+ * in place.
+ * @tparam N The number of slots. Must be a power of 2.
+ * @tparam Allocator Allocates the ring's storage.
+ */
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>> class MulticastRing {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+  public:
+    /**
+     * @brief The most consumers a ring can have, one bit each in an upstream mask.
+     */
+    static constexpr std::size_t MAX_CONSUMERS = 32;
+
+    /**
+     * @brief Constructor for MulticastRing.
+     *
+     * @param upstream One mask per consumer: bit `j` of `upstream[i]` is set if consumer `i` may
+     * only read a slot once consumer `j` has released it. Consumers may only wait on consumers
+     * with a lower index, which rules out cycles. Between 1 and `MAX_CONSUMERS` consumers.
+     * @param alloc Allocates the slots.
+     */
+    explicit MulticastRing(const std::vector<std::uint32_t>& upstream,
+                           const Allocator& alloc = Allocator())
+        : alloc_{alloc}, ring_{AllocTraits::allocate(alloc_, N)}, cursors_(upstream.size()) {
+        static_assert(N >= 2, "MulticastRing needs at least 2 slots");
+        static_assert((N & (N - 1)) == 0, "MulticastRing size must be a power of 2");
+        assert(!upstream.empty() && upstream.size() <= MAX_CONSUMERS);
+        for (std::size_t i = 0; i < N; ++i) {
+            AllocTraits::construct(alloc_, ring_ + i);
+        }
+
+        std::uint32_t waitedOn = 0;
+        for (std::size_t i = 0; i < upstream.size(); ++i) {
+            assert((upstream[i] >> i) == 0);
+            cursors_[i].upstream = upstream[i];
+            waitedOn |= upstream[i];
+        }
+        gating_ = ~waitedOn & static_cast<std::uint32_t>((std::uint64_t{1} << upstream.size()) - 1);
+    }
+
+    ~MulticastRing() {
+        for (std::size_t i = 0; i < N; ++i) {
+            AllocTraits::destroy(alloc_, ring_ + i);
+        }
+        AllocTraits::deallocate(alloc_, ring_, N);
+    }
+
+    /**
+     * @brief Claims a contiguous run of slots every consumer has released, so the producer can
+     * write elements in place. Nothing is visible to the consumers until `commitWrite` is called.
+     * The run never wraps around the end of the ring.
+     *
+     * @param slots Set to the first claimed slot.
+     * @param maxCount The maximum number of slots to claim.
+     * @return The number of slots claimed, or 0 if the slowest consumer is a whole ring behind.
+     */
+    std::size_t claimWrite(T*& slots, const std::size_t maxCount) {
+        const auto published = published_.load(std::memory_order_relaxed);
+        const auto index = static_cast<std::size_t>(published & (N - 1));
+        const auto wanted = std::min(maxCount, N - index);
+        auto free = static_cast<std::size_t>(slowestCache_ + N - published);
+        if (free < wanted) {
+            slowestCache_ = slowest();
+            free = static_cast<std::size_t>(slowestCache_ + N - published);
+        }
+        slots = ring_ + index;
+        return std::min(wanted, free);
+    }
+
+    /**
+     * @brief Publishes the first `count` slots returned by the last `claimWrite` to every
+     * consumer without upstream.
+     */
+    void commitWrite(const std::size_t count) {
+        const auto published = published_.load(std::memory_order_relaxed);
+        published_.store(published + count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Claims a contiguous run of slots that `consumer` has not read yet and that the
+     * producer, or every consumer upstream of it, has released. The run never wraps around the
+     * end of the ring.
+     *
+     * @param consumer The index of the calling consumer. Each consumer must only be driven by one
+     * thread.
+     * @param slots Set to the first readable slot.
+     * @param maxCount The maximum number of slots to claim.
+     * @return The number of slots claimed, or 0 if there is nothing to read yet.
+     */
+    std::size_t claimRead(const std::size_t consumer, T*& slots, const std::size_t maxCount) {
+        Cursor& cursor = cursors_[consumer];
+        const auto released = cursor.released.load(std::memory_order_relaxed);
+        const auto index = static_cast<std::size_t>(released & (N - 1));
+        const auto wanted = std::min(maxCount, N - index);
+        auto available = static_cast<std::size_t>(cursor.readableCache - released);
+        if (available < wanted) {
+            cursor.readableCache = readable(cursor);
+            available = static_cast<std::size_t>(cursor.readableCache - released);
+        }
+        slots = ring_ + index;
+        return std::min(wanted, available);
+    }
+
+    /**
+     * @brief Releases the first `count` slots returned by `consumer`'s last `claimRead` to the
+     * consumers downstream of it and, once all consumers have released them, to the producer.
+     */
+    void commitRead(const std::size_t consumer, const std::size_t count) {
+        auto& released = cursors_[consumer].released;
+        released.store(released.load(std::memory_order_relaxed) + count,
+                       std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns `true` if `consumer` has released every slot published so far. Once the
+     * producer has stopped, a consumer that finds nothing to read is done when this holds.
+     */
+    bool drained(const std::size_t consumer) const {
+        return cursors_[consumer].released.load(std::memory_order_acquire) ==
+               published_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the number of consumers.
+     */
+    std::size_t consumers() const {
+        return cursors_.size();
+    }
+
+    MulticastRing(const MulticastRing& ring) = delete;
+    MulticastRing(MulticastRing&& ring) = delete;
+    void operator=(const MulticastRing& ring) = delete;
+    void operator=(MulticastRing&& ring) = delete;
+
+  private:
+    /**
+     * @brief The position of one consumer, on its own cache line.
+     */
+    struct alignas(64) Cursor {
+        std::atomic<std::uint64_t> released{0}; /// slots this consumer is done with
+        std::uint64_t readableCache{0};         /// consumer-local view of how far it may read
+        std::uint32_t upstream{0};
+    };
+
+    /**
+     * @brief Returns how far the slowest consumer has released, as seen by the producer.
+     */
+    std::uint64_t slowest() const {
+        auto slowest = published_.load(std::memory_order_relaxed);
+        for (std::uint32_t mask = gating_; mask != 0; mask &= mask - 1) {
+            const auto& released = cursors_[__builtin_ctz(mask)].released;
+            slowest = std::min(slowest, released.load(std::memory_order_acquire));
+        }
+        return slowest;
+    }
+
+    /**
+     * @brief Returns how far the consumer at `cursor` may read: as far as the producer has
+     * published, or as far as all of its upstream have released.
+     */
+    std::uint64_t readable(const Cursor& cursor) const {
+        if (cursor.upstream == 0) {
+            return published_.load(std::memory_order_acquire);
+        }
+        auto readable = std::numeric_limits<std::uint64_t>::max();
+        for (std::uint32_t mask = cursor.upstream; mask != 0; mask &= mask - 1) {
+            const auto& released = cursors_[__builtin_ctz(mask)].released;
+            readable = std::min(readable, released.load(std::memory_order_acquire));
+        }
+        return readable;
+    }
+
+    Allocator alloc_;
+    T* ring_;
+    std::vector<Cursor> cursors_;
+    std::uint32_t gating_; /// consumers no other consumer waits on
+    alignas(64) std::atomic<std::uint64_t> published_{0};
+    std::uint64_t slowestCache_{0}; /// producer-local view of `slowest()`
+};
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Which end of a `ShmSPSCQueue` a process attaches as.
+ */
+enum class ShmRole : std::uint8_t { Producer = 0, Consumer };
+
+/**
+ * @brief What one end of a `ShmSPSCQueue` knows about the process at the other end.
+ */
+enum class PeerState : std::uint8_t {
+    Waiting,  /// no process has attached to the other end yet
+    Attached, /// a live process holds the other end
+    Detached, /// the other end was held and released cleanly
+    Dead,     /// the process holding the other end exited without detaching
+};
+
+/**
+ * @brief The single-producer, single-consumer protocol of `SPSCQueue` across two processes. The
+ * indices, the capacity, a layout version and the ring itself live in a POSIX shared memory
+ * region, so a feed handler can hand messages to a strategy process without a socket hop or any
+ * serialization: elements are written and read in place.
+ *
+ * One process creates the region with `create`, the other opens it with `attach`; each names the
+ * role it takes. A role can only be held by one live process at a time. Each end records its PID
+ * in the region, so the other end can tell a peer that has not arrived yet, one that left cleanly
+ * and one that died (`peerState`). A consumer that replaces a dead one resumes from the last
+ * committed read index, so nothing that was claimed but not committed is lost. `create` replaces
+ * a region left over from an earlier run only once no live process holds either end of it.
+ *
+ * As in `SPSCQueue`, the usable capacity is one less than the ring size and each end caches the
+ * other's index, which lives only in this process. Unlike it, the ring size is chosen at run time
+ * and stored in the region, and elements must be trivially copyable since they are shared as raw
+ * bytes between address spaces.
+ *
+ * @tparam T The type of element to store. This type must be trivially copyable and have the same
+ * layout in both processes; its size is checked on `attach`.
+ */
+template <typename T> class ShmSPSCQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "elements are shared as raw bytes");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                      std::atomic<std::int32_t>::is_always_lock_free,
+                  "atomics in shared memory must not rely on process-local locks");
+
+  public:
+    /**
+     * @brief Identifies a region laid out by this class. `create` writes it last, so `attach`
+     * never sees a partly initialized header.
+     */
+    static constexpr std::uint64_t MAGIC = 0x3151505348535452; /// "RTSHSPQ1"
+
+    /**
+     * @brief Bumped whenever the region layout changes, so mismatched builds refuse to attach.
+     */
+    static constexpr std::uint32_t LAYOUT_VERSION = 1;
+
+    /**
+     * @brief Creates the region `name` and attaches to it. A region left over from an earlier run
+     * is replaced once no live process holds either end of it.
+     *
+     * @param name The shared memory object name, e.g. "/market_feed".
+     * @param capacity The number of slots in the ring. Must be a power of 2, at least 2.
+     * @param role The end this process takes.
+     * @return The attached queue, or `nullptr` with `errno` set on failure: `EINVAL` for a bad
+     * capacity, `EBUSY` if a live process still holds an end of an existing region `name`.
+     */
+    static std::unique_ptr<ShmSPSCQueue> create(const char* name, std::size_t capacity,
+                                                ShmRole role);
+
+    /**
+     * @brief Attaches to the region `name` created by another process.
+     *
+     * @param name The shared memory object name passed to `create`.
+     * @param role The end this process takes.
+     * @return The attached queue, or `nullptr` with `errno` set on failure: `ENOENT` or `EAGAIN`
+     * if the region does not exist or is still being set up, `EPROTO` if it was laid out for a
+     * different layout version or element size, `EBUSY` if a live process holds `role`.
+     */
+    static std::unique_ptr<ShmSPSCQueue> attach(const char* name, ShmRole role);
+
+    /**
+     * @brief Removes the region's name. Processes still attached keep their mapping.
+     *
+     * @return 0 on success, or -1 with `errno` set.
+     */
+    static int remove(const char* name) {
+        return shm_unlink(name);
+    }
+
+    /**
+     * @brief Detaches from the region: releases this process's role and unmaps it.
+     */
+    ~ShmSPSCQueue();
+
+    /**
+     * @brief Tries to copy `item` into the queue.
+     *
+     * @return `true` on successful enqueue or `false` if the queue is full.
+     */
+    bool enqueue(const T& item) {
+        T* slot;
+        if (claimWrite(slot, 1) == 0) {
+            return false;
+        }
+        *slot = item;
+        commitWrite(1);
+        return true;
+    }
+
+    /**
+     * @brief Tries to copy the first element into `item` and remove it.
+     *
+     * @return `true` on successful dequeue or `false` if the queue is empty.
+     */
+    bool dequeue(T& item) {
+        T* slot;
+        if (claimRead(slot, 1) == 0) {
+            return false;
+        }
+        item = *slot;
+        commitRead(1);
+        return true;
+    }
+
+    /**
+     * @brief Claims a contiguous run of free slots, as `SPSCQueue::claimWrite`.
+     */
+    std::size_t claimWrite(T*& slots, const std::size_t maxCount) {
+        const auto writeIdx = header_->writeIdx.load(std::memory_order_relaxed);
+        const auto wanted = std::min(maxCount, capacity() - writeIdx);
+        auto free = (readIdxCache_ - writeIdx - 1) & mask_;
+        if (free < wanted) {
+            readIdxCache_ = header_->readIdx.load(std::memory_order_acquire);
+            free = (readIdxCache_ - writeIdx - 1) & mask_;
+        }
+        slots = slots_ + writeIdx;
+        return std::min(wanted, free);
+    }
+
+    /**
+     * @brief Publishes the first `count` slots returned by the last `claimWrite`.
+     */
+    void commitWrite(const std::size_t count) {
+        const auto writeIdx = header_->writeIdx.load(std::memory_order_relaxed);
+        header_->writeIdx.store((writeIdx + count) & mask_, std::memory_order_release);
+    }
+
+    /**
+     * @brief Claims a contiguous run of filled slots, as `SPSCQueue::claimRead`.
+     */
+    std::size_t claimRead(T*& slots, const std::size_t maxCount) {
+        const auto readIdx = header_->readIdx.load(std::memory_order_relaxed);
+        const auto wanted = std::min(maxCount, capacity() - readIdx);
+        auto filled = (writeIdxCache_ - readIdx) & mask_;
+        if (filled < wanted) {
+            writeIdxCache_ = header_->writeIdx.load(std::memory_order_acquire);
+            filled = (writeIdxCache_ - readIdx) & mask_;
+        }
+        slots = slots_ + readIdx;
+        return std::min(wanted, filled);
+    }
+
+    /**
+     * @brief Releases the first `count` slots returned by the last `claimRead` to the producer.
+     */
+    void commitRead(const std::size_t count) {
+        const auto readIdx = header_->readIdx.load(std::memory_order_relaxed);
+        header_->readIdx.store((readIdx + count) & mask_, std::memory_order_release);
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Gets the number of elements currently stored in the queue.
+     */
+    std::size_t size() const {
+        const auto readIdx = header_->readIdx.load(std::memory_order_relaxed);
+        const auto writeIdx = header_->writeIdx.load(std::memory_order_relaxed);
+        return (writeIdx - readIdx) & mask_;
+    }
+
+    /**
+     * @brief Gets the number of slots in the ring, one more than the most it can hold.
+     */
+    std::size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * @brief Reports whether the process at the other end is there, gone, or yet to arrive.
+     */
+    PeerState peerState() const {
+        const Endpoint& peer = header_->endpoints[role_ == ShmRole::Producer ? 1 : 0];
+        const pid_t pid = peer.pid.load(std::memory_order_acquire);
+        if (pid != 0) {
+            return isAlive(pid) ? PeerState::Attached : PeerState::Dead;
+        }
+        return peer.sessions.load(std::memory_order_acquire) == 0 ? PeerState::Waiting
+                                                                   : PeerState::Detached;
+    }
+
+    ShmSPSCQueue(const ShmSPSCQueue& queue) = delete;
+    ShmSPSCQueue(ShmSPSCQueue&& queue) = delete;
+    void operator=(const ShmSPSCQueue& queue) = delete;
+    void operator=(ShmSPSCQueue&& queue) = delete;
+
+  private:
+    /**
+     * @brief The process holding one end of the queue.
+     */
+    struct Endpoint {
+        std::atomic<std::int32_t> pid;       /// 0 while no process holds the role
+        std::atomic<std::uint32_t> sessions; /// number of times the role has been taken
+    };
+
+    /**
+     * @brief The start of the region. The ring follows at `ringOffset()`.
+     */
+    struct Header {
+        std::atomic<std::uint64_t> magic;
+        std::uint32_t version;
+        std::uint32_t slotSize;
+        std::uint64_t capacity;
+        alignas(64) std::atomic<std::uint64_t> writeIdx;
+        alignas(64) std::atomic<std::uint64_t> readIdx;
+        alignas(64) Endpoint endpoints[2]; /// indexed by `ShmRole`
+    };
+
+    static_assert(alignof(T) <= alignof(Header), "the ring starts right after the header");
+
+    static constexpr std::size_t ringOffset() {
+        return sizeof(Header);
+    }
+
+    static bool isAlive(const pid_t pid) {
+        return kill(pid, 0) == 0 || errno == EPERM;
+    }
+
+    ShmSPSCQueue(void* region, std::size_t length, ShmRole role)
+        : header_{static_cast<Header*>(region)},
+          slots_{reinterpret_cast<T*>(static_cast<std::uint8_t*>(region) + ringOffset())},
+          mapLength_{length}, mask_{header_->capacity - 1}, role_{role} {}
+
+    /**
+     * @brief Maps `length` bytes of the shared memory object `fd` and closes it.
+     *
+     * @return The mapping, or `nullptr` with `errno` set.
+     */
+    static void* mapRegion(const int fd, const std::size_t length) {
+        void* region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int err = errno;
+        close(fd);
+        if (region == MAP_FAILED) {
+            errno = err;
+            return nullptr;
+        }
+        return region;
+    }
+
+    /**
+     * @brief Reports whether the region `name` exists, was laid out by this version and has a
+     * live process holding either end. A region of another layout is never considered held.
+     */
+    static bool isHeld(const char* name) {
+        const int fd = shm_open(name, O_RDONLY, 0);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == -1 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+            close(fd);
+            return false;
+        }
+        void* region = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (region == MAP_FAILED) {
+            return false;
+        }
+
+        const auto* header = static_cast<const Header*>(region);
+        bool held = false;
+        if (header->magic.load(std::memory_order_acquire) == MAGIC &&
+            header->version == LAYOUT_VERSION) {
+            for (const Endpoint& endpoint : header->endpoints) {
+                const pid_t pid = endpoint.pid.load(std::memory_order_acquire);
+                held = held || (pid != 0 && isAlive(pid));
+            }
+        }
+        munmap(region, sizeof(Header));
+        return held;
+    }
+
+    /**
+     * @brief Takes `role` for this process. A role held by a dead process is taken over.
+     *
+     * @return `false` with `errno` set to `EBUSY` if a live process holds the role.
+     */
+    bool takeRole() {
+        Endpoint& self = header_->endpoints[static_cast<std::size_t>(role_)];
+        const pid_t pid = getpid();
+        std::int32_t holder = self.pid.load(std::memory_order_acquire);
+        do {
+            if (holder != 0 && isAlive(holder)) {
+                errno = EBUSY;
+                return false;
+            }
+        } while (!self.pid.compare_exchange_weak(holder, pid, std::memory_order_acq_rel));
+        self.sessions.fetch_add(1, std::memory_order_release);
+        holdsRole_ = true;
+
+        readIdxCache_ = header_->readIdx.load(std::memory_order_acquire);
+        writeIdxCache_ = header_->writeIdx.load(std::memory_order_acquire);
+        return true;
+    }
+
+    Header* header_;
+    T* slots_;
+    std::size_t mapLength_;
+    std::size_t mask_;
+    ShmRole role_;
+    bool holdsRole_{false};
+    std::size_t readIdxCache_{0};  /// producer-local view of `readIdx`
+    std::size_t writeIdxCache_{0}; /// consumer-local view of `writeIdx`
+};
+
+template <typename T>
+auto ShmSPSCQueue<T>::create(const char* name, const std::size_t capacity, const ShmRole role)
+    -> std::unique_ptr<ShmSPSCQueue> {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    if (isHeld(name)) {
+        errno = EBUSY;
+        return nullptr;
+    }
+    shm_unlink(name); /// a region left by a crashed run would have stale indices and PIDs
+
+    const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        return nullptr;
+    }
+    const std::size_t length = ringOffset() + capacity * sizeof(T);
+    if (ftruncate(fd, static_cast<off_t>(length)) == -1) {
+        const int err = errno;
+        close(fd);
+        shm_unlink(name);
+        errno = err;
+        return nullptr;
+    }
+    void* region = mapRegion(fd, length);
+    if (region == nullptr) {
+        const int err = errno;
+        shm_unlink(name);
+        errno = err;
+        return nullptr;
+    }
+
+    auto* header = new (region) Header{}; /// ftruncate zero-filled the ring
+    header->version = LAYOUT_VERSION;
+    header->slotSize = sizeof(T);
+    header->capacity = capacity;
+    header->magic.store(MAGIC, std::memory_order_release);
+
+    std::unique_ptr<ShmSPSCQueue> queue{new ShmSPSCQueue(region, length, role)};
+    queue->takeRole(); /// the region is new, so the role is free
+    return queue;
+}
+
+template <typename T>
+auto ShmSPSCQueue<T>::attach(const char* name, const ShmRole role)
+    -> std::unique_ptr<ShmSPSCQueue> {
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return nullptr;
+    }
+    if (static_cast<std::size_t>(st.st_size) < ringOffset()) { /// not sized yet
+        close(fd);
+        errno = EAGAIN;
+        return nullptr;
+    }
+
+    const std::size_t length = static_cast<std::size_t>(st.st_size);
+    void* region = mapRegion(fd, length);
+    if (region == nullptr) {
+        return nullptr;
+    }
+    const auto* header = static_cast<const Header*>(region);
+    int err = 0;
+    if (header->magic.load(std::memory_order_acquire) != MAGIC) {
+        err = EAGAIN;
+    } else if (header->version != LAYOUT_VERSION || header->slotSize != sizeof(T) ||
+               ringOffset() + header->capacity * sizeof(T) > length) {
+        err = EPROTO;
+    }
+    if (err != 0) {
+        munmap(region, length);
+        errno = err;
+        return nullptr;
+    }
+
+    std::unique_ptr<ShmSPSCQueue> queue{new ShmSPSCQueue(region, length, role)};
+    if (!queue->takeRole()) {
+        queue.reset();
+        errno = EBUSY;
+        return nullptr;
+    }
+    return queue;
+}
+
+template <typename T> ShmSPSCQueue<T>::~ShmSPSCQueue() {
+    if (holdsRole_) {
+        header_->endpoints[static_cast<std::size_t>(role_)].pid.store(0, std::memory_order_release);
+    }
+    munmap(header_, mapLength_);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <memory>
@@ -16,27 +17,50 @@
  * the empty condition. The full condition is writeIdx+1 & (N-1) == readIdx, in other words, if the
  * current write is at the last free cell behind the read pointer, we must be full.
  *
+ * Each side keeps a private copy of the other side's index and only reloads the shared atomic when
+ * that copy says the queue is full (producer) or empty (consumer). Combined with the bulk and
+ * claim/commit operations this means the index cache lines move between cores once per batch
+ * instead of once per element.
+ *
  * @tparam T The type of element to store in the Queue. This type must be moveable.
  * @tparam N The size of the queue. This value must be a power of 2. The queue will dynamically
  * allocate `sizeof(T) * N` many bytes for storage and will never move the queue from that allocated
  * space.
+ * @tparam Allocator Allocates the ring's storage, e.g. a `std::pmr::polymorphic_allocator` over a
+ * `HugePageResource` to back large rings with pre-faulted huge pages.
  */
-template <typename T, std::size_t N> class SPSCQueue {
-    std::unique_ptr<T[]> queue_;
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>> class SPSCQueue {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    Allocator alloc_;
+    T* queue_;
     alignas(64) std::atomic<std::size_t> readIdx_{0};
+    std::size_t writeIdxCache_{0}; /// consumer-local view of `writeIdx_`
     alignas(64) std::atomic<std::size_t> writeIdx_{0};
+    std::size_t readIdxCache_{0}; /// producer-local view of `readIdx_`
 
   public:
     /**
      * @brief Constructor for SPSCQueue class. Necessary parameters are provided through the
      * template.
      */
-    SPSCQueue() : queue_{std::make_unique<T[]>(N)} {
+    explicit SPSCQueue(const Allocator& alloc = Allocator())
+        : alloc_{alloc}, queue_{AllocTraits::allocate(alloc_, N)} {
         static_assert(
             N >= 2,
             "SPSC Queue can only be instantiated with size that is greater than or equal to 2");
         static_assert((N & (N - 1)) == 0,
                       "SPSC Queue can only be instantiated with size that is power of 2");
+        for (std::size_t i = 0; i < N; ++i) {
+            AllocTraits::construct(alloc_, queue_ + i);
+        }
+    }
+
+    ~SPSCQueue() {
+        for (std::size_t i = 0; i < N; ++i) {
+            AllocTraits::destroy(alloc_, queue_ + i);
+        }
+        AllocTraits::deallocate(alloc_, queue_, N);
     }
 
     /**
@@ -56,6 +80,69 @@ template <typename T, std::size_t N> class SPSCQueue {
      */
     bool dequeue(T& item);
 
+    /**
+     * @brief Tries to enqueue up to `count` items from `items` with a single publish of the write
+     * index. Items are std::moved into the queue in order.
+     *
+     * @param items Pointer to the first item to enqueue.
+     * @param count The number of items available at `items`.
+     * @return The number of items enqueued, which is less than `count` if the queue fills up.
+     */
+    std::size_t enqueueBulk(T* items, std::size_t count);
+
+    /**
+     * @brief Tries to dequeue up to `maxCount` items into `items` with a single publish of the read
+     * index.
+     *
+     * @param items Pointer to the output array, which must have room for `maxCount` items.
+     * @param maxCount The maximum number of items to dequeue.
+     * @return The number of items dequeued.
+     */
+    std::size_t dequeueBulk(T* items, std::size_t maxCount);
+
+    /**
+     * @brief Claims a contiguous run of free slots so the producer can construct items in place.
+     * Nothing is visible to the consumer until `commitWrite` is called. The run never wraps around
+     * the end of the ring, so fewer than `maxCount` slots may be returned even if more are free.
+     *
+     * @param slots Set to the first claimed slot on success.
+     * @param maxCount The maximum number of slots to claim.
+     * @return The number of slots claimed, or 0 if the queue is full.
+     */
+    std::size_t claimWrite(T*& slots, std::size_t maxCount);
+
+    /**
+     * @brief Publishes the first `count` slots returned by the last `claimWrite`.
+     *
+     * @param count The number of slots to publish. Must not exceed the last claimed count.
+     */
+    void commitWrite(std::size_t count) {
+        const auto writeIdx = writeIdx_.load(std::memory_order_relaxed);
+        writeIdx_.store((writeIdx + count) & (N - 1), std::memory_order_release);
+    }
+
+    /**
+     * @brief Claims a contiguous run of filled slots so the consumer can process items in place.
+     * The slots stay owned by the consumer until `commitRead` is called. The run never wraps
+     * around the end of the ring.
+     *
+     * @param slots Set to the first readable slot on success.
+     * @param maxCount The maximum number of slots to claim.
+     * @return The number of slots claimed, or 0 if the queue is empty.
+     */
+    std::size_t claimRead(T*& slots, std::size_t maxCount);
+
+    /**
+     * @brief Releases the first `count` slots returned by the last `claimRead` back to the
+     * producer.
+     *
+     * @param count The number of slots to release. Must not exceed the last claimed count.
+     */
+    void commitRead(std::size_t count) {
+        const auto readIdx = readIdx_.load(std::memory_order_relaxed);
+        readIdx_.store((readIdx + count) & (N - 1), std::memory_order_release);
+    }
+
     /**
      * @brief Checks if the SPSC Queue is full.
      *
@@ -97,15 +184,45 @@ template <typename T, std::size_t N> class SPSCQueue {
     SPSCQueue(SPSCQueue&& queue) = delete;
     void operator=(const SPSCQueue& queue) = delete;
     void operator=(SPSCQueue&& queue) = delete;
+
+  private:
+    /**
+     * @brief Number of free slots as seen by the producer, reloading `readIdx_` only if the cached
+     * copy shows fewer than `wanted`.
+     */
+    std::size_t freeSlots(std::size_t writeIdx, std::size_t wanted) {
+        auto free = (readIdxCache_ - writeIdx - 1) & (N - 1);
+        if (free < wanted) {
+            readIdxCache_ = readIdx_.load(std::memory_order_acquire);
+            free = (readIdxCache_ - writeIdx - 1) & (N - 1);
+        }
+        return free;
+    }
+
+    /**
+     * @brief Number of filled slots as seen by the consumer, reloading `writeIdx_` only if the
+     * cached copy shows fewer than `wanted`.
+     */
+    std::size_t filledSlots(std::size_t readIdx, std::size_t wanted) {
+        auto filled = (writeIdxCache_ - readIdx) & (N - 1);
+        if (filled < wanted) {
+            writeIdxCache_ = writeIdx_.load(std::memory_order_acquire);
+            filled = (writeIdxCache_ - readIdx) & (N - 1);
+        }
+        return filled;
+    }
 };
 
-template <typename T, std::size_t N> bool SPSCQueue<T, N>::enqueue(T& item) {
-    const auto readIdx = readIdx_.load(std::memory_order_acquire);
+template <typename T, std::size_t N, typename Allocator>
+bool SPSCQueue<T, N, Allocator>::enqueue(T& item) {
     const auto writeIdx = writeIdx_.load(std::memory_order_relaxed);
 
     const auto nextWriteIdx = (writeIdx + 1) & (N - 1);
-    if (nextWriteIdx == readIdx) {
-        return false;
+    if (nextWriteIdx == readIdxCache_) {
+        readIdxCache_ = readIdx_.load(std::memory_order_acquire);
+        if (nextWriteIdx == readIdxCache_) {
+            return false;
+        }
     }
 
     queue_[writeIdx] = std::move(item);
@@ -113,12 +230,15 @@ template <typename T, std::size_t N> bool SPSCQueue<T, N>::enqueue(T& item) {
     return true;
 }
 
-template <typename T, std::size_t N> bool SPSCQueue<T, N>::dequeue(T& item) {
+template <typename T, std::size_t N, typename Allocator>
+bool SPSCQueue<T, N, Allocator>::dequeue(T& item) {
     const auto readIdx = readIdx_.load(std::memory_order_relaxed);
-    const auto writeIdx = writeIdx_.load(std::memory_order_acquire);
 
-    if (readIdx == writeIdx) {
-        return false;
+    if (readIdx == writeIdxCache_) {
+        writeIdxCache_ = writeIdx_.load(std::memory_order_acquire);
+        if (readIdx == writeIdxCache_) {
+            return false;
+        }
     }
 
     item = std::move(queue_[readIdx]);
@@ -126,3 +246,55 @@ template <typename T, std::size_t N> bool SPSCQueue<T, N>::dequeue(T& item) {
     readIdx_.store(nextReadIdx, std::memory_order_release);
     return true;
 }
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t SPSCQueue<T, N, Allocator>::enqueueBulk(T* items, std::size_t count) {
+    const auto writeIdx = writeIdx_.load(std::memory_order_relaxed);
+    const auto toWrite = std::min(count, freeSlots(writeIdx, count));
+    if (toWrite == 0) {
+        return 0;
+    }
+
+    const auto firstRun = std::min(toWrite, N - writeIdx); /// slots before wrap around
+    std::move(items, items + firstRun, queue_ + writeIdx);
+    std::move(items + firstRun, items + toWrite, queue_);
+
+    writeIdx_.store((writeIdx + toWrite) & (N - 1), std::memory_order_release);
+    return toWrite;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t SPSCQueue<T, N, Allocator>::dequeueBulk(T* items, std::size_t maxCount) {
+    const auto readIdx = readIdx_.load(std::memory_order_relaxed);
+    const auto toRead = std::min(maxCount, filledSlots(readIdx, maxCount));
+    if (toRead == 0) {
+        return 0;
+    }
+
+    const auto firstRun = std::min(toRead, N - readIdx); /// slots before wrap around
+    std::move(queue_ + readIdx, queue_ + readIdx + firstRun, items);
+    std::move(queue_, queue_ + (toRead - firstRun), items + firstRun);
+
+    readIdx_.store((readIdx + toRead) & (N - 1), std::memory_order_release);
+    return toRead;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t SPSCQueue<T, N, Allocator>::claimWrite(T*& slots, std::size_t maxCount) {
+    const auto writeIdx = writeIdx_.load(std::memory_order_relaxed);
+    const auto wanted = std::min(maxCount, N - writeIdx);
+    const auto claimed = std::min(wanted, freeSlots(writeIdx, wanted));
+
+    slots = queue_ + writeIdx;
+    return claimed;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+std::size_t SPSCQueue<T, N, Allocator>::claimRead(T*& slots, std::size_t maxCount) {
+    const auto readIdx = readIdx_.load(std::memory_order_relaxed);
+    const auto wanted = std::min(maxCount, N - readIdx);
+    const auto claimed = std::min(wanted, filledSlots(readIdx, wanted));
+
+    slots = queue_ + readIdx;
+    return claimed;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <immintrin.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Wait strategies decide what a thread does while an `SPSCQueue` is full (producer) or empty
+ * (consumer). Each is a policy class with the same two members:
+ *
+ *  - `waitUntil(attempt)` calls `attempt()` until it returns `true`, idling between failed
+ *    attempts. The first call happens immediately, so a ready queue costs nothing extra.
+ *  - `notify()` is called by the other side after it publishes (commits) so a blocked waiter can
+ *    wake up. Only `FutexWait` needs it; for the others it compiles to nothing.
+ *
+ * One instance guards one direction of one queue (e.g. "not empty") and is shared by the waiting
+ * and the notifying thread. Retry state lives on the waiter's stack, so every strategy is safe to
+ * share that way.
+ */
+
+/**
+ * @brief Retries continuously with a `pause` between attempts. Lowest wake-up latency, but burns
+ * its core the whole time and starves a peer sharing that core, so only use it with pinned threads
+ * on dedicated cores.
+ */
+struct BusySpinWait {
+    template <typename Attempt> void waitUntil(Attempt&& attempt) {
+        while (!attempt()) {
+            _mm_pause();
+        }
+    }
+
+    void notify() {}
+};
+
+/**
+ * @brief Spins with `pause` for a short while, then yields the core between attempts. Reacts
+ * within nanoseconds to short stalls and still lets a peer on the same core run during long ones.
+ */
+struct SpinYieldWait {
+    static constexpr std::uint32_t SPIN_LIMIT = 128;
+
+    template <typename Attempt> void waitUntil(Attempt&& attempt) {
+        for (std::uint32_t spins = 0; !attempt(); ++spins) {
+            if (spins < SPIN_LIMIT) {
+                _mm_pause();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify() {}
+};
+
+/**
+ * @brief Exponential backoff: doubles the number of `pause`s between attempts up to a limit, then
+ * sleeps for doubling intervals capped at `MAX_SLEEP`. Uses little CPU while idle with a bounded
+ * worst-case reaction time.
+ */
+struct BackoffWait {
+    static constexpr std::uint32_t MAX_PAUSES = 1024;
+    static constexpr std::chrono::microseconds MAX_SLEEP{50};
+
+    template <typename Attempt> void waitUntil(Attempt&& attempt) {
+        std::uint32_t pauses = 1;
+        std::chrono::microseconds sleep{1};
+        while (!attempt()) {
+            if (pauses <= MAX_PAUSES) {
+                for (std::uint32_t i = 0; i < pauses; ++i) {
+                    _mm_pause();
+                }
+                pauses *= 2;
+            } else {
+                std::this_thread::sleep_for(sleep);
+                sleep = std::min(sleep * 2, MAX_SLEEP);
+            }
+        }
+    }
+
+    void notify() {}
+};
+
+/**
+ * @brief Spins briefly, then blocks in the kernel on a futex until the other side calls `notify`.
+ * Frees the core entirely while idle at the cost of a syscall to wake up. `notify` is a single
+ * atomic increment plus a load unless a waiter is actually asleep.
+ *
+ * This is an event count: the waiter reads the epoch before its final attempt and sleeps only if
+ * the epoch is unchanged, so a notify that lands between the attempt and the sleep is never lost.
+ */
+class FutexWait {
+  public:
+    static constexpr std::uint32_t SPIN_LIMIT = 128;
+
+    template <typename Attempt> void waitUntil(Attempt&& attempt) {
+        for (std::uint32_t spins = 0; spins < SPIN_LIMIT; ++spins) {
+            if (attempt()) {
+                return;
+            }
+            _mm_pause();
+        }
+
+        while (true) {
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const auto key = epoch_.load(std::memory_order_seq_cst);
+            if (attempt()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, key,
+                    nullptr, nullptr, 0);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void notify() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE,
+                    INT32_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+  private:
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+                  "futex needs a plain 32-bit word");
+
+    alignas(64) std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> waiters_{0};
+};
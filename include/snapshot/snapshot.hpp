@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+
+#include "orderbook/l3_order_book.hpp"
+#include "orderbook/orderbook.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+/**
+ * @brief How far into a feed file processing has got.
+ */
+struct FeedPosition {
+    std::uint64_t offset{0};   /// byte offset of the next unprocessed message, counting the header
+    std::uint64_t messages{0}; /// number of messages processed before `offset`
+};
+
+/**
+ * The snapshot file format. All fields are little-endian and every section is 8-byte aligned, so a
+ * mapped snapshot can be read in place:
+ *
+ *     SnapshotHeader
+ *     std::uint64_t symbols[symbolCount]   the symbol table in ID order
+ *     BookRecord    books[bookCount]       top of book per symbol, in ID order
+ *     LevelRecord   levels[levelCount]     the depth levels of each book record, in record order
+ *     VWAPRecord    vwaps[vwapCount]       VWAP totals per symbol, in ID order
+ *     OrderRecord   orders[orderCount]     resting orders, each level's in time priority
+ *
+ * Records refer to symbols by their index in `symbols`. Any change to the layout must bump
+ * `SNAPSHOT_VERSION`; readers reject other versions.
+ */
+
+static constexpr std::uint64_t SNAPSHOT_MAGIC = 0x50414E5344464D; /// "MDFSNAP" read as bytes
+static constexpr std::uint32_t SNAPSHOT_VERSION = 2;
+
+struct SnapshotHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize; /// `sizeof(SnapshotHeader)`, a cross-check of the version
+    std::uint64_t feedOffset;
+    std::uint64_t messages;
+    std::uint64_t symbolCount;
+    std::uint64_t bookCount;
+    std::uint64_t levelCount;
+    std::uint64_t vwapCount;
+    std::uint64_t orderCount;
+};
+
+struct BookRecord {
+    std::uint32_t symbol;
+    std::uint32_t levelCount; /// number of this symbol's entries in the level section
+    std::uint64_t updatedAt;
+    std::uint64_t bidPrice;
+    std::uint64_t askPrice;
+    std::uint32_t bidQuantity;
+    std::uint32_t askQuantity;
+};
+
+struct LevelRecord {
+    std::uint64_t price;
+    std::uint32_t quantity;
+    Side side;
+    std::uint8_t padding[3];
+};
+
+struct VWAPRecord {
+    std::uint32_t symbol;
+    std::uint32_t totalTrades;
+    std::uint64_t updatedAt;
+    std::uint64_t totalPriceByQuantity;
+    std::uint64_t totalQuantity;
+};
+
+struct OrderRecord {
+    std::uint64_t orderId;
+    std::uint64_t price;
+    std::uint32_t symbol;
+    std::uint32_t quantity;
+    Side side;
+    std::uint8_t padding[7];
+};
+
+/**
+ * @brief Writes the book, tracker, resting orders and feed position to a snapshot file. The file
+ * is written next to `path` and renamed over it once complete, so a crash mid-write leaves the
+ * previous snapshot intact.
+ *
+ * @param path The snapshot file to create or replace.
+ * @param symbols The table `book` and `tracker` resolve symbols through.
+ * @param book The book to save.
+ * @param tracker The tracker to save.
+ * @param orders The order-by-order book whose resting orders to save.
+ * @param position The feed position the state corresponds to.
+ * @return 0 on success, or -1 with `errno` set.
+ */
+int writeSnapshot(const char* path, const SymbolTable& symbols, const OrderBook& book,
+                  const VWAPTracker& tracker, const L3OrderBook& orders,
+                  const FeedPosition& position);
+
+/**
+ * @brief Loads a snapshot file into a book, tracker and order-by-order book. The recorded symbols
+ * are interned into `symbols` first, in their original order, so an empty table gets back the
+ * same IDs.
+ *
+ * @param path The snapshot file to read.
+ * @param symbols The table `book` and `tracker` resolve symbols through.
+ * @param book Receives the saved book entries and depth ladders.
+ * @param tracker Receives the saved VWAP totals.
+ * @param orders Receives the saved resting orders, in their original time priority. Should be
+ * empty and attached to `book`.
+ * @param position Receives the feed position to resume from.
+ * @return 0 on success, or -1 with `errno` set; `EINVAL` if the file is not a snapshot of this
+ * version or is damaged, in which case nothing was loaded.
+ */
+int readSnapshot(const char* path, SymbolTable& symbols, OrderBook& book, VWAPTracker& tracker,
+                 L3OrderBook& orders, FeedPosition& position);
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Mixes the bytes of an 8-byte symbol into a well-distributed 64-bit hash. ASCII-packed
+ * tickers only differ in a few low bits of each byte and are zero-padded at the top, so an
+ * identity hash would cluster badly in a power-of-two table. This is the 64-bit finalizer from
+ * MurmurHash3, which avalanches every input bit into both halves of the result.
+ *
+ * Tables index with the low bits of the hash; callers partitioning symbols across tables (e.g.
+ * shards) should use the high bits so each partition still spreads over its own table.
+ *
+ * @param symbol The symbol to hash.
+ * @return The mixed hash.
+ */
+inline std::uint64_t hashSymbol(std::uint64_t symbol) {
+    symbol ^= symbol >> 33;
+    symbol *= 0xFF51AFD7ED558CCDull;
+    symbol ^= symbol >> 33;
+    symbol *= 0xC4CEB9FE1A85EC53ull;
+    symbol ^= symbol >> 33;
+    return symbol;
+}
+
+/**
+ * @brief A flat, open-addressing hash map from 8-byte symbols to `V`.
+ *
+ * Keys and values live inline in a single power-of-two array and collisions are resolved with
+ * linear probing, so a lookup is one hash plus a short forward scan over adjacent memory and an
+ * insert never allocates unless the table grows. The key `EMPTY_KEY` (all bits set) is reserved to
+ * mark unused slots: it is never found and `tryEmplace` refuses to insert it. It is not a valid
+ * ASCII ticker, but callers keyed by wire data must still handle it.
+ *
+ * Growing the table moves values, which invalidates pointers returned by `find`/`tryEmplace`. Use
+ * `reserve` up front to keep them valid for a known symbol universe, or set `StableValues` to keep
+ * values in separate chunked storage that never moves, at the cost of one extra indirection per
+ * lookup. Flat maps support `erase`, which also moves values; stable maps cannot erase.
+ *
+ * Although tuned for symbols, any 64-bit key other than `EMPTY_KEY` works, e.g. order IDs.
+ *
+ * @tparam V The mapped type. Must be default-constructible.
+ * @tparam StableValues If `true`, pointers to values remain valid for the lifetime of the map.
+ */
+template <typename V, bool StableValues = false> class FlatSymbolMap {
+  public:
+    static constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t{0};
+
+    /**
+     * @brief Constructs a map able to hold `expectedSize` entries without growing.
+     *
+     * @param expectedSize The number of entries to preallocate for.
+     */
+    explicit FlatSymbolMap(std::size_t expectedSize = 0) {
+        allocate(capacityFor(expectedSize));
+    }
+
+    /**
+     * @brief Looks up the value mapped to `key`.
+     *
+     * @param key The symbol to find.
+     * @return A pointer to the value, or `nullptr` if `key` is not present or is `EMPTY_KEY`.
+     */
+    V* find(std::uint64_t key) {
+        const auto idx = probe(key);
+        return slots_[idx].key == key && key != EMPTY_KEY ? valueAt(idx) : nullptr;
+    }
+
+    const V* find(std::uint64_t key) const {
+        const auto idx = probe(key);
+        return slots_[idx].key == key && key != EMPTY_KEY ? valueAt(idx) : nullptr;
+    }
+
+    /**
+     * @brief Finds the value mapped to `key`, value-initializing a new one if it is absent. This is
+     * a single probe sequence whether or not the key exists.
+     *
+     * @param key The symbol to find or insert.
+     * @return A pointer to the value and `true` if it was inserted by this call, or `nullptr` and
+     * `false` if `key` is the reserved `EMPTY_KEY`.
+     */
+    std::pair<V*, bool> tryEmplace(std::uint64_t key) {
+        if (key == EMPTY_KEY) {
+            return {nullptr, false};
+        }
+        auto idx = probe(key);
+        if (slots_[idx].key == key) {
+            return {valueAt(idx), false};
+        }
+
+        if ((size_ + 1) * 4 > capacity_ * 3) { /// keep load factor at or below 3/4
+            grow();
+            idx = probe(key);
+        }
+
+        slots_[idx].key = key;
+        if constexpr (StableValues) {
+            slots_[idx].value = static_cast<std::uint32_t>(values_.size());
+            values_.emplace_back();
+        } else {
+            slots_[idx].value = V{};
+        }
+        ++size_;
+        return {valueAt(idx), true};
+    }
+
+    /**
+     * @brief Returns a reference to the value mapped to `key`, inserting it if absent. `key` must
+     * not be `EMPTY_KEY`; use `tryEmplace` for keys that may be.
+     */
+    V& operator[](std::uint64_t key) {
+        assert(key != EMPTY_KEY && "FlatSymbolMap reserves the all-ones key");
+        return *tryEmplace(key).first;
+    }
+
+    /**
+     * @brief Removes `key` from the map. Later entries in the same probe run are shifted back into
+     * the hole, so lookups never need tombstones.
+     *
+     * @param key The key to remove.
+     * @return `true` if `key` was present.
+     */
+    bool erase(std::uint64_t key) {
+        static_assert(!StableValues, "FlatSymbolMap with stable values does not support erase");
+        auto hole = probe(key);
+        if (slots_[hole].key != key || key == EMPTY_KEY) {
+            return false;
+        }
+
+        const auto mask = capacity_ - 1;
+        for (auto next = (hole + 1) & mask; slots_[next].key != EMPTY_KEY;
+             next = (next + 1) & mask) {
+            const auto home = hashSymbol(slots_[next].key) & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask)) { /// hole is on next's probe path
+                slots_[hole] = std::move(slots_[next]);
+                hole = next;
+            }
+        }
+        slots_[hole].key = EMPTY_KEY;
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Grows the table so that `expectedSize` entries fit without further rehashing.
+     */
+    void reserve(std::size_t expectedSize) {
+        const auto wanted = capacityFor(expectedSize);
+        if (wanted > capacity_) {
+            rehash(wanted);
+        }
+    }
+
+    /**
+     * @brief Calls `fn(key, value)` for every entry, in table order.
+     */
+    template <typename Fn> void forEach(Fn&& fn) const {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].key != EMPTY_KEY) {
+                fn(slots_[i].key, *valueAt(i));
+            }
+        }
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+  private:
+    /// Inline value for flat maps, index into `values_` for stable maps.
+    using SlotValue = std::conditional_t<StableValues, std::uint32_t, V>;
+
+    struct NoValues {};
+    /// Chunked value storage for stable maps; `std::deque` never relocates elements on push_back.
+    using ValueStore = std::conditional_t<StableValues, std::deque<V>, NoValues>;
+
+    struct Slot {
+        std::uint64_t key;
+        SlotValue value;
+    };
+
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    /**
+     * @brief Smallest power-of-two capacity that holds `expectedSize` entries under the maximum
+     * load factor.
+     */
+    static std::size_t capacityFor(std::size_t expectedSize) {
+        std::size_t capacity = MIN_CAPACITY;
+        while (expectedSize * 4 > capacity * 3) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    /**
+     * @brief Returns the slot holding `key`, or the empty slot where it would be inserted.
+     */
+    std::size_t probe(std::uint64_t key) const {
+        auto idx = hashSymbol(key) & (capacity_ - 1);
+        while (slots_[idx].key != key && slots_[idx].key != EMPTY_KEY) {
+            idx = (idx + 1) & (capacity_ - 1);
+        }
+        return idx;
+    }
+
+    V* valueAt(std::size_t idx) {
+        if constexpr (StableValues) {
+            return &values_[slots_[idx].value];
+        } else {
+            return &slots_[idx].value;
+        }
+    }
+
+    const V* valueAt(std::size_t idx) const {
+        if constexpr (StableValues) {
+            return &values_[slots_[idx].value];
+        } else {
+            return &slots_[idx].value;
+        }
+    }
+
+    void allocate(std::size_t capacity) {
+        slots_ = std::make_unique<Slot[]>(capacity);
+        capacity_ = capacity;
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].key = EMPTY_KEY;
+        }
+    }
+
+    void grow() {
+        rehash(capacity_ * 2);
+    }
+
+    void rehash(std::size_t newCapacity) {
+        auto oldSlots = std::move(slots_);
+        const auto oldCapacity = capacity_;
+        allocate(newCapacity);
+
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldSlots[i].key != EMPTY_KEY) {
+                const auto idx = probe(oldSlots[i].key);
+                slots_[idx].key = oldSlots[i].key;
+                slots_[idx].value = std::move(oldSlots[i].value);
+            }
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t capacity_{0};
+    std::size_t size_{0};
+    ValueStore values_;
+};
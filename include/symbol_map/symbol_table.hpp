@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "messages.hpp"
+#include "symbol_map/flat_symbol_map.hpp"
+
+/**
+ * @brief A dictionary that interns 8-byte symbols into dense `SymbolId`s. The parser interns each
+ * message's symbol once, so downstream state can be stored in arrays indexed by ID and the
+ * consumer never hashes. This data structure cannot and should not be moved or copied.
+ *
+ * Note: Interning is not thread-safe. While a pipeline is running only the parser may call
+ * `intern`; other threads may use IDs they were handed but should not look up symbols until the
+ * parser has stopped.
+ */
+class SymbolTable {
+  public:
+    /**
+     * @brief Constructor for SymbolTable that preallocates room for `expectedSymbols` symbols.
+     *
+     * @param expectedSymbols The number of symbols the table can hold before its storage grows.
+     */
+    explicit SymbolTable(std::size_t expectedSymbols = 0);
+
+    /**
+     * @brief Returns the ID of `symbol`, assigning the next free ID if it has not been seen before.
+     *
+     * @param symbol The symbol to intern.
+     * @return The dense ID of `symbol`.
+     */
+    SymbolId intern(const std::uint64_t symbol) {
+        auto [id, inserted] = ids_.tryEmplace(symbol);
+        if (id == nullptr) { /// the all-ones symbol, which the map reserves
+            id = &reservedId_;
+            inserted = reservedId_ == NO_ID;
+        }
+        if (inserted) {
+            *id = static_cast<SymbolId>(symbols_.size());
+            symbols_.push_back(symbol);
+        }
+        return *id;
+    }
+
+    /**
+     * @brief Attempts to retrieve the ID of an already interned symbol.
+     *
+     * @param symbol The symbol to look up.
+     * @return An optional containing the ID of `symbol` if it has been interned.
+     */
+    std::optional<SymbolId> find(const std::uint64_t symbol) const;
+
+    /**
+     * @brief Returns the symbol that was assigned `id`. `id` must have been returned by `intern`.
+     */
+    std::uint64_t symbolOf(const SymbolId id) const {
+        return symbols_[id];
+    }
+
+    std::size_t size() const {
+        return symbols_.size();
+    }
+
+    SymbolTable(const SymbolTable& st) = delete;
+    SymbolTable(SymbolTable&& st) = delete;
+    void operator=(const SymbolTable& st) = delete;
+    void operator=(SymbolTable&& st) = delete;
+
+  private:
+    /// `reservedId_` before the all-ones symbol has been interned.
+    static constexpr SymbolId NO_ID = std::numeric_limits<SymbolId>::max();
+
+    FlatSymbolMap<SymbolId> ids_;
+    SymbolId reservedId_{NO_ID}; /// ID of the all-ones symbol, which `ids_` cannot hold
+    std::vector<std::uint64_t> symbols_; /// indexed by ID
+};
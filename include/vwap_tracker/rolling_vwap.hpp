@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+/**
+ * @brief Per-symbol VWAP over rolling time windows, e.g. the last second, minute and five minutes
+ * by message `timestamp`. Kept next to `VWAPTracker`, whose totals run from the start of the feed.
+ * This data structure cannot and should not be moved or copied.
+ *
+ * Each window is split into `buckets` fixed-width time buckets held in a ring per symbol, with a
+ * running total of the buckets still inside the window. A trade is added to the bucket of its
+ * timestamp; when time moves into a new bucket, the buckets that slid out of the window are
+ * subtracted from the total and cleared. Each bucket is expired once, so updates are O(1)
+ * amortized and reads of the latest window are O(1), without keeping individual trades. The cost
+ * is granularity: a window covers its current, partly elapsed bucket plus the `buckets - 1` before
+ * it, so its span varies by up to one bucket width.
+ *
+ * Like `VWAPTracker`, state is stored in columns indexed by `SymbolId`, with symbol-keyed
+ * operations interning through an owned or shared `SymbolTable`. Trades more than a window older
+ * than the symbol's latest trade are left out of that window.
+ */
+class RollingVWAP {
+  public:
+    /**
+     * @brief The configuration of one rolling window.
+     */
+    struct Window {
+        std::string name;      /// column heading in `showStats`, e.g. "1m"
+        std::uint64_t length;  /// in `timestamp` units
+        std::uint32_t buckets; /// resolution: the window slides one `length / buckets` at a time
+    };
+
+    /**
+     * @brief The trade totals of one symbol within one window.
+     */
+    struct WindowEntry {
+        std::uint64_t totalPriceByQuantity;
+        std::uint64_t totalQuantity;
+        std::uint32_t totalTrades;
+    };
+
+    static constexpr std::uint32_t DEFAULT_BUCKETS = 60;
+
+    /**
+     * @brief Constructor for RollingVWAP with a private symbol table.
+     *
+     * @param windows The windows to maintain. May be empty, which makes updates no-ops.
+     * @param expectedSymbols The number of symbols the tracker can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns and bucket rings.
+     */
+    explicit RollingVWAP(std::vector<Window> windows, std::size_t expectedSymbols = 0,
+                         std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Constructor for RollingVWAP that resolves symbols through a shared table, so IDs
+     * handed out by the parser can be used with the `...ById` operations. `symbols` must outlive
+     * the tracker.
+     *
+     * @param symbols The table that assigns IDs to symbols.
+     * @param windows The windows to maintain. May be empty, which makes updates no-ops.
+     * @param expectedSymbols The number of symbols the tracker can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns and bucket rings.
+     */
+    RollingVWAP(SymbolTable& symbols, std::vector<Window> windows,
+                std::size_t expectedSymbols = 0,
+                std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Attempts to retrieve the totals of a symbol within one window.
+     *
+     * @param symbol The symbol of the instrument.
+     * @param window The index of the window in the constructor's list.
+     * @param now The time to evaluate the window at. Buckets that have slid out of the window by
+     * then are excluded; a `now` before the symbol's latest trade is treated as that trade's time.
+     * @return An optional containing the totals, or `std::nullopt` if the symbol had no trades in
+     * the window.
+     */
+    std::optional<WindowEntry> getWindow(std::uint64_t symbol, std::size_t window,
+                                         std::uint64_t now) const;
+
+    /**
+     * @brief Same as `getWindow` for a symbol that has already been interned.
+     */
+    std::optional<WindowEntry> getWindowById(const SymbolId id, const std::size_t window,
+                                             const std::uint64_t now) const;
+
+    /**
+     * @brief Adds a trade to every window of its symbol.
+     *
+     * @param symbol The symbol that traded.
+     * @param msg The data of the incoming trade.
+     */
+    void addTrade(const std::uint64_t symbol, const TradeMessage& msg);
+
+    /**
+     * @brief Same as `addTrade` for a symbol that has already been interned.
+     *
+     * @param id The ID of the symbol in the tracker's symbol table.
+     * @param msg The data of the incoming trade.
+     */
+    void addTradeById(const SymbolId id, const TradeMessage& msg) {
+        if (!windows_.empty()) {
+            update(id, msg.timestamp, {msg.price * msg.quantity, msg.quantity, 1});
+        }
+    }
+
+    /**
+     * @brief Folds the windows of `other`, which must have the same configuration, into this
+     * tracker. Each symbol's windows end at the later of the two latest trades, and the buckets of
+     * both that are still inside them are added together.
+     *
+     * @param other The tracker to merge from.
+     */
+    void mergeFrom(const RollingVWAP& other);
+
+    const std::vector<Window>& windows() const {
+        return windows_;
+    }
+
+    /**
+     * @brief Returns the latest trade timestamp seen for any symbol, the natural `now` for reads
+     * at the end of a replay.
+     */
+    std::uint64_t latestTimestamp() const {
+        return latest_;
+    }
+
+    /**
+     * @brief Displays the VWAP of every symbol in every window as of `now`.
+     */
+    void showStats(const std::uint64_t now) const;
+
+    RollingVWAP(const RollingVWAP& rv) = delete;
+    RollingVWAP(RollingVWAP&& rv) = delete;
+    void operator=(const RollingVWAP& rv) = delete;
+    void operator=(RollingVWAP&& rv) = delete;
+
+  private:
+    /**
+     * @brief The bucket rings and running totals of one window across all symbols. Symbol `id`
+     * owns `buckets[id * numBuckets, (id + 1) * numBuckets)`; the bucket of time bucket `e` is
+     * `e % numBuckets`.
+     */
+    struct WindowState {
+        WindowState(std::uint64_t width, std::uint32_t numBuckets,
+                    std::pmr::memory_resource* memory)
+            : width{width}, numBuckets{numBuckets}, buckets{memory}, totals{memory},
+              headStart{memory}, headSlot{memory} {}
+
+        std::uint64_t width;
+        std::uint32_t numBuckets;
+        std::pmr::vector<WindowEntry> buckets;
+        std::pmr::vector<WindowEntry> totals;     /// sum of the symbol's buckets inside the window
+        std::pmr::vector<std::uint64_t> headStart; /// start time of the symbol's newest bucket
+        std::pmr::vector<std::uint32_t> headSlot;  /// ring index of that bucket
+    };
+
+    /**
+     * @brief Advances every window of `id` to `timestamp` and adds `trade` to its buckets.
+     */
+    void update(const SymbolId id, const std::uint64_t timestamp, const WindowEntry& trade);
+
+    /**
+     * @brief Moves the window of `id` from ending at time bucket `from` to ending at `to`,
+     * expiring the buckets that slide out.
+     */
+    static void advance(WindowState& window, const SymbolId id, const std::uint64_t from,
+                        const std::uint64_t to);
+
+    /**
+     * @brief Caches the start time and ring index of the newest bucket of `id`, so trades that
+     * fall into it skip the divisions.
+     */
+    static void setHead(WindowState& window, const SymbolId id, const std::uint64_t head);
+
+    /**
+     * @brief Sets up the bucket rings of each configured window.
+     */
+    void initWindows(std::pmr::memory_resource* memory);
+
+    /**
+     * @brief Grows every column so that `id` is a valid index.
+     */
+    void ensureCapacity(const SymbolId id);
+
+    std::unique_ptr<SymbolTable> ownedSymbols_; /// only set when no table was shared
+    SymbolTable* symbols_;
+    std::vector<Window> windows_;
+    std::uint64_t latest_{0};
+
+    std::pmr::vector<std::uint8_t> present_;
+    std::pmr::vector<std::uint64_t> latestAt_; /// latest trade timestamp per symbol
+    std::vector<WindowState> state_;           /// one per window
+};
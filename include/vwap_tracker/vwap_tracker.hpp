@@ -1,14 +1,21 @@
 #pragma once
 
 #include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <unordered_map>
+#include <vector>
 
 /**
  * @brief A class for storing symbols mapped to executed trade metadata useful for calculating VWAP.
  * Supports insertion of a symbol/entry pair and updating the entry for an existing symbol. This
  * data structure cannot and should not be moved or copied.
+ *
+ * Like `OrderBook`, state is stored as a struct of arrays indexed by `SymbolId` and symbol-keyed
+ * operations intern through an owned or shared `SymbolTable`. A symbol is present once it has at
+ * least one trade.
  */
 class VWAPTracker {
   public:
@@ -23,18 +30,42 @@ class VWAPTracker {
     };
 
     /**
-     * @brief Default constructor for OrderBook that instantiates all member variables.
+     * @brief Constructor for VWAPTracker with a private symbol table and room for
+     * `expectedSymbols` symbols.
+     *
+     * @param expectedSymbols The number of symbols the tracker can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns.
+     */
+    explicit VWAPTracker(std::size_t expectedSymbols = 0,
+                         std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief Constructor for VWAPTracker that resolves symbols through a shared table, so IDs
+     * handed out by the parser can be used with the `...ById` operations. `symbols` must outlive
+     * the tracker.
+     *
+     * @param symbols The table that assigns IDs to symbols.
+     * @param expectedSymbols The number of symbols the tracker can hold before its storage grows.
+     * @param memory Allocates the per-symbol columns.
      */
-    VWAPTracker() = default;
+    explicit VWAPTracker(SymbolTable& symbols, std::size_t expectedSymbols = 0,
+                         std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     /**
-     * @brief Attempts to retrieve the VWAP metadata object associated with the input symbol.
+     * @brief Attempts to retrieve the VWAP metadata associated with the input symbol.
      *
      * @param key The symbol of the instrument stored as the key.
-     * @return An optional containing a const pointer to the `VWAPEntry` associated with `key` if it
-     * exists.
+     * @return An optional containing a copy of the `VWAPEntry` associated with `key` if it exists.
      */
-    std::optional<const VWAPEntry*> getVWAP(std::uint64_t symbol) const;
+    std::optional<VWAPEntry> getVWAP(std::uint64_t symbol) const;
+
+    /**
+     * @brief Attempts to retrieve the VWAP metadata associated with the input symbol ID.
+     *
+     * @param id The ID of the symbol in the tracker's symbol table.
+     * @return An optional containing a copy of the `VWAPEntry` for `id` if it exists.
+     */
+    std::optional<VWAPEntry> getVWAPById(const SymbolId id) const;
 
     /**
      * @brief Creates a new mapping of symbol to VWAP data using the provided `TradeMessage`.
@@ -44,8 +75,54 @@ class VWAPTracker {
      */
     void upsertVWAP(const std::uint64_t symbol, const TradeMessage& msg);
 
+    /**
+     * @brief Same as `upsertVWAP` for a symbol that has already been interned.
+     *
+     * @param id The ID of the symbol in the tracker's symbol table.
+     * @param msg The data of the incoming trade.
+     */
+    void upsertVWAPById(const SymbolId id, const TradeMessage& msg);
+
+    /**
+     * @brief Calls `fn(id, entry)` for every symbol in the tracker, in ID order.
+     */
+    template <typename Fn> void forEachEntry(Fn&& fn) const {
+        for (SymbolId id = 0; id < totalTrades_.size(); ++id) {
+            if (totalTrades_[id] != 0) {
+                fn(id, VWAPEntry{updatedAt_[id], totalPriceByQuantity_[id], totalQuantity_[id],
+                                 totalTrades_[id]});
+            }
+        }
+    }
+
+    /**
+     * @brief Sets the totals of `id` as they were saved, e.g. from a snapshot, replacing any
+     * existing totals for the symbol. An entry without trades leaves the symbol absent.
+     *
+     * @param id The ID of the symbol in the tracker's symbol table.
+     * @param entry The saved totals.
+     */
+    void restoreEntryById(const SymbolId id, const VWAPEntry& entry);
+
+    /**
+     * @brief Folds the entries of `other` into this tracker. VWAP sums are associative, so trackers
+     * built over disjoint slices of a feed merge into the same totals as a single sequential pass.
+     *
+     * @param other The tracker to merge from.
+     */
+    void mergeFrom(const VWAPTracker& other);
+
+    /**
+     * @brief Folds the entries of `other`, built from a later slice of the same feed, into this
+     * tracker. Sums add up as in `mergeFrom`, but the update time of `other` wins whatever its
+     * value, as the last trade's would in a sequential pass.
+     *
+     * @param other The tracker to merge from.
+     */
+    void mergeLaterFrom(const VWAPTracker& other);
+
     std::size_t size() const {
-        return tracker_.size();
+        return size_;
     }
 
     /**
@@ -59,5 +136,22 @@ class VWAPTracker {
     void operator=(VWAPTracker&& vt) = delete;
 
   private:
-    std::unordered_map<std::uint64_t, VWAPEntry> tracker_;
+    /**
+     * @brief Grows every column so that `id` is a valid index.
+     */
+    void ensureCapacity(const SymbolId id);
+
+    /**
+     * @brief Implements `mergeFrom` and, if `laterWins`, `mergeLaterFrom`.
+     */
+    void merge(const VWAPTracker& other, bool laterWins);
+
+    std::unique_ptr<SymbolTable> ownedSymbols_; /// only set when no table was shared
+    SymbolTable* symbols_;
+    std::size_t size_{0};
+
+    std::pmr::vector<std::uint64_t> updatedAt_;
+    std::pmr::vector<std::uint64_t> totalPriceByQuantity_;
+    std::pmr::vector<std::uint64_t> totalQuantity_;
+    std::pmr::vector<std::uint32_t> totalTrades_; /// zero marks an absent symbol
 };
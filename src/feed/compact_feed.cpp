@@ -0,0 +1,453 @@
+#include "feed/compact_feed.hpp"
+#include "io/byte_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static_assert(sizeof(CompactHeader) == 64 && sizeof(CompactBlockIndex) == 32,
+              "compact feed records must keep their on-disk size");
+
+/**
+ * @brief Appends `value` to `out` as a varint.
+ */
+static void appendVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+CompactEncoder::CompactEncoder(std::uint32_t blockMessages)
+    : blockMessages_{std::max<std::uint32_t>(blockMessages, 1)} {
+    for (auto& column : columns_) {
+        column.reserve(blockMessages_);
+    }
+}
+
+CompactEncoder::~CompactEncoder() {
+    close();
+}
+
+int CompactEncoder::open(const char* path) {
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ == -1) {
+        return -1;
+    }
+    const CompactHeader header{}; /// rewritten by `close` once the counts are known
+    if (writeAll(fd_, reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)) == -1) {
+        const int err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        errno = err;
+        return -1;
+    }
+    fileOffset_ = sizeof(header);
+    return 0;
+}
+
+int CompactEncoder::add(const std::uint8_t* data) {
+    if (!isKnownMessageType(*data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    const auto type = static_cast<MessageType>(*data);
+    std::uint8_t side = 0;
+    if (type == MessageType::Depth) {
+        side = static_cast<std::uint8_t>(reinterpret_cast<const DepthMessage*>(data)->side);
+    } else if (type == MessageType::AddOrder) {
+        side = static_cast<std::uint8_t>(reinterpret_cast<const AddOrderMessage*>(data)->side);
+    }
+    if (side > static_cast<std::uint8_t>(Side::Ask)) {
+        errno = EINVAL;
+        return -1;
+    }
+    std::uint64_t timestamp;
+    std::uint64_t symbolKey;
+    std::memcpy(&timestamp, data + offsetof(TradeMessage, timestamp), sizeof(timestamp));
+    std::memcpy(&symbolKey, data + offsetof(TradeMessage, symbol), sizeof(symbolKey));
+
+    const SymbolId id = symbols_.intern(symbolKey);
+    if (id >= state_.size()) {
+        state_.resize(id + 1);
+    }
+    SymbolState& symbol = state_[id];
+    std::uint64_t price = symbol.block == epoch_ ? symbol.price : 0;
+
+    columns_[TYPE_COLUMN].push_back(static_cast<std::uint8_t>(*data | side << 3));
+    appendVarint(columns_[TIMESTAMP_COLUMN],
+                 zigzag(static_cast<std::int64_t>(timestamp - timestamp_)));
+    appendVarint(columns_[SYMBOL_COLUMN], id);
+    timestamp_ = timestamp;
+
+    const auto putPrice = [this, &price](const std::uint64_t value) {
+        appendVarint(columns_[PRICE_COLUMN], zigzag(static_cast<std::int64_t>(value - price)));
+        price = value;
+    };
+    const auto putQuantity = [this](const std::uint32_t value) {
+        appendVarint(columns_[QUANTITY_COLUMN], value);
+    };
+    const auto putOrderId = [this](const std::uint64_t value) {
+        appendVarint(columns_[ORDER_ID_COLUMN],
+                     zigzag(static_cast<std::int64_t>(value - orderId_)));
+        orderId_ = value;
+    };
+
+    switch (type) {
+    case MessageType::Trade: {
+        const auto& trade = *reinterpret_cast<const TradeMessage*>(data);
+        putPrice(trade.price);
+        putQuantity(trade.quantity);
+        break;
+    }
+    case MessageType::Quote: {
+        const auto& quote = *reinterpret_cast<const QuoteMessage*>(data);
+        putPrice(quote.bidPrice);
+        putQuantity(quote.bidQuantity);
+        appendVarint(columns_[PRICE_COLUMN],
+                     zigzag(static_cast<std::int64_t>(quote.askPrice - quote.bidPrice)));
+        putQuantity(quote.askQuantity);
+        break;
+    }
+    case MessageType::Depth: {
+        const auto& depth = *reinterpret_cast<const DepthMessage*>(data);
+        putPrice(depth.price);
+        putQuantity(depth.quantity);
+        break;
+    }
+    case MessageType::AddOrder: {
+        const auto& add = *reinterpret_cast<const AddOrderMessage*>(data);
+        putOrderId(add.orderId);
+        putPrice(add.price);
+        putQuantity(add.quantity);
+        break;
+    }
+    case MessageType::ModifyOrder: {
+        const auto& modify = *reinterpret_cast<const ModifyOrderMessage*>(data);
+        putOrderId(modify.orderId);
+        putPrice(modify.price);
+        putQuantity(modify.quantity);
+        break;
+    }
+    case MessageType::CancelOrder:
+        putOrderId(reinterpret_cast<const CancelOrderMessage*>(data)->orderId);
+        break;
+    case MessageType::ExecuteOrder: {
+        const auto& execute = *reinterpret_cast<const ExecuteOrderMessage*>(data);
+        putOrderId(execute.orderId);
+        putQuantity(execute.quantity);
+        break;
+    }
+    }
+    symbol = {price, epoch_};
+
+    if (blockCount_ == 0) {
+        index_.push_back({fileOffset_, messages_, rawOffset_, 0, 0});
+    }
+    ++messages_;
+    rawOffset_ += messageSize(type);
+    if (++blockCount_ == blockMessages_) {
+        return flushBlock();
+    }
+    return 0;
+}
+
+int CompactEncoder::flushBlock() {
+    if (blockCount_ == 0) {
+        return 0;
+    }
+    block_.clear();
+    for (const auto& column : columns_) {
+        append(block_, static_cast<std::uint32_t>(column.size()));
+    }
+    for (auto& column : columns_) {
+        block_.insert(block_.end(), column.begin(), column.end());
+        column.clear();
+    }
+    CompactBlockIndex& entry = index_.back();
+    entry.bytes = static_cast<std::uint32_t>(block_.size());
+    entry.messages = blockCount_;
+    if (writeAll(fd_, block_.data(), block_.size()) == -1) {
+        return -1;
+    }
+    fileOffset_ += block_.size();
+    blockCount_ = 0;
+    ++epoch_;
+    timestamp_ = 0;
+    orderId_ = 0;
+    return 0;
+}
+
+int CompactEncoder::close() {
+    if (fd_ == -1) {
+        return 0;
+    }
+    int result = flushBlock();
+    if (result == 0) {
+        /// zeros after the last block keep a corrupt one from decoding past the end of the file,
+        /// and align the index
+        const std::uint64_t gap = COMPACT_PADDING + 7 - (fileOffset_ + COMPACT_PADDING + 7) % 8;
+        std::vector<std::uint8_t> tail(gap);
+        for (const auto& entry : index_) {
+            append(tail, entry);
+        }
+        for (SymbolId id = 0; id < symbols_.size(); ++id) {
+            append(tail, symbols_.symbolOf(id));
+        }
+
+        CompactHeader header{};
+        header.magic = COMPACT_MAGIC;
+        header.version = COMPACT_VERSION;
+        header.blockMessages = blockMessages_;
+        header.messages = messages_;
+        header.blocks = index_.size();
+        header.symbolCount = symbols_.size();
+        header.indexOffset = fileOffset_ + gap;
+        header.rawSize = rawOffset_;
+        if (writeAll(fd_, tail.data(), tail.size()) == -1 ||
+            pwrite(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+            result = -1;
+        } else {
+            fileOffset_ += tail.size();
+        }
+    }
+    const int err = errno;
+    if (::close(fd_) == -1) {
+        result = -1;
+    } else {
+        errno = err;
+    }
+    fd_ = -1;
+    return result;
+}
+
+int CompactFeed::open(const std::uint8_t* data, std::size_t size) {
+    CompactHeader header;
+    if (!matches(data, size) || size < sizeof(header) ||
+        reinterpret_cast<std::uintptr_t>(data) % alignof(CompactBlockIndex) != 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    const std::uint64_t indexBytes = header.blocks * sizeof(CompactBlockIndex);
+    const std::uint64_t symbolBytes = header.symbolCount * sizeof(std::uint64_t);
+    if (header.version != COMPACT_VERSION || header.indexOffset % 8 != 0 ||
+        header.indexOffset < sizeof(header) + COMPACT_PADDING ||
+        header.indexOffset > size || indexBytes > size - header.indexOffset ||
+        symbolBytes != size - header.indexOffset - indexBytes) {
+        errno = EPROTO;
+        return -1;
+    }
+
+    const auto* index = reinterpret_cast<const CompactBlockIndex*>(data + header.indexOffset);
+    std::uint64_t messages = 0;
+    std::uint64_t end = sizeof(header);
+    for (std::uint64_t i = 0; i < header.blocks; ++i) {
+        const CompactBlockIndex& entry = index[i];
+        if (entry.offset != end || entry.firstMessage != messages ||
+            entry.bytes < COMPACT_COLUMNS * sizeof(std::uint32_t) ||
+            entry.offset + entry.bytes + COMPACT_PADDING > header.indexOffset) {
+            errno = EPROTO;
+            return -1;
+        }
+        end += entry.bytes;
+        messages += entry.messages;
+    }
+    if (messages != header.messages) {
+        errno = EPROTO;
+        return -1;
+    }
+
+    base_ = data;
+    index_ = index;
+    blocks_ = header.blocks;
+    messages_ = header.messages;
+    symbols_.resize(header.symbolCount);
+    std::memcpy(symbols_.data(), data + header.indexOffset + indexBytes, symbolBytes);
+    state_.assign(header.symbolCount, SymbolState{});
+    nextBlock_ = 0;
+    remaining_ = 0;
+    batchSize_ = 0;
+    batchNext_ = 0;
+    truncated_ = false;
+    offset_ = blocks_ > 0 ? index_[0].feedOffset : sizeof(std::uint64_t);
+    return 0;
+}
+
+bool CompactFeed::enterBlock(const std::uint64_t block) {
+    const CompactBlockIndex& entry = index_[block];
+    const std::uint8_t* data = base_ + entry.offset;
+    std::uint32_t lengths[COMPACT_COLUMNS];
+    std::memcpy(lengths, data, sizeof(lengths));
+    std::uint64_t bytes = sizeof(lengths);
+    for (const std::uint32_t length : lengths) {
+        bytes += length;
+    }
+    /// every message has a type byte, and the columns must fill the block exactly
+    if (lengths[TYPE_COLUMN] != entry.messages || bytes != entry.bytes) {
+        return false;
+    }
+    const std::uint8_t* column = data + sizeof(lengths);
+    for (std::size_t i = 0; i < COMPACT_COLUMNS; ++i) {
+        cursors_[i] = column;
+        column += lengths[i];
+        ends_[i] = column;
+    }
+    remaining_ = entry.messages;
+    batchSize_ = 0;
+    batchNext_ = 0;
+    offset_ = entry.feedOffset;
+    nextBlock_ = block + 1;
+    ++epoch_;
+    timestamp_ = 0;
+    orderId_ = 0;
+    return true;
+}
+
+bool CompactFeed::nextBlock() {
+    while (remaining_ == 0) {
+        if (nextBlock_ == blocks_) {
+            return false;
+        }
+        if (!enterBlock(nextBlock_)) {
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompactFeed::refill() {
+    if (remaining_ == 0 && !nextBlock()) {
+        return false;
+    }
+    const std::uint8_t* types = cursors_[TYPE_COLUMN];
+    const std::uint8_t* timestamps = cursors_[TIMESTAMP_COLUMN];
+    const std::uint8_t* symbols = cursors_[SYMBOL_COLUMN];
+    const std::uint8_t* prices = cursors_[PRICE_COLUMN];
+    const std::uint8_t* quantities = cursors_[QUANTITY_COLUMN];
+    const std::uint8_t* orderIds = cursors_[ORDER_ID_COLUMN];
+    const std::uint64_t* const keys = symbols_.data();
+    SymbolState* const state = state_.data();
+    const std::uint64_t symbolCount = symbols_.size();
+    const std::uint64_t epoch = epoch_;
+    std::uint64_t timestamp = timestamp_;
+    std::uint64_t orderId = orderId_;
+
+    const auto delta = [](const std::uint8_t*& p) {
+        return static_cast<std::uint64_t>(unzigzag(readVarint(p)));
+    };
+    const auto quantity = [&quantities]() {
+        return static_cast<std::uint32_t>(readVarint(quantities));
+    };
+
+    const std::size_t count = std::min<std::size_t>(remaining_, DECODE_BATCH);
+    std::size_t decoded = 0;
+    for (; decoded < count; ++decoded) {
+        const std::uint8_t typeByte = *types++;
+        const auto type = static_cast<MessageType>(typeByte & 7);
+        const auto side = static_cast<Side>(typeByte >> 3);
+        timestamp += delta(timestamps);
+        const std::uint64_t id = readVarint(symbols);
+        if (id >= symbolCount) {
+            break;
+        }
+        const std::uint64_t symbolKey = keys[id];
+        SymbolState& symbol = state[id];
+        std::uint64_t price = symbol.block == epoch ? symbol.price : 0;
+
+        MarketDataMessage& msg = batch_[decoded];
+        switch (type) {
+        case MessageType::Trade:
+            price += delta(prices);
+            msg.trade = {type, timestamp, symbolKey, price, quantity(), {}};
+            break;
+        case MessageType::Quote: {
+            price += delta(prices);
+            const std::uint32_t bidQuantity = quantity();
+            const std::uint64_t askPrice = price + delta(prices);
+            msg.quote = {type, timestamp, symbolKey, price, bidQuantity, askPrice, quantity(), {}};
+            break;
+        }
+        case MessageType::Depth:
+            price += delta(prices);
+            msg.depth = {type, timestamp, symbolKey, price, quantity(), side, {}};
+            break;
+        case MessageType::AddOrder:
+            orderId += delta(orderIds);
+            price += delta(prices);
+            msg.addOrder = {type, timestamp, symbolKey, orderId, price, quantity(), side, {}};
+            break;
+        case MessageType::ModifyOrder:
+            orderId += delta(orderIds);
+            price += delta(prices);
+            msg.modifyOrder = {type, timestamp, symbolKey, orderId, price, quantity(), {}};
+            break;
+        case MessageType::CancelOrder:
+            orderId += delta(orderIds);
+            msg.cancelOrder = {type, timestamp, symbolKey, orderId, {}};
+            break;
+        case MessageType::ExecuteOrder:
+            orderId += delta(orderIds);
+            msg.executeOrder = {type, timestamp, symbolKey, orderId, quantity(), {}};
+            break;
+        default:
+            break;
+        }
+        /// a corrupt message is caught once it is decoded, before the next one can read further
+        const bool corrupt = !isKnownMessageType(typeByte & 7) | (typeByte > 0xF) |
+                             (types > ends_[TYPE_COLUMN]) | (timestamps > ends_[TIMESTAMP_COLUMN]) |
+                             (symbols > ends_[SYMBOL_COLUMN]) | (prices > ends_[PRICE_COLUMN]) |
+                             (quantities > ends_[QUANTITY_COLUMN]) |
+                             (orderIds > ends_[ORDER_ID_COLUMN]);
+        if (corrupt) {
+            break;
+        }
+        symbol = {price, epoch};
+    }
+
+    cursors_[TYPE_COLUMN] = types;
+    cursors_[TIMESTAMP_COLUMN] = timestamps;
+    cursors_[SYMBOL_COLUMN] = symbols;
+    cursors_[PRICE_COLUMN] = prices;
+    cursors_[QUANTITY_COLUMN] = quantities;
+    cursors_[ORDER_ID_COLUMN] = orderIds;
+    timestamp_ = timestamp;
+    orderId_ = orderId;
+    remaining_ -= static_cast<std::uint32_t>(decoded);
+    batchSize_ = decoded;
+    batchNext_ = 0;
+    if (decoded < count) {
+        stop();
+    }
+    return decoded > 0;
+}
+
+bool CompactFeed::seekToMessage(const std::uint64_t message) {
+    if (message > messages_) {
+        return false;
+    }
+    /// the last block starting at or before `message`
+    const auto* block =
+        std::upper_bound(index_, index_ + blocks_, message,
+                         [](const std::uint64_t m, const CompactBlockIndex& entry) {
+                             return m < entry.firstMessage;
+                         });
+    if (block == index_) { /// an empty feed
+        return true;
+    }
+    if (!enterBlock(static_cast<std::uint64_t>(block - index_) - 1)) {
+        stop();
+        return false;
+    }
+    for (std::uint64_t skip = message - block[-1].firstMessage; skip > 0; --skip) {
+        if (next() == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
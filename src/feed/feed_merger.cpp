@@ -0,0 +1,26 @@
+#include "feed/feed_merger.hpp"
+
+FeedMerger::FeedMerger(std::vector<MergeInput> inputs)
+    : inputs_{std::move(inputs)}, heads_(inputs_.size()), keys_(inputs_.size()),
+      merged_(inputs_.size()), tree_(inputs_.size()) {
+    const std::size_t count = inputs_.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        startOffsets_.push_back(inputs_[i].feed.offset());
+        advance(i);
+    }
+
+    /// play every match bottom-up: leaf `i` sits at node `count + i`, node `n` plays the winners
+    /// of nodes `2n` and `2n + 1`, keeps the loser and passes the winner up
+    std::vector<std::size_t> winners(2 * count);
+    for (std::size_t i = 0; i < count; ++i) {
+        winners[count + i] = i;
+    }
+    for (std::size_t node = count - 1; node > 0; --node) {
+        const std::size_t left = winners[2 * node];
+        const std::size_t right = winners[2 * node + 1];
+        const bool leftWins = beats(left, right);
+        winners[node] = leftWins ? left : right;
+        tree_[node] = leftWins ? right : left;
+    }
+    tree_[0] = count > 1 ? winners[1] : 0;
+}
@@ -0,0 +1,43 @@
+#include "feed/feed_scan.hpp"
+
+#include <algorithm>
+
+FeedScan scanFeed(const std::uint8_t* data, const std::size_t size,
+                  const std::uint64_t maxMessages, const std::size_t numChunks) {
+    FeedScan scan;
+    const std::size_t target = std::max<std::size_t>(1, (size + numChunks - 1) / numChunks);
+    scan.chunks.reserve(numChunks);
+
+    std::size_t offset = 0;
+    std::size_t chunkBegin = 0;
+    std::uint64_t chunkStartMessage = 0;
+    std::size_t nextCut = target;
+    std::uint32_t types = 0;
+    std::uint64_t messages = 0;
+
+    while (offset < size && messages < maxMessages) {
+        const std::uint8_t type = data[offset];
+        const std::size_t length = MESSAGE_SIZES[type];
+        if (length == 0 || length > size - offset) {
+            scan.truncated = true;
+            break;
+        }
+        types |= 1u << (type & 31);
+        offset += length;
+        ++messages;
+
+        if (offset >= nextCut) {
+            scan.chunks.push_back({chunkBegin, offset, messages - chunkStartMessage});
+            chunkBegin = offset;
+            chunkStartMessage = messages;
+            nextCut = std::max(nextCut + target, offset + 1);
+        }
+    }
+    if (messages > chunkStartMessage) {
+        scan.chunks.push_back({chunkBegin, offset, messages - chunkStartMessage});
+    }
+
+    scan.types = types;
+    scan.messages = messages;
+    return scan;
+}
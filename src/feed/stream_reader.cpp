@@ -0,0 +1,108 @@
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "feed/stream_reader.hpp"
+
+StreamReader::StreamReader(int fd, std::size_t chunkSize) : fd_{fd}, chunkSize_{chunkSize} {
+    for (auto& chunk : chunks_) {
+        chunk.buffer = std::make_unique<std::uint8_t[]>(HEADROOM + chunkSize_);
+    }
+
+    struct stat st;
+    regularFile_ = fstat(fd_, &st) == 0 && S_ISREG(st.st_mode);
+    if (regularFile_) {
+        posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    reader_ = std::thread{&StreamReader::readLoop, this};
+}
+
+StreamReader::~StreamReader() {
+    stop_.store(true, std::memory_order_release);
+    reader_.join();
+}
+
+bool StreamReader::refill(std::size_t wanted) {
+    assert(wanted <= HEADROOM && "StreamReader can only carry HEADROOM bytes across chunks");
+
+    while (static_cast<std::size_t>(end_ - cursor_) < wanted) {
+        if (ended_) {
+            return false;
+        }
+
+        Chunk& next = chunks_[current_ ^ 1];
+        while (!next.full.load(std::memory_order_acquire)) { /// wait for the reader thread
+            std::this_thread::yield();
+        }
+        if (next.size == 0) {
+            ended_ = true;
+            return false;
+        }
+
+        /// carry the unread tail into the headroom so it joins the new data contiguously
+        const auto leftover = static_cast<std::size_t>(end_ - cursor_);
+        std::uint8_t* dest = next.buffer.get() + HEADROOM - leftover;
+        if (leftover > 0) {
+            std::memcpy(dest, cursor_, leftover);
+        }
+        if (holding_) {
+            chunks_[current_].full.store(false, std::memory_order_release);
+        }
+
+        current_ ^= 1;
+        holding_ = true;
+        cursor_ = dest;
+        end_ = next.buffer.get() + HEADROOM + next.size;
+    }
+    return true;
+}
+
+void StreamReader::readLoop() {
+    std::size_t k = 0;
+    off_t offset = regularFile_ ? lseek(fd_, 0, SEEK_CUR) : 0; /// the caller may have seeked
+    bool done = false;
+
+    while (true) {
+        Chunk& chunk = chunks_[k];
+        while (chunk.full.load(std::memory_order_acquire)) { /// wait for the parser to release it
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        std::size_t filled = 0;
+        while (!done && filled < chunkSize_) {
+            const auto wanted = chunkSize_ - filled;
+            const auto n = ::read(fd_, chunk.buffer.get() + HEADROOM + filled, wanted);
+            if (n > 0) {
+                filled += static_cast<std::size_t>(n);
+                if (static_cast<std::size_t>(n) < wanted && !regularFile_) {
+                    break; /// a pipe has drained for now, hand over what we have
+                }
+            } else if (n == 0) {
+                done = true;
+            } else if (errno != EINTR) {
+                error_.store(errno, std::memory_order_release);
+                done = true;
+            }
+        }
+
+        if (regularFile_ && filled > 0) { /// the bytes are copied out, don't keep them cached
+            posix_fadvise(fd_, offset, static_cast<off_t>(filled), POSIX_FADV_DONTNEED);
+            offset += static_cast<off_t>(filled);
+        }
+
+        chunk.size = filled;
+        chunk.full.store(true, std::memory_order_release);
+        if (filled == 0) { /// end of input published
+            return;
+        }
+        k ^= 1;
+    }
+}
@@ -0,0 +1,151 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "feed/udp_feed.hpp"
+
+/**
+ * @brief Requested kernel receive buffer, so bursts queue in the socket rather than being dropped
+ * while the parser is busy. The kernel caps this at `net.core.rmem_max`.
+ */
+static constexpr int RECEIVE_BUFFER_SIZE = 16 << 20;
+
+/**
+ * @brief Number of empty non-blocking polls between idle timeout checks in busy-poll mode.
+ */
+static constexpr std::size_t POLLS_PER_CLOCK_CHECK = 1024;
+
+int openUdpSocket(const char* address, std::uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    const int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &RECEIVE_BUFFER_SIZE, sizeof(RECEIVE_BUFFER_SIZE));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+UdpFeed::UdpFeed(int fd, bool busyPoll, int idleTimeoutMs)
+    : fd_{fd}, busyPoll_{busyPoll}, idleTimeoutMs_{idleTimeoutMs},
+      buffers_{std::make_unique<std::uint8_t[]>(BATCH_SIZE * MAX_DATAGRAM_SIZE)} {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+        iovecs_[i].iov_base = buffers_.get() + i * MAX_DATAGRAM_SIZE;
+        iovecs_[i].iov_len = MAX_DATAGRAM_SIZE;
+        std::memset(&headers_[i], 0, sizeof(headers_[i]));
+        headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+        headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    if (!busyPoll_) { /// blocking receives give up after the idle timeout
+        timeval timeout{};
+        timeout.tv_sec = idleTimeoutMs_ / 1000;
+        timeout.tv_usec = (idleTimeoutMs_ % 1000) * 1000;
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+}
+
+bool UdpFeed::nextDatagram() {
+    while (!ended_) {
+        if (batchIdx_ == batchSize_ && !receive()) {
+            ended_ = true;
+            break;
+        }
+
+        const auto* data = static_cast<const std::uint8_t*>(iovecs_[batchIdx_].iov_base);
+        const std::size_t length = headers_[batchIdx_].msg_len;
+        ++batchIdx_;
+        ++datagrams_;
+        if (length < sizeof(PacketHeader)) {
+            truncated_ = true;
+            continue;
+        }
+
+        PacketHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.messageCount == END_OF_SESSION) {
+            ended_ = true;
+            break;
+        }
+
+        if (!started_) { /// join the session wherever it currently is
+            started_ = true;
+            expected_ = header.sequence;
+        }
+        if (header.sequence > expected_) {
+            ++gaps_;
+            missedMessages_ += header.sequence - expected_;
+        } else if (header.sequence + header.messageCount <= expected_) {
+            ++duplicates_;
+            continue;
+        }
+
+        cursor_ = data + sizeof(PacketHeader);
+        end_ = data + length;
+        remaining_ = header.messageCount;
+
+        /// a partially repeated packet starts with messages that were already delivered
+        for (auto seen = expected_ > header.sequence ? expected_ - header.sequence : 0;
+             seen > 0 && cursor_ < end_ && isKnownMessageType(*cursor_); --seen) {
+            cursor_ += messageSize(static_cast<MessageType>(*cursor_));
+            --remaining_;
+        }
+        expected_ = header.sequence + header.messageCount;
+        return true;
+    }
+    return false;
+}
+
+bool UdpFeed::receive() {
+    const int flags = busyPoll_ ? MSG_DONTWAIT : MSG_WAITFORONE;
+    auto idleSince = std::chrono::steady_clock::now();
+    std::size_t emptyPolls = 0;
+
+    while (true) {
+        const int received = recvmmsg(fd_, headers_, BATCH_SIZE, flags, nullptr);
+        if (received > 0) {
+            batchSize_ = static_cast<std::size_t>(received);
+            batchIdx_ = 0;
+            return true;
+        }
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            error_ = errno;
+            return false;
+        }
+        if (!busyPoll_) { /// SO_RCVTIMEO expired
+            timedOut_ = true;
+            return false;
+        }
+
+        if (++emptyPolls % POLLS_PER_CLOCK_CHECK == 0) {
+            const auto idle = std::chrono::steady_clock::now() - idleSince;
+            if (idle > std::chrono::milliseconds{idleTimeoutMs_}) {
+                timedOut_ = true;
+                return false;
+            }
+        }
+    }
+}
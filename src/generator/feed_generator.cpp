@@ -0,0 +1,251 @@
+#include "generator/feed_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "messages.hpp"
+
+/**
+ * @brief Mid prices start log-uniformly between these, in cents.
+ */
+static constexpr double MIN_START_PRICE = 2'000;
+static constexpr double MAX_START_PRICE = 500'000;
+
+/**
+ * @brief Seeds of the streams a chunk draws from, besides the symbol levels and names.
+ */
+enum Stream : std::uint64_t { SPINE_STREAM, DETAIL_STREAM, SETUP_STREAM };
+
+/**
+ * @brief Returns the ticker of index `index`: A to Z, then AA to ZZ and so on, as a symbol.
+ */
+static std::uint64_t tickerSymbol(std::uint32_t index) {
+    char name[8] = {};
+    std::size_t length = 0;
+    for (std::uint32_t n = index + 1; n > 0; n = (n - 1) / 26) {
+        name[length++] = static_cast<char>('A' + (n - 1) % 26);
+    }
+    std::reverse(name, name + length);
+    std::uint64_t symbol;
+    std::memcpy(&symbol, name, sizeof(symbol));
+    return symbol;
+}
+
+/**
+ * @brief Returns `p` of 2^32, saturating at the largest value.
+ */
+static std::uint32_t toThreshold(const double p) {
+    return static_cast<std::uint32_t>(std::min(p * 0x1.0p32, 4294967295.0));
+}
+
+/**
+ * @brief Runs `fn(i)` for every `i` below `count`, on `count` threads including the caller.
+ */
+template <typename Fn> static void parallelFor(const std::size_t count, const Fn& fn) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (std::size_t i = 1; i < count; ++i) {
+        threads.emplace_back([&fn, i]() { fn(i); });
+    }
+    if (count > 0) {
+        fn(0);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+ZipfSampler::ZipfSampler(const std::uint32_t n, const double exponent)
+    : size_{n}, threshold_(n), alias_(n) {
+    std::vector<double> weights(n);
+    double total = 0;
+    for (std::uint32_t rank = 0; rank < n; ++rank) {
+        weights[rank] = std::pow(rank + 1.0, -exponent);
+        total += weights[rank];
+    }
+    /// Vose: pair each rank below the mean weight with one above it, which tops it up
+    std::vector<std::uint32_t> small;
+    std::vector<std::uint32_t> large;
+    for (std::uint32_t rank = 0; rank < n; ++rank) {
+        weights[rank] *= n / total;
+        (weights[rank] < 1 ? small : large).push_back(rank);
+    }
+    while (!small.empty() && !large.empty()) {
+        const std::uint32_t less = small.back();
+        const std::uint32_t more = large.back();
+        small.pop_back();
+        threshold_[less] = toThreshold(weights[less]);
+        alias_[less] = more;
+        weights[more] -= 1 - weights[less];
+        if (weights[more] < 1) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    /// what is left is 1 up to rounding
+    for (const auto* ranks : {&small, &large}) {
+        for (const std::uint32_t rank : *ranks) {
+            threshold_[rank] = UINT32_MAX;
+            alias_[rank] = rank;
+        }
+    }
+}
+
+FeedGenerator::FeedGenerator(const GeneratorConfig& config)
+    : config_{config},
+      zipf_{config.symbols, config.zipfExponent},
+      workers_(std::max(config.threads, 1u)),
+      chunkCount_{(config.messages + CHUNK_MESSAGES - 1) / CHUNK_MESSAGES} {
+    const double leave = 1 / config.burstLength;
+    const double enter =
+        config.burstRatio >= 1 ? 1 : leave * config.burstRatio / (1 - config.burstRatio);
+    enterBurst_ = toThreshold(enter);
+    leaveBurst_ = toThreshold(leave);
+
+    /// the first symbols.size() tickers, shortest first, handed out to ranks in a random order
+    SplitMix64 setup{streamSeed(0, SETUP_STREAM)};
+    symbols_.resize(config.symbols);
+    carry_.resize(config.symbols);
+    for (std::uint32_t rank = 0; rank < config.symbols; ++rank) {
+        symbols_[rank] = tickerSymbol(rank);
+    }
+    for (std::uint32_t rank = config.symbols; rank > 1; --rank) {
+        std::swap(symbols_[rank - 1], symbols_[setup.below(rank)]);
+    }
+    const double spread = std::log(MAX_START_PRICE / MIN_START_PRICE);
+    for (auto& mid : carry_) {
+        mid = static_cast<std::int64_t>(MIN_START_PRICE * std::exp(spread * setup.uniform()));
+    }
+
+    for (auto& worker : workers_) {
+        worker.mids.resize(config.symbols);
+        worker.slots.resize(config.symbols);
+        worker.out.reserve(CHUNK_MESSAGES * MAX_MESSAGE_SIZE);
+    }
+}
+
+std::uint64_t FeedGenerator::streamSeed(const std::uint64_t chunk,
+                                        const std::uint64_t stream) const {
+    return SplitMix64::mix(config_.seed ^ SplitMix64::mix(chunk * 4 + stream + 1));
+}
+
+FeedGenerator::Spine FeedGenerator::nextSpine(SplitMix64& rng, bool& burst) const {
+    Spine spine;
+    spine.rank = zipf_(rng());
+    const std::uint64_t random = rng();
+    /// low 2 bits: the step; next 30: the gap; high 32: whether the burst state flips
+    const std::uint64_t stepBits = random & 3;
+    spine.step = stepBits == 0 ? -1 : stepBits == 3 ? 1 : 0;
+    const double u = (static_cast<double>((random >> 2) & 0x3FFFFFFF) + 0.5) * 0x1.0p-30;
+    const double mean = burst ? config_.burstGap : config_.meanGap;
+    spine.gap = static_cast<std::uint64_t>(-std::log(u) * mean);
+    if (static_cast<std::uint32_t>(random >> 32) < (burst ? leaveBurst_ : enterBurst_)) {
+        burst = !burst;
+    }
+    return spine;
+}
+
+void FeedGenerator::measure(Worker& worker) const {
+    SplitMix64 rng{streamSeed(worker.chunk, SPINE_STREAM)};
+    bool burst = rng.uniform() < config_.burstRatio;
+    worker.duration = 0;
+    for (std::size_t i = 0; i < worker.messages; ++i) {
+        const Spine spine = nextSpine(rng, burst);
+        worker.duration += spine.gap;
+        std::uint32_t& slot = worker.slots[spine.rank];
+        if (slot == 0) {
+            worker.touched.push_back(spine.rank);
+            worker.walk.push_back(0);
+            slot = static_cast<std::uint32_t>(worker.touched.size());
+        }
+        worker.walk[slot - 1] += spine.step;
+    }
+}
+
+void FeedGenerator::emit(Worker& worker, std::uint64_t timestamp) const {
+    for (std::size_t i = 0; i < worker.touched.size(); ++i) {
+        worker.mids[worker.touched[i]] = worker.walk[i];
+    }
+    SplitMix64 rng{streamSeed(worker.chunk, SPINE_STREAM)};
+    SplitMix64 detail{streamSeed(worker.chunk, DETAIL_STREAM)};
+    bool burst = rng.uniform() < config_.burstRatio;
+    const double tradeCutoff = config_.depthRatio + (1 - config_.depthRatio) * config_.tradeRatio;
+
+    worker.out.resize(worker.messages * MAX_MESSAGE_SIZE);
+    std::uint8_t* out = worker.out.data();
+    for (std::size_t i = 0; i < worker.messages; ++i) {
+        const Spine spine = nextSpine(rng, burst);
+        std::int64_t& walk = worker.mids[spine.rank];
+        walk += spine.step;
+        const auto mid = static_cast<std::uint64_t>(std::max(walk, MIN_MID_PRICE));
+        const std::uint64_t symbol = symbols_[spine.rank];
+
+        /// the ranges of `test_generator.py`, around the symbol's mid
+        MarketDataMessage msg;
+        const double type = detail.uniform();
+        if (type < config_.depthRatio) {
+            const auto side = static_cast<Side>(detail.below(2));
+            const std::uint64_t level = detail.below(101);
+            const std::uint64_t price = side == Side::Bid ? mid - level : mid + level;
+            const std::uint32_t quantity = detail.below(21) * 100; /// zero removes the level
+            msg.depth = {MessageType::Depth, timestamp, symbol, price, quantity, side, {0, 0}};
+        } else if (type < tradeCutoff) {
+            const std::uint64_t price = mid + detail.below(11) - 5;
+            const std::uint32_t quantity = (1 + detail.below(10)) * 100;
+            msg.trade = {MessageType::Trade, timestamp, symbol, price, quantity, {0, 0, 0}};
+        } else {
+            const std::uint64_t bid = mid - 1 - detail.below(5);
+            const std::uint32_t bidQuantity = (1 + detail.below(20)) * 100;
+            const std::uint64_t ask = mid + 1 + detail.below(5);
+            const std::uint32_t askQuantity = (1 + detail.below(20)) * 100;
+            msg.quote = {MessageType::Quote, timestamp, symbol,     bid,
+                         bidQuantity,        ask,       askQuantity, {0, 0, 0}};
+        }
+        const std::size_t size = messageSize(msg.type);
+        std::memcpy(out, &msg, size);
+        out += size;
+        timestamp += spine.gap;
+    }
+    worker.out.resize(static_cast<std::size_t>(out - worker.out.data()));
+
+    for (const std::uint32_t rank : worker.touched) {
+        worker.slots[rank] = 0;
+    }
+    worker.touched.clear();
+    worker.walk.clear();
+}
+
+bool FeedGenerator::nextRound() {
+    roundChunks_ = static_cast<std::size_t>(
+        std::min<std::uint64_t>(workers_.size(), chunkCount_ - nextChunk_));
+    if (roundChunks_ == 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i < roundChunks_; ++i) {
+        Worker& worker = workers_[i];
+        worker.chunk = nextChunk_ + i;
+        const std::uint64_t left = config_.messages - worker.chunk * CHUNK_MESSAGES;
+        worker.messages = static_cast<std::size_t>(std::min<std::uint64_t>(CHUNK_MESSAGES, left));
+    }
+    parallelFor(roundChunks_, [this](const std::size_t i) { measure(workers_[i]); });
+
+    /// hand each chunk the timestamp and mids the chunks before it end on
+    std::vector<std::uint64_t> starts(roundChunks_);
+    for (std::size_t i = 0; i < roundChunks_; ++i) {
+        Worker& worker = workers_[i];
+        starts[i] = timestamp_;
+        timestamp_ += worker.duration;
+        for (std::size_t j = 0; j < worker.touched.size(); ++j) {
+            std::int64_t& carry = carry_[worker.touched[j]];
+            const std::int64_t net = worker.walk[j];
+            worker.walk[j] = carry;
+            carry += net;
+        }
+    }
+    parallelFor(roundChunks_,
+                [this, &starts](const std::size_t i) { emit(workers_[i], starts[i]); });
+    nextChunk_ += roundChunks_;
+    return true;
+}
@@ -0,0 +1,187 @@
+#include "journal/journal.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(JournalHeader) == 64 && sizeof(JournalRecord) == 112,
+              "journal records must keep their on-disk size");
+
+/**
+ * @brief Returns the file size that holds a header and `records` records.
+ */
+static std::size_t journalLength(const std::uint64_t records) {
+    return sizeof(JournalHeader) + records * sizeof(JournalRecord);
+}
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+int JournalWriter::open(const char* path) {
+    fd_ = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ == -1) {
+        return -1;
+    }
+    if (reserve(GROWTH_RECORDS) == -1) {
+        const int err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        errno = err;
+        return -1;
+    }
+
+    JournalHeader header{};
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.recordSize = sizeof(JournalRecord);
+    header.openedAt = wallClockNs();
+    std::memcpy(base_, &header, sizeof(header));
+    size_ = 0;
+    return 0;
+}
+
+int JournalWriter::reserve(const std::uint64_t capacity) {
+    const std::size_t length = journalLength(capacity);
+    if (ftruncate(fd_, static_cast<off_t>(length)) == -1) {
+        return -1;
+    }
+    /// Reserve the blocks now so writes don't fail or stall on allocation later. Not every
+    /// filesystem supports it; the file is then sparse and allocated as it is written.
+    posix_fallocate(fd_, 0, static_cast<off_t>(length));
+
+    void* mapped;
+    if (base_ == nullptr) {
+        mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    } else {
+        mapped = mremap(base_, journalLength(capacity_), length, MREMAP_MAYMOVE);
+    }
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+    base_ = static_cast<std::uint8_t*>(mapped);
+    capacity_ = capacity;
+    return 0;
+}
+
+int JournalWriter::append(const JournalRecord& record) {
+    if (size_ == capacity_ && reserve(capacity_ + GROWTH_RECORDS) == -1) {
+        return -1;
+    }
+    std::memcpy(base_ + journalLength(size_), &record, sizeof(record));
+    ++size_;
+    return 0;
+}
+
+int JournalWriter::close() {
+    if (fd_ == -1) {
+        return 0;
+    }
+    int result = 0;
+    std::memcpy(base_ + offsetof(JournalHeader, records), &size_, sizeof(size_));
+    if (munmap(base_, journalLength(capacity_)) == -1 ||
+        ftruncate(fd_, static_cast<off_t>(journalLength(size_))) == -1) {
+        result = -1;
+    }
+    const int err = errno;
+    if (::close(fd_) == -1) {
+        result = -1;
+    } else {
+        errno = err;
+    }
+    fd_ = -1;
+    base_ = nullptr;
+    capacity_ = 0;
+    return result;
+}
+
+JournalReader::~JournalReader() {
+    if (base_ != nullptr) {
+        munmap(const_cast<std::uint8_t*>(base_), length_);
+    }
+}
+
+int JournalReader::open(const char* path) {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        return -1;
+    }
+    const auto length = static_cast<std::size_t>(st.st_size);
+    if (length < sizeof(JournalHeader)) {
+        ::close(fd);
+        errno = EPROTO;
+        return -1;
+    }
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        errno = err;
+        return -1;
+    }
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    base_ = static_cast<const std::uint8_t*>(mapped);
+    length_ = length;
+
+    const JournalHeader& h = header();
+    const std::uint64_t room = (length - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    if (h.magic != JOURNAL_MAGIC || h.version != JOURNAL_VERSION ||
+        h.recordSize != sizeof(JournalRecord) || h.records > room) {
+        errno = EPROTO;
+        return -1;
+    }
+
+    size_ = h.records;
+    if (size_ == 0) { /// not closed: keep the records written in sequence
+        while (size_ < room && records()[size_].sequence == size_ + 1) {
+            ++size_;
+        }
+    }
+    return 0;
+}
+
+JournalRecorder::JournalRecorder(JournalWriter& writer)
+    : writer_{writer}, thread_{[this]() { run(); }} {}
+
+JournalRecorder::~JournalRecorder() {
+    stop();
+}
+
+int JournalRecorder::stop() {
+    if (thread_.joinable()) {
+        stopping_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+    return error_;
+}
+
+void JournalRecorder::run() {
+    while (true) {
+        JournalRecord* records;
+        const std::size_t claimed = queue_.claimRead(records, QUEUE_SIZE);
+        if (claimed == 0) {
+            if (stopping_.load(std::memory_order_acquire) && queue_.isEmpty()) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        for (std::size_t i = 0; i < claimed && error_ == 0; ++i) {
+            if (writer_.append(records[i]) == -1) {
+                error_ = errno;
+            }
+        }
+        queue_.commitRead(claimed);
+    }
+}
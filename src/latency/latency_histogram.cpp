@@ -0,0 +1,28 @@
+#include <cmath>
+
+#include "latency/latency_histogram.hpp"
+
+std::uint64_t LatencyHistogram::percentile(const double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const auto target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count_))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        seen += counts_[bucket];
+        if (seen >= target) {
+            return std::min(highestValueIn(bucket), max_);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::mergeFrom(const LatencyHistogram& other) {
+    for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        counts_[bucket] += other.counts_[bucket];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+}
@@ -0,0 +1,55 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "latency/latency_stats.hpp"
+
+/**
+ * @brief Prints one row of the latency table.
+ */
+static void showRow(const char* label, const LatencyHistogram& histogram, const double ticksPerNs) {
+    const auto ns = [ticksPerNs](std::uint64_t ticks) {
+        return static_cast<double>(ticks) / ticksPerNs;
+    };
+
+    std::cout << std::left << std::setw(22) << label << std::right << std::setw(12)
+              << histogram.count() << std::fixed << std::setprecision(0) << std::setw(10)
+              << ns(histogram.percentile(0.5)) << std::setw(10) << ns(histogram.percentile(0.99))
+              << std::setw(10) << ns(histogram.percentile(0.999)) << std::setw(12)
+              << ns(histogram.max()) << '\n';
+}
+
+void LatencyStats::mergeFrom(const LatencyStats& other) {
+    for (std::size_t i = 0; i < NUM_STAGES; ++i) {
+        stages_[i].mergeFrom(other.stages_[i]);
+    }
+    for (std::size_t i = 0; i < NUM_TYPES; ++i) {
+        types_[i].mergeFrom(other.types_[i]);
+    }
+}
+
+void LatencyStats::showStats(const double ticksPerNs) const {
+    static const char* const STAGE_NAMES[NUM_STAGES] = {
+        "Parse -> enqueue",
+        "Enqueue -> dequeue",
+        "Dequeue -> apply",
+        "Parse -> apply",
+    };
+
+    std::cout << "\n=== Latency (ns) ===\n";
+    std::cout << std::left << std::setw(22) << "Stage" << std::right << std::setw(12) << "Count"
+              << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(12) << "max" << '\n';
+    std::cout << std::string(76, '-') << '\n';
+
+    for (std::size_t i = 0; i < NUM_STAGES; ++i) {
+        showRow(STAGE_NAMES[i], stages_[i], ticksPerNs);
+    }
+    for (std::size_t i = 0; i < NUM_TYPES; ++i) {
+        if (types_[i].count() == 0) {
+            continue;
+        }
+        const std::string label = std::string{"  "} + messageTypeName(static_cast<MessageType>(i));
+        showRow(label.c_str(), types_[i], ticksPerNs);
+    }
+}
@@ -0,0 +1,15 @@
+#include <chrono>
+#include <thread>
+
+#include "latency/tsc_clock.hpp"
+
+double calibrateTscTicksPerNs(unsigned calibrationMs) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto startTsc = readTsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds{calibrationMs});
+    const auto endTsc = readTsc();
+    const auto endTime = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double, std::nano> elapsed = endTime - startTime;
+    return static_cast<double>(endTsc - startTsc) / elapsed.count();
+}
@@ -1,35 +1,597 @@
-#include <cassert>
-#include <chrono>
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <thread>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
 
+#include <fcntl.h>
+#include <getopt.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "feed/compact_feed.hpp"
+#include "feed/feed_merger.hpp"
+#include "feed/mapped_feed.hpp"
+#include "feed/parser.hpp"
+#include "feed/stream_reader.hpp"
+#include "feed/udp_feed.hpp"
+#include "journal/journal.hpp"
+#include "latency/latency_stats.hpp"
+#include "latency/tsc_clock.hpp"
+#include "memory/huge_page_resource.hpp"
 #include "messages.hpp"
 #include "orderbook/orderbook.hpp"
-#include "ringbuffer/spsc_queue.hpp"
+#include "pipeline/batch.hpp"
+#include "pipeline/board_pollers.hpp"
+#include "pipeline/market_state.hpp"
+#include "pipeline/multicast_pipeline.hpp"
+#include "pipeline/parallel_replay.hpp"
+#include "pipeline/pipeline.hpp"
+#include "pipeline/sharded_pipeline.hpp"
+#include "publish/quote_board.hpp"
+#include "ringbuffer/shm_spsc_queue.hpp"
+#include "ringbuffer/wait_strategy.hpp"
+#include "snapshot/snapshot.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/rolling_vwap.hpp"
 #include "vwap_tracker/vwap_tracker.hpp"
 
+/**
+ * @brief Upper bound on the number of consumer shards or replay jobs accepted on the command line.
+ */
+static constexpr std::size_t MAX_SHARDS = 64;
+
+/**
+ * @brief Number of symbols the `--publish` quote board has cells for. Symbols beyond it are still
+ * processed, just not published.
+ */
+static constexpr std::size_t BOARD_CAPACITY = 4096;
+
+/**
+ * @brief Number of slots in the `--shm` queue to another process. Larger than `QUEUE_SIZE` since a
+ * strategy process is typically slower than the in-process consumer and absorbs bursts here.
+ */
+static constexpr std::size_t SHM_QUEUE_SIZE = 1 << 16;
+
+/**
+ * @brief The wait strategies selectable with `--wait`, see `wait_strategy.hpp`.
+ */
+enum class WaitKind { Spin, Yield, Backoff, Block };
+
+/**
+ * @brief Runtime configuration collected from the command line.
+ */
+struct Options {
+    bool zeroCopy{false};     /// pass `MessageDescriptor`s into the mapped feed instead of copies
+    std::size_t shards{1};    /// number of consumer threads, each owning a slice of the symbols
+    bool stream{false};       /// read stdin through `StreamReader` even if it can be mapped
+    bool header{true};        /// the feed starts with an 8-byte message count
+    std::uint16_t udpPort{0}; /// receive the feed as UDP datagrams on this port instead of stdin
+    bool busyPoll{false};     /// spin on non-blocking UDP receives instead of sleeping
+    bool latency{false};      /// stamp messages with the TSC and report latency percentiles
+    bool hugePages{false};    /// allocate queues and book/tracker columns from `HugePageResource`
+    bool prefault{false};     /// fault the whole feed mapping in before the clock starts
+    std::size_t jobs{1};      /// replay a mapped feed in this many parallel chunks
+    bool conflate{false};     /// coalesce quotes per symbol while the consumer is behind
+    bool multicast{false};    /// apply book and VWAP updates on separate threads sharing one ring
+
+    WaitKind wait{WaitKind::Yield}; /// what threads do while a queue is full or empty
+    CpuPlacement cpus;              /// cores to pin the producer and consumers to
+
+    const char* snapshotPath{nullptr}; /// write the book and tracker state here at the end
+    const char* restorePath{nullptr};  /// resume from the state and position in this snapshot
+    std::uint64_t checkpointEvery{0};  /// also write the snapshot every this many messages
+
+    std::vector<RollingVWAP::Window> vwapWindows; /// rolling VWAP windows to maintain
+
+    bool publish{false};         /// publish top of book and VWAP to a `QuoteBoard`
+    std::size_t boardReaders{0}; /// threads polling the board while the feed is processed
+
+    const char* shmName{nullptr};     /// forward applied messages to this shared memory queue
+    const char* journalPath{nullptr}; /// record applied messages and their results to this file
+
+    std::vector<const char*> venuePaths; /// merge these feed files with stdin, one venue each
+};
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] < feed.bin\n"
+              << "  -z, --zero-copy          queue descriptors into the mapped feed, not copies\n"
+              << "  -s, --shards N           route symbols across N consumer threads (1-"
+              << MAX_SHARDS << ")\n"
+              << "  -S, --stream             read stdin in chunks instead of mapping it\n"
+              << "  -n, --no-header          the feed has no leading message count\n"
+              << "  -u, --udp PORT           receive the feed as UDP datagrams on PORT\n"
+              << "  -b, --busy-poll          with --udp, spin on the socket instead of blocking\n"
+              << "  -l, --latency            report per-stage and per-type latency percentiles\n"
+              << "  -j, --jobs N             replay a feed file in N parallel chunks (1-"
+              << MAX_SHARDS << ")\n"
+              << "  -H, --huge-pages         back queues and book/tracker storage with huge pages\n"
+              << "  -P, --prefault           fault in the mapped feed before processing starts\n"
+              << "  -C, --conflate           while the queue is full, keep only the latest quote\n"
+              << "                           per symbol; trades are always delivered\n"
+              << "  -m, --multicast          apply the book, VWAP and rolling VWAP on their own\n"
+              << "                           consumer threads, all reading one shared ring\n"
+              << "  -w, --wait KIND          on a full or empty queue: spin, yield (default),\n"
+              << "                           backoff or block\n"
+              << "  -p, --producer-cpu CPU   pin the producer thread to CPU\n"
+              << "  -c, --consumer-cpus LIST pin consumers to a comma-separated list of CPUs,\n"
+              << "                           reused round-robin when there are more shards\n"
+              << "  -o, --snapshot FILE      write the book and tracker state to FILE at the end\n"
+              << "  -k, --checkpoint-every N also write the snapshot every N messages\n"
+              << "  -r, --restore FILE       resume from the state and feed position in FILE\n"
+              << "  -W, --vwap-windows LIST  also track VWAP over rolling windows, e.g. 1s,1m,5m\n"
+              << "  -B, --publish N          publish top of book and VWAP to a seqlock board,\n"
+              << "                           polled by N reader threads (0 to publish only)\n"
+              << "  -M, --shm NAME           forward applied messages to another process through\n"
+              << "                           the shared memory queue NAME, e.g. /market_feed\n"
+              << "  -J, --journal FILE       record every applied message with the book and VWAP\n"
+              << "                           state it left to FILE, see journal_replay.out\n"
+              << "  -V, --venue FILE         merge feed FILE with stdin by timestamp, as the next\n"
+              << "                           venue, and keep an NBBO across venues (up to "
+              << MAX_VENUES << ")\n"
+              << "  -h, --help               show this message\n";
+}
+
+/**
+ * @brief Parses a CPU number for the pinning options.
+ *
+ * @return The CPU, or -1 if `text` is not a valid CPU number.
+ */
+int parseCpu(const char* text) {
+    char* end;
+    const auto cpu = std::strtol(text, &end, 10);
+    if (end == text || cpu < 0 || cpu >= CPU_SETSIZE) {
+        return -1;
+    }
+    return static_cast<int>(cpu);
+}
+
+/**
+ * @brief Parses a window length such as `500ms`, `1s` or `5m` into feed timestamp units, which are
+ * microseconds. A bare number is taken as microseconds.
+ *
+ * @return The length, or 0 if `text` is not a valid duration.
+ */
+std::uint64_t parseDuration(const char* text) {
+    char* end;
+    const auto value = std::strtoull(text, &end, 10);
+    if (end == text) {
+        return 0;
+    }
+    if (*end == '\0' || std::strcmp(end, "us") == 0) {
+        return value;
+    }
+    if (std::strcmp(end, "ms") == 0) {
+        return value * 1'000;
+    }
+    if (std::strcmp(end, "s") == 0) {
+        return value * 1'000'000;
+    }
+    if (std::strcmp(end, "m") == 0) {
+        return value * 60'000'000;
+    }
+    if (std::strcmp(end, "h") == 0) {
+        return value * 3'600'000'000;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses the command line into `opts`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, Options& opts) {
+    static const option longOptions[] = {
+        {"zero-copy", no_argument, nullptr, 'z'},
+        {"shards", required_argument, nullptr, 's'},
+        {"stream", no_argument, nullptr, 'S'},
+        {"no-header", no_argument, nullptr, 'n'},
+        {"udp", required_argument, nullptr, 'u'},
+        {"busy-poll", no_argument, nullptr, 'b'},
+        {"latency", no_argument, nullptr, 'l'},
+        {"jobs", required_argument, nullptr, 'j'},
+        {"huge-pages", no_argument, nullptr, 'H'},
+        {"prefault", no_argument, nullptr, 'P'},
+        {"conflate", no_argument, nullptr, 'C'},
+        {"multicast", no_argument, nullptr, 'm'},
+        {"wait", required_argument, nullptr, 'w'},
+        {"producer-cpu", required_argument, nullptr, 'p'},
+        {"consumer-cpus", required_argument, nullptr, 'c'},
+        {"snapshot", required_argument, nullptr, 'o'},
+        {"checkpoint-every", required_argument, nullptr, 'k'},
+        {"restore", required_argument, nullptr, 'r'},
+        {"vwap-windows", required_argument, nullptr, 'W'},
+        {"publish", required_argument, nullptr, 'B'},
+        {"shm", required_argument, nullptr, 'M'},
+        {"journal", required_argument, nullptr, 'J'},
+        {"venue", required_argument, nullptr, 'V'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    const char* shortOptions = "zs:Snu:blj:HPCmw:p:c:o:k:r:W:B:M:J:V:h";
+    while ((opt = getopt_long(argc, argv, shortOptions, longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'z':
+            opts.zeroCopy = true;
+            break;
+        case 's':
+            opts.shards = std::strtoul(optarg, nullptr, 10);
+            if (opts.shards == 0 || opts.shards > MAX_SHARDS) {
+                std::cerr << "Invalid shard count: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'S':
+            opts.stream = true;
+            break;
+        case 'n':
+            opts.header = false;
+            break;
+        case 'u': {
+            const auto port = std::strtoul(optarg, nullptr, 10);
+            if (port == 0 || port > 65535) {
+                std::cerr << "Invalid UDP port: " << optarg << '\n';
+                return false;
+            }
+            opts.udpPort = static_cast<std::uint16_t>(port);
+            break;
+        }
+        case 'b':
+            opts.busyPoll = true;
+            break;
+        case 'l':
+            opts.latency = true;
+            break;
+        case 'j':
+            opts.jobs = std::strtoul(optarg, nullptr, 10);
+            if (opts.jobs == 0 || opts.jobs > MAX_SHARDS) {
+                std::cerr << "Invalid job count: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'H':
+            opts.hugePages = true;
+            break;
+        case 'P':
+            opts.prefault = true;
+            break;
+        case 'C':
+            opts.conflate = true;
+            break;
+        case 'm':
+            opts.multicast = true;
+            break;
+        case 'w':
+            if (std::strcmp(optarg, "spin") == 0) {
+                opts.wait = WaitKind::Spin;
+            } else if (std::strcmp(optarg, "yield") == 0) {
+                opts.wait = WaitKind::Yield;
+            } else if (std::strcmp(optarg, "backoff") == 0) {
+                opts.wait = WaitKind::Backoff;
+            } else if (std::strcmp(optarg, "block") == 0) {
+                opts.wait = WaitKind::Block;
+            } else {
+                std::cerr << "Invalid wait strategy: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'p':
+            opts.cpus.producer = parseCpu(optarg);
+            if (opts.cpus.producer < 0) {
+                std::cerr << "Invalid producer CPU: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'c': {
+            opts.cpus.consumers.clear();
+            std::string list{optarg};
+            for (std::size_t pos = 0; pos <= list.size();) {
+                const auto comma = std::min(list.find(',', pos), list.size());
+                const int cpu = parseCpu(list.substr(pos, comma - pos).c_str());
+                if (cpu < 0) {
+                    std::cerr << "Invalid consumer CPU list: " << optarg << '\n';
+                    return false;
+                }
+                opts.cpus.consumers.push_back(cpu);
+                pos = comma + 1;
+            }
+            break;
+        }
+        case 'o':
+            opts.snapshotPath = optarg;
+            break;
+        case 'k':
+            opts.checkpointEvery = std::strtoull(optarg, nullptr, 10);
+            if (opts.checkpointEvery == 0) {
+                std::cerr << "Invalid checkpoint interval: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'r':
+            opts.restorePath = optarg;
+            break;
+        case 'W': {
+            opts.vwapWindows.clear();
+            std::string list{optarg};
+            for (std::size_t pos = 0; pos <= list.size();) {
+                const auto comma = std::min(list.find(',', pos), list.size());
+                const std::string name = list.substr(pos, comma - pos);
+                const std::uint64_t length = parseDuration(name.c_str());
+                if (length == 0) {
+                    std::cerr << "Invalid VWAP window list: " << optarg << '\n';
+                    return false;
+                }
+                opts.vwapWindows.push_back({name, length, RollingVWAP::DEFAULT_BUCKETS});
+                pos = comma + 1;
+            }
+            break;
+        }
+        case 'B': {
+            char* end;
+            opts.boardReaders = std::strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || opts.boardReaders > MAX_SHARDS) {
+                std::cerr << "Invalid board reader count: " << optarg << '\n';
+                return false;
+            }
+            opts.publish = true;
+            break;
+        }
+        case 'M':
+            opts.shmName = optarg;
+            break;
+        case 'J':
+            opts.journalPath = optarg;
+            break;
+        case 'V':
+            if (opts.venuePaths.size() + 1 >= MAX_VENUES) {
+                std::cerr << "Too many venues: at most " << MAX_VENUES << " feeds can be merged\n";
+                return false;
+            }
+            opts.venuePaths.push_back(optarg);
+            break;
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs the single-consumer, sharded or multicast pipeline over `source` as selected by
+ * `opts`, with timestamped slots if latency measurement is on.
+ *
+ * @tparam Slot The element carried by the queues, either `InternedMessage` or
+ * `MessageDescriptor`.
+ * @tparam Wait The wait strategy of every queue.
+ * @return The number of messages processed and the elapsed wall time.
+ */
+template <typename Slot, typename Wait, typename Source>
+RunResult runWithWait(const Options& opts, Source& source, const std::uint64_t maxMessages,
+                      SymbolTable& symbols, MarketState& state) {
+    const auto& cpus = opts.cpus;
+    if (opts.latency) {
+        using TimedSlot = Timestamped<Slot>;
+        if (opts.multicast) {
+            return runMulticastPipeline<TimedSlot, Wait>(source, maxMessages, symbols, state,
+                                                         cpus);
+        }
+        if (opts.shards > 1) {
+            return runShardedPipeline<TimedSlot, Wait>(source, maxMessages, opts.shards, symbols,
+                                                       state, cpus);
+        }
+        return runPipeline<TimedSlot, Wait>(source, maxMessages, symbols, state, cpus,
+                                            opts.conflate);
+    }
+
+    if (opts.multicast) {
+        return runMulticastPipeline<Slot, Wait>(source, maxMessages, symbols, state, cpus);
+    }
+    if (opts.shards > 1) {
+        return runShardedPipeline<Slot, Wait>(source, maxMessages, opts.shards, symbols, state,
+                                              cpus);
+    }
+    return runPipeline<Slot, Wait>(source, maxMessages, symbols, state, cpus, opts.conflate);
+}
+
+/**
+ * @brief Instantiates the pipeline for the wait strategy selected by `opts`.
+ *
+ * @tparam Slot The element carried by the queues, either `InternedMessage` or
+ * `MessageDescriptor`.
+ * @return The number of messages processed and the elapsed wall time.
+ */
+template <typename Slot, typename Source>
+RunResult runFeed(const Options& opts, Source& source, const std::uint64_t maxMessages,
+                  SymbolTable& symbols, MarketState& state) {
+    switch (opts.wait) {
+    case WaitKind::Spin:
+        return runWithWait<Slot, BusySpinWait>(opts, source, maxMessages, symbols, state);
+    case WaitKind::Backoff:
+        return runWithWait<Slot, BackoffWait>(opts, source, maxMessages, symbols, state);
+    case WaitKind::Block:
+        return runWithWait<Slot, FutexWait>(opts, source, maxMessages, symbols, state);
+    case WaitKind::Yield:
+        break;
+    }
+    return runWithWait<Slot, SpinYieldWait>(opts, source, maxMessages, symbols, state);
+}
+
+/**
+ * @brief Reads the feed header of a file feed, if it has one. A header count of 0 means the count
+ * is unknown and the feed is read to its end.
+ *
+ * @return The number of messages to process, or `NO_MESSAGE_LIMIT`. 0 if the feed is empty.
+ */
+template <typename Source> std::uint64_t readMessageLimit(const Options& opts, Source& source) {
+    if (!opts.header) {
+        return NO_MESSAGE_LIMIT;
+    }
+    const std::uint8_t* header = source.peek(sizeof(std::uint64_t));
+    if (header == nullptr) {
+        return 0;
+    }
+
+    std::uint64_t maxMessages;
+    std::memcpy(&maxMessages, header, sizeof(maxMessages));
+    source.consume(sizeof(maxMessages));
+    return maxMessages == 0 ? NO_MESSAGE_LIMIT : maxMessages;
+}
+
+/**
+ * @brief Reports a feed that ended partway through a message or before the message count its
+ * header promised.
+ */
+void warnIfShort(const bool truncated, const std::uint64_t maxMessages,
+                 const std::uint64_t processed) {
+    if (truncated) {
+        std::cerr << "Warning: feed contained a truncated message or an unknown message type\n";
+    } else if (maxMessages != NO_MESSAGE_LIMIT && processed < maxMessages) {
+        std::cerr << "Warning: feed header promised " << maxMessages << " messages, found "
+                  << processed << '\n';
+    }
+}
+
+/**
+ * @brief Runs the pipeline over at most `maxMessages` messages of a mapped feed, or of several
+ * merged ones, passing zero-copy descriptors if `opts` asks for them.
+ *
+ * @return The number of messages processed and the elapsed wall time.
+ */
+template <typename Source>
+RunResult runMapped(const Options& opts, Source& feed, const std::uint64_t maxMessages,
+                    SymbolTable& symbols, MarketState& state) {
+    return opts.zeroCopy ? runFeed<MessageDescriptor>(opts, feed, maxMessages, symbols, state)
+                         : runFeed<InternedMessage>(opts, feed, maxMessages, symbols, state);
+}
+
+/**
+ * @brief Runs at most `maxMessages` messages of `source` through the pipeline, or the parallel
+ * replay if `opts` asks for it, with the `--publish` pollers reading the board meanwhile.
+ * Zero-copy descriptors and parallel replay are only used when `source` keeps every message in
+ * memory.
+ *
+ * @return The number of messages processed and the elapsed wall time.
+ */
+template <typename Source>
+RunResult runSegment(const Options& opts, Source& source, const std::uint64_t maxMessages,
+                     SymbolTable& symbols, MarketState& state) {
+    BoardPollers pollers{state.board, opts.boardReaders};
+    RunResult result;
+    if constexpr (std::is_same_v<Source, MappedFeed>) {
+        std::optional<RunResult> replayed;
+        if (opts.jobs > 1) {
+            replayed = runParallelReplay(source, maxMessages, opts.jobs, symbols, state, opts.cpus);
+            if (!replayed.has_value()) {
+                std::cerr << "Note: the feed has depth or order messages, which need the state "
+                             "before them; replaying sequentially\n";
+            }
+        }
+        result = replayed.has_value() ? *replayed
+                                      : runMapped(opts, source, maxMessages, symbols, state);
+    } else if constexpr (std::is_same_v<Source, FeedMerger>) {
+        result = runMapped(opts, source, maxMessages, symbols, state);
+    } else {
+        result = runFeed<InternedMessage>(opts, source, maxMessages, symbols, state);
+    }
+    result.boardReads = pollers.stop();
+    return result;
+}
+
+/**
+ * @brief Writes the book, tracker and resting order state to the `--snapshot` file. A failed
+ * write is reported and processing carries on, since the previous snapshot is still intact.
+ */
+void writeCheckpoint(const Options& opts, const FeedPosition& position, const SymbolTable& symbols,
+                     const MarketState& state) {
+    if (writeSnapshot(opts.snapshotPath, symbols, state.book, state.vwapTracker, state.orders,
+                      position) == -1) {
+        perror("snapshot");
+    }
+}
+
+/**
+ * @brief Processes at most `maxMessages` messages of `source`, writing a snapshot every
+ * `opts.checkpointEvery` messages and at the end if `--snapshot` is given, and reports a feed that
+ * was cut short.
+ *
+ * Checkpoints are taken between pipeline runs rather than from the consumer thread, since the
+ * producer interns into the symbol table while the consumer applies messages. Each run drains its
+ * queues before returning, so the state matches the feed position exactly.
+ *
+ * @param origin The position of the first byte of `source` in the feed file and the number of
+ * messages processed before it, added to the position recorded in snapshots.
+ * @return The number of messages processed and the elapsed wall time, excluding snapshot writes.
+ */
+template <typename Source>
+RunResult runSource(const Options& opts, Source& source, const std::uint64_t maxMessages,
+                    const FeedPosition& origin, SymbolTable& symbols, MarketState& state) {
+    const std::uint64_t segment = opts.checkpointEvery == 0 ? maxMessages : opts.checkpointEvery;
+    const auto positionAfter = [&](const std::uint64_t processed) {
+        return FeedPosition{origin.offset + source.offset(), origin.messages + processed};
+    };
+
+    RunResult total{0, 0.0};
+    while (total.messages < maxMessages) {
+        const auto wanted = std::min(segment, maxMessages - total.messages);
+        const auto result = runSegment(opts, source, wanted, symbols, state);
+        total.messages += result.messages;
+        total.elapsedMs += result.elapsedMs;
+        total.conflated += result.conflated;
+        total.boardReads += result.boardReads;
+        if (result.messages < wanted) { /// the feed ended
+            break;
+        }
+        if (total.messages < maxMessages) {
+            writeCheckpoint(opts, positionAfter(total.messages), symbols, state);
+        }
+    }
+    if (opts.snapshotPath != nullptr) {
+        writeCheckpoint(opts, positionAfter(total.messages), symbols, state);
+    }
+
+    warnIfShort(source.truncated(), maxMessages, total.messages);
+    return total;
+}
+
 /**
  * @brief Helper function to hold all end-of-execution output logic.
  *
- * @param book The orderbook used in execution.
- * @param vwap The VWAP tracker used in execution.
- * @param totalMessages The total count of messages processed.
- * @param elapsedMs The time from start of execution to end of execution.
+ * @param state The book, tracker and latency state after execution.
+ * @param result The count of messages processed and the time from start to end of execution.
+ * @param tscTicksPerNs The calibrated TSC rate if latency was measured, otherwise 0.
  */
-void printResults(const OrderBook& book, const VWAPTracker& vwap, std::uint64_t totalMessages,
-                  double elapsedMs) {
-    book.showState();
-    vwap.showStats();
+void printResults(const MarketState& state, const RunResult& result, double tscTicksPerNs) {
+    state.book.showState();
+    if (state.book.venues() != 0) {
+        state.book.showNbbo();
+    }
+    state.vwapTracker.showStats();
+    if (!state.rollingVwap.windows().empty()) {
+        state.rollingVwap.showStats(state.rollingVwap.latestTimestamp());
+    }
 
+    const auto totalMessages = result.messages;
+    const auto elapsedMs = result.elapsedMs;
     std::cout << "\n=== Performance Metrics ===\n";
     std::cout << "Total messages processed: " << totalMessages << '\n';
     std::cout << "Processing time: " << std::fixed << std::setprecision(2) << elapsedMs << " ms\n";
@@ -41,6 +603,112 @@ void printResults(const OrderBook& book, const VWAPTracker& vwap, std::uint64_t
     double latency_us = (elapsedMs * 1000.0) / totalMessages;
     std::cout << "Average latency per message: " << std::fixed << std::setprecision(2) << latency_us
               << " μs\n";
+
+    if (result.conflated > 0) {
+        std::cout << "Quotes conflated: " << result.conflated << " ("
+                  << std::setprecision(2) << 100.0 * result.conflated / totalMessages
+                  << "% of messages)\n";
+    }
+
+    if (state.shmOut != nullptr) {
+        std::cout << "Shared memory queue: " << totalMessages - state.shmDropped
+                  << " messages forwarded";
+        if (state.shmDropped > 0) {
+            std::cout << ", " << state.shmDropped << " dropped with no reader attached";
+        }
+        std::cout << '\n';
+    }
+
+    if (state.board != nullptr) {
+        std::cout << "Quote board: " << state.board->size() << " symbols published";
+        if (state.unpublished > 0) {
+            std::cout << ", " << state.unpublished << " left off (board full)";
+        }
+        std::cout << ", " << result.boardReads << " snapshots read by pollers\n";
+    }
+
+    if (state.journal != nullptr) {
+        std::cout << "Journal: " << state.journalSequence << " records written\n";
+    }
+
+    if (const auto* hugePages = dynamic_cast<const HugePageResource*>(state.memory)) {
+        constexpr double MIB = 1 << 20;
+        std::cout << "Huge page storage (peak): " << std::setprecision(0)
+                  << hugePages->peakHugeTlbBytes() / MIB << " MiB explicit, "
+                  << hugePages->peakTransparentBytes() / MIB << " MiB transparent\n";
+    }
+
+    if (tscTicksPerNs > 0) {
+        state.latency.showStats(tscTicksPerNs);
+    }
+}
+
+/**
+ * @brief Prints the delivery statistics of a UDP feed.
+ */
+void printUdpStats(const UdpFeed& feed) {
+    std::cout << "\n=== UDP Feed ===\n";
+    std::cout << "Datagrams received: " << feed.datagrams() << '\n';
+    std::cout << "Sequence gaps: " << feed.gaps() << " (" << feed.missedMessages()
+              << " messages missed)\n";
+    std::cout << "Duplicate datagrams: " << feed.duplicates() << '\n';
+    if (feed.timedOut()) {
+        std::cout << "Ended on idle timeout, no end-of-session packet received\n";
+    }
+}
+
+/**
+ * @brief Prints how many messages each venue contributed to a merged feed.
+ *
+ * @param paths The feed file of each venue after the first, which is read from stdin.
+ */
+void printMergeStats(const FeedMerger& merger, const std::vector<const char*>& paths) {
+    std::cout << "\n=== Merged Venues ===\n";
+    for (std::size_t venue = 0; venue < merger.inputs(); ++venue) {
+        std::cout << "Venue " << venue << " (" << (venue == 0 ? "stdin" : paths[venue - 1])
+                  << "): " << merger.merged(static_cast<VenueId>(venue)) << " messages\n";
+    }
+}
+
+/**
+ * @brief A feed file mapped for `--venue`.
+ */
+struct MappedFile {
+    const std::uint8_t* data{nullptr};
+    std::size_t size{0};
+};
+
+/**
+ * @brief Maps the whole feed file at `path` for sequential reading, faulting it in up front if
+ * `prefault` is set.
+ *
+ * @return 0 on success, or -1 with `errno` set.
+ */
+int mapFeedFile(const char* path, const bool prefault, MappedFile& out) {
+    const int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ,
+                        prefault ? MAP_PRIVATE | MAP_POPULATE : MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+    madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+    out.data = static_cast<const std::uint8_t*>(mapped);
+    out.size = static_cast<std::size_t>(st.st_size);
+    return 0;
 }
 
 /**
@@ -48,13 +716,164 @@ void printResults(const OrderBook& book, const VWAPTracker& vwap, std::uint64_t
  * data and processing that data by maintaining an in-memory copy of the Orderbook and relevant
  * statistics used in trading strategies. Data is processed in little-endian format and inserted
  * into a lock-free queue by a single producer thread, and a single consumer thread dequeues the
- * messages and updates the in-memory data structures accordingly.
+ * messages and updates the in-memory data structures accordingly. With `--shards N` the producer
+ * instead routes messages by symbol to N consumers, each with its own book and tracker. Regular
+ * files are mapped whole; pipes (or any input with `--stream`) are read in chunks, so captures of
+ * any size can be replayed through e.g. `zcat feed.bin.gz | main.out`. With `--udp PORT` the feed
+ * is received as sequenced datagrams instead, e.g. from `udp_sender.out`. With `--venue FILE` the
+ * feed on stdin is merged by timestamp with the feeds of other venues, e.g. captures of the same
+ * instruments from several exchanges.
  */
-int main() {
-    SPSCQueue<MarketDataMessage, 8192> queue;
-    OrderBook book;
-    VWAPTracker vwapTracker;
-    std::uint8_t* bufferPtr;
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+
+    if (opts.jobs > 1 && opts.shards > 1) {
+        std::cerr << "--jobs replays chunks on threads of its own, so it cannot take --shards\n";
+        return 1;
+    }
+    if (opts.jobs > 1 && opts.latency) {
+        std::cerr << "--latency measures the queue pipeline, which --jobs does not use\n";
+        return 1;
+    }
+    if (opts.conflate && (opts.shards > 1 || opts.jobs > 1)) {
+        std::cerr << "--conflate applies to the single consumer pipeline, not --shards or --jobs\n";
+        return 1;
+    }
+    if (opts.shmName != nullptr && (opts.shards > 1 || opts.jobs > 1)) {
+        std::cerr << "--shm forwards from the single consumer pipeline, not --shards or --jobs\n";
+        return 1;
+    }
+    if (opts.journalPath != nullptr && (opts.shards > 1 || opts.jobs > 1)) {
+        std::cerr << "--journal records the single consumer pipeline, not --shards or --jobs\n";
+        return 1;
+    }
+    if (opts.publish && opts.jobs > 1) {
+        std::cerr << "--publish needs the queue pipeline; --jobs builds private per-chunk state\n";
+        return 1;
+    }
+    if (opts.multicast && (opts.shards > 1 || opts.jobs > 1 || opts.conflate || opts.publish ||
+                           opts.journalPath != nullptr)) {
+        std::cerr << "--multicast splits each message across threads, so it cannot be combined "
+                     "with --shards, --jobs, --conflate, --publish or --journal\n";
+        return 1;
+    }
+    if (opts.checkpointEvery != 0 && opts.snapshotPath == nullptr) {
+        std::cerr << "--checkpoint-every needs a --snapshot file to write\n";
+        return 1;
+    }
+    if (!opts.venuePaths.empty() &&
+        (opts.udpPort != 0 || opts.stream || opts.jobs > 1 || opts.conflate ||
+         opts.snapshotPath != nullptr || opts.restorePath != nullptr)) {
+        std::cerr << "--venue merges mapped feed files, so it cannot be combined with --udp, "
+                     "--stream, --jobs, --conflate, --snapshot or --restore\n";
+        return 1;
+    }
+    if ((opts.checkpointEvery != 0 || opts.restorePath != nullptr) && opts.shards > 1) {
+        std::cerr << "--checkpoint-every and --restore need the single consumer pipeline, whose "
+                     "state carries over between runs\n";
+        return 1;
+    }
+
+    HugePageResource hugePages;
+    SymbolTable symbols;
+    MarketState state{symbols, opts.hugePages ? &hugePages : std::pmr::get_default_resource(),
+                      opts.vwapWindows};
+    if (!opts.venuePaths.empty()) {
+        state.book.trackVenues(opts.venuePaths.size() + 1);
+    }
+    const double tscTicksPerNs = opts.latency ? calibrateTscTicksPerNs() : 0.0;
+
+    std::unique_ptr<ShmSPSCQueue<MarketDataMessage>> shmOut;
+    if (opts.shmName != nullptr) {
+        shmOut = ShmSPSCQueue<MarketDataMessage>::create(opts.shmName, SHM_QUEUE_SIZE,
+                                                         ShmRole::Producer);
+        if (shmOut == nullptr) {
+            perror("shm");
+            return 1;
+        }
+        state.shmOut = shmOut.get();
+    }
+
+    JournalWriter journalWriter;
+    std::unique_ptr<JournalRecorder> journal;
+    if (opts.journalPath != nullptr) {
+        if (journalWriter.open(opts.journalPath) == -1) {
+            perror("journal");
+            return 1;
+        }
+        journal = std::make_unique<JournalRecorder>(journalWriter);
+        state.journal = journal.get();
+    }
+    /// Writes out the rest of the journal before the results report its record count.
+    const auto closeJournal = [&journal, &journalWriter]() {
+        if (journal == nullptr) {
+            return true;
+        }
+        const int err = journal->stop();
+        if (err != 0) {
+            errno = err;
+            perror("journal");
+            return false;
+        }
+        if (journalWriter.close() == -1) {
+            perror("journal");
+            return false;
+        }
+        return true;
+    };
+
+    std::unique_ptr<QuoteBoard> board;
+    if (opts.publish) {
+        board = std::make_unique<QuoteBoard>(BOARD_CAPACITY);
+        state.board = board.get();
+    }
+
+    FeedPosition restored;
+    if (opts.restorePath != nullptr) {
+        if (opts.udpPort != 0) {
+            std::cerr << "--restore needs a feed file on stdin, not a UDP feed\n";
+            return 1;
+        }
+        if (readSnapshot(opts.restorePath, symbols, state.book, state.vwapTracker, state.orders,
+                         restored) == -1) {
+            perror("restore");
+            return 1;
+        }
+        std::cerr << "Restored state after " << restored.messages << " messages, resuming at byte "
+                  << restored.offset << '\n';
+    }
+
+    if (opts.udpPort != 0) {
+        if (opts.zeroCopy || opts.jobs > 1 || opts.snapshotPath != nullptr) {
+            std::cerr << "--zero-copy, --jobs and --snapshot need a regular file on stdin, not a "
+                         "UDP feed\n";
+            return 1;
+        }
+
+        const int fd = openUdpSocket("0.0.0.0", opts.udpPort);
+        if (fd == -1) {
+            perror("socket");
+            return 1;
+        }
+        UdpFeed feed{fd, opts.busyPoll};
+        const auto result = runSegment(opts, feed, NO_MESSAGE_LIMIT, symbols, state);
+        warnIfShort(feed.truncated(), NO_MESSAGE_LIMIT, result.messages);
+        close(fd);
+        if (feed.error() != 0) {
+            errno = feed.error();
+            perror("recvmmsg");
+            return 1;
+        }
+        if (!closeJournal()) {
+            return 1;
+        }
+        printResults(state, result, tscTicksPerNs);
+        printUdpStats(feed);
+        return 0;
+    }
 
     if (freopen(nullptr, "rb", stdin) == NULL) {
         perror("freopen");
@@ -73,75 +892,173 @@ int main() {
         return 1;
     }
 
-    void* mappedData = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FD, 0);
-    if (mappedData == MAP_FAILED) {
-        perror("mmap");
+    std::uint64_t magic = 0;
+    const bool compact = S_ISREG(st.st_mode) &&
+                         pread(STDIN_FD, &magic, sizeof(magic), 0) == sizeof(magic) &&
+                         magic == COMPACT_MAGIC;
+    if (opts.restorePath != nullptr &&
+        (!S_ISREG(st.st_mode) ||
+         (!compact && restored.offset > static_cast<std::uint64_t>(st.st_size)))) {
+        std::cerr << "--restore needs the feed file the snapshot was taken from on stdin\n";
         return 1;
     }
 
-    bufferPtr = static_cast<std::uint8_t*>(mappedData);
-    const std::uint64_t numExpectedMessages{*reinterpret_cast<std::uint64_t*>(bufferPtr)};
-    bufferPtr += sizeof(std::uint64_t);
+    /// The message limit of a resumed run is what the header promised less what the snapshot
+    /// already covers.
+    const auto resumeLimit = [&restored](const std::uint64_t maxMessages) {
+        if (maxMessages == NO_MESSAGE_LIMIT) {
+            return maxMessages;
+        }
+        return maxMessages - std::min(maxMessages, restored.messages);
+    };
+
+    if (!opts.venuePaths.empty() && (compact || !S_ISREG(st.st_mode))) {
+        std::cerr << "--venue needs a raw feed file on stdin to merge with, not a pipe or a "
+                     "compact feed\n";
+        return 1;
+    }
 
-    const auto producerFunctor = [&queue, &bufferPtr](const std::uint64_t numExpectedMessages) {
-        MarketDataMessage msg;
-        std::uint8_t type;
+    if (compact && (opts.stream || opts.zeroCopy || opts.jobs > 1 || !opts.header)) {
+        std::cerr << "--stream, --zero-copy, --jobs and --no-header need a raw feed, not a "
+                     "compact one\n";
+        return 1;
+    }
 
-        for (std::uint64_t i = 0; i < numExpectedMessages; ++i) {
-            if (i + 1 < numExpectedMessages) {
-                __builtin_prefetch(bufferPtr + 64, 0, 3);
-            }
-            type = *bufferPtr;
+    if (opts.stream || !S_ISREG(st.st_mode)) {
+        if (opts.zeroCopy || opts.jobs > 1) {
+            std::cerr << "--zero-copy and --jobs need a regular file on stdin and cannot be "
+                         "streamed\n";
+            return 1;
+        }
 
-            if (static_cast<MessageType>(type) == MessageType::Trade) {
-                std::memcpy(&msg.trade, bufferPtr, sizeof(TradeMessage));
-                bufferPtr += sizeof(TradeMessage);
-            } else {
-                std::memcpy(&msg.quote, bufferPtr, sizeof(QuoteMessage));
-                bufferPtr += sizeof(QuoteMessage);
+        std::uint64_t maxMessages = NO_MESSAGE_LIMIT;
+        if (opts.restorePath != nullptr) { /// read the header in place, then skip what's restored
+            std::uint64_t count = 0;
+            if (opts.header && pread(STDIN_FD, &count, sizeof(count), 0) == sizeof(count) &&
+                count != 0) {
+                maxMessages = resumeLimit(count);
             }
-            while (!queue.enqueue(msg)) {
-                std::this_thread::yield();
+            if (lseek(STDIN_FD, static_cast<off_t>(restored.offset), SEEK_SET) == -1) {
+                perror("lseek");
+                return 1;
             }
         }
-    };
 
-    const auto consumerFunctor = [&queue, &book,
-                                  &vwapTracker](const std::uint64_t numExpectedMessages) {
-        MarketDataMessage currentMsg;
-        std::uint64_t processedCount{0};
-
-        while (processedCount < numExpectedMessages) {
-            if (queue.dequeue(currentMsg)) {
-                if (currentMsg.type == MessageType::Trade) {
-                    vwapTracker.upsertVWAP(currentMsg.trade.symbol, currentMsg.trade);
-                } else {
-                    book.upsertEntry(currentMsg.quote.symbol, currentMsg.quote);
-                }
-                ++processedCount;
-            } else { /// SPSCQueue::dequeue is empty, wait for producer to enqueue
-                std::this_thread::yield();
+        StreamReader reader{STDIN_FD};
+        if (opts.restorePath == nullptr) {
+            const std::uint8_t* start = reader.peek(sizeof(std::uint64_t));
+            if (start != nullptr && CompactFeed::matches(start, sizeof(std::uint64_t))) {
+                std::cerr << "Compact feeds are decoded from a mapping: redirect the file to "
+                             "stdin instead of piping it\n";
+                return 1;
             }
+            maxMessages = readMessageLimit(opts, reader);
         }
-        return;
-    };
-
-    auto start = std::chrono::high_resolution_clock::now();
+        const auto result = runSource(opts, reader, maxMessages, restored, symbols, state);
+        if (reader.error() != 0) {
+            errno = reader.error();
+            perror("read");
+            return 1;
+        }
+        if (!closeJournal()) {
+            return 1;
+        }
+        printResults(state, result, tscTicksPerNs);
+        return 0;
+    }
 
-    std::thread producer(producerFunctor, numExpectedMessages);
-    std::thread consumer(consumerFunctor, numExpectedMessages);
+    const int mapFlags = opts.prefault ? MAP_PRIVATE | MAP_POPULATE : MAP_PRIVATE;
+    void* mappedData = mmap(nullptr, st.st_size, PROT_READ, mapFlags, STDIN_FD, 0);
+    if (mappedData == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    madvise(mappedData, st.st_size, MADV_SEQUENTIAL);
+    if (opts.prefault) { /// huge pages only apply where the filesystem supports them
+        madvise(mappedData, st.st_size, MADV_HUGEPAGE);
+    }
 
-    producer.join();
-    consumer.join();
+    /// Both feeds count offsets from the start of the raw feed, so only the message count of a
+    /// restored run carries over
+    const FeedPosition origin{0, restored.messages};
+    RunResult result;
+    std::vector<MappedFile> venueFiles;
+    std::unique_ptr<FeedMerger> merger;
+    if (!opts.venuePaths.empty()) {
+        /// every venue's feed is mapped and read up to its own header count
+        std::vector<MergeInput> inputs;
+        MappedFeed first{static_cast<const std::uint8_t*>(mappedData),
+                         static_cast<std::size_t>(st.st_size)};
+        const auto firstLimit = readMessageLimit(opts, first);
+        inputs.push_back({first, firstLimit});
+        for (const char* path : opts.venuePaths) {
+            MappedFile file;
+            if (mapFeedFile(path, opts.prefault, file) == -1) {
+                perror(path);
+                return 1;
+            }
+            venueFiles.push_back(file);
+            if (CompactFeed::matches(file.data, file.size)) {
+                std::cerr << path << ": --venue needs raw feed files, not compact ones\n";
+                return 1;
+            }
+            MappedFeed feed{file.data, file.size};
+            const auto limit = readMessageLimit(opts, feed);
+            inputs.push_back({feed, limit});
+        }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> duration = end - start;
-    printResults(book, vwapTracker, numExpectedMessages, duration.count());
+        std::uint64_t maxMessages = 0;
+        for (const auto& input : inputs) {
+            if (input.maxMessages == NO_MESSAGE_LIMIT) {
+                maxMessages = NO_MESSAGE_LIMIT;
+                break;
+            }
+            maxMessages += input.maxMessages;
+        }
+        merger = std::make_unique<FeedMerger>(std::move(inputs));
+        result = runSource(opts, *merger, maxMessages, origin, symbols, state);
+    } else if (compact) {
+        CompactFeed feed;
+        if (feed.open(static_cast<const std::uint8_t*>(mappedData),
+                      static_cast<std::size_t>(st.st_size)) == -1) {
+            perror("compact feed");
+            return 1;
+        }
+        if (!feed.seekToMessage(restored.messages) ||
+            (opts.restorePath != nullptr && feed.offset() != restored.offset)) {
+            std::cerr << "--restore needs the feed the snapshot was taken from on stdin\n";
+            return 1;
+        }
+        const auto maxMessages = feed.size() - restored.messages;
+        result = runSource(opts, feed, maxMessages, origin, symbols, state);
+    } else {
+        MappedFeed feed{static_cast<const std::uint8_t*>(mappedData),
+                        static_cast<std::size_t>(st.st_size)};
+        auto maxMessages = readMessageLimit(opts, feed);
+        if (opts.restorePath != nullptr) {
+            maxMessages = resumeLimit(maxMessages);
+            feed.consume(restored.offset - std::min(restored.offset, feed.offset()));
+        }
+        result = runSource(opts, feed, maxMessages, origin, symbols, state);
+    }
+    if (!closeJournal()) {
+        return 1;
+    }
+    printResults(state, result, tscTicksPerNs);
+    if (merger != nullptr) {
+        printMergeStats(*merger, opts.venuePaths);
+    }
 
     if (munmap(mappedData, st.st_size)) {
         perror("munmap");
         return 1;
     }
+    for (const auto& file : venueFiles) {
+        if (munmap(const_cast<std::uint8_t*>(file.data), file.size)) {
+            perror("munmap");
+            return 1;
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,103 @@
+#include "memory/huge_page_resource.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Rounds `bytes` up to a whole number of huge pages.
+ */
+static std::size_t mappedSize(const std::size_t bytes) {
+    return (bytes + HugePageResource::HUGE_PAGE_SIZE - 1) & ~(HugePageResource::HUGE_PAGE_SIZE - 1);
+}
+
+/**
+ * @brief Writes to every base page of `[data, data + size)` so the faults happen now.
+ */
+static void prefault(void* data, const std::size_t size) {
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto* bytes = static_cast<volatile std::uint8_t*>(data);
+    for (std::size_t offset = 0; offset < size; offset += pageSize) {
+        bytes[offset] = 0;
+    }
+}
+
+void* HugePageResource::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+    if (bytes < MIN_MAPPED_SIZE || alignment > HUGE_PAGE_SIZE) {
+        return upstream_->allocate(bytes, std::max(alignment, CACHE_LINE_SIZE));
+    }
+
+    const auto size = mappedSize(bytes);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if (data != MAP_FAILED) {
+        {
+            const std::lock_guard<std::mutex> lock{mappingsMutex_};
+            hugeTlbMappings_.insert(data);
+        }
+        count(hugeTlbBytes_, peakHugeTlbBytes_, size);
+        return data;
+    }
+
+    data = mapAligned(size);
+    if (data == nullptr) {
+        throw std::bad_alloc{};
+    }
+    madvise(data, size, MADV_HUGEPAGE); /// only a hint, THP may be disabled
+    prefault(data, size);
+    count(transparentBytes_, peakTransparentBytes_, size);
+    return data;
+}
+
+void HugePageResource::do_deallocate(void* p, const std::size_t bytes,
+                                     const std::size_t alignment) {
+    if (bytes < MIN_MAPPED_SIZE || alignment > HUGE_PAGE_SIZE) {
+        upstream_->deallocate(p, bytes, std::max(alignment, CACHE_LINE_SIZE));
+        return;
+    }
+
+    const auto size = mappedSize(bytes);
+    bool hugeTlb;
+    {
+        const std::lock_guard<std::mutex> lock{mappingsMutex_};
+        hugeTlb = hugeTlbMappings_.erase(p) > 0;
+    }
+    munmap(p, size);
+    (hugeTlb ? hugeTlbBytes_ : transparentBytes_).fetch_sub(size, std::memory_order_relaxed);
+}
+
+bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void* HugePageResource::mapAligned(const std::size_t size) {
+    /// Over-map by one huge page and trim both ends to a huge page boundary.
+    const auto padded = size + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const auto start = reinterpret_cast<std::uintptr_t>(raw);
+    const auto aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    const auto tail = start + padded - (aligned + size);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+void HugePageResource::count(std::atomic<std::size_t>& bytes, std::atomic<std::size_t>& peak,
+                             const std::size_t size) {
+    const auto now = bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto previous = peak.load(std::memory_order_relaxed);
+    while (previous < now &&
+           !peak.compare_exchange_weak(previous, now, std::memory_order_relaxed)) {
+    }
+}
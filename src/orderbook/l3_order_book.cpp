@@ -0,0 +1,222 @@
+#include <algorithm>
+
+#include "orderbook/l3_order_book.hpp"
+
+L3OrderBook::L3OrderBook(SymbolTable& symbols, OrderBook& book, VWAPTracker& vwap,
+                         std::size_t expectedOrders, std::size_t expectedSymbols,
+                         std::size_t levelsPerSymbol)
+    : symbols_{symbols}, book_{book}, vwap_{vwap}, orders_{expectedOrders},
+      levels_{expectedOrders}, orderIndex_{expectedOrders}, levelsPerSymbol_{levelsPerSymbol} {
+    levelIndex_.reserve(expectedSymbols);
+    for (std::size_t i = 0; i < expectedSymbols; ++i) {
+        levelIndex_.emplace_back(levelsPerSymbol_);
+    }
+}
+
+void L3OrderBook::addOrder(const AddOrderMessage& msg) {
+    addOrderById(symbols_.intern(msg.symbol), msg);
+}
+
+void L3OrderBook::addOrderById(const SymbolId id, const AddOrderMessage& msg) {
+    if (msg.orderId == INVALID_ORDER_ID) {
+        ++rejected_;
+        return;
+    }
+    const auto orderIdx = insertOrder(id, msg.orderId, msg.side, msg.price, msg.quantity);
+    if (orderIdx != IndexPool<Order>::NONE) {
+        appendToLevel(orderIdx, msg.timestamp);
+    }
+}
+
+void L3OrderBook::restoreOrderById(const SymbolId id, const std::uint64_t orderId,
+                                   const Side side, const std::uint64_t price,
+                                   const std::uint32_t quantity) {
+    if (orderId == INVALID_ORDER_ID) {
+        return;
+    }
+    const auto orderIdx = insertOrder(id, orderId, side, price, quantity);
+    if (orderIdx != IndexPool<Order>::NONE) {
+        appendToLevel(orderIdx, 0, false);
+    }
+}
+
+void L3OrderBook::modifyOrder(const ModifyOrderMessage& msg) {
+    if (msg.orderId == INVALID_ORDER_ID) {
+        ++rejected_;
+        return;
+    }
+    const std::uint32_t* slot = orderIndex_.find(msg.orderId);
+    if (slot == nullptr) {
+        return;
+    }
+    const auto orderIdx = *slot;
+    Order& order = orders_[orderIdx];
+
+    if (msg.quantity == 0) {
+        removeOrder(orderIdx, msg.timestamp);
+        return;
+    }
+
+    if (msg.price == order.price && msg.quantity <= order.quantity) { /// keeps queue position
+        Level& level = levels_[order.level];
+        level.quantity -= order.quantity - msg.quantity;
+        order.quantity = msg.quantity;
+        book_.setLevelById(order.symbolId, order.side, order.price, level.quantity, msg.timestamp);
+        return;
+    }
+
+    removeFromLevel(orderIdx, msg.timestamp);
+    order.price = msg.price;
+    order.quantity = msg.quantity;
+    appendToLevel(orderIdx, msg.timestamp);
+}
+
+void L3OrderBook::cancelOrder(const CancelOrderMessage& msg) {
+    if (msg.orderId == INVALID_ORDER_ID) {
+        ++rejected_;
+        return;
+    }
+    const std::uint32_t* slot = orderIndex_.find(msg.orderId);
+    if (slot == nullptr) {
+        return;
+    }
+    removeOrder(*slot, msg.timestamp);
+}
+
+void L3OrderBook::executeOrder(const ExecuteOrderMessage& msg) {
+    if (msg.orderId == INVALID_ORDER_ID) {
+        ++rejected_;
+        return;
+    }
+    const std::uint32_t* slot = orderIndex_.find(msg.orderId);
+    if (slot == nullptr) {
+        return;
+    }
+    const auto orderIdx = *slot;
+    Order& order = orders_[orderIdx];
+    const auto executed = std::min(msg.quantity, order.quantity);
+
+    const TradeMessage trade{MessageType::Trade, msg.timestamp, msg.symbol, order.price, executed,
+                             {0, 0, 0}};
+    vwap_.upsertVWAPById(order.symbolId, trade);
+
+    if (executed == order.quantity) {
+        removeOrder(orderIdx, msg.timestamp);
+        return;
+    }
+    Level& level = levels_[order.level];
+    level.quantity -= executed;
+    order.quantity -= executed;
+    book_.setLevelById(order.symbolId, order.side, order.price, level.quantity, msg.timestamp);
+}
+
+auto L3OrderBook::getOrder(const std::uint64_t orderId) const -> std::optional<Order> {
+    const std::uint32_t* slot = orderIndex_.find(orderId);
+    if (slot == nullptr) {
+        return std::nullopt;
+    }
+    return orders_[*slot];
+}
+
+std::size_t L3OrderBook::ordersAt(const SymbolId id, const Side side, const std::uint64_t price,
+                                  std::uint64_t* orderIds, const std::size_t maxOrders) const {
+    if (id >= levelIndex_.size()) {
+        return 0;
+    }
+    const std::uint32_t* levelIdx = levelIndex_[id].find(levelKey(side, price));
+    if (levelIdx == nullptr) {
+        return 0;
+    }
+
+    std::size_t count = 0;
+    auto orderIdx = levels_[*levelIdx].head;
+    while (orderIdx != IndexPool<Order>::NONE && count < maxOrders) {
+        orderIds[count++] = orders_[orderIdx].orderId;
+        orderIdx = orders_[orderIdx].next;
+    }
+    return count;
+}
+
+std::uint32_t L3OrderBook::insertOrder(const SymbolId id, const std::uint64_t orderId,
+                                       const Side side, const std::uint64_t price,
+                                       const std::uint32_t quantity) {
+    auto [slot, inserted] = orderIndex_.tryEmplace(orderId);
+    if (!inserted) {
+        return IndexPool<Order>::NONE;
+    }
+    const auto orderIdx = orders_.acquire();
+    *slot = orderIdx;
+
+    Order& order = orders_[orderIdx];
+    order.orderId = orderId;
+    order.price = price;
+    order.quantity = quantity;
+    order.symbolId = id;
+    order.side = side;
+    return orderIdx;
+}
+
+void L3OrderBook::appendToLevel(const std::uint32_t orderIdx, const std::uint64_t timestamp,
+                                const bool publish) {
+    Order& order = orders_[orderIdx];
+    if (order.symbolId >= levelIndex_.size()) { /// beyond the expected symbols
+        const auto size = std::max<std::size_t>(order.symbolId + 1, levelIndex_.size() * 2);
+        levelIndex_.reserve(size);
+        while (levelIndex_.size() < size) {
+            levelIndex_.emplace_back(levelsPerSymbol_);
+        }
+    }
+
+    auto [levelSlot, inserted] =
+        levelIndex_[order.symbolId].tryEmplace(levelKey(order.side, order.price));
+    if (inserted) {
+        *levelSlot = levels_.acquire();
+        levels_[*levelSlot] = {IndexPool<Order>::NONE, IndexPool<Order>::NONE, 0};
+    }
+    const auto levelIdx = *levelSlot;
+    Level& level = levels_[levelIdx];
+
+    order.level = levelIdx;
+    order.prev = level.tail;
+    order.next = IndexPool<Order>::NONE;
+    if (level.tail == IndexPool<Order>::NONE) {
+        level.head = orderIdx;
+    } else {
+        orders_[level.tail].next = orderIdx;
+    }
+    level.tail = orderIdx;
+    level.quantity += order.quantity;
+
+    if (publish) {
+        book_.setLevelById(order.symbolId, order.side, order.price, level.quantity, timestamp);
+    }
+}
+
+void L3OrderBook::removeFromLevel(const std::uint32_t orderIdx, const std::uint64_t timestamp) {
+    const Order& order = orders_[orderIdx];
+    Level& level = levels_[order.level];
+
+    if (order.prev == IndexPool<Order>::NONE) {
+        level.head = order.next;
+    } else {
+        orders_[order.prev].next = order.next;
+    }
+    if (order.next == IndexPool<Order>::NONE) {
+        level.tail = order.prev;
+    } else {
+        orders_[order.next].prev = order.prev;
+    }
+    level.quantity -= order.quantity;
+
+    book_.setLevelById(order.symbolId, order.side, order.price, level.quantity, timestamp);
+    if (level.head == IndexPool<Order>::NONE) {
+        levelIndex_[order.symbolId].erase(levelKey(order.side, order.price));
+        levels_.release(order.level);
+    }
+}
+
+void L3OrderBook::removeOrder(const std::uint32_t orderIdx, const std::uint64_t timestamp) {
+    removeFromLevel(orderIdx, timestamp);
+    orderIndex_.erase(orders_[orderIdx].orderId);
+    orders_.release(orderIdx);
+}
@@ -1,24 +1,296 @@
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 
 #include "orderbook/orderbook.hpp"
 
-auto OrderBook::getEntry(const std::uint64_t key) const -> std::optional<const OrderBookEntry*> {
-    auto it = book_.find(key);
-    if (it == book_.end()) {
+/**
+ * @brief Returns `true` if price `a` is better than price `b` on `side`: a higher bid or a lower
+ * ask. A price of 0 means no order on that side and is worse than any price.
+ */
+static bool isBetter(const Side side, const std::uint64_t a, const std::uint64_t b) {
+    if (side == Side::Bid) {
+        return a > b;
+    }
+    return a != 0 && (b == 0 || a < b);
+}
+
+/**
+ * @brief Moves one side of an NBBO for a venue whose price on that side went from where it was to
+ * `price`, with `quantity` at it.
+ *
+ * @param best, total, atBest The side's best price, the quantity at it across venues and the mask
+ * of venues at it.
+ * @param bit The venue's bit in the masks.
+ * @param oldQuantity The venue's quantity before the quote, counted in `total` if it was at best.
+ * @return `false` if the venue was alone at the best price and left it, so the side has to be
+ * rebuilt from every venue.
+ */
+static bool moveSide(const Side side, std::uint64_t& best, std::uint32_t& total,
+                     std::uint16_t& atBest, const std::uint16_t bit,
+                     const std::uint32_t oldQuantity, const std::uint64_t price,
+                     const std::uint32_t quantity) {
+    const bool wasAtBest = (atBest & bit) != 0;
+    if (isBetter(side, price, best)) {
+        best = price;
+        total = quantity;
+        atBest = bit;
+        return true;
+    }
+    if (price == best && price != 0) {
+        total += quantity - (wasAtBest ? oldQuantity : 0);
+        atBest |= bit;
+        return true;
+    }
+    if (!wasAtBest) {
+        return true;
+    }
+    total -= oldQuantity;
+    atBest &= static_cast<std::uint16_t>(~bit);
+    return atBest != 0;
+}
+
+OrderBook::OrderBook(std::size_t expectedSymbols, std::pmr::memory_resource* memory)
+    : ownedSymbols_{std::make_unique<SymbolTable>(expectedSymbols)}, symbols_{ownedSymbols_.get()},
+      present_{memory}, updatedAt_{memory}, bidPrice_{memory}, askPrice_{memory},
+      bidQuantity_{memory}, askQuantity_{memory}, ladders_{memory}, venueQuotes_{memory},
+      nbbo_{memory} {
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+OrderBook::OrderBook(SymbolTable& symbols, std::size_t expectedSymbols,
+                     std::pmr::memory_resource* memory)
+    : symbols_{&symbols}, present_{memory}, updatedAt_{memory}, bidPrice_{memory},
+      askPrice_{memory}, bidQuantity_{memory}, askQuantity_{memory}, ladders_{memory},
+      venueQuotes_{memory}, nbbo_{memory} {
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+auto OrderBook::getEntry(const std::uint64_t key) const -> std::optional<OrderBookEntry> {
+    const auto id = symbols_->find(key);
+    if (!id.has_value()) {
         return std::nullopt;
     }
-    return &it->second;
+    return getEntryById(*id);
+}
+
+auto OrderBook::getEntryById(const SymbolId id) const -> std::optional<OrderBookEntry> {
+    if (id >= present_.size() || !present_[id]) {
+        return std::nullopt;
+    }
+    return OrderBookEntry{updatedAt_[id], bidPrice_[id], askPrice_[id], bidQuantity_[id],
+                          askQuantity_[id]};
 }
 
 void OrderBook::upsertEntry(const std::uint64_t key, const QuoteMessage& msg) {
-    auto it = book_.find(key);
-    if (it == book_.end()) {
-        book_[key] = {msg.timestamp, msg.bidPrice, msg.askPrice, msg.bidQuantity, msg.askQuantity};
-        return;
+    upsertEntryById(symbols_->intern(key), msg);
+}
+
+void OrderBook::upsertEntryById(const SymbolId id, const QuoteMessage& msg) {
+    if (id >= present_.size()) {
+        ensureCapacity(id);
+    }
+    size_ += !present_[id];
+    present_[id] = 1;
+    updatedAt_[id] = msg.timestamp;
+    bidPrice_[id] = msg.bidPrice;
+    askPrice_[id] = msg.askPrice;
+    bidQuantity_[id] = msg.bidQuantity;
+    askQuantity_[id] = msg.askQuantity;
+}
+
+void OrderBook::trackVenues(const std::size_t venues) {
+    venues_ = venues;
+    venueQuotes_.assign(present_.size() * venues, OrderBookEntry{});
+    nbbo_.assign(present_.size(), NbboEntry{});
+}
+
+void OrderBook::upsertVenueQuoteById(const SymbolId id, const VenueId venue,
+                                     const QuoteMessage& msg) {
+    upsertEntryById(id, msg);
+    OrderBookEntry& quote = venueQuotes_[id * venues_ + venue];
+    NbboEntry& nbbo = nbbo_[id];
+    const auto bit = static_cast<std::uint16_t>(1u << venue);
+    const bool bidMoved = moveSide(Side::Bid, nbbo.bidPrice, nbbo.bidQuantity, nbbo.bidVenues, bit,
+                                   quote.bidQuantity, msg.bidPrice, msg.bidQuantity);
+    const bool askMoved = moveSide(Side::Ask, nbbo.askPrice, nbbo.askQuantity, nbbo.askVenues, bit,
+                                   quote.askQuantity, msg.askPrice, msg.askQuantity);
+    quote = OrderBookEntry{msg.timestamp, msg.bidPrice, msg.askPrice, msg.bidQuantity,
+                           msg.askQuantity};
+    nbbo.venues |= bit;
+    nbbo.updatedAt = msg.timestamp;
+    if (!bidMoved || !askMoved) {
+        rescanNbbo(id);
+    }
+}
+
+auto OrderBook::getVenueQuoteById(const SymbolId id, const VenueId venue) const
+    -> std::optional<OrderBookEntry> {
+    if (id >= nbbo_.size() || venue >= venues_ || (nbbo_[id].venues >> venue & 1) == 0) {
+        return std::nullopt;
+    }
+    return venueQuotes_[id * venues_ + venue];
+}
+
+auto OrderBook::getNbbo(const std::uint64_t key) const -> std::optional<NbboEntry> {
+    const auto id = symbols_->find(key);
+    if (!id.has_value()) {
+        return std::nullopt;
+    }
+    return getNbboById(*id);
+}
+
+auto OrderBook::getNbboById(const SymbolId id) const -> std::optional<NbboEntry> {
+    if (id >= nbbo_.size() || nbbo_[id].venues == 0) {
+        return std::nullopt;
+    }
+    return nbbo_[id];
+}
+
+void OrderBook::rescanNbbo(const SymbolId id) {
+    NbboEntry& nbbo = nbbo_[id];
+    nbbo.bidPrice = nbbo.askPrice = 0;
+    nbbo.bidQuantity = nbbo.askQuantity = 0;
+    nbbo.bidVenues = nbbo.askVenues = 0;
+    for (std::size_t venue = 0; venue < venues_; ++venue) {
+        const auto bit = static_cast<std::uint16_t>(1u << venue);
+        if ((nbbo.venues & bit) == 0) {
+            continue;
+        }
+        const OrderBookEntry& quote = venueQuotes_[id * venues_ + venue];
+        moveSide(Side::Bid, nbbo.bidPrice, nbbo.bidQuantity, nbbo.bidVenues, bit, 0,
+                 quote.bidPrice, quote.bidQuantity);
+        moveSide(Side::Ask, nbbo.askPrice, nbbo.askQuantity, nbbo.askVenues, bit, 0,
+                 quote.askPrice, quote.askQuantity);
+    }
+}
+
+void OrderBook::applyDepth(const std::uint64_t key, const DepthMessage& msg) {
+    applyDepthById(symbols_->intern(key), msg);
+}
+
+void OrderBook::applyDepthById(const SymbolId id, const DepthMessage& msg) {
+    setLevelById(id, msg.side, msg.price, msg.quantity, msg.timestamp);
+}
+
+void OrderBook::setLevelById(const SymbolId id, const Side side, const std::uint64_t price,
+                             const std::uint32_t quantity, const std::uint64_t timestamp) {
+    if (id >= present_.size()) {
+        ensureCapacity(id);
+    }
+    auto& ladder = ladders_[id];
+    if (!ladder) {
+        ladder = std::make_unique<PriceLadder>();
+    }
+    ladder->update(side, price, quantity);
+
+    const auto bid = ladder->best(Side::Bid);
+    const auto ask = ladder->best(Side::Ask);
+    size_ += !present_[id];
+    present_[id] = 1;
+    updatedAt_[id] = timestamp;
+    bidPrice_[id] = bid ? bid->price : 0;
+    bidQuantity_[id] = bid ? bid->quantity : 0;
+    askPrice_[id] = ask ? ask->price : 0;
+    askQuantity_[id] = ask ? ask->quantity : 0;
+}
+
+auto OrderBook::getLadder(const std::uint64_t key) const -> std::optional<const PriceLadder*> {
+    const auto id = symbols_->find(key);
+    if (!id.has_value()) {
+        return std::nullopt;
+    }
+    return getLadderById(*id);
+}
+
+auto OrderBook::getLadderById(const SymbolId id) const -> std::optional<const PriceLadder*> {
+    if (id >= ladders_.size() || !ladders_[id]) {
+        return std::nullopt;
+    }
+    return ladders_[id].get();
+}
+
+void OrderBook::mergeFrom(const OrderBook& other) {
+    merge(other, false);
+}
+
+void OrderBook::mergeLaterFrom(const OrderBook& other) {
+    merge(other, true);
+}
+
+void OrderBook::merge(const OrderBook& other, const bool laterWins) {
+    const bool sharedTable = symbols_ == other.symbols_;
+    for (SymbolId otherId = 0; otherId < other.present_.size(); ++otherId) {
+        if (!other.present_[otherId]) {
+            continue;
+        }
+        const SymbolId id =
+            sharedTable ? otherId : symbols_->intern(other.symbols_->symbolOf(otherId));
+        if (id >= present_.size()) {
+            ensureCapacity(id);
+        }
+        if (venues_ != 0 && other.venues_ == venues_ && other.nbbo_[otherId].venues != 0) {
+            NbboEntry& nbbo = nbbo_[id];
+            const NbboEntry& theirs = other.nbbo_[otherId];
+            for (std::size_t venue = 0; venue < venues_; ++venue) {
+                const OrderBookEntry& quote = other.venueQuotes_[otherId * venues_ + venue];
+                OrderBookEntry& ours = venueQuotes_[id * venues_ + venue];
+                if ((theirs.venues >> venue & 1) != 0 &&
+                    (laterWins || (nbbo.venues >> venue & 1) == 0 ||
+                     quote.udpatedAt >= ours.udpatedAt)) {
+                    ours = quote;
+                }
+            }
+            nbbo.venues |= theirs.venues;
+            nbbo.updatedAt =
+                laterWins ? theirs.updatedAt : std::max(nbbo.updatedAt, theirs.updatedAt);
+            rescanNbbo(id);
+        }
+        if (!laterWins && present_[id] && other.updatedAt_[otherId] < updatedAt_[id]) {
+            continue;
+        }
+        size_ += !present_[id];
+        present_[id] = 1;
+        updatedAt_[id] = other.updatedAt_[otherId];
+        bidPrice_[id] = other.bidPrice_[otherId];
+        askPrice_[id] = other.askPrice_[otherId];
+        bidQuantity_[id] = other.bidQuantity_[otherId];
+        askQuantity_[id] = other.askQuantity_[otherId];
+        if (other.ladders_[otherId]) {
+            ladders_[id] = std::make_unique<PriceLadder>(*other.ladders_[otherId]);
+        }
+    }
+}
+
+void OrderBook::restoreEntryById(const SymbolId id, const OrderBookEntry& entry,
+                                 const PriceLadder* ladder) {
+    if (id >= present_.size()) {
+        ensureCapacity(id);
+    }
+    size_ += !present_[id];
+    present_[id] = 1;
+    updatedAt_[id] = entry.udpatedAt;
+    bidPrice_[id] = entry.bidPrice;
+    askPrice_[id] = entry.askPrice;
+    bidQuantity_[id] = entry.bidQuantity;
+    askQuantity_[id] = entry.askQuantity;
+    ladders_[id] = ladder != nullptr ? std::make_unique<PriceLadder>(*ladder) : nullptr;
+}
+
+void OrderBook::ensureCapacity(const SymbolId id) {
+    const std::size_t newSize = std::max<std::size_t>(id + 1, present_.size() * 2);
+    present_.resize(newSize);
+    updatedAt_.resize(newSize);
+    bidPrice_.resize(newSize);
+    askPrice_.resize(newSize);
+    bidQuantity_.resize(newSize);
+    askQuantity_.resize(newSize);
+    ladders_.resize(newSize);
+    if (venues_ != 0) {
+        venueQuotes_.resize(newSize * venues_);
+        nbbo_.resize(newSize);
     }
-    it->second = {msg.timestamp, msg.bidPrice, msg.askPrice, msg.bidQuantity, msg.askQuantity};
 }
 
 void OrderBook::showState() const {
@@ -28,12 +300,42 @@ void OrderBook::showState() const {
               << std::setw(12) << "Ask Qty" << std::setw(15) << "Last Update\n";
     std::cout << std::string(73, '-') << '\n';
 
-    char symStr[8] = {0};
-    for (const auto& [symbol, book] : book_) {
+    char symStr[9] = {0};
+    for (SymbolId id = 0; id < present_.size(); ++id) {
+        if (!present_[id]) {
+            continue;
+        }
+        const std::uint64_t symbol = symbols_->symbolOf(id);
+        std::memcpy(symStr, &symbol, sizeof(symbol));
+        std::cout << std::left << std::setw(12) << symStr << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(12) << (bidPrice_[id] / 100.0)
+                  << std::setw(12) << bidQuantity_[id] << std::setw(12) << (askPrice_[id] / 100.0)
+                  << std::setw(12) << askQuantity_[id] << std::setw(15) << updatedAt_[id] << '\n';
+    }
+}
+
+void OrderBook::showNbbo() const {
+    std::cout << "\n=== Consolidated NBBO (" << venues_ << " venues) ===\n";
+    std::cout << std::left << std::setw(12) << "Symbol" << std::right << std::setw(12)
+              << "Bid Price" << std::setw(12) << "Bid Qty" << std::setw(8) << "Venues"
+              << std::setw(12) << "Ask Price" << std::setw(12) << "Ask Qty" << std::setw(8)
+              << "Venues" << std::setw(15) << "Last Update\n";
+    std::cout << std::string(89, '-') << '\n';
+
+    char symStr[9] = {0};
+    for (SymbolId id = 0; id < nbbo_.size(); ++id) {
+        const NbboEntry& nbbo = nbbo_[id];
+        if (nbbo.venues == 0) {
+            continue;
+        }
+        const std::uint64_t symbol = symbols_->symbolOf(id);
         std::memcpy(symStr, &symbol, sizeof(symbol));
         std::cout << std::left << std::setw(12) << symStr << std::right << std::fixed
-                  << std::setprecision(2) << std::setw(12) << (book.bidPrice / 100.0)
-                  << std::setw(12) << book.bidQuantity << std::setw(12) << (book.askPrice / 100.0)
-                  << std::setw(12) << book.askQuantity << std::setw(15) << book.udpatedAt << '\n';
+                  << std::setprecision(2) << std::setw(12) << (nbbo.bidPrice / 100.0)
+                  << std::setw(12) << nbbo.bidQuantity << std::setw(8)
+                  << __builtin_popcount(nbbo.bidVenues) << std::setw(12)
+                  << (nbbo.askPrice / 100.0) << std::setw(12) << nbbo.askQuantity << std::setw(8)
+                  << __builtin_popcount(nbbo.askVenues) << std::setw(15) << nbbo.updatedAt
+                  << '\n';
     }
 }
@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "orderbook/price_ladder.hpp"
+
+PriceLadder::PriceLadder(std::uint64_t tickSize, std::size_t windowTicks)
+    : tickSize_{tickSize}, bids_{windowTicks}, asks_{windowTicks} {}
+
+void PriceLadder::update(const Side side, const std::uint64_t price, const std::uint32_t quantity) {
+    (side == Side::Bid ? bids_ : asks_).set(toRank(side, price), quantity);
+}
+
+auto PriceLadder::best(const Side side) const -> std::optional<Level> {
+    const LadderSide& ladder = sideOf(side);
+    if (ladder.empty()) {
+        return std::nullopt;
+    }
+    return Level{toPrice(side, ladder.bestRank()), ladder.bestQuantity()};
+}
+
+std::size_t PriceLadder::depth(const Side side, Level* out, const std::size_t maxLevels) const {
+    std::size_t count = 0;
+    return sideOf(side).walk(maxLevels, [&](std::int64_t rank, std::uint32_t quantity) {
+        out[count++] = {toPrice(side, rank), quantity};
+    });
+}
+
+std::uint32_t PriceLadder::quantityAt(const Side side, const std::uint64_t price) const {
+    return sideOf(side).at(toRank(side, price));
+}
+
+std::size_t PriceLadder::levelCount(const Side side) const {
+    return sideOf(side).levelCount();
+}
+
+void PriceLadder::LadderSide::set(const std::int64_t rank, const std::uint32_t quantity) {
+    if (empty()) { /// outliers are only kept while the window is non-empty
+        if (quantity == 0) {
+            return;
+        }
+        if (quantities_.empty()) {
+            quantities_.assign(windowTicks_, 0);
+        }
+        base_ = rank - static_cast<std::int64_t>(windowTicks_) / 4;
+    }
+    const auto window = static_cast<std::int64_t>(quantities_.size());
+
+    auto idx = rank - base_;
+    if (idx < 0) { /// better than anything in the book
+        if (quantity == 0) {
+            return;
+        }
+        recenter(rank);
+        idx = rank - base_;
+    }
+
+    if (idx >= window) {
+        if (quantity == 0) {
+            outliers_.erase(rank);
+        } else {
+            outliers_[rank] = quantity;
+        }
+        return;
+    }
+
+    std::uint32_t& slot = quantities_[idx];
+    if (quantity > 0) {
+        if (slot == 0) {
+            best_ = (inWindow_ == 0 || rank < best_) ? rank : best_;
+            ++inWindow_;
+        }
+        slot = quantity;
+        return;
+    }
+
+    if (slot == 0) {
+        return;
+    }
+    slot = 0;
+    --inWindow_;
+    if (rank != best_) {
+        return;
+    }
+
+    if (inWindow_ > 0) {
+        while (quantities_[++idx] == 0) {
+        }
+        best_ = base_ + idx;
+        if (idx > window / 2) { /// keep room behind the best as the book trends to worse prices
+            recenter(best_);
+        }
+    } else if (!outliers_.empty()) {
+        recenter(outliers_.begin()->first);
+    }
+}
+
+std::uint32_t PriceLadder::LadderSide::at(const std::int64_t rank) const {
+    const auto idx = rank - base_;
+    if (!empty() && idx >= 0 && idx < static_cast<std::int64_t>(quantities_.size())) {
+        return quantities_[idx];
+    }
+    auto it = outliers_.find(rank);
+    return it == outliers_.end() ? 0 : it->second;
+}
+
+void PriceLadder::LadderSide::recenter(const std::int64_t newBest) {
+    const auto window = static_cast<std::int64_t>(quantities_.size());
+    const auto newBase = newBest - window / 4;
+    const auto shift = newBase - base_;
+    std::uint32_t* slots = quantities_.data();
+    if (shift > 0) { /// towards worse prices; every level is at or behind `newBest`, so stays
+        const auto kept = std::max<std::int64_t>(window - shift, 0);
+        std::copy(slots + window - kept, slots + window, slots);
+        std::fill(slots + kept, slots + window, 0);
+    } else if (shift < 0) { /// towards better prices; levels pushed off the back become outliers
+        const auto kept = std::max<std::int64_t>(window + shift, 0);
+        const auto firstOutlier = outliers_.begin(); /// every outlier is behind the pushed levels
+        for (auto idx = kept; idx < window; ++idx) {
+            if (slots[idx] != 0) {
+                outliers_.emplace_hint(firstOutlier, base_ + idx, slots[idx]);
+            }
+        }
+        std::copy_backward(slots, slots + kept, slots + window);
+        std::fill(slots, slots + window - kept, 0);
+    }
+    base_ = newBase;
+
+    auto it = outliers_.begin();
+    for (; it != outliers_.end() && it->first - base_ < window; ++it) {
+        slots[it->first - base_] = it->second;
+    }
+    outliers_.erase(outliers_.begin(), it);
+
+    inWindow_ = 0;
+    for (std::int64_t idx = 0; idx < window; ++idx) {
+        if (slots[idx] != 0) {
+            best_ = inWindow_ == 0 ? base_ + idx : best_;
+            ++inWindow_;
+        }
+    }
+}
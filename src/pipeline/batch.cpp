@@ -0,0 +1,20 @@
+#include "pipeline/batch.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#include <pthread.h>
+#include <sched.h>
+
+void pinCurrentThread(const int cpu, const char* role) {
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); err != 0) {
+        std::cerr << "Warning: could not pin " << role << " thread to CPU " << cpu << ": "
+                  << std::strerror(err) << '\n';
+    }
+}
@@ -0,0 +1,26 @@
+#include "pipeline/board_pollers.hpp"
+
+BoardPollers::BoardPollers(const QuoteBoard* board, const std::size_t count) {
+    for (std::size_t i = 0; board != nullptr && i < count; ++i) {
+        threads_.emplace_back([this, board]() {
+            std::uint64_t reads = 0;
+            while (!stop_.load(std::memory_order_relaxed)) {
+                for (std::size_t cell = 0; cell < board->cells(); ++cell) {
+                    if (board->symbolAt(cell) != 0 && board->getCell(cell).has_value()) {
+                        ++reads;
+                    }
+                }
+            }
+            reads_.fetch_add(reads, std::memory_order_relaxed);
+        });
+    }
+}
+
+std::uint64_t BoardPollers::stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    return reads_.load(std::memory_order_relaxed);
+}
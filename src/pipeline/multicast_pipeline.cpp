@@ -0,0 +1,15 @@
+#include "pipeline/multicast_pipeline.hpp"
+
+StagePlan planStages(const MarketState& state) {
+    StagePlan plan;
+    plan.stages = {Stage::Book, Stage::Vwap};
+    if (!state.rollingVwap.windows().empty()) {
+        plan.stages.push_back(Stage::RollingVwap);
+    }
+    plan.upstream.assign(plan.stages.size(), 0);
+    if (state.shmOut != nullptr) {
+        plan.stages.push_back(Stage::Forward);
+        plan.upstream.push_back((std::uint32_t{1} << plan.upstream.size()) - 1);
+    }
+    return plan;
+}
@@ -0,0 +1,69 @@
+#include "pipeline/parallel_replay.hpp"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "feed/feed_scan.hpp"
+#include "feed/parser.hpp"
+
+std::optional<RunResult> runParallelReplay(MappedFeed& feed, const std::uint64_t maxMessages,
+                                           const std::size_t numJobs, SymbolTable& symbols,
+                                           MarketState& state, const CpuPlacement& cpus) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    const std::uint8_t* data = feed.peek(0);
+    const FeedScan scan = scanFeed(data, feed.remaining(), maxMessages, numJobs);
+
+    if ((scan.types & ~CHUNKABLE_TYPES) != 0) {
+        return std::nullopt;
+    }
+
+    /// The state one worker builds from its chunk, with symbol IDs private to that worker.
+    struct ChunkState {
+        explicit ChunkState(const MarketState& parent)
+            : state{symbols, parent.memory, parent.rollingVwap.windows()} {}
+
+        SymbolTable symbols;
+        MarketState state;
+    };
+    std::vector<std::unique_ptr<ChunkState>> chunks;
+    for (std::size_t i = 0; i < scan.chunks.size(); ++i) {
+        chunks.push_back(std::make_unique<ChunkState>(state));
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < scan.chunks.size(); ++i) {
+        workers.emplace_back([&, i]() {
+            pinCurrentThread(cpus.consumerCpu(i), "replay");
+            const FeedChunk& range = scan.chunks[i];
+            ChunkState& chunk = *chunks[i];
+            MappedFeed slice{data + range.begin, range.end - range.begin};
+            const std::uint8_t* msg;
+            while ((msg = slice.next()) != nullptr) {
+                applyMessage(msg, chunk.symbols.intern(symbolOf(msg)), 0, chunk.state);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& chunk : chunks) { /// in feed order
+        /// Interns the chunk's symbols in the order it first saw them, before the merge interns
+        /// them book first and tracker second, so IDs and the report follow the feed like a
+        /// sequential run.
+        for (SymbolId id = 0; id < chunk->symbols.size(); ++id) {
+            symbols.intern(chunk->symbols.symbolOf(id));
+        }
+        state.mergeLaterFrom(chunk->state);
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+
+    feed.consume(scan.chunks.empty() ? 0 : scan.chunks.back().end);
+    if (scan.truncated) {
+        feed.next(); /// fails on the partial message and marks the feed truncated
+    }
+    return RunResult{scan.messages, elapsed.count()};
+}
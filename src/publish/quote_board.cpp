@@ -0,0 +1,61 @@
+#include "publish/quote_board.hpp"
+#include "symbol_map/flat_symbol_map.hpp"
+
+/**
+ * @brief Smallest power-of-two cell count that keeps the index at most half full with `capacity`
+ * symbols, so every probe sequence reaches a free cell.
+ */
+static std::size_t cellsFor(const std::size_t capacity) {
+    std::size_t cells = 2;
+    while (cells < capacity * 2) {
+        cells <<= 1;
+    }
+    return cells;
+}
+
+QuoteBoard::QuoteBoard(std::size_t capacity)
+    : capacity_{capacity}, mask_{cellsFor(capacity) - 1},
+      cells_{std::make_unique<Cell[]>(mask_ + 1)} {}
+
+auto QuoteBoard::claim(const std::uint64_t symbol) -> std::optional<std::size_t> {
+    if (symbol == 0) { /// reserved for free cells; never a packed ticker
+        return std::nullopt;
+    }
+    for (std::size_t cell = hashSymbol(symbol) & mask_;; cell = (cell + 1) & mask_) {
+        std::uint64_t owner = cells_[cell].symbol.load(std::memory_order_acquire);
+        if (owner == 0) {
+            if (size_.fetch_add(1, std::memory_order_relaxed) >= capacity_) {
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            if (cells_[cell].symbol.compare_exchange_strong(owner, symbol,
+                                                            std::memory_order_acq_rel)) {
+                return cell;
+            }
+            size_.fetch_sub(1, std::memory_order_relaxed); /// another writer took the cell
+        }
+        if (owner == symbol) {
+            return cell;
+        }
+    }
+}
+
+auto QuoteBoard::find(const std::uint64_t symbol) const -> std::optional<std::size_t> {
+    for (std::size_t cell = hashSymbol(symbol) & mask_;; cell = (cell + 1) & mask_) {
+        const std::uint64_t owner = cells_[cell].symbol.load(std::memory_order_acquire);
+        if (owner == symbol && symbol != 0) {
+            return cell;
+        }
+        if (owner == 0) {
+            return std::nullopt;
+        }
+    }
+}
+
+auto QuoteBoard::get(const std::uint64_t symbol) const -> std::optional<Entry> {
+    const auto cell = find(symbol);
+    if (!cell.has_value()) {
+        return std::nullopt;
+    }
+    return getCell(*cell);
+}
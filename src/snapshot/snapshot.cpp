@@ -0,0 +1,241 @@
+#include "snapshot/snapshot.hpp"
+#include "io/byte_io.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(SnapshotHeader) == 72 && sizeof(BookRecord) == 40 &&
+                  sizeof(LevelRecord) == 16 && sizeof(VWAPRecord) == 32 &&
+                  sizeof(OrderRecord) == 32,
+              "snapshot records must keep their on-disk size");
+
+int writeSnapshot(const char* path, const SymbolTable& symbols, const OrderBook& book,
+                  const VWAPTracker& tracker, const L3OrderBook& orders,
+                  const FeedPosition& position) {
+    std::vector<std::uint8_t> body;
+    for (SymbolId id = 0; id < symbols.size(); ++id) {
+        append(body, symbols.symbolOf(id));
+    }
+
+    std::vector<std::uint8_t> levels;
+    std::vector<PriceLadder::Level> depth;
+    std::uint64_t bookCount = 0;
+    std::uint64_t levelCount = 0;
+    book.forEachEntry([&](const SymbolId id, const OrderBook::OrderBookEntry& entry,
+                          const PriceLadder* ladder) {
+        BookRecord record{id, 0, entry.udpatedAt, entry.bidPrice, entry.askPrice,
+                          entry.bidQuantity, entry.askQuantity};
+        if (ladder != nullptr) {
+            for (const Side side : {Side::Bid, Side::Ask}) {
+                depth.resize(ladder->levelCount(side));
+                const auto count = ladder->depth(side, depth.data(), depth.size());
+                for (std::size_t i = 0; i < count; ++i) {
+                    append(levels, LevelRecord{depth[i].price, depth[i].quantity, side, {}});
+                }
+                record.levelCount += static_cast<std::uint32_t>(count);
+            }
+        }
+        append(body, record);
+        ++bookCount;
+        levelCount += record.levelCount;
+    });
+    body.insert(body.end(), levels.begin(), levels.end());
+
+    std::uint64_t vwapCount = 0;
+    tracker.forEachEntry([&](const SymbolId id, const VWAPTracker::VWAPEntry& entry) {
+        append(body, VWAPRecord{id, entry.totalTrades, entry.updatedAt,
+                                entry.totalPriceByQuantity, entry.totalQuantity});
+        ++vwapCount;
+    });
+
+    std::uint64_t orderCount = 0;
+    orders.forEachOrder([&](const L3OrderBook::Order& order) {
+        append(body, OrderRecord{order.orderId, order.price, order.symbolId, order.quantity,
+                                 order.side, {}});
+        ++orderCount;
+    });
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.feedOffset = position.offset;
+    header.messages = position.messages;
+    header.symbolCount = symbols.size();
+    header.bookCount = bookCount;
+    header.levelCount = levelCount;
+    header.vwapCount = vwapCount;
+    header.orderCount = orderCount;
+
+    const std::string tmpPath = std::string{path} + ".tmp";
+    const int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    if (writeAll(fd, reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)) == -1 ||
+        writeAll(fd, body.data(), body.size()) == -1 || fsync(fd) == -1) {
+        const int err = errno;
+        close(fd);
+        unlink(tmpPath.c_str());
+        errno = err;
+        return -1;
+    }
+    if (close(fd) == -1 || rename(tmpPath.c_str(), path) == -1) {
+        const int err = errno;
+        unlink(tmpPath.c_str());
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks the header and record references of a mapped snapshot of `size` bytes before
+ * anything is loaded from it.
+ */
+static bool validate(const std::uint8_t* data, const std::size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.headerSize != sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    /// Bound every count by the file size first so the size sum below can't overflow.
+    const std::uint64_t body = size - sizeof(header);
+    if (header.symbolCount > body / sizeof(std::uint64_t) ||
+        header.bookCount > body / sizeof(BookRecord) ||
+        header.levelCount > body / sizeof(LevelRecord) ||
+        header.vwapCount > body / sizeof(VWAPRecord) ||
+        header.orderCount > body / sizeof(OrderRecord)) {
+        return false;
+    }
+    const std::uint64_t expected =
+        header.symbolCount * sizeof(std::uint64_t) + header.bookCount * sizeof(BookRecord) +
+        header.levelCount * sizeof(LevelRecord) + header.vwapCount * sizeof(VWAPRecord) +
+        header.orderCount * sizeof(OrderRecord);
+    if (expected != body) {
+        return false;
+    }
+
+    const auto* books = reinterpret_cast<const BookRecord*>(
+        data + sizeof(header) + header.symbolCount * sizeof(std::uint64_t));
+    std::uint64_t levels = 0;
+    for (std::uint64_t i = 0; i < header.bookCount; ++i) {
+        if (books[i].symbol >= header.symbolCount) {
+            return false;
+        }
+        levels += books[i].levelCount;
+    }
+    if (levels != header.levelCount) {
+        return false;
+    }
+
+    const auto* vwaps = reinterpret_cast<const VWAPRecord*>(
+        reinterpret_cast<const std::uint8_t*>(books + header.bookCount) +
+        header.levelCount * sizeof(LevelRecord));
+    for (std::uint64_t i = 0; i < header.vwapCount; ++i) {
+        if (vwaps[i].symbol >= header.symbolCount) {
+            return false;
+        }
+    }
+
+    const auto* orders = reinterpret_cast<const OrderRecord*>(vwaps + header.vwapCount);
+    for (std::uint64_t i = 0; i < header.orderCount; ++i) {
+        if (orders[i].symbol >= header.symbolCount || orders[i].quantity == 0 ||
+            (orders[i].side != Side::Bid && orders[i].side != Side::Ask)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int readSnapshot(const char* path, SymbolTable& symbols, OrderBook& book, VWAPTracker& tracker,
+                 L3OrderBook& orders, FeedPosition& position) {
+    const int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size < sizeof(SnapshotHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    const int err = errno;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        errno = err;
+        return -1;
+    }
+
+    const auto* data = static_cast<const std::uint8_t*>(mapped);
+    if (!validate(data, size)) {
+        munmap(mapped, size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const auto* saved = reinterpret_cast<const std::uint64_t*>(data + sizeof(header));
+    const auto* books = reinterpret_cast<const BookRecord*>(saved + header.symbolCount);
+    const auto* levels = reinterpret_cast<const LevelRecord*>(books + header.bookCount);
+    const auto* vwaps = reinterpret_cast<const VWAPRecord*>(levels + header.levelCount);
+    const auto* savedOrders = reinterpret_cast<const OrderRecord*>(vwaps + header.vwapCount);
+
+    std::vector<SymbolId> ids(header.symbolCount);
+    for (std::uint64_t i = 0; i < header.symbolCount; ++i) {
+        ids[i] = symbols.intern(saved[i]);
+    }
+
+    for (std::uint64_t i = 0; i < header.bookCount; ++i) {
+        const BookRecord& record = books[i];
+        const OrderBook::OrderBookEntry entry{record.updatedAt, record.bidPrice, record.askPrice,
+                                              record.bidQuantity, record.askQuantity};
+        if (record.levelCount == 0) {
+            book.restoreEntryById(ids[record.symbol], entry, nullptr);
+            continue;
+        }
+        PriceLadder ladder;
+        for (std::uint32_t l = 0; l < record.levelCount; ++l, ++levels) {
+            ladder.update(levels->side, levels->price, levels->quantity);
+        }
+        book.restoreEntryById(ids[record.symbol], entry, &ladder);
+    }
+
+    for (std::uint64_t i = 0; i < header.vwapCount; ++i) {
+        const VWAPRecord& record = vwaps[i];
+        tracker.restoreEntryById(ids[record.symbol],
+                                 {record.updatedAt, record.totalPriceByQuantity,
+                                  record.totalQuantity, record.totalTrades});
+    }
+
+    for (std::uint64_t i = 0; i < header.orderCount; ++i) {
+        const OrderRecord& record = savedOrders[i];
+        orders.restoreOrderById(ids[record.symbol], record.orderId, record.side, record.price,
+                                record.quantity);
+    }
+
+    position = {header.feedOffset, header.messages};
+    munmap(mapped, size);
+    return 0;
+}
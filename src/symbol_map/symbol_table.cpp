@@ -0,0 +1,14 @@
+#include "symbol_map/symbol_table.hpp"
+
+SymbolTable::SymbolTable(std::size_t expectedSymbols) : ids_{expectedSymbols} {
+    symbols_.reserve(expectedSymbols);
+}
+
+auto SymbolTable::find(const std::uint64_t symbol) const -> std::optional<SymbolId> {
+    const SymbolId* id = symbol == FlatSymbolMap<SymbolId>::EMPTY_KEY ? &reservedId_
+                                                                      : ids_.find(symbol);
+    if (id == nullptr || *id == NO_ID) {
+        return std::nullopt;
+    }
+    return *id;
+}
@@ -0,0 +1,227 @@
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "feed/compact_feed.hpp"
+#include "feed/stream_reader.hpp"
+#include "messages.hpp"
+
+/**
+ * @brief Bytes of raw messages collected before they are written out when decoding.
+ */
+static constexpr std::size_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief Runtime configuration collected from the command line.
+ */
+struct CompactOptions {
+    const char* path{nullptr};
+    bool decode{false}; /// turn a compact feed back into a raw one instead
+    std::uint32_t blockMessages{CompactEncoder::DEFAULT_BLOCK_MESSAGES};
+};
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] feed.mdc < feed.bin\n"
+              << "       " << prog << " --decode feed.mdc > feed.bin\n"
+              << "  -b, --block N  messages per block, the granularity of seeking (default "
+              << CompactEncoder::DEFAULT_BLOCK_MESSAGES << ")\n"
+              << "  -d, --decode   write the raw feed of a compact feed to stdout\n"
+              << "  -h, --help     show this message\n";
+}
+
+/**
+ * @brief Parses the command line into `opts`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, CompactOptions& opts) {
+    static const option longOptions[] = {
+        {"block", required_argument, nullptr, 'b'},
+        {"decode", no_argument, nullptr, 'd'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:dh", longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'b': {
+            char* end;
+            const auto count = std::strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || count == 0 || count > (1u << 24)) {
+                std::cerr << "Invalid block size: " << optarg << '\n';
+                return false;
+            }
+            opts.blockMessages = static_cast<std::uint32_t>(count);
+            break;
+        }
+        case 'd':
+            opts.decode = true;
+            break;
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (optind != argc - 1) {
+        printUsage(argv[0]);
+        return false;
+    }
+    opts.path = argv[optind];
+    return true;
+}
+
+/**
+ * @brief Writes all of `buffer` to stdout and empties it.
+ *
+ * @return 0 on success, or -1 with `errno` set.
+ */
+int flush(std::vector<std::uint8_t>& buffer) {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        const auto n = write(STDOUT_FILENO, buffer.data() + written, buffer.size() - written);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    buffer.clear();
+    return 0;
+}
+
+/**
+ * @brief Encodes the raw feed on stdin into the compact feed at `opts.path`, stopping at the
+ * message count in the feed header if it has one.
+ */
+int encode(const CompactOptions& opts) {
+    StreamReader reader{STDIN_FILENO};
+    std::uint64_t maxMessages = 0;
+    if (const std::uint8_t* header = reader.peek(sizeof(maxMessages))) {
+        std::memcpy(&maxMessages, header, sizeof(maxMessages));
+        reader.consume(sizeof(maxMessages));
+    }
+
+    CompactEncoder encoder{opts.blockMessages};
+    if (encoder.open(opts.path) == -1) {
+        perror("open");
+        return 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const std::uint8_t* data;
+    while ((maxMessages == 0 || encoder.size() < maxMessages) && (data = reader.next())) {
+        if (encoder.add(data) == -1) {
+            perror("write");
+            return 1;
+        }
+    }
+    const std::uint64_t rawSize = reader.offset();
+    if (encoder.close() == -1) {
+        perror("write");
+        return 1;
+    }
+    if (reader.error() != 0) {
+        errno = reader.error();
+        perror("read");
+        return 1;
+    }
+    if (reader.truncated()) {
+        std::cerr << "Warning: feed contained a truncated message or an unknown message type\n";
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cerr << "Encoded " << encoder.size() << " messages, " << rawSize << " bytes into "
+              << encoder.bytesWritten() << " (" << std::fixed << std::setprecision(1)
+              << 100.0 * static_cast<double>(encoder.bytesWritten()) /
+                     static_cast<double>(std::max<std::uint64_t>(rawSize, 1))
+              << "%) in " << std::setprecision(2) << elapsed.count() << " ms\n";
+    return 0;
+}
+
+/**
+ * @brief Writes the raw feed of the compact feed at `opts.path` to stdout, with its count header.
+ */
+int decode(const CompactOptions& opts) {
+    const int fd = open(opts.path, O_RDONLY);
+    if (fd == -1) {
+        perror("open");
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        perror("fstat");
+        return 1;
+    }
+    void* mappedData = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mappedData == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    CompactFeed feed;
+    if (feed.open(static_cast<const std::uint8_t*>(mappedData),
+                  static_cast<std::size_t>(st.st_size)) == -1) {
+        perror("compact feed");
+        return 1;
+    }
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(OUTPUT_BUFFER_SIZE + MAX_MESSAGE_SIZE);
+    const std::uint64_t count = feed.size();
+    buffer.insert(buffer.end(), reinterpret_cast<const std::uint8_t*>(&count),
+                  reinterpret_cast<const std::uint8_t*>(&count) + sizeof(count));
+
+    const std::uint8_t* data;
+    while ((data = feed.next()) != nullptr) {
+        buffer.insert(buffer.end(), data, data + messageSize(static_cast<MessageType>(*data)));
+        if (buffer.size() >= OUTPUT_BUFFER_SIZE && flush(buffer) == -1) {
+            perror("write");
+            return 1;
+        }
+    }
+    if (flush(buffer) == -1) {
+        perror("write");
+        return 1;
+    }
+    munmap(mappedData, st.st_size);
+    if (feed.truncated()) {
+        std::cerr << "Error: the compact feed is corrupt after " << feed.offset()
+                  << " bytes of raw feed\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Converts feed captures between the raw wire format and the compact archive format of
+ * `feed/compact_feed.hpp`. `main.out` reads either; compact files must be given as a file on
+ * stdin, since they are decoded from a mapping.
+ */
+int main(int argc, char** argv) {
+    CompactOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+    return opts.decode ? decode(opts) : encode(opts);
+}
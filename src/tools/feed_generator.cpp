@@ -0,0 +1,201 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include "generator/feed_generator.hpp"
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    const GeneratorConfig defaults;
+    std::cerr << "Usage: " << prog << " [options] > feed.bin\n"
+              << "  -m, --messages N      messages to generate (default " << defaults.messages
+              << ")\n"
+              << "  -s, --symbols N       symbol universe, 1-" << MAX_GENERATOR_SYMBOLS
+              << " (default " << defaults.symbols << ")\n"
+              << "  -z, --zipf S          Zipf exponent of symbol popularity, 0 for uniform\n"
+              << "                        (default " << defaults.zipfExponent << ")\n"
+              << "  -t, --trade-ratio R   share of trades among quotes and trades (default "
+              << defaults.tradeRatio << ")\n"
+              << "  -d, --depth-ratio R   share of depth updates (default " << defaults.depthRatio
+              << ")\n"
+              << "  -g, --gap US          mean microseconds between messages (default "
+              << defaults.meanGap << ")\n"
+              << "  -G, --burst-gap US    mean microseconds between messages in a burst\n"
+              << "                        (default " << defaults.burstGap << ")\n"
+              << "  -r, --burst-ratio R   share of messages sent in bursts (default "
+              << defaults.burstRatio << ")\n"
+              << "  -l, --burst-length N  mean messages per burst (default " << defaults.burstLength
+              << ")\n"
+              << "  -x, --seed N          random seed; the feed depends only on the options\n"
+              << "                        above and this (default " << defaults.seed << ")\n"
+              << "  -j, --threads N       generator threads (default: one per core)\n"
+              << "  -h, --help            show this message\n";
+}
+
+/**
+ * @brief Parses `arg` as a number in [`min`, `max`] into `value`, printing an error naming `what`
+ * if it is not.
+ */
+template <typename T> bool parseNumber(const char* arg, T min, T max, const char* what, T& value) {
+    char* end;
+    const double parsed = std::strtod(arg, &end);
+    if (end == arg || *end != '\0' || !(parsed >= static_cast<double>(min)) ||
+        !(parsed <= static_cast<double>(max))) {
+        std::cerr << "Invalid " << what << ": " << arg << '\n';
+        return false;
+    }
+    value = static_cast<T>(parsed);
+    return true;
+}
+
+/**
+ * @brief Parses the command line into `config`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, GeneratorConfig& config) {
+    static const option longOptions[] = {
+        {"messages", required_argument, nullptr, 'm'},
+        {"symbols", required_argument, nullptr, 's'},
+        {"zipf", required_argument, nullptr, 'z'},
+        {"trade-ratio", required_argument, nullptr, 't'},
+        {"depth-ratio", required_argument, nullptr, 'd'},
+        {"gap", required_argument, nullptr, 'g'},
+        {"burst-gap", required_argument, nullptr, 'G'},
+        {"burst-ratio", required_argument, nullptr, 'r'},
+        {"burst-length", required_argument, nullptr, 'l'},
+        {"seed", required_argument, nullptr, 'x'},
+        {"threads", required_argument, nullptr, 'j'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "m:s:z:t:d:g:G:r:l:x:j:h", longOptions, nullptr)) != -1) {
+        bool ok;
+        switch (opt) {
+        case 'm':
+            ok = parseNumber<std::uint64_t>(optarg, 1, 1e12, "message count", config.messages);
+            break;
+        case 's':
+            ok = parseNumber<std::uint32_t>(optarg, 1, MAX_GENERATOR_SYMBOLS, "symbol count",
+                                            config.symbols);
+            break;
+        case 'z':
+            ok = parseNumber(optarg, 0.0, 10.0, "Zipf exponent", config.zipfExponent);
+            break;
+        case 't':
+            ok = parseNumber(optarg, 0.0, 1.0, "trade ratio", config.tradeRatio);
+            break;
+        case 'd':
+            ok = parseNumber(optarg, 0.0, 1.0, "depth ratio", config.depthRatio);
+            break;
+        case 'g':
+            ok = parseNumber(optarg, 0.0, 1e9, "gap", config.meanGap);
+            break;
+        case 'G':
+            ok = parseNumber(optarg, 0.0, 1e9, "burst gap", config.burstGap);
+            break;
+        case 'r':
+            ok = parseNumber(optarg, 0.0, 1.0, "burst ratio", config.burstRatio);
+            break;
+        case 'l':
+            ok = parseNumber(optarg, 1.0, 1e12, "burst length", config.burstLength);
+            break;
+        case 'x':
+            ok = parseNumber<std::uint64_t>(optarg, 0, 1e15, "seed", config.seed);
+            break;
+        case 'j':
+            ok = parseNumber(optarg, 1u, 256u, "thread count", config.threads);
+            break;
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (optind != argc) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes all of the `size` bytes at `data` to stdout.
+ *
+ * @return 0 on success, or -1 with `errno` set.
+ */
+int writeOut(const std::uint8_t* data, std::size_t size) {
+    while (size > 0) {
+        const auto n = write(STDOUT_FILENO, data, size);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a synthetic feed file to stdout, with its leading message count, for benchmarks
+ * and tests that need more symbols and messages than `test_generator.py` can produce in
+ * reasonable time, e.g. `feed_generator.out -m 100000000 -s 100000 > build/market_feed.bin`.
+ */
+int main(int argc, char** argv) {
+    GeneratorConfig config;
+    config.threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (!parseOptions(argc, argv, config)) {
+        return 1;
+    }
+    if (isatty(STDOUT_FILENO)) {
+        std::cerr << "Refusing to write a binary feed to a terminal: redirect stdout to a file\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    FeedGenerator generator{config};
+    if (writeOut(reinterpret_cast<const std::uint8_t*>(&config.messages),
+                 sizeof(config.messages)) == -1) {
+        perror("write");
+        return 1;
+    }
+    std::uint64_t bytes = sizeof(config.messages);
+    while (generator.nextRound()) {
+        for (std::size_t i = 0; i < generator.chunks(); ++i) {
+            const auto& chunk = generator.chunk(i);
+            if (writeOut(chunk.data(), chunk.size()) == -1) {
+                perror("write");
+                return 1;
+            }
+            bytes += chunk.size();
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "Generated " << config.messages << " messages over " << config.symbols
+              << " symbols, " << bytes << " bytes, in " << std::fixed << std::setprecision(2)
+              << elapsed.count() << " s on " << config.threads << " threads ("
+              << static_cast<double>(config.messages) / elapsed.count() / 1e6
+              << " M messages/s)\n";
+    return 0;
+}
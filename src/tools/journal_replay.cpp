@@ -0,0 +1,188 @@
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include "journal/journal.hpp"
+#include "messages.hpp"
+
+/**
+ * @brief Bytes of messages collected before they are written to stdout.
+ */
+static constexpr std::size_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief How far ahead of its due time a message may be written. Messages due sooner are written
+ * right away rather than sleeping, since a sleep is not that precise anyway.
+ */
+static constexpr std::chrono::microseconds SLEEP_THRESHOLD{50};
+
+/**
+ * @brief Runtime configuration collected from the command line.
+ */
+struct ReplayOptions {
+    const char* path{nullptr};
+    std::uint64_t speed{0}; /// replay this many times faster than recorded, 0 for no pacing
+};
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] journal.bin > feed.bin\n"
+              << "  -x, --speed N|max  replay N times faster than the recorded timestamps, or\n"
+              << "                     as fast as possible (default max)\n"
+              << "  -h, --help         show this message\n";
+}
+
+/**
+ * @brief Parses the command line into `opts`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, ReplayOptions& opts) {
+    static const option longOptions[] = {
+        {"speed", required_argument, nullptr, 'x'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "x:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'x': {
+            if (std::strcmp(optarg, "max") == 0) {
+                opts.speed = 0;
+                break;
+            }
+            char* end;
+            opts.speed = std::strtoull(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || opts.speed == 0) {
+                std::cerr << "Invalid speed: " << optarg << '\n';
+                return false;
+            }
+            break;
+        }
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (optind != argc - 1) {
+        printUsage(argv[0]);
+        return false;
+    }
+    opts.path = argv[optind];
+    return true;
+}
+
+/**
+ * @brief Writes all of `buffer` to stdout and empties it.
+ *
+ * @return 0 on success, or -1 with `errno` set.
+ */
+int flush(std::vector<std::uint8_t>& buffer) {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        const auto n = write(STDOUT_FILENO, buffer.data() + written, buffer.size() - written);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    buffer.clear();
+    return 0;
+}
+
+/**
+ * @brief Replays a journal written by `main.out --journal` as a feed file on stdout, with the
+ * leading message count, so the recorded session can be fed back through the handler, e.g.
+ * `journal_replay.out --speed 10 journal.bin | main.out`. With a speed, messages are written when
+ * the gap since the first message's `timestamp` says they are due, divided by the speed, which
+ * reproduces the bursts and lulls of the recorded session. Timestamps are in microseconds.
+ */
+int main(int argc, char** argv) {
+    ReplayOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+
+    JournalReader journal;
+    if (journal.open(opts.path) == -1) {
+        perror("journal");
+        return 1;
+    }
+    const JournalRecord* records = journal.records();
+    const std::uint64_t count = journal.size();
+    if (journal.header().records == 0 && count != 0) {
+        std::cerr << "Warning: the journal was not closed, replaying the " << count
+                  << " records recovered\n";
+    }
+
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(OUTPUT_BUFFER_SIZE + MAX_MESSAGE_SIZE);
+    buffer.insert(buffer.end(), reinterpret_cast<const std::uint8_t*>(&count),
+                  reinterpret_cast<const std::uint8_t*>(&count) + sizeof(count));
+
+    std::uint64_t firstTimestamp = 0;
+    std::chrono::steady_clock::duration maxLag{0};
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const auto* data = reinterpret_cast<const std::uint8_t*>(&records[i].msg);
+        if (opts.speed != 0) {
+            std::uint64_t timestamp;
+            std::memcpy(&timestamp, data + offsetof(TradeMessage, timestamp), sizeof(timestamp));
+            if (i == 0) {
+                firstTimestamp = timestamp;
+            }
+            const auto gap = timestamp > firstTimestamp ? timestamp - firstTimestamp : 0;
+            const auto due = start + std::chrono::microseconds(gap / opts.speed);
+            const auto now = std::chrono::steady_clock::now();
+            if (due - now > SLEEP_THRESHOLD) { /// hand over what is due before waiting
+                if (flush(buffer) == -1) {
+                    perror("write");
+                    return 1;
+                }
+                std::this_thread::sleep_until(due);
+            } else if (now - due > maxLag) {
+                maxLag = now - due;
+            }
+        }
+
+        const auto size = messageSize(static_cast<MessageType>(*data));
+        buffer.insert(buffer.end(), data, data + size);
+        if (buffer.size() >= OUTPUT_BUFFER_SIZE && flush(buffer) == -1) {
+            perror("write");
+            return 1;
+        }
+    }
+    if (flush(buffer) == -1) {
+        perror("write");
+        return 1;
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const std::chrono::duration<double, std::milli> lag = maxLag;
+    std::cerr << "Replayed " << count << " messages in " << elapsed.count() << " ms";
+    if (opts.speed != 0) {
+        std::cerr << " at " << opts.speed << "x, at most " << lag.count() << " ms behind";
+    }
+    std::cerr << '\n';
+    return 0;
+}
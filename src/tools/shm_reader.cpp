@@ -0,0 +1,143 @@
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <getopt.h>
+
+#include "messages.hpp"
+#include "ringbuffer/shm_spsc_queue.hpp"
+
+/**
+ * @brief Maximum number of messages read per claim on the queue.
+ */
+static constexpr std::size_t READ_BATCH = 256;
+
+/**
+ * @brief Runtime configuration collected from the command line.
+ */
+struct ReaderOptions {
+    const char* name{"/market_feed"};
+    std::uint64_t waitSeconds{10}; /// how long to wait for the feed handler to create the queue
+};
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "  -n, --name NAME    shared memory queue to read (default /market_feed)\n"
+              << "  -t, --wait SECONDS how long to wait for the queue to appear (default 10)\n"
+              << "  -h, --help         show this message\n";
+}
+
+/**
+ * @brief Parses the command line into `opts`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, ReaderOptions& opts) {
+    static const option longOptions[] = {
+        {"name", required_argument, nullptr, 'n'},
+        {"wait", required_argument, nullptr, 't'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "n:t:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'n':
+            opts.name = optarg;
+            break;
+        case 't':
+            opts.waitSeconds = std::strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief A stand-in strategy process: attaches to the shared memory queue that `main.out --shm`
+ * forwards messages to, consumes them until the feed handler detaches, and prints what it
+ * received. Started before or after the feed handler; if it starts first it waits for the queue.
+ */
+int main(int argc, char** argv) {
+    ReaderOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+
+    using Queue = ShmSPSCQueue<MarketDataMessage>;
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(opts.waitSeconds);
+    auto queue = Queue::attach(opts.name, ShmRole::Consumer);
+    while (queue == nullptr && (errno == ENOENT || errno == EAGAIN) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue = Queue::attach(opts.name, ShmRole::Consumer);
+    }
+    if (queue == nullptr) {
+        perror("attach");
+        return 1;
+    }
+
+    std::uint64_t byType[8] = {};
+    std::uint64_t received = 0;
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point last;
+
+    while (true) {
+        MarketDataMessage* slots;
+        const auto claimed = queue->claimRead(slots, READ_BATCH);
+        if (claimed == 0) {
+            const PeerState producer = queue->peerState();
+            if (producer == PeerState::Detached || producer == PeerState::Dead) {
+                if (!queue->isEmpty()) { /// committed just before detaching
+                    continue;
+                }
+                if (producer == PeerState::Dead) {
+                    std::cerr << "Warning: the feed handler exited without detaching\n";
+                }
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (received == 0) {
+            first = std::chrono::steady_clock::now();
+        }
+        for (std::size_t i = 0; i < claimed; ++i) {
+            ++byType[static_cast<std::uint8_t>(slots[i].type) & 7];
+        }
+        received += claimed;
+        queue->commitRead(claimed);
+        last = std::chrono::steady_clock::now();
+    }
+    Queue::remove(opts.name);
+
+    const std::chrono::duration<double, std::milli> elapsed = last - first;
+    std::cout << "Received " << received << " messages in " << std::fixed << std::setprecision(2)
+              << elapsed.count() << " ms\n";
+    std::cout << "Trades: " << byType[static_cast<std::uint8_t>(MessageType::Trade)]
+              << ", quotes: " << byType[static_cast<std::uint8_t>(MessageType::Quote)]
+              << ", depth: " << byType[static_cast<std::uint8_t>(MessageType::Depth)]
+              << ", order messages: "
+              << received - byType[static_cast<std::uint8_t>(MessageType::Trade)] -
+                     byType[static_cast<std::uint8_t>(MessageType::Quote)] -
+                     byType[static_cast<std::uint8_t>(MessageType::Depth)]
+              << '\n';
+    return 0;
+}
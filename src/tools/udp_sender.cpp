@@ -0,0 +1,245 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "feed/mapped_feed.hpp"
+#include "feed/udp_feed.hpp"
+#include "messages.hpp"
+
+/**
+ * @brief Number of datagrams handed to the kernel per `sendmmsg` call.
+ */
+static constexpr std::size_t SEND_BATCH = 32;
+
+/**
+ * @brief How many times the end-of-session packet is sent, so a single loss doesn't leave the
+ * receiver waiting for its idle timeout.
+ */
+static constexpr int END_OF_SESSION_REPEATS = 3;
+
+/**
+ * @brief Runtime configuration collected from the command line.
+ */
+struct SenderOptions {
+    const char* address{"127.0.0.1"};
+    std::uint16_t port{9000};
+    std::uint64_t rate{0};        /// messages per second, 0 sends as fast as possible
+    std::size_t maxPayload{1400}; /// datagram size limit including the packet header
+    std::uint64_t dropEvery{0};   /// skip every Nth packet to exercise gap detection, 0 = off
+};
+
+/**
+ * @brief Prints the command line usage of the program.
+ *
+ * @param prog The name the program was invoked with.
+ */
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] < feed.bin\n"
+              << "  -a, --address ADDR      destination IPv4 address (default 127.0.0.1)\n"
+              << "  -p, --port PORT         destination port (default 9000)\n"
+              << "  -r, --rate N            messages per second, 0 for no limit (default 0)\n"
+              << "  -m, --max-payload BYTES datagram size limit (default 1400, max "
+              << UdpFeed::MAX_DATAGRAM_SIZE << ")\n"
+              << "  -d, --drop-every N      skip every Nth packet to simulate loss\n"
+              << "  -h, --help              show this message\n";
+}
+
+/**
+ * @brief Parses the command line into `opts`.
+ *
+ * @return `true` if the program should continue or `false` if it should exit.
+ */
+bool parseOptions(int argc, char** argv, SenderOptions& opts) {
+    static const option longOptions[] = {
+        {"address", required_argument, nullptr, 'a'},
+        {"port", required_argument, nullptr, 'p'},
+        {"rate", required_argument, nullptr, 'r'},
+        {"max-payload", required_argument, nullptr, 'm'},
+        {"drop-every", required_argument, nullptr, 'd'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "a:p:r:m:d:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+        case 'a':
+            opts.address = optarg;
+            break;
+        case 'p': {
+            const auto port = std::strtoul(optarg, nullptr, 10);
+            if (port == 0 || port > 65535) {
+                std::cerr << "Invalid port: " << optarg << '\n';
+                return false;
+            }
+            opts.port = static_cast<std::uint16_t>(port);
+            break;
+        }
+        case 'r':
+            opts.rate = std::strtoull(optarg, nullptr, 10);
+            break;
+        case 'm':
+            opts.maxPayload = std::strtoul(optarg, nullptr, 10);
+            if (opts.maxPayload < sizeof(PacketHeader) + MAX_MESSAGE_SIZE ||
+                opts.maxPayload > UdpFeed::MAX_DATAGRAM_SIZE) {
+                std::cerr << "Invalid max payload: " << optarg << '\n';
+                return false;
+            }
+            break;
+        case 'd':
+            opts.dropEvery = std::strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Replays a feed file from stdin as sequenced UDP datagrams, the format `main.out --udp`
+ * receives. Messages are packed into datagrams up to the payload limit, sent in `sendmmsg`
+ * batches and paced to the requested message rate; the session ends with an `END_OF_SESSION`
+ * packet.
+ */
+int main(int argc, char** argv) {
+    SenderOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(STDIN_FILENO, &st) == -1) {
+        perror("fstat");
+        return 1;
+    }
+    void* mappedData = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+    if (mappedData == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd == -1) {
+        perror("socket");
+        return 1;
+    }
+    sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(opts.port);
+    if (inet_pton(AF_INET, opts.address, &dest.sin_addr) != 1) {
+        std::cerr << "Invalid address: " << opts.address << '\n';
+        return 1;
+    }
+
+    MappedFeed feed{static_cast<const std::uint8_t*>(mappedData),
+                    static_cast<std::size_t>(st.st_size)};
+    std::uint64_t maxMessages = 0;
+    if (const std::uint8_t* header = feed.peek(sizeof(maxMessages))) {
+        std::memcpy(&maxMessages, header, sizeof(maxMessages));
+        feed.consume(sizeof(maxMessages));
+    }
+
+    std::vector<std::uint8_t> buffers(SEND_BATCH * opts.maxPayload);
+    iovec iovecs[SEND_BATCH];
+    mmsghdr headers[SEND_BATCH];
+    std::memset(headers, 0, sizeof(headers));
+    for (std::size_t i = 0; i < SEND_BATCH; ++i) {
+        iovecs[i].iov_base = buffers.data() + i * opts.maxPayload;
+        headers[i].msg_hdr.msg_name = &dest;
+        headers[i].msg_hdr.msg_namelen = sizeof(dest);
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::uint64_t sequence = 1;
+    std::uint64_t sent = 0;
+    std::uint64_t packets = 0;
+    std::uint64_t dropped = 0;
+    const std::uint8_t* pending = feed.next(); /// first message not yet packed
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto more = [&]() {
+        return pending != nullptr && (maxMessages == 0 || sent < maxMessages);
+    };
+
+    while (more()) {
+        std::size_t batch = 0;
+        while (batch < SEND_BATCH && more()) {
+            auto* packet = static_cast<std::uint8_t*>(iovecs[batch].iov_base);
+            std::size_t length = sizeof(PacketHeader);
+            PacketHeader header{sequence, 0};
+
+            while (more() && header.messageCount < END_OF_SESSION - 1) {
+                const auto size = messageSize(static_cast<MessageType>(*pending));
+                if (length + size > opts.maxPayload) {
+                    break;
+                }
+                std::memcpy(packet + length, pending, size);
+                length += size;
+                ++header.messageCount;
+                ++sent;
+                pending = feed.next();
+            }
+            std::memcpy(packet, &header, sizeof(header));
+            sequence += header.messageCount;
+
+            ++packets;
+            if (opts.dropEvery != 0 && packets % opts.dropEvery == 0) {
+                ++dropped; /// simulated loss: the sequence advances but nothing is sent
+                continue;
+            }
+            iovecs[batch].iov_len = length;
+            ++batch;
+        }
+
+        for (std::size_t done = 0; done < batch;) {
+            const int n = sendmmsg(fd, headers + done, batch - done, 0);
+            if (n == -1) {
+                perror("sendmmsg");
+                return 1;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+
+        if (opts.rate != 0) { /// wait until the messages sent so far are due
+            const auto due = start + std::chrono::duration<double>(static_cast<double>(sent) /
+                                                                   static_cast<double>(opts.rate));
+            std::this_thread::sleep_until(
+                std::chrono::time_point_cast<std::chrono::steady_clock::duration>(due));
+        }
+    }
+
+    const PacketHeader end{sequence, END_OF_SESSION};
+    for (int i = 0; i < END_OF_SESSION_REPEATS; ++i) {
+        if (sendto(fd, &end, sizeof(end), 0, reinterpret_cast<const sockaddr*>(&dest),
+                   sizeof(dest)) == -1) {
+            perror("sendto");
+            return 1;
+        }
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Sent " << sent << " messages in " << packets << " packets (" << dropped
+              << " dropped on purpose) in " << elapsed.count() << " ms\n";
+
+    close(fd);
+    munmap(mappedData, st.st_size);
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "vwap_tracker/rolling_vwap.hpp"
+
+/**
+ * @brief Adds the totals of `from` to `into`.
+ */
+static void addTotals(RollingVWAP::WindowEntry& into, const RollingVWAP::WindowEntry& from) {
+    into.totalPriceByQuantity += from.totalPriceByQuantity;
+    into.totalQuantity += from.totalQuantity;
+    into.totalTrades += from.totalTrades;
+}
+
+/**
+ * @brief Removes the totals of `from`, previously added, from `into`.
+ */
+static void subtractTotals(RollingVWAP::WindowEntry& into, const RollingVWAP::WindowEntry& from) {
+    into.totalPriceByQuantity -= from.totalPriceByQuantity;
+    into.totalQuantity -= from.totalQuantity;
+    into.totalTrades -= from.totalTrades;
+}
+
+RollingVWAP::RollingVWAP(std::vector<Window> windows, std::size_t expectedSymbols,
+                         std::pmr::memory_resource* memory)
+    : ownedSymbols_{std::make_unique<SymbolTable>(expectedSymbols)}, symbols_{ownedSymbols_.get()},
+      windows_{std::move(windows)}, present_{memory}, latestAt_{memory} {
+    initWindows(memory);
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+RollingVWAP::RollingVWAP(SymbolTable& symbols, std::vector<Window> windows,
+                         std::size_t expectedSymbols, std::pmr::memory_resource* memory)
+    : symbols_{&symbols}, windows_{std::move(windows)}, present_{memory}, latestAt_{memory} {
+    initWindows(memory);
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+auto RollingVWAP::getWindow(std::uint64_t symbol, std::size_t window, std::uint64_t now) const
+    -> std::optional<WindowEntry> {
+    const auto id = symbols_->find(symbol);
+    if (!id.has_value()) {
+        return std::nullopt;
+    }
+    return getWindowById(*id, window, now);
+}
+
+auto RollingVWAP::getWindowById(const SymbolId id, const std::size_t window,
+                                const std::uint64_t now) const -> std::optional<WindowEntry> {
+    if (id >= present_.size() || !present_[id] || window >= state_.size()) {
+        return std::nullopt;
+    }
+    const WindowState& ws = state_[window];
+    const std::uint64_t head = latestAt_[id] / ws.width;
+    const std::uint64_t end = std::max(head, now / ws.width);
+    if (end - head >= ws.numBuckets) { /// every bucket has slid out
+        return std::nullopt;
+    }
+
+    WindowEntry entry = ws.totals[id];
+    const std::size_t base = static_cast<std::size_t>(id) * ws.numBuckets;
+    for (std::uint64_t k = head + 1; k <= end; ++k) {
+        subtractTotals(entry, ws.buckets[base + k % ws.numBuckets]);
+    }
+    if (entry.totalTrades == 0) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+void RollingVWAP::addTrade(const std::uint64_t symbol, const TradeMessage& msg) {
+    addTradeById(symbols_->intern(symbol), msg);
+}
+
+void RollingVWAP::update(const SymbolId id, const std::uint64_t timestamp,
+                         const WindowEntry& trade) {
+    if (id >= present_.size()) {
+        ensureCapacity(id);
+    }
+    if (!present_[id]) {
+        present_[id] = 1;
+        latestAt_[id] = timestamp;
+        for (auto& ws : state_) {
+            setHead(ws, id, timestamp / ws.width);
+        }
+    }
+
+    const std::uint64_t previous = latestAt_[id];
+    for (auto& ws : state_) {
+        const std::size_t base = static_cast<std::size_t>(id) * ws.numBuckets;
+        if (timestamp - ws.headStart[id] < ws.width) { /// the common case: same bucket as before
+            addTotals(ws.buckets[base + ws.headSlot[id]], trade);
+            addTotals(ws.totals[id], trade);
+            continue;
+        }
+
+        const std::uint64_t head = previous / ws.width;
+        const std::uint64_t bucket = timestamp / ws.width;
+        if (bucket > head) {
+            advance(ws, id, head, bucket);
+            setHead(ws, id, bucket);
+        }
+        if (bucket + ws.numBuckets > std::max(head, bucket)) { /// a late trade may be too old
+            addTotals(ws.buckets[base + bucket % ws.numBuckets], trade);
+            addTotals(ws.totals[id], trade);
+        }
+    }
+    latestAt_[id] = std::max(previous, timestamp);
+    latest_ = std::max(latest_, timestamp);
+}
+
+void RollingVWAP::advance(WindowState& window, const SymbolId id, const std::uint64_t from,
+                          const std::uint64_t to) {
+    const std::size_t base = static_cast<std::size_t>(id) * window.numBuckets;
+    if (to - from >= window.numBuckets) { /// the whole ring has slid out
+        std::fill_n(window.buckets.begin() + base, window.numBuckets, WindowEntry{});
+        window.totals[id] = {};
+        return;
+    }
+    for (std::uint64_t k = from + 1; k <= to; ++k) { /// the slot of `k` held `k - numBuckets`
+        WindowEntry& expired = window.buckets[base + k % window.numBuckets];
+        subtractTotals(window.totals[id], expired);
+        expired = {};
+    }
+}
+
+void RollingVWAP::setHead(WindowState& window, const SymbolId id, const std::uint64_t head) {
+    window.headStart[id] = head * window.width;
+    window.headSlot[id] = static_cast<std::uint32_t>(head % window.numBuckets);
+}
+
+void RollingVWAP::mergeFrom(const RollingVWAP& other) {
+    const bool sharedTable = symbols_ == other.symbols_;
+    for (SymbolId otherId = 0; otherId < other.present_.size(); ++otherId) {
+        if (!other.present_[otherId]) {
+            continue;
+        }
+        const SymbolId id =
+            sharedTable ? otherId : symbols_->intern(other.symbols_->symbolOf(otherId));
+        if (id >= present_.size()) {
+            ensureCapacity(id);
+        }
+        if (!present_[id]) {
+            present_[id] = 1;
+            latestAt_[id] = other.latestAt_[otherId];
+        }
+
+        const std::uint64_t latestAt = std::max(latestAt_[id], other.latestAt_[otherId]);
+        for (std::size_t w = 0; w < state_.size() && w < other.state_.size(); ++w) {
+            WindowState& ws = state_[w];
+            const WindowState& theirs = other.state_[w];
+            const std::uint64_t head = latestAt_[id] / ws.width;
+            const std::uint64_t otherHead = other.latestAt_[otherId] / ws.width;
+            const std::uint64_t newHead = latestAt / ws.width;
+            if (newHead > head) {
+                advance(ws, id, head, newHead);
+            }
+            setHead(ws, id, newHead);
+
+            const std::size_t base = static_cast<std::size_t>(id) * ws.numBuckets;
+            const std::size_t otherBase = static_cast<std::size_t>(otherId) * ws.numBuckets;
+            for (std::uint64_t j = 0; j < ws.numBuckets && j <= otherHead; ++j) {
+                const std::uint64_t k = otherHead - j;
+                if (k + ws.numBuckets <= newHead) { /// outside the merged window
+                    break;
+                }
+                const WindowEntry& bucket = theirs.buckets[otherBase + k % ws.numBuckets];
+                addTotals(ws.buckets[base + k % ws.numBuckets], bucket);
+                addTotals(ws.totals[id], bucket);
+            }
+        }
+        latestAt_[id] = latestAt;
+    }
+    latest_ = std::max(latest_, other.latest_);
+}
+
+void RollingVWAP::initWindows(std::pmr::memory_resource* memory) {
+    for (auto& window : windows_) {
+        window.buckets = std::max<std::uint32_t>(1, window.buckets);
+        state_.emplace_back(std::max<std::uint64_t>(1, window.length / window.buckets),
+                            window.buckets, memory);
+    }
+}
+
+void RollingVWAP::ensureCapacity(const SymbolId id) {
+    const std::size_t newSize = std::max<std::size_t>(id + 1, present_.size() * 2);
+    present_.resize(newSize);
+    latestAt_.resize(newSize);
+    for (auto& ws : state_) {
+        ws.buckets.resize(newSize * ws.numBuckets);
+        ws.totals.resize(newSize);
+        ws.headStart.resize(newSize);
+        ws.headSlot.resize(newSize);
+    }
+}
+
+void RollingVWAP::showStats(const std::uint64_t now) const {
+    std::cout << "\n=== Rolling VWAP (as of " << now << ") ===\n";
+    std::cout << std::left << std::setw(12) << "Symbol" << std::right;
+    for (const auto& window : windows_) {
+        std::cout << std::setw(12) << window.name;
+    }
+    std::cout << '\n' << std::string(12 + 12 * windows_.size(), '-') << '\n';
+
+    char symStr[9] = {0};
+    for (SymbolId id = 0; id < present_.size(); ++id) {
+        if (!present_[id]) {
+            continue;
+        }
+
+        const std::uint64_t symbol = symbols_->symbolOf(id);
+        std::memcpy(symStr, &symbol, sizeof(symbol));
+        std::cout << std::left << std::setw(12) << symStr << std::right;
+        for (std::size_t w = 0; w < windows_.size(); ++w) {
+            const auto entry = getWindowById(id, w, now);
+            if (!entry.has_value() || entry->totalQuantity == 0) {
+                std::cout << std::setw(12) << "-";
+                continue;
+            }
+            const double vwap =
+                static_cast<double>(entry->totalPriceByQuantity) / entry->totalQuantity / 100.0;
+            std::cout << std::fixed << std::setprecision(2) << std::setw(12) << vwap;
+        }
+        std::cout << '\n';
+    }
+}
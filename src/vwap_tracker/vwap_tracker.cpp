@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -5,45 +6,119 @@
 #include "messages.hpp"
 #include "vwap_tracker/vwap_tracker.hpp"
 
-auto VWAPTracker::getVWAP(std::uint64_t symbol) const -> std::optional<const VWAPEntry*> {
-    auto it = tracker_.find(symbol);
-    if (it == tracker_.end()) {
+VWAPTracker::VWAPTracker(std::size_t expectedSymbols, std::pmr::memory_resource* memory)
+    : ownedSymbols_{std::make_unique<SymbolTable>(expectedSymbols)}, symbols_{ownedSymbols_.get()},
+      updatedAt_{memory}, totalPriceByQuantity_{memory}, totalQuantity_{memory},
+      totalTrades_{memory} {
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+VWAPTracker::VWAPTracker(SymbolTable& symbols, std::size_t expectedSymbols,
+                         std::pmr::memory_resource* memory)
+    : symbols_{&symbols}, updatedAt_{memory}, totalPriceByQuantity_{memory},
+      totalQuantity_{memory}, totalTrades_{memory} {
+    ensureCapacity(static_cast<SymbolId>(expectedSymbols));
+}
+
+auto VWAPTracker::getVWAP(std::uint64_t symbol) const -> std::optional<VWAPEntry> {
+    const auto id = symbols_->find(symbol);
+    if (!id.has_value()) {
+        return std::nullopt;
+    }
+    return getVWAPById(*id);
+}
+
+auto VWAPTracker::getVWAPById(const SymbolId id) const -> std::optional<VWAPEntry> {
+    if (id >= totalTrades_.size() || totalTrades_[id] == 0) {
         return std::nullopt;
     }
-    return &it->second;
+    return VWAPEntry{updatedAt_[id], totalPriceByQuantity_[id], totalQuantity_[id],
+                     totalTrades_[id]};
 }
 
 void VWAPTracker::upsertVWAP(std::uint64_t symbol, const TradeMessage& msg) {
-    auto it = tracker_.find(symbol);
-    if (it == tracker_.end()) {
-        tracker_[symbol] = {msg.timestamp, msg.price * msg.quantity, msg.quantity, 1};
-        return;
+    upsertVWAPById(symbols_->intern(symbol), msg);
+}
+
+void VWAPTracker::upsertVWAPById(const SymbolId id, const TradeMessage& msg) {
+    if (id >= totalTrades_.size()) {
+        ensureCapacity(id);
     }
-    VWAPEntry& entry = it->second;
-    entry.updatedAt = msg.timestamp;
-    ++entry.totalTrades;
-    entry.totalPriceByQuantity += msg.price * msg.quantity;
-    entry.totalQuantity += msg.quantity;
+    size_ += totalTrades_[id] == 0;
+    updatedAt_[id] = msg.timestamp;
+    ++totalTrades_[id];
+    totalPriceByQuantity_[id] += msg.price * msg.quantity;
+    totalQuantity_[id] += msg.quantity;
     return;
 }
 
+void VWAPTracker::mergeFrom(const VWAPTracker& other) {
+    merge(other, false);
+}
+
+void VWAPTracker::mergeLaterFrom(const VWAPTracker& other) {
+    merge(other, true);
+}
+
+void VWAPTracker::merge(const VWAPTracker& other, const bool laterWins) {
+    const bool sharedTable = symbols_ == other.symbols_;
+    for (SymbolId otherId = 0; otherId < other.totalTrades_.size(); ++otherId) {
+        if (other.totalTrades_[otherId] == 0) {
+            continue;
+        }
+        const SymbolId id =
+            sharedTable ? otherId : symbols_->intern(other.symbols_->symbolOf(otherId));
+        if (id >= totalTrades_.size()) {
+            ensureCapacity(id);
+        }
+        size_ += totalTrades_[id] == 0;
+        updatedAt_[id] = laterWins ? other.updatedAt_[otherId]
+                                   : std::max(updatedAt_[id], other.updatedAt_[otherId]);
+        totalPriceByQuantity_[id] += other.totalPriceByQuantity_[otherId];
+        totalQuantity_[id] += other.totalQuantity_[otherId];
+        totalTrades_[id] += other.totalTrades_[otherId];
+    }
+}
+
+void VWAPTracker::restoreEntryById(const SymbolId id, const VWAPEntry& entry) {
+    if (id >= totalTrades_.size()) {
+        ensureCapacity(id);
+    }
+    const bool wasPresent = totalTrades_[id] != 0;
+    const bool isPresent = entry.totalTrades != 0;
+    size_ = size_ + isPresent - wasPresent;
+    updatedAt_[id] = entry.updatedAt;
+    totalPriceByQuantity_[id] = entry.totalPriceByQuantity;
+    totalQuantity_[id] = entry.totalQuantity;
+    totalTrades_[id] = entry.totalTrades;
+}
+
+void VWAPTracker::ensureCapacity(const SymbolId id) {
+    const std::size_t newSize = std::max<std::size_t>(id + 1, totalTrades_.size() * 2);
+    updatedAt_.resize(newSize);
+    totalPriceByQuantity_.resize(newSize);
+    totalQuantity_.resize(newSize);
+    totalTrades_.resize(newSize);
+}
+
 void VWAPTracker::showStats() const {
     std::cout << "\n=== VWAP Statistics ===\n";
     std::cout << std::left << std::setw(12) << "Symbol" << std::right << std::setw(12) << "VWAP"
               << std::setw(15) << "Total Qty" << std::setw(15) << "Trade Count\n";
     std::cout << std::string(54, '-') << '\n';
 
-    char symStr[8] = {0};
-    for (const auto& [symbol, vwap] : tracker_) {
-        if (vwap.totalQuantity == 0)
+    char symStr[9] = {0};
+    for (SymbolId id = 0; id < totalTrades_.size(); ++id) {
+        if (totalQuantity_[id] == 0)
             continue;
 
+        const std::uint64_t symbol = symbols_->symbolOf(id);
         std::memcpy(symStr, &symbol, sizeof(symbol));
         double vwap_price =
-            static_cast<double>(vwap.totalPriceByQuantity) / vwap.totalQuantity / 100.0;
+            static_cast<double>(totalPriceByQuantity_[id]) / totalQuantity_[id] / 100.0;
 
         std::cout << std::left << std::setw(12) << symStr << std::right << "$" << std::fixed
                   << std::setprecision(2) << std::setw(10) << vwap_price << std::setw(15)
-                  << vwap.totalQuantity << std::setw(15) << vwap.totalTrades << '\n';
+                  << totalQuantity_[id] << std::setw(15) << totalTrades_[id] << '\n';
     }
 }
@@ -5,6 +5,81 @@ import random
 
 DEBUG=True if os.getenv('DEBUG', False) == 'true' else False
 NUM_MESSAGES=int(os.getenv('MSGS', 1_000_000))
+DEPTH_RATIO=float(os.getenv('DEPTH_RATIO', 0.0))
+ORDER_RATIO=float(os.getenv('ORDER_RATIO', 0.0))
+
+def write_order_message(f, timestamp, symbol, base_price, live_orders, next_order_id):
+    # Adds new orders, or modifies/cancels/executes a random live one (IDs are never reused)
+    action = random.random() if live_orders else 0.0
+    if action < 0.4:
+        side = random.randint(0, 1)
+        if side == 0:
+            price = base_price + random.randint(-100, 0)
+        else:
+            price = base_price + random.randint(0, 100)
+        quantity = random.randint(1, 20) * 100
+        live_orders[next_order_id] = (symbol, side, price, quantity)
+
+        if DEBUG:
+            print(f"ADD -> symbol: {symbol}, id: {next_order_id}, side: {side}, price: {price}, qty: {quantity}, timestamp: {timestamp}")
+
+        f.write(struct.pack('<B', 4))
+        f.write(struct.pack('<Q', timestamp))
+        f.write(symbol)
+        f.write(struct.pack('<Q', next_order_id))
+        f.write(struct.pack('<Q', price))
+        f.write(struct.pack('<I', quantity))
+        f.write(struct.pack('<B', side))
+        f.write(b'\x00\x00')  # Padding
+        return next_order_id + 1
+
+    order_id = random.choice(list(live_orders))
+    symbol, side, price, quantity = live_orders[order_id]
+    if action < 0.6:
+        quantity = random.randint(0, 20) * 100  # zero cancels the order
+        if quantity == 0:
+            del live_orders[order_id]
+        else:
+            live_orders[order_id] = (symbol, side, price, quantity)
+
+        if DEBUG:
+            print(f"MODIFY -> symbol: {symbol}, id: {order_id}, price: {price}, qty: {quantity}, timestamp: {timestamp}")
+
+        f.write(struct.pack('<B', 5))
+        f.write(struct.pack('<Q', timestamp))
+        f.write(symbol)
+        f.write(struct.pack('<Q', order_id))
+        f.write(struct.pack('<Q', price))
+        f.write(struct.pack('<I', quantity))
+        f.write(b'\x00\x00\x00')  # Padding
+    elif action < 0.8:
+        del live_orders[order_id]
+
+        if DEBUG:
+            print(f"CANCEL -> symbol: {symbol}, id: {order_id}, timestamp: {timestamp}")
+
+        f.write(struct.pack('<B', 6))
+        f.write(struct.pack('<Q', timestamp))
+        f.write(symbol)
+        f.write(struct.pack('<Q', order_id))
+        f.write(b'\x00' * 7)  # Padding
+    else:
+        executed = random.randint(1, quantity // 100) * 100
+        if executed == quantity:
+            del live_orders[order_id]
+        else:
+            live_orders[order_id] = (symbol, side, price, quantity - executed)
+
+        if DEBUG:
+            print(f"EXECUTE -> symbol: {symbol}, id: {order_id}, qty: {executed}, timestamp: {timestamp}")
+
+        f.write(struct.pack('<B', 7))
+        f.write(struct.pack('<Q', timestamp))
+        f.write(symbol)
+        f.write(struct.pack('<Q', order_id))
+        f.write(struct.pack('<I', executed))
+        f.write(b'\x00\x00\x00')  # Padding
+    return next_order_id
 
 def generate_market_data(filename, num_messages=1_000_000):
     symbols = [
@@ -27,13 +102,39 @@ def generate_market_data(filename, num_messages=1_000_000):
         f.write(struct.pack('<Q', num_messages))
         
         timestamp = 1000000  # Start at 1 second
+        live_orders = {}
+        next_order_id = 1
         
         for _ in range(num_messages):
             symbol = random.choice(symbols)
             base_price = base_prices[symbol]
             
-            # 70% quotes, 30% trades
-            if random.random() < 0.7:
+            # ORDER_RATIO order messages, DEPTH_RATIO depth updates, then 70% quotes, 30% trades
+            # of the remainder
+            roll = random.random()
+            if roll < ORDER_RATIO:
+                next_order_id = write_order_message(f, timestamp, symbol, base_price, live_orders,
+                                                    next_order_id)
+            elif roll < ORDER_RATIO + DEPTH_RATIO:
+                msg_type = 3
+                side = random.randint(0, 1)
+                if side == 0:
+                    price = base_price + random.randint(-100, 0)
+                else:
+                    price = base_price + random.randint(0, 100)
+                quantity = random.randint(0, 20) * 100  # zero removes the level
+
+                if DEBUG:
+                    print(f"DEPTH -> symbol: {symbol}, side: {side}, price: {price}, qty: {quantity}, timestamp: {timestamp}")
+
+                f.write(struct.pack('<B', msg_type))
+                f.write(struct.pack('<Q', timestamp))
+                f.write(symbol)
+                f.write(struct.pack('<Q', price))
+                f.write(struct.pack('<I', quantity))
+                f.write(struct.pack('<B', side))
+                f.write(b'\x00\x00')  # Padding
+            elif random.random() < 0.7:
                 # Quote message
                 msg_type = 2
                 bid_price = base_price + random.randint(-100, 0)
@@ -0,0 +1,208 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "feed/compact_feed.hpp"
+#include "messages.hpp"
+
+class CompactFeedTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "compact_feed_test_" + std::to_string(getpid()) + ".mdc";
+        for (std::uint64_t i = 0; i < NUM_MESSAGES_; ++i) {
+            append(makeMessage(i));
+        }
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    /**
+     * @brief Message `i` of the test feed: every type in turn, over a few symbols, with prices
+     * and order IDs that move both ways.
+     */
+    static MarketDataMessage makeMessage(const std::uint64_t i) {
+        const auto type = static_cast<MessageType>(i % 7 + 1);
+        const std::uint64_t timestamp = 1'000'000 + 10 * i - (i % 5 == 0 ? 3 : 0);
+        const std::uint64_t symbol = 0x4C505041 + i % 3;
+        const std::uint64_t price = 15'000 + (i * 37) % 101 - 50;
+        const std::uint64_t orderId = 500 + (i * 13) % 29;
+        const auto quantity = static_cast<std::uint32_t>(100 + i);
+        const Side side = i % 2 == 0 ? Side::Bid : Side::Ask;
+
+        MarketDataMessage msg{};
+        switch (type) {
+        case MessageType::Trade:
+            msg.trade = {type, timestamp, symbol, price, quantity, {}};
+            break;
+        case MessageType::Quote:
+            msg.quote = {type, timestamp, symbol, price, quantity, price - 2, quantity + 1, {}};
+            break;
+        case MessageType::Depth:
+            msg.depth = {type, timestamp, symbol, price, quantity, side, {}};
+            break;
+        case MessageType::AddOrder:
+            msg.addOrder = {type, timestamp, symbol, orderId, price, quantity, side, {}};
+            break;
+        case MessageType::ModifyOrder:
+            msg.modifyOrder = {type, timestamp, symbol, orderId, price, quantity, {}};
+            break;
+        case MessageType::CancelOrder:
+            msg.cancelOrder = {type, timestamp, symbol, orderId, {}};
+            break;
+        case MessageType::ExecuteOrder:
+            msg.executeOrder = {type, timestamp, symbol, orderId, quantity, {}};
+            break;
+        }
+        return msg;
+    }
+
+    void append(const MarketDataMessage& msg) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        offsets_.push_back(sizeof(std::uint64_t) + raw_.size());
+        raw_.insert(raw_.end(), bytes, bytes + messageSize(msg.type));
+    }
+
+    /**
+     * @brief Encodes the test feed to `path_` and loads the file into `file_`.
+     */
+    void encode() {
+        CompactEncoder encoder{BLOCK_MESSAGES_};
+        ASSERT_EQ(0, encoder.open(path_.c_str()));
+        for (std::size_t i = 0; i < NUM_MESSAGES_; ++i) {
+            ASSERT_EQ(0, encoder.add(raw_.data() + offsets_[i] - sizeof(std::uint64_t)));
+        }
+        ASSERT_EQ(0, encoder.close());
+
+        std::ifstream in{path_, std::ios::binary | std::ios::ate};
+        size_ = static_cast<std::size_t>(in.tellg());
+        file_.assign((size_ + 7) / 8, 0);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(file_.data()), static_cast<std::streamsize>(size_));
+    }
+
+    const std::uint8_t* data() const {
+        return reinterpret_cast<const std::uint8_t*>(file_.data());
+    }
+
+    std::uint8_t* data() {
+        return reinterpret_cast<std::uint8_t*>(file_.data());
+    }
+
+    /**
+     * @brief Expects `msg` to be raw message `i`.
+     */
+    void expectMessage(const std::uint8_t* msg, const std::size_t i) {
+        ASSERT_NE(nullptr, msg);
+        const std::uint8_t* expected = raw_.data() + offsets_[i] - sizeof(std::uint64_t);
+        const auto size = messageSize(static_cast<MessageType>(*expected));
+        EXPECT_EQ(0, std::memcmp(expected, msg, size)) << "message " << i;
+    }
+
+    static constexpr std::size_t NUM_MESSAGES_ = 100;
+    static constexpr std::uint32_t BLOCK_MESSAGES_ = 16;
+
+    std::string path_;
+    std::vector<std::uint8_t> raw_;      /// the raw feed, without its count header
+    std::vector<std::uint64_t> offsets_; /// raw feed offset of each message, with the header
+    std::vector<std::uint64_t> file_;    /// the encoded file, 8-byte aligned
+    std::size_t size_{0};
+};
+
+TEST_F(CompactFeedTest, RoundTripsEveryMessageType) {
+    encode();
+    ASSERT_TRUE(CompactFeed::matches(data(), size_));
+    EXPECT_LT(size_, raw_.size());
+
+    CompactFeed feed;
+    ASSERT_EQ(0, feed.open(data(), size_));
+    ASSERT_EQ(NUM_MESSAGES_, feed.size());
+    for (std::size_t i = 0; i < NUM_MESSAGES_; ++i) {
+        EXPECT_EQ(offsets_[i], feed.offset());
+        expectMessage(feed.next(), i);
+    }
+    EXPECT_EQ(nullptr, feed.next());
+    EXPECT_FALSE(feed.truncated());
+    EXPECT_EQ(sizeof(std::uint64_t) + raw_.size(), feed.offset());
+}
+
+TEST_F(CompactFeedTest, SeeksToAnyMessage) {
+    encode();
+    CompactFeed feed;
+    ASSERT_EQ(0, feed.open(data(), size_));
+    for (const std::size_t message : {57, 0, 15, 16, 17, 99}) {
+        ASSERT_TRUE(feed.seekToMessage(message));
+        EXPECT_EQ(offsets_[message], feed.offset());
+        expectMessage(feed.next(), message);
+    }
+    ASSERT_TRUE(feed.seekToMessage(NUM_MESSAGES_));
+    EXPECT_EQ(nullptr, feed.next());
+    EXPECT_FALSE(feed.seekToMessage(NUM_MESSAGES_ + 1));
+    EXPECT_FALSE(feed.truncated());
+}
+
+TEST_F(CompactFeedTest, RejectsOtherData) {
+    encode();
+    CompactFeed feed;
+    EXPECT_EQ(-1, feed.open(data(), 0));
+    EXPECT_EQ(EPROTO, errno);
+    EXPECT_EQ(-1, feed.open(data(), size_ - 8));
+    EXPECT_EQ(EPROTO, errno);
+
+    CompactHeader header;
+    std::memcpy(&header, data(), sizeof(header));
+    ++header.version;
+    std::memcpy(data(), &header, sizeof(header));
+    EXPECT_EQ(-1, feed.open(data(), size_));
+    EXPECT_EQ(EPROTO, errno);
+}
+
+TEST_F(CompactFeedTest, StopsAtCorruptBlock) {
+    encode();
+    CompactHeader header;
+    std::memcpy(&header, data(), sizeof(header));
+    CompactBlockIndex second;
+    std::memcpy(&second, data() + header.indexOffset + sizeof(second), sizeof(second));
+    /// a symbol index past the dictionary at the start of the second block's symbol column
+    std::uint32_t lengths[COMPACT_COLUMNS];
+    std::memcpy(lengths, data() + second.offset, sizeof(lengths));
+    std::size_t symbolColumn = second.offset + sizeof(lengths);
+    for (std::size_t column = 0; column < SYMBOL_COLUMN; ++column) {
+        symbolColumn += lengths[column];
+    }
+    data()[symbolColumn] = 0x7F;
+
+    CompactFeed feed;
+    ASSERT_EQ(0, feed.open(data(), size_));
+    std::size_t count = 0;
+    while (feed.next() != nullptr) {
+        ++count;
+    }
+    EXPECT_EQ(BLOCK_MESSAGES_, count);
+    EXPECT_TRUE(feed.truncated());
+    EXPECT_EQ(offsets_[BLOCK_MESSAGES_], feed.offset());
+}
+
+TEST_F(CompactFeedTest, EncoderRejectsUnknownMessages) {
+    CompactEncoder encoder;
+    ASSERT_EQ(0, encoder.open(path_.c_str()));
+    MarketDataMessage msg = makeMessage(0);
+    msg.trade.type = static_cast<MessageType>(0);
+    EXPECT_EQ(-1, encoder.add(reinterpret_cast<const std::uint8_t*>(&msg)));
+    EXPECT_EQ(EINVAL, errno);
+
+    msg = makeMessage(2); /// a depth update with a side that is neither bid nor ask
+    msg.depth.side = static_cast<Side>(2);
+    EXPECT_EQ(-1, encoder.add(reinterpret_cast<const std::uint8_t*>(&msg)));
+    EXPECT_EQ(EINVAL, errno);
+    EXPECT_EQ(0, encoder.close());
+    EXPECT_EQ(0u, encoder.size());
+}
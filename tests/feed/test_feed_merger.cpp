@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+#include "feed/feed_merger.hpp"
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+
+class FeedMergerTest : public testing::Test {
+  protected:
+    /**
+     * @brief Returns a feed of one trade per timestamp in `timestamps`, each for symbol `symbol`.
+     */
+    static std::vector<std::uint8_t> feedOf(const std::vector<std::uint64_t>& timestamps,
+                                            const std::uint64_t symbol) {
+        std::vector<std::uint8_t> bytes(timestamps.size() * sizeof(TradeMessage));
+        for (std::size_t i = 0; i < timestamps.size(); ++i) {
+            TradeMessage trade{};
+            trade.type = MessageType::Trade;
+            trade.timestamp = timestamps[i];
+            trade.symbol = symbol;
+            std::memcpy(bytes.data() + i * sizeof(trade), &trade, sizeof(trade));
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Merges `feeds_` in full, returning the timestamp, symbol and venue of each message.
+     */
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> mergeAll(std::vector<VenueId>& venues) {
+        std::vector<MergeInput> inputs;
+        for (const auto& feed : feeds_) {
+            inputs.push_back({MappedFeed{feed.data(), feed.size()}, UINT64_MAX});
+        }
+        FeedMerger merger{std::move(inputs)};
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> merged;
+        while (const std::uint8_t* data = merger.next()) {
+            const auto& trade = *reinterpret_cast<const TradeMessage*>(data);
+            merged.emplace_back(trade.timestamp, trade.symbol);
+            venues.push_back(merger.venue());
+        }
+        EXPECT_FALSE(merger.truncated());
+        return merged;
+    }
+
+    std::vector<std::vector<std::uint8_t>> feeds_;
+};
+
+TEST_F(FeedMergerTest, MergesByTimestampAndTagsVenues) {
+    feeds_.push_back(feedOf({1, 4, 9}, 10));
+    feeds_.push_back(feedOf({2, 3, 10, 11}, 11));
+    feeds_.push_back(feedOf({5}, 12));
+
+    std::vector<VenueId> venues;
+    const auto merged = mergeAll(venues);
+    const std::vector<std::pair<std::uint64_t, std::uint64_t>> expected{
+        {1, 10}, {2, 11}, {3, 11}, {4, 10}, {5, 12}, {9, 10}, {10, 11}, {11, 11}};
+    EXPECT_EQ(expected, merged);
+    EXPECT_EQ((std::vector<VenueId>{0, 1, 1, 0, 2, 0, 1, 1}), venues);
+}
+
+TEST_F(FeedMergerTest, BreaksTiesByVenue) {
+    feeds_.push_back(feedOf({7, 7}, 20));
+    feeds_.push_back(feedOf({7}, 21));
+    feeds_.push_back(feedOf({6, 7}, 22));
+
+    std::vector<VenueId> venues;
+    mergeAll(venues);
+    EXPECT_EQ((std::vector<VenueId>{2, 0, 0, 1, 2}), venues);
+}
+
+TEST_F(FeedMergerTest, MatchesSortedMergeOfManyVenues) {
+    /// an odd venue count leaves the loser tree's leaves on two levels
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> expected;
+    for (std::uint64_t venue = 0; venue < 11; ++venue) {
+        std::vector<std::uint64_t> timestamps;
+        for (std::uint64_t t = venue; t < 500; t += venue % 4 + 1) {
+            timestamps.push_back(t * 3 / 2);
+            expected.emplace_back(t * 3 / 2, venue);
+        }
+        feeds_.push_back(feedOf(timestamps, venue));
+    }
+    std::stable_sort(expected.begin(), expected.end());
+
+    std::vector<VenueId> venues;
+    EXPECT_EQ(expected, mergeAll(venues));
+    for (std::size_t i = 0; i < venues.size(); ++i) {
+        EXPECT_EQ(expected[i].second, venues[i]);
+    }
+}
+
+TEST_F(FeedMergerTest, StopsEachInputAtItsLimitOrTruncation) {
+    feeds_.push_back(feedOf({1, 2, 3, 4}, 30));
+    feeds_.push_back(feedOf({1, 5}, 31));
+    feeds_[1].pop_back(); /// cuts the second message short
+
+    FeedMerger merger{{{MappedFeed{feeds_[0].data(), feeds_[0].size()}, 2},
+                       {MappedFeed{feeds_[1].data(), feeds_[1].size()}, UINT64_MAX}}};
+    std::uint64_t count = 0;
+    while (merger.next() != nullptr) {
+        ++count;
+    }
+    EXPECT_EQ(3u, count);
+    EXPECT_EQ(2u, merger.merged(0));
+    EXPECT_EQ(1u, merger.merged(1));
+    EXPECT_TRUE(merger.truncated());
+    EXPECT_EQ(3 * sizeof(TradeMessage), merger.offset());
+}
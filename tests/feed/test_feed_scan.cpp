@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "feed/feed_scan.hpp"
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+
+class FeedScanTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        for (std::size_t i = 0; i < NUM_MESSAGES_; ++i) {
+            append(i % 3 == 0 ? MessageType::Trade : MessageType::Quote);
+        }
+    }
+
+    void append(MessageType type) {
+        MarketDataMessage msg{};
+        msg.trade.type = type;
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        bytes_.insert(bytes_.end(), bytes, bytes + messageSize(type));
+    }
+
+    /// Checks that `scan` tiles `[0, end)` with chunks that each hold whole messages.
+    void expectTiled(const FeedScan& scan, std::size_t end) {
+        std::size_t offset = 0;
+        std::uint64_t messages = 0;
+        for (const auto& chunk : scan.chunks) {
+            EXPECT_EQ(offset, chunk.begin);
+            MappedFeed slice{bytes_.data() + chunk.begin, chunk.end - chunk.begin};
+            std::uint64_t count = 0;
+            while (slice.next() != nullptr) {
+                ++count;
+            }
+            EXPECT_FALSE(slice.truncated());
+            EXPECT_EQ(chunk.messages, count);
+            offset = chunk.end;
+            messages += count;
+        }
+        EXPECT_EQ(end, offset);
+        EXPECT_EQ(scan.messages, messages);
+    }
+
+    static constexpr std::size_t NUM_MESSAGES_ = 1'000;
+
+    std::vector<std::uint8_t> bytes_;
+};
+
+TEST_F(FeedScanTest, SplitsOnMessageBoundaries) {
+    const auto scan = scanFeed(bytes_.data(), bytes_.size(), UINT64_MAX, 7);
+    EXPECT_EQ(7u, scan.chunks.size());
+    EXPECT_EQ(NUM_MESSAGES_, scan.messages);
+    EXPECT_FALSE(scan.truncated);
+    expectTiled(scan, bytes_.size());
+}
+
+TEST_F(FeedScanTest, RecordsMessageTypes) {
+    auto scan = scanFeed(bytes_.data(), bytes_.size(), UINT64_MAX, 2);
+    EXPECT_TRUE(scan.contains(MessageType::Trade));
+    EXPECT_TRUE(scan.contains(MessageType::Quote));
+    EXPECT_FALSE(scan.contains(MessageType::Depth));
+
+    append(MessageType::AddOrder);
+    scan = scanFeed(bytes_.data(), bytes_.size(), UINT64_MAX, 2);
+    EXPECT_TRUE(scan.contains(MessageType::AddOrder));
+}
+
+TEST_F(FeedScanTest, StopsAtMessageLimit) {
+    const auto scan = scanFeed(bytes_.data(), bytes_.size(), 10, 4);
+    EXPECT_EQ(10u, scan.messages);
+    expectTiled(scan, scan.chunks.back().end);
+}
+
+TEST_F(FeedScanTest, DetectsTruncatedMessage) {
+    const auto scan = scanFeed(bytes_.data(), bytes_.size() - 1, UINT64_MAX, 3);
+    EXPECT_TRUE(scan.truncated);
+    EXPECT_EQ(NUM_MESSAGES_ - 1, scan.messages);
+    expectTiled(scan, scan.chunks.back().end);
+}
+
+TEST_F(FeedScanTest, MoreChunksThanMessages) {
+    bytes_.resize(messageSize(MessageType::Trade) + messageSize(MessageType::Quote));
+    const auto scan = scanFeed(bytes_.data(), bytes_.size(), UINT64_MAX, 16);
+    EXPECT_EQ(2u, scan.chunks.size());
+    expectTiled(scan, bytes_.size());
+}
+
+TEST_F(FeedScanTest, EmptyFeed) {
+    const auto scan = scanFeed(bytes_.data(), 0, UINT64_MAX, 4);
+    EXPECT_TRUE(scan.chunks.empty());
+    EXPECT_EQ(0u, scan.messages);
+}
@@ -0,0 +1,75 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+
+class MappedFeedTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        const std::uint64_t count = 2;
+        append(&count, sizeof(count));
+
+        TradeMessage trade{};
+        trade.type = MessageType::Trade;
+        trade.timestamp = 1;
+        append(&trade, sizeof(trade));
+
+        QuoteMessage quote{};
+        quote.type = MessageType::Quote;
+        quote.timestamp = 2;
+        append(&quote, sizeof(quote));
+    }
+
+    void append(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+    }
+
+    std::vector<std::uint8_t> bytes_;
+};
+
+TEST_F(MappedFeedTest, ReadsHeaderAndMessages) {
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+
+    const std::uint8_t* header = feed.peek(sizeof(std::uint64_t));
+    ASSERT_EQ(bytes_.data(), header);
+    feed.consume(sizeof(std::uint64_t));
+
+    const std::uint8_t* trade = feed.next();
+    ASSERT_NE(nullptr, trade);
+    EXPECT_EQ(MessageType::Trade, static_cast<MessageType>(*trade));
+
+    const std::uint8_t* quote = feed.next();
+    ASSERT_EQ(trade + sizeof(TradeMessage), quote);
+    EXPECT_EQ(MessageType::Quote, static_cast<MessageType>(*quote));
+
+    EXPECT_EQ(nullptr, feed.next());
+    EXPECT_FALSE(feed.truncated());
+}
+
+TEST_F(MappedFeedTest, DetectsTruncatedMessage) {
+    MappedFeed feed{bytes_.data(), bytes_.size() - 1};
+    feed.consume(sizeof(std::uint64_t));
+
+    EXPECT_NE(nullptr, feed.next());
+    EXPECT_EQ(nullptr, feed.next());
+    EXPECT_TRUE(feed.truncated());
+}
+
+TEST_F(MappedFeedTest, PeekPastEnd) {
+    MappedFeed feed{bytes_.data(), 4};
+    EXPECT_EQ(nullptr, feed.peek(sizeof(std::uint64_t)));
+}
+
+TEST_F(MappedFeedTest, StopsAtUnknownType) {
+    bytes_[sizeof(std::uint64_t) + sizeof(TradeMessage)] = 0xEE; /// corrupt the quote's type
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    feed.consume(sizeof(std::uint64_t));
+
+    EXPECT_NE(nullptr, feed.next());
+    EXPECT_EQ(nullptr, feed.next());
+    EXPECT_TRUE(feed.truncated());
+}
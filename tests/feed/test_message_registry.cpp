@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "messages.hpp"
+
+class MessageRegistryTest : public testing::Test {
+  protected:
+    /// Records which overload `dispatchMessage` picked.
+    struct Recorder {
+        void operator()(const TradeMessage& msg) {
+            seen = "Trade";
+            timestamp = msg.timestamp;
+        }
+        void operator()(const QuoteMessage&) {
+            seen = "Quote";
+        }
+        void operator()(const DepthMessage&) {
+            seen = "Depth";
+        }
+        void operator()(const AddOrderMessage&) {
+            seen = "AddOrder";
+        }
+        void operator()(const ModifyOrderMessage&) {
+            seen = "ModifyOrder";
+        }
+        void operator()(const CancelOrderMessage&) {
+            seen = "CancelOrder";
+        }
+        void operator()(const ExecuteOrderMessage&) {
+            seen = "ExecuteOrder";
+        }
+
+        std::string seen;
+        std::uint64_t timestamp{0};
+    };
+};
+
+TEST_F(MessageRegistryTest, SizesMatchStructs) {
+    EXPECT_EQ(sizeof(TradeMessage), messageSize(MessageType::Trade));
+    EXPECT_EQ(sizeof(QuoteMessage), messageSize(MessageType::Quote));
+    EXPECT_EQ(sizeof(DepthMessage), messageSize(MessageType::Depth));
+    EXPECT_EQ(sizeof(ExecuteOrderMessage), messageSize(MessageType::ExecuteOrder));
+    EXPECT_EQ(sizeof(QuoteMessage), MAX_MESSAGE_SIZE);
+}
+
+TEST_F(MessageRegistryTest, UnknownTypes) {
+    for (const std::uint8_t type : {0, 8, 0x7F, 0xFF}) {
+        EXPECT_FALSE(isKnownMessageType(type));
+        EXPECT_EQ(0u, messageSize(static_cast<MessageType>(type)));
+        EXPECT_STREQ("Unknown", messageTypeName(static_cast<MessageType>(type)));
+    }
+    EXPECT_TRUE(isKnownMessageType(static_cast<std::uint8_t>(MessageType::Trade)));
+    EXPECT_STREQ("CancelOrder", messageTypeName(MessageType::CancelOrder));
+}
+
+TEST_F(MessageRegistryTest, DispatchesToOverloadForType) {
+    for (std::uint8_t type = 1; type <= 7; ++type) {
+        MarketDataMessage msg{};
+        msg.type = static_cast<MessageType>(type);
+        Recorder recorder;
+        EXPECT_TRUE(dispatchMessage(reinterpret_cast<const std::uint8_t*>(&msg), recorder));
+        EXPECT_EQ(messageTypeName(msg.type), recorder.seen);
+    }
+
+    MarketDataMessage trade{};
+    trade.trade = {MessageType::Trade, 42, 0, 100, 1, {0, 0, 0}};
+    Recorder recorder;
+    dispatchMessage(reinterpret_cast<const std::uint8_t*>(&trade), recorder);
+    EXPECT_EQ(42u, recorder.timestamp);
+}
+
+TEST_F(MessageRegistryTest, IgnoresUnknownType) {
+    std::uint8_t bytes[MAX_MESSAGE_SIZE] = {0xEE};
+    Recorder recorder;
+    EXPECT_FALSE(dispatchMessage(bytes, recorder));
+    EXPECT_TRUE(recorder.seen.empty());
+}
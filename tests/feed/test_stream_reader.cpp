@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "feed/stream_reader.hpp"
+#include "messages.hpp"
+
+class StreamReaderTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(0, pipe(fds_));
+    }
+
+    void TearDown() override {
+        if (fds_[0] != -1) {
+            close(fds_[0]);
+        }
+        if (fds_[1] != -1) {
+            close(fds_[1]);
+        }
+    }
+
+    /// Appends a message of `type` with the given timestamp, cycling through every wire size.
+    static void appendMessage(std::vector<std::uint8_t>& feed, MessageType type,
+                              std::uint64_t timestamp) {
+        MarketDataMessage msg{};
+        msg.trade.type = type;
+        msg.trade.timestamp = timestamp;
+        msg.trade.symbol = 0x4C5041; /// "APL"
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        feed.insert(feed.end(), bytes, bytes + messageSize(type));
+    }
+
+    static std::vector<std::uint8_t> makeFeed(std::size_t numMessages) {
+        std::vector<std::uint8_t> feed;
+        for (std::size_t i = 0; i < numMessages; ++i) {
+            appendMessage(feed, static_cast<MessageType>(1 + i % 7), i);
+        }
+        return feed;
+    }
+
+    /// Writes `bytes` to the pipe in `pieceSize` writes from another thread, then closes it.
+    std::thread writeInPieces(const std::vector<std::uint8_t>& bytes, std::size_t pieceSize) {
+        const int fd = fds_[1];
+        fds_[1] = -1;
+        return std::thread{[&bytes, pieceSize, fd]() {
+            for (std::size_t off = 0; off < bytes.size(); off += pieceSize) {
+                const auto len = std::min(pieceSize, bytes.size() - off);
+                ASSERT_EQ(static_cast<ssize_t>(len), write(fd, bytes.data() + off, len));
+            }
+            close(fd);
+        }};
+    }
+
+    int fds_[2]{-1, -1};
+};
+
+TEST_F(StreamReaderTest, ReassemblesMessagesSplitAcrossChunks) {
+    const auto feed = makeFeed(1'000);
+    auto writer = writeInPieces(feed, 7);
+
+    StreamReader reader{fds_[0], 16}; /// chunks smaller than a message
+    for (std::uint64_t i = 0; i < 1'000; ++i) {
+        const std::uint8_t* data = reader.next();
+        ASSERT_NE(nullptr, data);
+        TradeMessage header;
+        std::memcpy(&header, data, sizeof(header));
+        EXPECT_EQ(static_cast<MessageType>(1 + i % 7), header.type);
+        EXPECT_EQ(i, header.timestamp);
+    }
+    EXPECT_EQ(nullptr, reader.next());
+    EXPECT_FALSE(reader.truncated());
+    EXPECT_EQ(0, reader.error());
+    writer.join();
+}
+
+TEST_F(StreamReaderTest, PeekAndConsumeHeader) {
+    std::vector<std::uint8_t> feed(sizeof(std::uint64_t));
+    const std::uint64_t count = 3;
+    std::memcpy(feed.data(), &count, sizeof(count));
+    const auto messages = makeFeed(3);
+    feed.insert(feed.end(), messages.begin(), messages.end());
+    auto writer = writeInPieces(feed, 5);
+
+    StreamReader reader{fds_[0], 32};
+    const std::uint8_t* header = reader.peek(sizeof(std::uint64_t));
+    ASSERT_NE(nullptr, header);
+    std::uint64_t value;
+    std::memcpy(&value, header, sizeof(value));
+    EXPECT_EQ(count, value);
+    reader.consume(sizeof(value));
+
+    std::size_t read = 0;
+    while (reader.next() != nullptr) {
+        ++read;
+    }
+    EXPECT_EQ(3u, read);
+    writer.join();
+}
+
+TEST_F(StreamReaderTest, DetectsTruncatedMessage) {
+    auto feed = makeFeed(10);
+    feed.resize(feed.size() - 5);
+    auto writer = writeInPieces(feed, 64);
+
+    StreamReader reader{fds_[0], 64};
+    std::size_t read = 0;
+    while (reader.next() != nullptr) {
+        ++read;
+    }
+    EXPECT_EQ(9u, read);
+    EXPECT_TRUE(reader.truncated());
+    writer.join();
+}
+
+TEST_F(StreamReaderTest, EmptyInput) {
+    close(fds_[1]);
+    fds_[1] = -1;
+
+    StreamReader reader{fds_[0]};
+    EXPECT_EQ(nullptr, reader.peek(sizeof(std::uint64_t)));
+    EXPECT_EQ(nullptr, reader.next());
+    EXPECT_FALSE(reader.truncated());
+}
+
+TEST_F(StreamReaderTest, ReadsRegularFile) {
+    const auto feed = makeFeed(5'000);
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(feed.size(), std::fwrite(feed.data(), 1, feed.size(), file));
+    std::fflush(file);
+    std::rewind(file);
+
+    StreamReader reader{fileno(file), 4'096};
+    std::uint64_t read = 0;
+    const std::uint8_t* data;
+    while ((data = reader.next()) != nullptr) {
+        TradeMessage header;
+        std::memcpy(&header, data, sizeof(header));
+        EXPECT_EQ(read++, header.timestamp);
+    }
+    EXPECT_EQ(5'000u, read);
+    EXPECT_FALSE(reader.truncated());
+    std::fclose(file);
+}
@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "feed/udp_feed.hpp"
+#include "messages.hpp"
+
+class UdpFeedTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        receiver_ = openUdpSocket("127.0.0.1", 0);
+        ASSERT_NE(-1, receiver_);
+        socklen_t len = sizeof(addr_);
+        ASSERT_EQ(0, getsockname(receiver_, reinterpret_cast<sockaddr*>(&addr_), &len));
+
+        sender_ = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, sender_);
+    }
+
+    void TearDown() override {
+        close(receiver_);
+        close(sender_);
+    }
+
+    /// Sends a packet carrying `count` trades whose timestamps equal their sequence numbers.
+    void sendPacket(std::uint64_t sequence, std::uint16_t count) {
+        const PacketHeader header{sequence, count};
+        std::vector<std::uint8_t> packet(sizeof(header) + count * sizeof(TradeMessage));
+        std::memcpy(packet.data(), &header, sizeof(header));
+
+        for (std::uint16_t i = 0; i < count; ++i) {
+            TradeMessage trade{};
+            trade.type = MessageType::Trade;
+            trade.timestamp = sequence + i;
+            std::memcpy(packet.data() + sizeof(header) + i * sizeof(trade), &trade, sizeof(trade));
+        }
+        sendRaw(packet.data(), packet.size());
+    }
+
+    void sendEndOfSession(std::uint64_t sequence) {
+        const PacketHeader header{sequence, END_OF_SESSION};
+        sendRaw(&header, sizeof(header));
+    }
+
+    void sendRaw(const void* data, std::size_t size) {
+        ASSERT_EQ(static_cast<ssize_t>(size),
+                  sendto(sender_, data, size, 0, reinterpret_cast<const sockaddr*>(&addr_),
+                         sizeof(addr_)));
+    }
+
+    /// Drains the feed and returns the timestamps of the delivered trades.
+    static std::vector<std::uint64_t> drain(UdpFeed& feed) {
+        std::vector<std::uint64_t> timestamps;
+        const std::uint8_t* data;
+        while ((data = feed.next()) != nullptr) {
+            TradeMessage trade;
+            std::memcpy(&trade, data, sizeof(trade));
+            timestamps.push_back(trade.timestamp);
+        }
+        return timestamps;
+    }
+
+    static constexpr int TIMEOUT_MS = 200;
+
+    int receiver_{-1};
+    int sender_{-1};
+    sockaddr_in addr_{};
+};
+
+TEST_F(UdpFeedTest, DeliversMessagesInSequence) {
+    sendPacket(1, 3);
+    sendPacket(4, 2);
+    sendEndOfSession(6);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 2, 3, 4, 5}), drain(feed));
+    EXPECT_EQ(0u, feed.gaps());
+    EXPECT_EQ(0u, feed.duplicates());
+    EXPECT_FALSE(feed.timedOut());
+    EXPECT_FALSE(feed.truncated());
+}
+
+TEST_F(UdpFeedTest, DetectsGaps) {
+    sendPacket(1, 2);
+    sendPacket(6, 1); /// 3, 4 and 5 lost
+    sendPacket(7, 1);
+    sendEndOfSession(8);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 2, 6, 7}), drain(feed));
+    EXPECT_EQ(1u, feed.gaps());
+    EXPECT_EQ(3u, feed.missedMessages());
+}
+
+TEST_F(UdpFeedTest, DropsRepeatedMessages) {
+    sendPacket(1, 3);
+    sendPacket(1, 3); /// exact duplicate
+    sendPacket(3, 3); /// overlaps message 3
+    sendEndOfSession(6);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 2, 3, 4, 5}), drain(feed));
+    EXPECT_EQ(1u, feed.duplicates());
+    EXPECT_EQ(0u, feed.gaps());
+}
+
+TEST_F(UdpFeedTest, JoinsMidSession) {
+    sendPacket(100, 2);
+    sendEndOfSession(102);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{100, 101}), drain(feed));
+    EXPECT_EQ(0u, feed.gaps());
+}
+
+TEST_F(UdpFeedTest, MalformedDatagramSkipped) {
+    sendPacket(1, 1);
+    const PacketHeader header{2, 2}; /// claims two messages but carries none
+    sendRaw(&header, sizeof(header));
+    sendPacket(4, 1);
+    sendEndOfSession(5);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 4}), drain(feed));
+    EXPECT_TRUE(feed.truncated());
+}
+
+TEST_F(UdpFeedTest, EndsOnIdleTimeout) {
+    sendPacket(1, 1);
+
+    UdpFeed feed{receiver_, false, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1}), drain(feed));
+    EXPECT_TRUE(feed.timedOut());
+}
+
+TEST_F(UdpFeedTest, BusyPoll) {
+    sendPacket(1, 2);
+    sendEndOfSession(3);
+
+    UdpFeed feed{receiver_, true, TIMEOUT_MS};
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 2}), drain(feed));
+    EXPECT_FALSE(feed.timedOut());
+}
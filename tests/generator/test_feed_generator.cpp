@@ -0,0 +1,140 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vector>
+
+#include "feed/mapped_feed.hpp"
+#include "generator/feed_generator.hpp"
+#include "messages.hpp"
+
+class FeedGeneratorTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        config_.messages = 3 * FeedGenerator::CHUNK_MESSAGES + 123;
+        config_.symbols = 10;
+    }
+
+    /**
+     * @brief Returns the whole feed `config` generates, without a count header.
+     */
+    static std::vector<std::uint8_t> generate(const GeneratorConfig& config) {
+        FeedGenerator generator{config};
+        std::vector<std::uint8_t> feed;
+        while (generator.nextRound()) {
+            for (std::size_t i = 0; i < generator.chunks(); ++i) {
+                feed.insert(feed.end(), generator.chunk(i).begin(), generator.chunk(i).end());
+            }
+        }
+        return feed;
+    }
+
+    /**
+     * @brief Calls `fn` with every message of `feed`, expecting whole messages of known types.
+     */
+    template <typename Fn>
+    static std::uint64_t forEachMessage(const std::vector<std::uint8_t>& feed, Fn fn) {
+        MappedFeed source{feed.data(), feed.size()};
+        std::uint64_t count = 0;
+        while (const std::uint8_t* data = source.next()) {
+            fn(*reinterpret_cast<const MarketDataMessage*>(data));
+            ++count;
+        }
+        EXPECT_FALSE(source.truncated());
+        return count;
+    }
+
+    GeneratorConfig config_;
+};
+
+TEST_F(FeedGeneratorTest, DependsOnSeedNotThreads) {
+    config_.threads = 1;
+    const auto serial = generate(config_);
+    config_.threads = 3;
+    EXPECT_EQ(serial, generate(config_));
+    config_.seed += 1;
+    EXPECT_NE(serial, generate(config_));
+}
+
+TEST_F(FeedGeneratorTest, WritesOrderedFeedOfTheUniverse) {
+    config_.threads = 2;
+    config_.depthRatio = 0.1;
+    FeedGenerator generator{config_};
+    std::unordered_map<std::uint64_t, int> universe;
+    for (std::uint32_t rank = 0; rank < config_.symbols; ++rank) {
+        universe[generator.symbol(rank)] = 0;
+    }
+    EXPECT_EQ(config_.symbols, universe.size());
+
+    std::uint64_t timestamp = FeedGenerator::START_TIMESTAMP;
+    const auto count = forEachMessage(generate(config_), [&](const MarketDataMessage& msg) {
+        EXPECT_GE(msg.trade.timestamp, timestamp);
+        timestamp = msg.trade.timestamp;
+        EXPECT_EQ(1u, universe.count(msg.trade.symbol));
+        if (msg.type == MessageType::Quote) {
+            EXPECT_LT(msg.quote.bidPrice, msg.quote.askPrice);
+            EXPECT_GT(msg.quote.bidQuantity, 0u);
+        }
+    });
+    EXPECT_EQ(config_.messages, count);
+}
+
+TEST_F(FeedGeneratorTest, MatchesConfiguredMix) {
+    config_.depthRatio = 0.2;
+    config_.tradeRatio = 0.5;
+    FeedGenerator generator{config_};
+    const std::uint64_t top = generator.symbol(0);
+    const std::uint64_t last = generator.symbol(config_.symbols - 1);
+
+    std::unordered_map<int, double> types;
+    double topCount = 0;
+    double lastCount = 0;
+    const auto count = forEachMessage(generate(config_), [&](const MarketDataMessage& msg) {
+        ++types[static_cast<int>(msg.type)];
+        topCount += msg.trade.symbol == top;
+        lastCount += msg.trade.symbol == last;
+    });
+    EXPECT_NEAR(0.2, types[static_cast<int>(MessageType::Depth)] / count, 0.01);
+    EXPECT_NEAR(0.4, types[static_cast<int>(MessageType::Trade)] / count, 0.01);
+    EXPECT_NEAR(0.4, types[static_cast<int>(MessageType::Quote)] / count, 0.01);
+
+    /// Zipf with exponent 1 over 10 ranks: the first is drawn 1/H(10) of the time, the last a
+    /// tenth of that
+    const double harmonic = 2.9289682539682538;
+    EXPECT_NEAR(1 / harmonic, topCount / count, 0.01);
+    EXPECT_NEAR(0.1 / harmonic, lastCount / count, 0.005);
+}
+
+TEST_F(FeedGeneratorTest, PricesWalkAcrossChunks) {
+    config_.threads = 2;
+    std::unordered_map<std::uint64_t, std::uint64_t> last;
+    /// trade prices and bids are within 5 of the mid, which moves by at most 1 per message
+    forEachMessage(generate(config_), [&](const MarketDataMessage& msg) {
+        const std::uint64_t price =
+            msg.type == MessageType::Trade ? msg.trade.price : msg.quote.bidPrice;
+        const auto it = last.find(msg.trade.symbol);
+        if (it != last.end()) {
+            EXPECT_LE(std::llabs(static_cast<long long>(price - it->second)), 11);
+        }
+        last[msg.trade.symbol] = price;
+    });
+}
+
+TEST_F(FeedGeneratorTest, GapsFollowTheBurstMix) {
+    config_.burstRatio = 0.5;
+    config_.meanGap = 100;
+    config_.burstGap = 2;
+    const auto feed = generate(config_);
+    std::uint64_t first = 0;
+    std::uint64_t lastTimestamp = 0;
+    const auto count = forEachMessage(feed, [&](const MarketDataMessage& msg) {
+        if (first == 0) {
+            first = msg.trade.timestamp;
+        }
+        lastTimestamp = msg.trade.timestamp;
+    });
+    /// half the gaps average about 100, the other half about 2, less a half for rounding down
+    const double meanGap = static_cast<double>(lastTimestamp - first) / (count - 1);
+    EXPECT_NEAR(0.5 * 99.5 + 0.5 * 1.5, meanGap, 5);
+}
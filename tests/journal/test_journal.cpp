@@ -0,0 +1,139 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "journal/journal.hpp"
+#include "messages.hpp"
+
+class JournalTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "journal_test_" + std::to_string(getpid()) + ".bin";
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    /**
+     * @brief A record of a trade at `sequence`, with the sequence mixed into its fields.
+     */
+    static JournalRecord makeRecord(const std::uint64_t sequence) {
+        JournalRecord record{};
+        record.sequence = sequence;
+        record.receivedAt = 1'000'000 + sequence;
+        record.msg.trade.type = MessageType::Trade;
+        record.msg.trade.timestamp = 10 * sequence;
+        record.msg.trade.price = 15'000 + sequence;
+        record.msg.trade.quantity = 100;
+        record.totalQuantity = 100 * sequence;
+        record.totalTrades = static_cast<std::uint32_t>(sequence);
+        return record;
+    }
+
+    std::string path_;
+};
+
+TEST_F(JournalTest, RoundTrip) {
+    JournalWriter writer;
+    ASSERT_EQ(0, writer.open(path_.c_str()));
+    for (std::uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_EQ(0, writer.append(makeRecord(i)));
+    }
+    EXPECT_EQ(3u, writer.size());
+    ASSERT_EQ(0, writer.close());
+
+    JournalReader reader;
+    ASSERT_EQ(0, reader.open(path_.c_str()));
+    EXPECT_EQ(JOURNAL_VERSION, reader.header().version);
+    EXPECT_EQ(3u, reader.header().records);
+    EXPECT_NE(0u, reader.header().openedAt);
+    ASSERT_EQ(3u, reader.size());
+    for (std::uint64_t i = 0; i < 3; ++i) {
+        const JournalRecord& record = reader.records()[i];
+        EXPECT_EQ(i + 1, record.sequence);
+        EXPECT_EQ(1'000'001 + i, record.receivedAt);
+        EXPECT_EQ(MessageType::Trade, record.msg.trade.type);
+        EXPECT_EQ(15'001 + i, record.msg.trade.price);
+        EXPECT_EQ(100 * (i + 1), record.totalQuantity);
+    }
+}
+
+TEST_F(JournalTest, GrowsPastPreallocation) {
+    constexpr std::uint64_t COUNT = JournalWriter::GROWTH_RECORDS + 10;
+    JournalWriter writer;
+    ASSERT_EQ(0, writer.open(path_.c_str()));
+    for (std::uint64_t i = 1; i <= COUNT; ++i) {
+        ASSERT_EQ(0, writer.append(makeRecord(i)));
+    }
+    ASSERT_EQ(0, writer.close());
+
+    JournalReader reader;
+    ASSERT_EQ(0, reader.open(path_.c_str()));
+    ASSERT_EQ(COUNT, reader.size());
+    EXPECT_EQ(1u, reader.records()[0].sequence);
+    EXPECT_EQ(COUNT, reader.records()[COUNT - 1].sequence);
+}
+
+TEST_F(JournalTest, RecoversUnclosedJournal) {
+    const pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) { /// dies after appending, without closing the journal
+        JournalWriter writer;
+        if (writer.open(path_.c_str()) == -1) {
+            _exit(1);
+        }
+        for (std::uint64_t i = 1; i <= 5; ++i) {
+            writer.append(makeRecord(i));
+        }
+        _exit(0);
+    }
+    int status;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    JournalReader reader;
+    ASSERT_EQ(0, reader.open(path_.c_str()));
+    EXPECT_EQ(0u, reader.header().records);
+    ASSERT_EQ(5u, reader.size());
+    EXPECT_EQ(5u, reader.records()[4].sequence);
+}
+
+TEST_F(JournalTest, RejectsOtherFiles) {
+    JournalReader reader;
+    EXPECT_EQ(-1, reader.open(path_.c_str()));
+    EXPECT_EQ(ENOENT, errno);
+
+    std::ofstream{path_, std::ios::binary} << std::string(200, 'x');
+    EXPECT_EQ(-1, reader.open(path_.c_str()));
+    EXPECT_EQ(EPROTO, errno);
+}
+
+TEST_F(JournalTest, RecorderWritesEveryRecordInOrder) {
+    constexpr std::uint64_t COUNT = 3 * JournalRecorder::QUEUE_SIZE + 7;
+    JournalWriter writer;
+    ASSERT_EQ(0, writer.open(path_.c_str()));
+    {
+        JournalRecorder recorder{writer};
+        for (std::uint64_t i = 1; i <= COUNT; ++i) {
+            recorder.record(makeRecord(i));
+        }
+        EXPECT_EQ(0, recorder.stop());
+    }
+    EXPECT_EQ(COUNT, writer.size());
+    ASSERT_EQ(0, writer.close());
+
+    JournalReader reader;
+    ASSERT_EQ(0, reader.open(path_.c_str()));
+    ASSERT_EQ(COUNT, reader.size());
+    for (std::uint64_t i = 0; i < COUNT; ++i) {
+        ASSERT_EQ(i + 1, reader.records()[i].sequence);
+        ASSERT_EQ(15'001 + i, reader.records()[i].msg.trade.price);
+    }
+}
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "latency/latency_histogram.hpp"
+#include "latency/latency_stats.hpp"
+#include "messages.hpp"
+
+class LatencyHistogramTest : public testing::Test {
+  protected:
+    LatencyHistogram histogram_;
+};
+
+TEST_F(LatencyHistogramTest, Empty) {
+    EXPECT_EQ(0u, histogram_.count());
+    EXPECT_EQ(0u, histogram_.percentile(0.5));
+    EXPECT_EQ(0u, histogram_.max());
+}
+
+TEST_F(LatencyHistogramTest, SmallValuesAreExact) {
+    for (std::uint64_t v = 1; v <= 10; ++v) {
+        histogram_.record(v);
+    }
+    EXPECT_EQ(10u, histogram_.count());
+    EXPECT_EQ(5u, histogram_.percentile(0.5));
+    EXPECT_EQ(10u, histogram_.percentile(1.0));
+    EXPECT_EQ(1u, histogram_.percentile(0.0));
+}
+
+TEST_F(LatencyHistogramTest, BucketsCoverEveryValueInOrder) {
+    std::uint64_t previousHighest = 0;
+    for (std::size_t bucket = 1; bucket < LatencyHistogram::NUM_BUCKETS; ++bucket) {
+        const auto highest = LatencyHistogram::highestValueIn(bucket);
+        ASSERT_GT(highest, previousHighest);
+        EXPECT_EQ(bucket, LatencyHistogram::bucketOf(previousHighest + 1)); /// no holes
+        EXPECT_EQ(bucket, LatencyHistogram::bucketOf(highest));
+        previousHighest = highest;
+    }
+    EXPECT_EQ(~std::uint64_t{0}, previousHighest);
+}
+
+TEST_F(LatencyHistogramTest, PercentilesWithinPrecision) {
+    for (std::uint64_t v = 1; v <= 100'000; ++v) {
+        histogram_.record(v);
+    }
+    const auto within = [](std::uint64_t actual, double expected) {
+        return actual >= expected && actual <= expected * (1.0 + 1.0 / 32);
+    };
+    EXPECT_TRUE(within(histogram_.percentile(0.5), 50'000));
+    EXPECT_TRUE(within(histogram_.percentile(0.99), 99'000));
+    EXPECT_TRUE(within(histogram_.percentile(0.999), 99'900));
+    EXPECT_EQ(100'000u, histogram_.percentile(1.0)); /// capped at the exact maximum
+    EXPECT_EQ(100'000u, histogram_.max());
+}
+
+TEST_F(LatencyHistogramTest, MergeFrom) {
+    LatencyHistogram other;
+    histogram_.record(10);
+    other.record(20);
+    other.record(1'000'000);
+
+    histogram_.mergeFrom(other);
+    EXPECT_EQ(3u, histogram_.count());
+    EXPECT_EQ(20u, histogram_.percentile(0.5));
+    EXPECT_EQ(1'000'000u, histogram_.max());
+}
+
+TEST(LatencyStatsTest, RecordsStagesAndTypes) {
+    LatencyStats stats;
+    stats.record(MessageType::Trade, 100, 110, 140, 145);
+    stats.record(MessageType::Quote, 200, 205, 190, 230); /// dequeue stamp behind enqueue stamp
+
+    EXPECT_EQ(2u, stats.stage(LatencyStats::EndToEnd).count());
+    EXPECT_EQ(45u, stats.stage(LatencyStats::EndToEnd).max());
+    EXPECT_EQ(30u, stats.stage(LatencyStats::EnqueueToDequeue).max());
+    EXPECT_EQ(0u, stats.stage(LatencyStats::EnqueueToDequeue).percentile(0.0));
+    EXPECT_EQ(1u, stats.type(MessageType::Trade).count());
+    EXPECT_EQ(45u, stats.type(MessageType::Trade).max());
+    EXPECT_EQ(0u, stats.type(MessageType::Depth).count());
+}
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory_resource>
+
+#include "memory/huge_page_resource.hpp"
+#include "messages.hpp"
+#include "orderbook/orderbook.hpp"
+#include "ringbuffer/spsc_queue.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+class HugePageResourceTest : public testing::Test {
+  protected:
+    static bool isAligned(const void* p, std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+
+    HugePageResource resource_;
+};
+
+TEST_F(HugePageResourceTest, LargeAllocationsAreMappedInHugePages) {
+    const std::size_t bytes = 3 * HugePageResource::HUGE_PAGE_SIZE + 123;
+    void* p = resource_.allocate(bytes, alignof(std::uint64_t));
+    ASSERT_NE(nullptr, p);
+    EXPECT_TRUE(isAligned(p, HugePageResource::HUGE_PAGE_SIZE));
+    EXPECT_EQ(4 * HugePageResource::HUGE_PAGE_SIZE,
+              resource_.hugeTlbBytes() + resource_.transparentBytes());
+
+    std::memset(p, 0xAB, bytes);
+    EXPECT_EQ(0xAB, static_cast<std::uint8_t*>(p)[bytes - 1]);
+    resource_.deallocate(p, bytes, alignof(std::uint64_t));
+}
+
+TEST_F(HugePageResourceTest, DeallocationUnmapsAndUncounts) {
+    const std::size_t bytes = HugePageResource::HUGE_PAGE_SIZE;
+    void* a = resource_.allocate(bytes, alignof(std::uint64_t));
+    void* b = resource_.allocate(2 * bytes, alignof(std::uint64_t));
+    EXPECT_EQ(3 * bytes, resource_.hugeTlbBytes() + resource_.transparentBytes());
+
+    resource_.deallocate(a, bytes, alignof(std::uint64_t));
+    EXPECT_EQ(2 * bytes, resource_.hugeTlbBytes() + resource_.transparentBytes());
+    resource_.deallocate(b, 2 * bytes, alignof(std::uint64_t));
+    EXPECT_EQ(0u, resource_.hugeTlbBytes());
+    EXPECT_EQ(0u, resource_.transparentBytes());
+    EXPECT_EQ(3 * bytes, resource_.peakHugeTlbBytes() + resource_.peakTransparentBytes());
+}
+
+TEST_F(HugePageResourceTest, SmallAllocationsAreCacheLineAligned) {
+    void* a = resource_.allocate(24, 8);
+    void* b = resource_.allocate(24, 8);
+    EXPECT_TRUE(isAligned(a, HugePageResource::CACHE_LINE_SIZE));
+    EXPECT_TRUE(isAligned(b, HugePageResource::CACHE_LINE_SIZE));
+    EXPECT_EQ(0u, resource_.hugeTlbBytes() + resource_.transparentBytes());
+    resource_.deallocate(a, 24, 8);
+    resource_.deallocate(b, 24, 8);
+}
+
+TEST_F(HugePageResourceTest, BacksQueueRing) {
+    SPSCQueue<std::uint64_t, 1 << 16, std::pmr::polymorphic_allocator<std::uint64_t>> queue{
+        &resource_};
+    EXPECT_EQ(HugePageResource::HUGE_PAGE_SIZE,
+              resource_.hugeTlbBytes() + resource_.transparentBytes());
+
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue.enqueue(i));
+    }
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        std::uint64_t value;
+        ASSERT_TRUE(queue.dequeue(value));
+        EXPECT_EQ(i, value);
+    }
+}
+
+TEST_F(HugePageResourceTest, BacksBookAndTrackerColumns) {
+    SymbolTable symbols;
+    OrderBook book{symbols, 100'000, &resource_};
+    VWAPTracker tracker{symbols, 100'000, &resource_};
+    EXPECT_GT(resource_.hugeTlbBytes() + resource_.transparentBytes(), 0u);
+
+    QuoteMessage quote{};
+    quote.type = MessageType::Quote;
+    quote.symbol = 0x4C5041;
+    quote.askPrice = 101;
+    book.upsertEntry(quote.symbol, quote);
+
+    TradeMessage trade{};
+    trade.type = MessageType::Trade;
+    trade.symbol = 0x4C5041;
+    trade.price = 100;
+    trade.quantity = 10;
+    tracker.upsertVWAP(trade.symbol, trade);
+
+    ASSERT_TRUE(book.getEntry(0x4C5041).has_value());
+    EXPECT_EQ(101u, book.getEntry(0x4C5041)->askPrice);
+    ASSERT_TRUE(tracker.getVWAP(0x4C5041).has_value());
+    EXPECT_EQ(10u, tracker.getVWAP(0x4C5041)->totalQuantity);
+}
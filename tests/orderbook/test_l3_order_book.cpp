@@ -0,0 +1,249 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "messages.hpp"
+#include "orderbook/l3_order_book.hpp"
+#include "orderbook/orderbook.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+class L3OrderBookTest : public testing::Test {
+  protected:
+    AddOrderMessage addMsg(std::uint64_t orderId, Side side, std::uint64_t price,
+                           std::uint32_t quantity) const {
+        AddOrderMessage msg{};
+        msg.type = MessageType::AddOrder;
+        msg.timestamp = timestamp_;
+        msg.symbol = SYMBOL;
+        msg.orderId = orderId;
+        msg.price = price;
+        msg.quantity = quantity;
+        msg.side = side;
+        return msg;
+    }
+
+    ModifyOrderMessage modifyMsg(std::uint64_t orderId, std::uint64_t price,
+                                 std::uint32_t quantity) const {
+        ModifyOrderMessage msg{};
+        msg.type = MessageType::ModifyOrder;
+        msg.timestamp = timestamp_;
+        msg.symbol = SYMBOL;
+        msg.orderId = orderId;
+        msg.price = price;
+        msg.quantity = quantity;
+        return msg;
+    }
+
+    CancelOrderMessage cancelMsg(std::uint64_t orderId) const {
+        CancelOrderMessage msg{};
+        msg.type = MessageType::CancelOrder;
+        msg.timestamp = timestamp_;
+        msg.symbol = SYMBOL;
+        msg.orderId = orderId;
+        return msg;
+    }
+
+    ExecuteOrderMessage executeMsg(std::uint64_t orderId, std::uint32_t quantity) const {
+        ExecuteOrderMessage msg{};
+        msg.type = MessageType::ExecuteOrder;
+        msg.timestamp = timestamp_;
+        msg.symbol = SYMBOL;
+        msg.orderId = orderId;
+        msg.quantity = quantity;
+        return msg;
+    }
+
+    std::uint32_t levelQuantity(Side side, std::uint64_t price) const {
+        auto ladder = book_.getLadder(SYMBOL);
+        return ladder.has_value() ? ladder.value()->quantityAt(side, price) : 0;
+    }
+
+    static constexpr std::uint64_t SYMBOL = 1;
+
+    std::uint64_t timestamp_{1'000'000};
+    SymbolTable symbols_;
+    OrderBook book_{symbols_};
+    VWAPTracker vwap_{symbols_};
+    L3OrderBook orders_{symbols_, book_, vwap_, 4};
+};
+
+TEST_F(L3OrderBookTest, AddOrdersQueueInTimePriority) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(11, Side::Bid, 100, 200));
+    orders_.addOrder(addMsg(12, Side::Ask, 101, 50));
+
+    EXPECT_EQ(3u, orders_.size());
+    EXPECT_EQ(500u, levelQuantity(Side::Bid, 100));
+    EXPECT_EQ(50u, levelQuantity(Side::Ask, 101));
+
+    std::uint64_t ids[4];
+    ASSERT_EQ(2u, orders_.ordersAt(symbols_.intern(SYMBOL), Side::Bid, 100, ids, 4));
+    EXPECT_EQ(10u, ids[0]);
+    EXPECT_EQ(11u, ids[1]);
+
+    auto order = orders_.getOrder(12);
+    ASSERT_TRUE(order.has_value());
+    EXPECT_EQ(Side::Ask, order->side);
+    EXPECT_EQ(101u, order->price);
+    EXPECT_EQ(50u, order->quantity);
+}
+
+TEST_F(L3OrderBookTest, DuplicateAddIgnored) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(10, Side::Bid, 99, 100));
+
+    EXPECT_EQ(1u, orders_.size());
+    EXPECT_EQ(300u, levelQuantity(Side::Bid, 100));
+    EXPECT_EQ(0u, levelQuantity(Side::Bid, 99));
+}
+
+TEST_F(L3OrderBookTest, ModifyDownKeepsPriority) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(11, Side::Bid, 100, 200));
+    orders_.modifyOrder(modifyMsg(10, 100, 100));
+
+    std::uint64_t ids[2];
+    ASSERT_EQ(2u, orders_.ordersAt(symbols_.intern(SYMBOL), Side::Bid, 100, ids, 2));
+    EXPECT_EQ(10u, ids[0]);
+    EXPECT_EQ(300u, levelQuantity(Side::Bid, 100));
+}
+
+TEST_F(L3OrderBookTest, ModifyUpLosesPriority) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(11, Side::Bid, 100, 200));
+    orders_.modifyOrder(modifyMsg(10, 100, 400));
+
+    std::uint64_t ids[2];
+    ASSERT_EQ(2u, orders_.ordersAt(symbols_.intern(SYMBOL), Side::Bid, 100, ids, 2));
+    EXPECT_EQ(11u, ids[0]);
+    EXPECT_EQ(10u, ids[1]);
+    EXPECT_EQ(600u, levelQuantity(Side::Bid, 100));
+}
+
+TEST_F(L3OrderBookTest, ModifyPriceMovesLevel) {
+    orders_.addOrder(addMsg(10, Side::Ask, 105, 300));
+    orders_.modifyOrder(modifyMsg(10, 104, 300));
+
+    EXPECT_EQ(0u, levelQuantity(Side::Ask, 105));
+    EXPECT_EQ(300u, levelQuantity(Side::Ask, 104));
+
+    auto entry = book_.getEntry(SYMBOL);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(104u, entry->askPrice);
+}
+
+TEST_F(L3OrderBookTest, ModifyToZeroRemovesOrder) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.modifyOrder(modifyMsg(10, 100, 0));
+
+    EXPECT_EQ(0u, orders_.size());
+    EXPECT_FALSE(orders_.getOrder(10).has_value());
+    EXPECT_EQ(0u, levelQuantity(Side::Bid, 100));
+}
+
+TEST_F(L3OrderBookTest, CancelRemovesOrderAndLevel) {
+    orders_.addOrder(addMsg(10, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(11, Side::Bid, 100, 200));
+    orders_.addOrder(addMsg(12, Side::Bid, 100, 100));
+
+    orders_.cancelOrder(cancelMsg(11));
+    std::uint64_t ids[4];
+    ASSERT_EQ(2u, orders_.ordersAt(symbols_.intern(SYMBOL), Side::Bid, 100, ids, 4));
+    EXPECT_EQ(10u, ids[0]);
+    EXPECT_EQ(12u, ids[1]);
+    EXPECT_EQ(400u, levelQuantity(Side::Bid, 100));
+
+    orders_.cancelOrder(cancelMsg(10));
+    orders_.cancelOrder(cancelMsg(12));
+    EXPECT_EQ(0u, orders_.size());
+    EXPECT_EQ(0u, orders_.ordersAt(symbols_.intern(SYMBOL), Side::Bid, 100, ids, 4));
+    EXPECT_EQ(0u, levelQuantity(Side::Bid, 100));
+}
+
+TEST_F(L3OrderBookTest, ExecuteRecordsTrades) {
+    orders_.addOrder(addMsg(10, Side::Ask, 200, 300));
+
+    orders_.executeOrder(executeMsg(10, 100));
+    auto order = orders_.getOrder(10);
+    ASSERT_TRUE(order.has_value());
+    EXPECT_EQ(200u, order->quantity);
+    EXPECT_EQ(200u, levelQuantity(Side::Ask, 200));
+
+    orders_.executeOrder(executeMsg(10, 500)); /// over-execution fills only what rests
+    EXPECT_FALSE(orders_.getOrder(10).has_value());
+    EXPECT_EQ(0u, levelQuantity(Side::Ask, 200));
+
+    auto vwap = vwap_.getVWAP(SYMBOL);
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_EQ(2u, vwap->totalTrades);
+    EXPECT_EQ(300u, vwap->totalQuantity);
+    EXPECT_EQ(60'000u, vwap->totalPriceByQuantity);
+}
+
+TEST_F(L3OrderBookTest, UnknownOrdersIgnored) {
+    orders_.modifyOrder(modifyMsg(99, 100, 100));
+    orders_.cancelOrder(cancelMsg(99));
+    orders_.executeOrder(executeMsg(99, 100));
+
+    EXPECT_EQ(0u, orders_.size());
+    EXPECT_FALSE(vwap_.getVWAP(SYMBOL).has_value());
+    EXPECT_FALSE(book_.getLadder(SYMBOL).has_value());
+}
+
+TEST_F(L3OrderBookTest, PoolSlotsRecycled) {
+    for (std::uint64_t id = 1; id <= 1'000; ++id) {
+        orders_.addOrder(addMsg(id, Side::Bid, 100 + id % 8, 100));
+        if (id > 2) {
+            orders_.cancelOrder(cancelMsg(id - 2));
+        }
+    }
+
+    EXPECT_EQ(2u, orders_.size());
+    EXPECT_TRUE(orders_.getOrder(999).has_value());
+    EXPECT_TRUE(orders_.getOrder(1'000).has_value());
+    EXPECT_EQ(100u, levelQuantity(Side::Bid, 100 + 999 % 8));
+}
+
+/// Each message with the reserved ID must be dropped without touching the two orders resting
+/// at the same price, whose slots an unguarded lookup would hit.
+class L3OrderBookInvalidIdTest : public L3OrderBookTest {
+  protected:
+    void SetUp() override {
+        orders_.addOrder(addMsg(1, Side::Bid, 100, 500));
+        orders_.addOrder(addMsg(2, Side::Bid, 100, 700));
+    }
+
+    void TearDown() override {
+        EXPECT_FALSE(orders_.getOrder(INVALID).has_value());
+        EXPECT_EQ(2u, orders_.size());
+        EXPECT_EQ(500u, orders_.getOrder(1)->quantity);
+        EXPECT_EQ(700u, orders_.getOrder(2)->quantity);
+        EXPECT_EQ(1'200u, levelQuantity(Side::Bid, 100));
+        EXPECT_FALSE(vwap_.getVWAP(SYMBOL).has_value());
+    }
+
+    static constexpr std::uint64_t INVALID = L3OrderBook::INVALID_ORDER_ID;
+};
+
+TEST_F(L3OrderBookInvalidIdTest, AddRejected) {
+    orders_.addOrder(addMsg(INVALID, Side::Bid, 100, 300));
+    orders_.addOrder(addMsg(INVALID, Side::Bid, 100, 300));
+    EXPECT_EQ(2u, orders_.rejected());
+}
+
+TEST_F(L3OrderBookInvalidIdTest, ModifyRejected) {
+    orders_.modifyOrder(modifyMsg(INVALID, 100, 100));
+    orders_.modifyOrder(modifyMsg(INVALID, 101, 0));
+    EXPECT_EQ(2u, orders_.rejected());
+}
+
+TEST_F(L3OrderBookInvalidIdTest, CancelRejected) {
+    orders_.cancelOrder(cancelMsg(INVALID));
+    orders_.cancelOrder(cancelMsg(INVALID)); /// would release the same pool slot twice
+    EXPECT_EQ(2u, orders_.rejected());
+}
+
+TEST_F(L3OrderBookInvalidIdTest, ExecuteRejected) {
+    orders_.executeOrder(executeMsg(INVALID, 100));
+    EXPECT_EQ(1u, orders_.rejected());
+}
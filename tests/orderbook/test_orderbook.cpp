@@ -43,7 +43,7 @@ TEST_F(OrderBookTest, GetEntrySuccess) {
     auto entry = book_.getEntry(std::uint64_t{1});
     ASSERT_TRUE(entry.has_value());
 
-    auto value = *entry.value();
+    auto value = entry.value();
     EXPECT_EQ(value.udpatedAt, std::uint64_t{1'000'000});
     EXPECT_EQ(value.bidPrice, std::uint64_t{15'005});
     EXPECT_EQ(value.bidQuantity, std::uint32_t{100});
@@ -53,7 +53,7 @@ TEST_F(OrderBookTest, GetEntrySuccess) {
     entry = book_.getEntry(std::uint64_t{2});
     ASSERT_TRUE(entry.has_value());
 
-    value = *entry.value();
+    value = entry.value();
     EXPECT_EQ(value.udpatedAt, std::uint64_t{1'000'050});
     EXPECT_EQ(value.bidPrice, std::uint64_t{15'005});
     EXPECT_EQ(value.bidQuantity, std::uint32_t{100});
@@ -63,7 +63,7 @@ TEST_F(OrderBookTest, GetEntrySuccess) {
     entry = book_.getEntry(std::uint64_t{3});
     ASSERT_TRUE(entry.has_value());
 
-    value = *entry.value();
+    value = entry.value();
     EXPECT_EQ(value.udpatedAt, std::uint64_t{1'000'100});
     EXPECT_EQ(value.bidPrice, std::uint64_t{15'005});
     EXPECT_EQ(value.bidQuantity, std::uint32_t{100});
@@ -79,3 +79,258 @@ TEST_F(OrderBookTest, GetEntryNull) {
 TEST_F(OrderBookTest, Size) {
     EXPECT_EQ(3u, book_.size());
 }
+
+TEST_F(OrderBookTest, MergeFrom) {
+    OrderBook other;
+    QuoteMessage msg = getDefaultMsg();
+
+    msg.timestamp = std::uint64_t{2'000'000}; /// newer than the entry in `book_`
+    msg.bidPrice = std::uint64_t{15'100};
+    other.upsertEntry(msg.symbol, msg);
+
+    msg.symbol = std::uint64_t{2};
+    msg.timestamp = std::uint64_t{1}; /// older than the entry in `book_`
+    other.upsertEntry(msg.symbol, msg);
+
+    msg.symbol = std::uint64_t{4};
+    other.upsertEntry(msg.symbol, msg);
+
+    book_.mergeFrom(other);
+    EXPECT_EQ(4u, book_.size());
+
+    auto entry = book_.getEntry(std::uint64_t{1});
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->bidPrice, std::uint64_t{15'100});
+
+    entry = book_.getEntry(std::uint64_t{2});
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->udpatedAt, std::uint64_t{1'000'050});
+
+    EXPECT_TRUE(book_.getEntry(std::uint64_t{4}).has_value());
+}
+
+TEST_F(OrderBookTest, MergeLaterFromIgnoresTimestamps) {
+    OrderBook later;
+    QuoteMessage msg = getDefaultMsg();
+    msg.symbol = std::uint64_t{2};
+    msg.timestamp = std::uint64_t{1}; /// older than the entry in `book_`, but later in the feed
+    msg.bidPrice = std::uint64_t{14'000};
+    later.upsertEntry(msg.symbol, msg);
+
+    book_.mergeLaterFrom(later);
+    EXPECT_EQ(3u, book_.size());
+    const auto entry = book_.getEntry(std::uint64_t{2});
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(std::uint64_t{14'000}, entry->bidPrice);
+    EXPECT_EQ(std::uint64_t{1}, entry->udpatedAt);
+}
+
+TEST_F(OrderBookTest, UpsertById) {
+    SymbolTable symbols;
+    OrderBook book{symbols};
+    QuoteMessage msg = getDefaultMsg();
+
+    const SymbolId id = symbols.intern(msg.symbol);
+    book.upsertEntryById(id, msg);
+    EXPECT_EQ(1u, book.size());
+
+    auto byId = book.getEntryById(id);
+    ASSERT_TRUE(byId.has_value());
+    EXPECT_EQ(byId->bidPrice, std::uint64_t{15'005});
+
+    auto bySymbol = book.getEntry(msg.symbol); /// symbol path resolves through the shared table
+    ASSERT_TRUE(bySymbol.has_value());
+    EXPECT_EQ(bySymbol->udpatedAt, byId->udpatedAt);
+
+    const SymbolId unseenId = symbols.intern(std::uint64_t{99}); /// in the table, not the book
+    EXPECT_FALSE(book.getEntryById(unseenId).has_value());
+    EXPECT_FALSE(book.getEntry(std::uint64_t{99}).has_value());
+}
+
+TEST_F(OrderBookTest, ApplyDepth) {
+    DepthMessage msg;
+    msg.type = MessageType::Depth;
+    msg.timestamp = std::uint64_t{2'000'000};
+    msg.symbol = std::uint64_t{5};
+    msg.side = Side::Bid;
+    msg.price = std::uint64_t{15'000};
+    msg.quantity = std::uint32_t{100};
+    book_.applyDepth(msg.symbol, msg);
+
+    msg.price = std::uint64_t{15'001};
+    msg.quantity = std::uint32_t{50};
+    book_.applyDepth(msg.symbol, msg);
+
+    msg.side = Side::Ask;
+    msg.price = std::uint64_t{15'003};
+    msg.quantity = std::uint32_t{70};
+    msg.timestamp += 10;
+    book_.applyDepth(msg.symbol, msg);
+
+    auto entry = book_.getEntry(std::uint64_t{5}); /// top of book follows the ladder
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->bidPrice, std::uint64_t{15'001});
+    EXPECT_EQ(entry->bidQuantity, std::uint32_t{50});
+    EXPECT_EQ(entry->askPrice, std::uint64_t{15'003});
+    EXPECT_EQ(entry->udpatedAt, std::uint64_t{2'000'010});
+
+    auto ladder = book_.getLadder(std::uint64_t{5});
+    ASSERT_TRUE(ladder.has_value());
+    EXPECT_EQ(2u, ladder.value()->levelCount(Side::Bid));
+
+    EXPECT_FALSE(book_.getLadder(std::uint64_t{1}).has_value()); /// quote-only symbol
+}
+
+TEST_F(OrderBookTest, VenueQuotesMakeNbbo) {
+    SymbolTable symbols;
+    OrderBook book{symbols};
+    book.trackVenues(3);
+    const SymbolId id = symbols.intern(std::uint64_t{7});
+    QuoteMessage msg = getDefaultMsg();
+
+    const auto quote = [&](const VenueId venue, const std::uint64_t bid, const std::uint32_t bidQty,
+                           const std::uint64_t ask, const std::uint32_t askQty) {
+        msg.timestamp += 1;
+        msg.bidPrice = bid;
+        msg.bidQuantity = bidQty;
+        msg.askPrice = ask;
+        msg.askQuantity = askQty;
+        book.upsertVenueQuoteById(id, venue, msg);
+        return book.getNbboById(id).value();
+    };
+
+    auto nbbo = quote(0, 100, 10, 105, 20);
+    EXPECT_EQ(100u, nbbo.bidPrice);
+    EXPECT_EQ(105u, nbbo.askPrice);
+
+    nbbo = quote(1, 100, 5, 104, 7); /// joins the bid, improves the ask
+    EXPECT_EQ(15u, nbbo.bidQuantity);
+    EXPECT_EQ(0b11, nbbo.bidVenues);
+    EXPECT_EQ(104u, nbbo.askPrice);
+    EXPECT_EQ(7u, nbbo.askQuantity);
+    EXPECT_EQ(0b10, nbbo.askVenues);
+
+    nbbo = quote(2, 99, 1, 0, 0); /// below the bid, with no ask
+    EXPECT_EQ(100u, nbbo.bidPrice);
+    EXPECT_EQ(104u, nbbo.askPrice);
+    EXPECT_EQ(0b111, nbbo.venues);
+
+    nbbo = quote(0, 98, 10, 106, 20); /// leaves the bid, still shared with venue 1
+    EXPECT_EQ(100u, nbbo.bidPrice);
+    EXPECT_EQ(5u, nbbo.bidQuantity);
+    EXPECT_EQ(0b10, nbbo.bidVenues);
+
+    nbbo = quote(1, 97, 3, 107, 9); /// the last venue at each best backs off: both are rebuilt
+    EXPECT_EQ(99u, nbbo.bidPrice);
+    EXPECT_EQ(1u, nbbo.bidQuantity);
+    EXPECT_EQ(0b100, nbbo.bidVenues);
+    EXPECT_EQ(106u, nbbo.askPrice);
+    EXPECT_EQ(20u, nbbo.askQuantity);
+    EXPECT_EQ(0b1, nbbo.askVenues);
+    EXPECT_EQ(msg.timestamp, nbbo.updatedAt);
+
+    auto entry = book.getEntryById(id); /// the top of book is the latest quote of any venue
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(97u, entry->bidPrice);
+    ASSERT_TRUE(book.getVenueQuoteById(id, 2).has_value());
+    EXPECT_EQ(0u, book.getVenueQuoteById(id, 2)->askPrice);
+    EXPECT_FALSE(book.getNbbo(std::uint64_t{1}).has_value());
+    EXPECT_FALSE(book_.getNbbo(std::uint64_t{1}).has_value()); /// venues not tracked
+}
+
+TEST_F(OrderBookTest, MergeFromKeepsLatestVenueQuotes) {
+    SymbolTable symbols;
+    OrderBook book{symbols};
+    OrderBook other{symbols};
+    book.trackVenues(2);
+    other.trackVenues(2);
+    const SymbolId id = symbols.intern(std::uint64_t{8});
+    QuoteMessage msg = getDefaultMsg();
+
+    msg.bidPrice = 100;
+    book.upsertVenueQuoteById(id, 0, msg);
+    msg.timestamp += 1;
+    msg.bidPrice = 90;
+    other.upsertVenueQuoteById(id, 0, msg); /// newer, replaces venue 0's bid of 100
+    msg.bidPrice = 95;
+    other.upsertVenueQuoteById(id, 1, msg);
+
+    book.mergeFrom(other);
+    const auto nbbo = book.getNbboById(id);
+    ASSERT_TRUE(nbbo.has_value());
+    EXPECT_EQ(95u, nbbo->bidPrice);
+    EXPECT_EQ(0b10, nbbo->bidVenues);
+    EXPECT_EQ(0b11, nbbo->venues);
+}
+
+TEST_F(OrderBookTest, MergeLaterFromReplacesVenueQuotes) {
+    SymbolTable symbols;
+    OrderBook book{symbols};
+    OrderBook later{symbols};
+    book.trackVenues(2);
+    later.trackVenues(2);
+    const SymbolId id = symbols.intern(std::uint64_t{8});
+    QuoteMessage msg = getDefaultMsg();
+
+    msg.bidPrice = 100;
+    book.upsertVenueQuoteById(id, 0, msg);
+    msg.timestamp -= 1;
+    msg.bidPrice = 90;
+    later.upsertVenueQuoteById(id, 0, msg); /// older, but later in the feed
+
+    book.mergeLaterFrom(later);
+    const auto nbbo = book.getNbboById(id);
+    ASSERT_TRUE(nbbo.has_value());
+    EXPECT_EQ(90u, nbbo->bidPrice);
+    EXPECT_EQ(msg.timestamp, nbbo->updatedAt);
+}
+
+TEST_F(OrderBookTest, NbboMatchesScanOfVenueQuotes) {
+    SymbolTable symbols;
+    OrderBook book{symbols};
+    book.trackVenues(5);
+    const SymbolId id = symbols.intern(std::uint64_t{9});
+    QuoteMessage msg = getDefaultMsg();
+    std::uint64_t state = 12345;
+    const auto draw = [&state](const std::uint64_t n) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        return (state >> 33) % n;
+    };
+
+    for (int i = 0; i < 5000; ++i) {
+        const auto venue = static_cast<VenueId>(draw(5));
+        msg.bidPrice = draw(6) == 0 ? 0 : 95 + draw(6); /// few prices, so venues often tie
+        msg.askPrice = draw(6) == 0 ? 0 : 100 + draw(6);
+        msg.bidQuantity = static_cast<std::uint32_t>(draw(50));
+        msg.askQuantity = static_cast<std::uint32_t>(draw(50));
+        book.upsertVenueQuoteById(id, venue, msg);
+
+        OrderBook::NbboEntry expected{};
+        for (VenueId v = 0; v < 5; ++v) {
+            const auto quote = book.getVenueQuoteById(id, v);
+            if (!quote.has_value()) {
+                continue;
+            }
+            if (quote->bidPrice > expected.bidPrice) {
+                expected.bidPrice = quote->bidPrice;
+                expected.bidQuantity = 0;
+            }
+            if (quote->bidPrice == expected.bidPrice && quote->bidPrice != 0) {
+                expected.bidQuantity += quote->bidQuantity;
+            }
+            if (quote->askPrice != 0 &&
+                (expected.askPrice == 0 || quote->askPrice < expected.askPrice)) {
+                expected.askPrice = quote->askPrice;
+                expected.askQuantity = 0;
+            }
+            if (quote->askPrice == expected.askPrice && quote->askPrice != 0) {
+                expected.askQuantity += quote->askQuantity;
+            }
+        }
+        const auto nbbo = book.getNbboById(id).value();
+        ASSERT_EQ(expected.bidPrice, nbbo.bidPrice) << i;
+        ASSERT_EQ(expected.bidQuantity, nbbo.bidQuantity) << i;
+        ASSERT_EQ(expected.askPrice, nbbo.askPrice) << i;
+        ASSERT_EQ(expected.askQuantity, nbbo.askQuantity) << i;
+    }
+}
@@ -0,0 +1,127 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "messages.hpp"
+#include "orderbook/price_ladder.hpp"
+
+class PriceLadderTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ladder_.update(Side::Bid, 10'000, 100);
+        ladder_.update(Side::Bid, 9'998, 200);
+        ladder_.update(Side::Bid, 9'999, 300);
+        ladder_.update(Side::Ask, 10'002, 400);
+        ladder_.update(Side::Ask, 10'001, 500);
+    }
+
+    static constexpr std::size_t WINDOW_TICKS_ = 16;
+    PriceLadder ladder_{1, WINDOW_TICKS_};
+    PriceLadder emptyLadder_;
+};
+
+TEST_F(PriceLadderTest, DefaultConstructor) {
+    EXPECT_FALSE(emptyLadder_.best(Side::Bid).has_value());
+    EXPECT_FALSE(emptyLadder_.best(Side::Ask).has_value());
+    EXPECT_EQ(0u, emptyLadder_.levelCount(Side::Bid));
+}
+
+TEST_F(PriceLadderTest, BestPrices) {
+    auto bid = ladder_.best(Side::Bid);
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_EQ(bid->price, std::uint64_t{10'000});
+    EXPECT_EQ(bid->quantity, std::uint32_t{100});
+
+    auto ask = ladder_.best(Side::Ask);
+    ASSERT_TRUE(ask.has_value());
+    EXPECT_EQ(ask->price, std::uint64_t{10'001});
+    EXPECT_EQ(ask->quantity, std::uint32_t{500});
+}
+
+TEST_F(PriceLadderTest, RemovingBestFindsNextLevel) {
+    ladder_.update(Side::Bid, 10'000, 0);
+    EXPECT_EQ(ladder_.best(Side::Bid)->price, std::uint64_t{9'999});
+
+    ladder_.update(Side::Ask, 10'001, 0);
+    EXPECT_EQ(ladder_.best(Side::Ask)->price, std::uint64_t{10'002});
+
+    ladder_.update(Side::Ask, 10'002, 0);
+    EXPECT_FALSE(ladder_.best(Side::Ask).has_value());
+    EXPECT_EQ(0u, ladder_.levelCount(Side::Ask));
+}
+
+TEST_F(PriceLadderTest, Depth) {
+    PriceLadder::Level levels[5];
+    ASSERT_EQ(3u, ladder_.depth(Side::Bid, levels, 5));
+    EXPECT_EQ(levels[0].price, std::uint64_t{10'000});
+    EXPECT_EQ(levels[1].price, std::uint64_t{9'999});
+    EXPECT_EQ(levels[2].price, std::uint64_t{9'998});
+    EXPECT_EQ(levels[2].quantity, std::uint32_t{200});
+
+    ASSERT_EQ(1u, ladder_.depth(Side::Ask, levels, 1));
+    EXPECT_EQ(levels[0].price, std::uint64_t{10'001});
+}
+
+TEST_F(PriceLadderTest, OutliersBeyondWindow) {
+    ladder_.update(Side::Bid, 9'000, 50); /// far below the window
+    EXPECT_EQ(4u, ladder_.levelCount(Side::Bid));
+    EXPECT_EQ(std::uint32_t{50}, ladder_.quantityAt(Side::Bid, 9'000));
+
+    PriceLadder::Level levels[4];
+    ASSERT_EQ(4u, ladder_.depth(Side::Bid, levels, 4));
+    EXPECT_EQ(levels[3].price, std::uint64_t{9'000});
+
+    /// clearing every in-window level leaves the outlier as the best bid
+    ladder_.update(Side::Bid, 10'000, 0);
+    ladder_.update(Side::Bid, 9'999, 0);
+    ladder_.update(Side::Bid, 9'998, 0);
+    auto bid = ladder_.best(Side::Bid);
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_EQ(bid->price, std::uint64_t{9'000});
+    EXPECT_EQ(bid->quantity, std::uint32_t{50});
+}
+
+TEST_F(PriceLadderTest, BestMovesPastWindow) {
+    ladder_.update(Side::Ask, 9'000, 10); /// far better than the current window
+    EXPECT_EQ(ladder_.best(Side::Ask)->price, std::uint64_t{9'000});
+    EXPECT_EQ(std::uint32_t{500}, ladder_.quantityAt(Side::Ask, 10'001));
+
+    PriceLadder::Level levels[3];
+    ASSERT_EQ(3u, ladder_.depth(Side::Ask, levels, 3));
+    EXPECT_EQ(levels[1].price, std::uint64_t{10'001});
+    EXPECT_EQ(levels[2].price, std::uint64_t{10'002});
+}
+
+TEST_F(PriceLadderTest, TickSize) {
+    PriceLadder ladder{5, WINDOW_TICKS_};
+    ladder.update(Side::Bid, 1'000, 1);
+    ladder.update(Side::Bid, 995, 2);
+    ladder.update(Side::Bid, 1'000, 0);
+    EXPECT_EQ(ladder.best(Side::Bid)->price, std::uint64_t{995});
+}
+
+TEST_F(PriceLadderTest, BestDriftsToWorsePrices) {
+    /// asks trend upwards: the window follows the best past its middle and its far end
+    PriceLadder ladder{1, WINDOW_TICKS_};
+    for (std::uint64_t price = 100; price < 160; ++price) {
+        ladder.update(Side::Ask, price, static_cast<std::uint32_t>(price));
+    }
+    for (std::uint64_t price = 100; price < 159; ++price) {
+        ladder.update(Side::Ask, price, 0);
+        ASSERT_EQ(ladder.best(Side::Ask)->price, price + 1);
+        ASSERT_EQ(159 - price, ladder.levelCount(Side::Ask));
+
+        PriceLadder::Level levels[3];
+        const auto count = ladder.depth(Side::Ask, levels, 3);
+        ASSERT_EQ(std::min<std::uint64_t>(3, 159 - price), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(price + 1 + i, levels[i].price);
+            EXPECT_EQ(price + 1 + i, levels[i].quantity);
+        }
+    }
+
+    /// a better price afterwards moves the window back, pushing the old levels out
+    ladder.update(Side::Ask, 20, 7);
+    EXPECT_EQ(ladder.best(Side::Ask)->price, std::uint64_t{20});
+    EXPECT_EQ(std::uint32_t{159}, ladder.quantityAt(Side::Ask, 159));
+    EXPECT_EQ(2u, ladder.levelCount(Side::Ask));
+}
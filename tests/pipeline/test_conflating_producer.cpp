@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+#include "pipeline/conflating_producer.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+class ConflatingProducerTest : public testing::Test {
+  protected:
+    using Producer = ConflatingProducer<InternedMessage, MappedFeed>;
+
+    /// Each message is tagged with its position in the feed as its timestamp.
+    void append(const MessageType type, const std::uint64_t symbol) {
+        MarketDataMessage msg{};
+        msg.trade.type = type;
+        msg.trade.timestamp = ++sequence_;
+        msg.trade.symbol = symbol;
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        bytes_.insert(bytes_.end(), bytes, bytes + messageSize(type));
+    }
+
+    /// Reads ahead until the producer stops, as it would while the queue stays full.
+    static void readAheadAll(Producer& producer) {
+        while (producer.readAhead()) {
+        }
+    }
+
+    /// Returns the feed positions of the first `count` slots.
+    static std::vector<std::uint64_t> sequenceOf(const InternedMessage* slots,
+                                                 const std::size_t count) {
+        std::vector<std::uint64_t> out;
+        for (std::size_t i = 0; i < count; ++i) {
+            out.push_back(slots[i].msg.trade.timestamp);
+        }
+        return out;
+    }
+
+    std::vector<std::uint8_t> bytes_;
+    std::uint64_t sequence_{0};
+    SymbolTable symbols_;
+    InternedMessage slots_[16];
+};
+
+TEST_F(ConflatingProducerTest, PassesThroughWhileQueueHasRoom) {
+    append(MessageType::Quote, 1);
+    append(MessageType::Quote, 1);
+    append(MessageType::Trade, 1);
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    Producer producer{feed, symbols_, UINT64_MAX};
+
+    const auto used = producer.fill(slots_, 16);
+    EXPECT_EQ((std::vector<std::uint64_t>{1, 2, 3}), sequenceOf(slots_, used));
+    EXPECT_EQ(0u, producer.conflated());
+    EXPECT_TRUE(producer.done());
+}
+
+TEST_F(ConflatingProducerTest, KeepsLatestQuotePerSymbolAndEveryTrade) {
+    append(MessageType::Quote, 1); /// 1: superseded by 4
+    append(MessageType::Trade, 1); /// 2
+    append(MessageType::Quote, 2); /// 3: superseded by 6
+    append(MessageType::Quote, 1); /// 4
+    append(MessageType::Trade, 2); /// 5
+    append(MessageType::Quote, 2); /// 6
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    Producer producer{feed, symbols_, UINT64_MAX};
+
+    readAheadAll(producer);
+    EXPECT_FALSE(producer.done());
+    const auto used = producer.fill(slots_, 16);
+
+    /// one quote per symbol, in the order the symbols were first parked, then the trades in order
+    EXPECT_EQ((std::vector<std::uint64_t>{4, 6, 2, 5}), sequenceOf(slots_, used));
+    EXPECT_EQ(2u, producer.conflated());
+    EXPECT_EQ(6u, producer.parsed());
+    EXPECT_TRUE(producer.done());
+}
+
+TEST_F(ConflatingProducerTest, HoldsOtherMessagesUntilEverythingParkedIsQueued) {
+    append(MessageType::Quote, 1); /// 1
+    append(MessageType::Trade, 1); /// 2
+    append(MessageType::Depth, 1); /// 3: stops the read-ahead
+    append(MessageType::Quote, 1); /// 4: read only once the depth update is queued
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    Producer producer{feed, symbols_, UINT64_MAX};
+
+    readAheadAll(producer);
+    EXPECT_EQ(3u, producer.parsed());
+
+    auto used = producer.fill(slots_, 1);
+    EXPECT_EQ((std::vector<std::uint64_t>{1}), sequenceOf(slots_, used));
+    used = producer.fill(slots_, 1);
+    EXPECT_EQ((std::vector<std::uint64_t>{2}), sequenceOf(slots_, used));
+    used = producer.fill(slots_, 16);
+    EXPECT_EQ((std::vector<std::uint64_t>{3, 4}), sequenceOf(slots_, used));
+    EXPECT_EQ(0u, producer.conflated());
+    EXPECT_TRUE(producer.done());
+}
+
+TEST_F(ConflatingProducerTest, StopsAtMessageLimit) {
+    for (int i = 0; i < 5; ++i) {
+        append(MessageType::Quote, 1);
+    }
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    Producer producer{feed, symbols_, 3};
+
+    readAheadAll(producer);
+    EXPECT_EQ(3u, producer.parsed());
+    const auto used = producer.fill(slots_, 16);
+    EXPECT_EQ((std::vector<std::uint64_t>{3}), sequenceOf(slots_, used));
+    EXPECT_EQ(2u, producer.conflated());
+    EXPECT_TRUE(producer.done());
+}
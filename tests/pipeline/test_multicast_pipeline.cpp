@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+#include "pipeline/multicast_pipeline.hpp"
+#include "ringbuffer/shm_spsc_queue.hpp"
+#include "ringbuffer/wait_strategy.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+class MulticastPipelineTest : public testing::Test {
+  protected:
+    void TearDown() override {
+        ShmSPSCQueue<MarketDataMessage>::remove(shmName_.c_str());
+    }
+
+    void appendTrade(const std::uint64_t symbol, const std::uint64_t price) {
+        TradeMessage msg{};
+        msg.type = MessageType::Trade;
+        msg.timestamp = ++sequence_;
+        msg.symbol = symbol;
+        msg.price = price;
+        msg.quantity = 10;
+        append(msg);
+    }
+
+    void appendQuote(const std::uint64_t symbol, const std::uint64_t bidPrice) {
+        QuoteMessage msg{};
+        msg.type = MessageType::Quote;
+        msg.timestamp = ++sequence_;
+        msg.symbol = symbol;
+        msg.bidPrice = bidPrice;
+        msg.bidQuantity = 100;
+        msg.askPrice = bidPrice + 1;
+        msg.askQuantity = 100;
+        append(msg);
+    }
+
+    template <typename Msg> void append(const Msg& msg) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        bytes_.insert(bytes_.end(), bytes, bytes + sizeof(msg));
+    }
+
+    /// Interns and copies every message of the feed, as the producer would.
+    std::vector<InternedMessage> internAll() {
+        MappedFeed feed{bytes_.data(), bytes_.size()};
+        std::vector<InternedMessage> slots;
+        const std::uint8_t* data;
+        while ((data = feed.next()) != nullptr) {
+            slots.emplace_back();
+            parseInto(data, slots.back(), symbols_, 0);
+        }
+        return slots;
+    }
+
+    const std::string shmName_ = "/multicast_pipeline_test_" + std::to_string(getpid());
+
+    std::vector<std::uint8_t> bytes_;
+    std::uint64_t sequence_{0};
+    SymbolTable symbols_;
+};
+
+TEST_F(MulticastPipelineTest, PlansBookAndVwapStages) {
+    MarketState state{symbols_};
+    const StagePlan plan = planStages(state);
+    EXPECT_EQ((std::vector<Stage>{Stage::Book, Stage::Vwap}), plan.stages);
+    EXPECT_EQ((std::vector<std::uint32_t>{0, 0}), plan.upstream);
+}
+
+TEST_F(MulticastPipelineTest, GatesForwardOnEveryOtherStage) {
+    MarketState state{symbols_, std::pmr::get_default_resource(), {{"1s", 1'000'000, 10}}};
+    auto out = ShmSPSCQueue<MarketDataMessage>::create(shmName_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, out);
+    state.shmOut = out.get();
+
+    const StagePlan plan = planStages(state);
+    EXPECT_EQ((std::vector<Stage>{Stage::Book, Stage::Vwap, Stage::RollingVwap, Stage::Forward}),
+              plan.stages);
+    EXPECT_EQ((std::vector<std::uint32_t>{0, 0, 0, 0b111}), plan.upstream);
+}
+
+TEST_F(MulticastPipelineTest, StagesSplitTradesFromEverythingElse) {
+    appendQuote(1, 100);
+    appendTrade(1, 101);
+    appendQuote(2, 200);
+    const auto slots = internAll();
+
+    MarketState state{symbols_};
+    VWAPTracker trades{symbols_};
+    LatencyStats latency;
+
+    applyStage(Stage::Book, slots.data(), slots.size(), state, trades, latency);
+    EXPECT_EQ(2u, state.book.size());
+    EXPECT_EQ(0u, trades.size());
+
+    applyStage(Stage::Vwap, slots.data(), slots.size(), state, trades, latency);
+    EXPECT_EQ(2u, state.book.size());
+    ASSERT_TRUE(trades.getVWAP(1).has_value());
+    EXPECT_EQ(1u, trades.getVWAP(1)->totalTrades);
+    EXPECT_FALSE(trades.getVWAP(2).has_value());
+    EXPECT_EQ(0u, state.vwapTracker.size()); /// merged into the state only after the run
+}
+
+TEST_F(MulticastPipelineTest, ForwardsAppliedMessagesInFeedOrder) {
+    constexpr std::uint64_t NUM_MESSAGES = 5'000;
+    for (std::uint64_t i = 0; i < NUM_MESSAGES; ++i) {
+        if (i % 3 == 0) {
+            appendTrade(i % 7, 1'000 + i);
+        } else {
+            appendQuote(i % 7, 1'000 + i);
+        }
+    }
+
+    auto out = ShmSPSCQueue<MarketDataMessage>::create(shmName_.c_str(), 1 << 13,
+                                                       ShmRole::Producer);
+    ASSERT_NE(nullptr, out);
+    auto reader = ShmSPSCQueue<MarketDataMessage>::attach(shmName_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, reader);
+
+    MarketState state{symbols_};
+    state.shmOut = out.get();
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    const RunResult result = runMulticastPipeline<InternedMessage, SpinYieldWait>(
+        feed, NUM_MESSAGES, symbols_, state, CpuPlacement{});
+
+    EXPECT_EQ(NUM_MESSAGES, result.messages);
+    EXPECT_EQ(0u, state.shmDropped);
+    EXPECT_EQ(7u, state.book.size());
+    EXPECT_EQ(7u, state.vwapTracker.size());
+    const auto last = state.book.getEntry((NUM_MESSAGES - 1) % 7); /// the last message, a quote
+    ASSERT_TRUE(last.has_value());
+    EXPECT_EQ(NUM_MESSAGES, last->udpatedAt);
+
+    MarketDataMessage msg;
+    for (std::uint64_t i = 0; i < NUM_MESSAGES; ++i) {
+        ASSERT_TRUE(reader->dequeue(msg));
+        EXPECT_EQ(i + 1, msg.trade.timestamp);
+    }
+    EXPECT_FALSE(reader->dequeue(msg));
+}
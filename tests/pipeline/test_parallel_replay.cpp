@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "feed/mapped_feed.hpp"
+#include "messages.hpp"
+#include "pipeline/parallel_replay.hpp"
+#include "symbol_map/symbol_table.hpp"
+
+class ParallelReplayTest : public testing::Test {
+  protected:
+    void appendQuote(const std::uint64_t symbol, const std::uint64_t timestamp,
+                     const std::uint64_t bidPrice) {
+        QuoteMessage msg{};
+        msg.type = MessageType::Quote;
+        msg.timestamp = timestamp;
+        msg.symbol = symbol;
+        msg.bidPrice = bidPrice;
+        msg.bidQuantity = 100;
+        msg.askPrice = bidPrice + 1;
+        msg.askQuantity = 100;
+        append(msg);
+    }
+
+    void appendTrade(const std::uint64_t symbol, const std::uint64_t timestamp,
+                     const std::uint64_t price) {
+        TradeMessage msg{};
+        msg.type = MessageType::Trade;
+        msg.timestamp = timestamp;
+        msg.symbol = symbol;
+        msg.price = price;
+        msg.quantity = 10;
+        append(msg);
+    }
+
+    template <typename Msg> void append(const Msg& msg) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&msg);
+        bytes_.insert(bytes_.end(), bytes, bytes + sizeof(msg));
+    }
+
+    /// Applies the whole feed in order on this thread, into `state`.
+    void applySequentially(SymbolTable& symbols, MarketState& state) {
+        MappedFeed feed{bytes_.data(), bytes_.size()};
+        const std::uint8_t* msg;
+        while ((msg = feed.next()) != nullptr) {
+            applyMessage(msg, symbols.intern(symbolOf(msg)), 0, state);
+        }
+    }
+
+    std::vector<std::uint8_t> bytes_;
+};
+
+TEST_F(ParallelReplayTest, MatchesSequentialPassWhenTimestampsGoBackwards) {
+    constexpr std::uint64_t NUM_MESSAGES = 4'000;
+    appendTrade(9, 1'000'000, 50); /// a symbol seen first in a trade
+    for (std::uint64_t i = 1; i < NUM_MESSAGES; ++i) {
+        const std::uint64_t timestamp = 1'000'000 + i;
+        if (i % 4 == 0) {
+            appendTrade(i % 5, timestamp, 1'000 + i);
+        } else {
+            appendQuote(i % 5, timestamp, 1'000 + i);
+        }
+    }
+    appendQuote(1, 1, 7); /// last in the feed, but with the earliest timestamp
+    appendTrade(2, 1, 7);
+
+    SymbolTable expectedSymbols;
+    MarketState expected{expectedSymbols};
+    applySequentially(expectedSymbols, expected);
+
+    SymbolTable symbols;
+    MarketState state{symbols};
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    const auto result = runParallelReplay(feed, UINT64_MAX, 4, symbols, state, CpuPlacement{});
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(NUM_MESSAGES + 2, result->messages);
+    EXPECT_EQ(0u, feed.remaining());
+
+    ASSERT_EQ(expectedSymbols.size(), symbols.size());
+    for (SymbolId id = 0; id < symbols.size(); ++id) {
+        EXPECT_EQ(expectedSymbols.symbolOf(id), symbols.symbolOf(id)); /// first-seen order
+    }
+    for (std::uint64_t symbol = 0; symbol < 5; ++symbol) {
+        const auto top = state.book.getEntry(symbol);
+        const auto expectedTop = expected.book.getEntry(symbol);
+        ASSERT_TRUE(top.has_value());
+        ASSERT_TRUE(expectedTop.has_value());
+        EXPECT_EQ(expectedTop->bidPrice, top->bidPrice);
+        EXPECT_EQ(expectedTop->udpatedAt, top->udpatedAt);
+
+        const auto vwap = state.vwapTracker.getVWAP(symbol);
+        const auto expectedVwap = expected.vwapTracker.getVWAP(symbol);
+        ASSERT_EQ(expectedVwap.has_value(), vwap.has_value());
+        if (vwap.has_value()) {
+            EXPECT_EQ(expectedVwap->updatedAt, vwap->updatedAt);
+            EXPECT_EQ(expectedVwap->totalPriceByQuantity, vwap->totalPriceByQuantity);
+            EXPECT_EQ(expectedVwap->totalTrades, vwap->totalTrades);
+        }
+    }
+    EXPECT_EQ(7u, state.book.getEntry(1)->bidPrice);
+    EXPECT_EQ(1u, state.vwapTracker.getVWAP(2)->updatedAt);
+}
+
+TEST_F(ParallelReplayTest, LeavesFeedsWithDepthToTheCaller) {
+    appendQuote(1, 1, 100);
+    DepthMessage depth{};
+    depth.type = MessageType::Depth;
+    depth.timestamp = 2;
+    depth.symbol = 1;
+    depth.price = 99;
+    depth.quantity = 100;
+    append(depth);
+
+    SymbolTable symbols;
+    MarketState state{symbols};
+    MappedFeed feed{bytes_.data(), bytes_.size()};
+    EXPECT_FALSE(runParallelReplay(feed, UINT64_MAX, 4, symbols, state, CpuPlacement{}));
+    EXPECT_EQ(bytes_.size(), feed.remaining()); /// nothing consumed
+    EXPECT_EQ(0u, state.book.size());
+}
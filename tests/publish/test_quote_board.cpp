@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "publish/quote_board.hpp"
+
+class QuoteBoardTest : public testing::Test {
+  protected:
+    static QuoteBoard::Entry entry(std::uint64_t bidPrice, std::uint64_t askPrice) {
+        QuoteBoard::Entry e{};
+        e.bidPrice = bidPrice;
+        e.askPrice = askPrice;
+        e.bidQuantity = 10;
+        e.askQuantity = 20;
+        return e;
+    }
+
+    static constexpr std::uint64_t APPLE_ = 0x4C5041; /// "APL"
+    static constexpr std::uint64_t MSFT_ = 0x5446534D;
+
+    QuoteBoard board_{4};
+};
+
+TEST_F(QuoteBoardTest, UnknownSymbol) {
+    EXPECT_FALSE(board_.find(APPLE_).has_value());
+    EXPECT_FALSE(board_.get(APPLE_).has_value());
+    EXPECT_EQ(0u, board_.size());
+}
+
+TEST_F(QuoteBoardTest, ClaimIsStablePerSymbol) {
+    const auto apple = board_.claim(APPLE_);
+    const auto msft = board_.claim(MSFT_);
+    ASSERT_TRUE(apple.has_value());
+    ASSERT_TRUE(msft.has_value());
+    EXPECT_NE(*apple, *msft);
+    EXPECT_EQ(apple, board_.claim(APPLE_));
+    EXPECT_EQ(apple, board_.find(APPLE_));
+    EXPECT_EQ(APPLE_, board_.symbolAt(*apple));
+    EXPECT_EQ(2u, board_.size());
+}
+
+TEST_F(QuoteBoardTest, ClaimedButUnpublished) {
+    ASSERT_TRUE(board_.claim(APPLE_).has_value());
+    EXPECT_FALSE(board_.get(APPLE_).has_value());
+}
+
+TEST_F(QuoteBoardTest, ReadsLatestPublished) {
+    const auto cell = board_.claim(APPLE_);
+    ASSERT_TRUE(cell.has_value());
+    board_.publish(*cell, entry(100, 101));
+    board_.publish(*cell, entry(102, 103));
+
+    const auto published = board_.get(APPLE_);
+    ASSERT_TRUE(published.has_value());
+    EXPECT_EQ(102u, published->bidPrice);
+    EXPECT_EQ(103u, published->askPrice);
+    EXPECT_EQ(20u, published->askQuantity);
+}
+
+TEST_F(QuoteBoardTest, RejectsSymbolsBeyondCapacity) {
+    for (std::uint64_t symbol = 1; symbol <= board_.capacity(); ++symbol) {
+        ASSERT_TRUE(board_.claim(symbol).has_value());
+    }
+    EXPECT_FALSE(board_.claim(board_.capacity() + 1).has_value());
+    EXPECT_TRUE(board_.claim(1).has_value()); /// existing symbols keep their cells
+    EXPECT_EQ(board_.capacity(), board_.size());
+}
+
+TEST_F(QuoteBoardTest, WritersClaimConcurrently) {
+    QuoteBoard board{1'000};
+    auto claimRange = [&board](std::uint64_t first) {
+        for (std::uint64_t symbol = first; symbol < first + 500; ++symbol) {
+            const auto cell = board.claim(symbol);
+            ASSERT_TRUE(cell.has_value());
+            board.publish(*cell, entry(symbol, symbol + 1));
+        }
+    };
+    std::thread other(claimRange, 501);
+    claimRange(1);
+    other.join();
+
+    EXPECT_EQ(1'000u, board.size());
+    for (std::uint64_t symbol = 1; symbol <= 1'000; ++symbol) {
+        const auto published = board.get(symbol);
+        ASSERT_TRUE(published.has_value());
+        EXPECT_EQ(symbol, published->bidPrice);
+    }
+}
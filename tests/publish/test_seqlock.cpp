@@ -0,0 +1,66 @@
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "publish/seqlock.hpp"
+
+class SeqlockTest : public testing::Test {
+  protected:
+    /// Odd-sized so the value does not fill its last word.
+    struct Value {
+        std::uint64_t a;
+        std::uint64_t b;
+        std::uint32_t c;
+    };
+
+    Seqlock<Value> lock_;
+};
+
+TEST_F(SeqlockTest, StartsUnpublished) {
+    EXPECT_EQ(0u, lock_.version());
+    const Value value = lock_.load();
+    EXPECT_EQ(0u, value.a);
+    EXPECT_EQ(0u, value.c);
+}
+
+TEST_F(SeqlockTest, LoadsLatestStore) {
+    lock_.store({1, 2, 3});
+    lock_.store({4, 5, 6});
+    EXPECT_EQ(2u, lock_.version());
+
+    Value value{};
+    ASSERT_TRUE(lock_.tryLoad(value));
+    EXPECT_EQ(4u, value.a);
+    EXPECT_EQ(5u, value.b);
+    EXPECT_EQ(6u, value.c);
+}
+
+TEST_F(SeqlockTest, ReadersNeverSeeTornValues) {
+    constexpr std::uint64_t STORES = 200'000;
+    std::atomic<bool> started{false};
+    std::atomic<bool> done{false};
+    bool torn = false;
+
+    std::thread reader([&] {
+        std::uint64_t last = 0;
+        do {
+            const Value value = lock_.load();
+            torn |= value.a != value.b || value.c != static_cast<std::uint32_t>(value.a);
+            torn |= value.a < last; /// stores are never seen out of order
+            last = value.a;
+            started.store(true, std::memory_order_release);
+        } while (!done.load(std::memory_order_acquire));
+    });
+    while (!started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    for (std::uint64_t i = 1; i <= STORES; ++i) {
+        lock_.store({i, i, static_cast<std::uint32_t>(i)});
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_FALSE(torn);
+    EXPECT_EQ(STORES, lock_.load().a);
+}
@@ -0,0 +1,230 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "messages.hpp"
+#include "orderbook/l3_order_book.hpp"
+#include "orderbook/orderbook.hpp"
+#include "snapshot/snapshot.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/vwap_tracker.hpp"
+
+class SnapshotTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "snapshot_test.snap";
+
+        QuoteMessage quote{};
+        quote.type = MessageType::Quote;
+        quote.timestamp = 1'000;
+        quote.bidPrice = 15'005;
+        quote.bidQuantity = 100;
+        quote.askPrice = 15'010;
+        quote.askQuantity = 90;
+        book_.upsertEntry(SYMBOL_C_, quote);
+
+        DepthMessage depth{};
+        depth.type = MessageType::Depth;
+        depth.timestamp = 2'000;
+        for (const auto& [side, price, quantity] :
+             {std::tuple{Side::Bid, 9'990u, 300u}, std::tuple{Side::Bid, 9'995u, 200u},
+              std::tuple{Side::Ask, 10'005u, 150u}}) {
+            depth.side = side;
+            depth.price = price;
+            depth.quantity = quantity;
+            book_.applyDepth(SYMBOL_A_, depth);
+        }
+
+        TradeMessage trade{};
+        trade.type = MessageType::Trade;
+        trade.timestamp = 3'000;
+        trade.price = 20'000;
+        trade.quantity = 10;
+        tracker_.upsertVWAP(SYMBOL_B_, trade);
+        trade.price = 20'010;
+        trade.quantity = 30;
+        tracker_.upsertVWAP(SYMBOL_B_, trade);
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::vector<char> readFile() const {
+        std::ifstream in{path_, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    void writeFile(const std::vector<char>& bytes) const {
+        std::ofstream out{path_, std::ios::binary | std::ios::trunc};
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    static constexpr std::uint64_t SYMBOL_A_ = 0x4C5041; /// "APL"
+    static constexpr std::uint64_t SYMBOL_B_ = 0x544642; /// "BFT"
+    static constexpr std::uint64_t SYMBOL_C_ = 0x534F43; /// "COS"
+
+    std::string path_;
+    SymbolTable symbols_;
+    OrderBook book_{symbols_};
+    VWAPTracker tracker_{symbols_};
+    L3OrderBook orders_{symbols_, book_, tracker_, 16};
+
+    SymbolTable restoredSymbols_;
+    OrderBook restoredBook_{restoredSymbols_};
+    VWAPTracker restoredTracker_{restoredSymbols_};
+    L3OrderBook restoredOrders_{restoredSymbols_, restoredBook_, restoredTracker_, 16};
+    FeedPosition position_;
+};
+
+TEST_F(SnapshotTest, RoundTrip) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {4'096, 17}));
+    ASSERT_EQ(0, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                              restoredOrders_, position_));
+
+    EXPECT_EQ(4'096u, position_.offset);
+    EXPECT_EQ(17u, position_.messages);
+    EXPECT_EQ(book_.size(), restoredBook_.size());
+    EXPECT_EQ(tracker_.size(), restoredTracker_.size());
+
+    const auto quote = restoredBook_.getEntry(SYMBOL_C_);
+    ASSERT_TRUE(quote.has_value());
+    EXPECT_EQ(1'000u, quote->udpatedAt);
+    EXPECT_EQ(15'005u, quote->bidPrice);
+    EXPECT_EQ(100u, quote->bidQuantity);
+    EXPECT_EQ(15'010u, quote->askPrice);
+    EXPECT_EQ(90u, quote->askQuantity);
+    EXPECT_FALSE(restoredBook_.getLadder(SYMBOL_C_).has_value());
+
+    const auto vwap = restoredTracker_.getVWAP(SYMBOL_B_);
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_EQ(3'000u, vwap->updatedAt);
+    EXPECT_EQ(20'000u * 10 + 20'010u * 30, vwap->totalPriceByQuantity);
+    EXPECT_EQ(40u, vwap->totalQuantity);
+    EXPECT_EQ(2u, vwap->totalTrades);
+}
+
+TEST_F(SnapshotTest, RestoresDepthLadders) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {}));
+    ASSERT_EQ(0, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                              restoredOrders_, position_));
+
+    const auto ladder = restoredBook_.getLadder(SYMBOL_A_);
+    ASSERT_TRUE(ladder.has_value());
+    EXPECT_EQ(2u, (*ladder)->levelCount(Side::Bid));
+    EXPECT_EQ(1u, (*ladder)->levelCount(Side::Ask));
+    EXPECT_EQ(300u, (*ladder)->quantityAt(Side::Bid, 9'990));
+    EXPECT_EQ(200u, (*ladder)->quantityAt(Side::Bid, 9'995));
+    EXPECT_EQ(150u, (*ladder)->quantityAt(Side::Ask, 10'005));
+
+    const auto entry = restoredBook_.getEntry(SYMBOL_A_);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(9'995u, entry->bidPrice);
+    EXPECT_EQ(10'005u, entry->askPrice);
+}
+
+TEST_F(SnapshotTest, RestoresRestingOrders) {
+    AddOrderMessage add{};
+    add.type = MessageType::AddOrder;
+    add.timestamp = 4'000;
+    add.symbol = SYMBOL_B_;
+    add.side = Side::Bid;
+    add.price = 19'990;
+    for (const auto& [orderId, quantity] : {std::pair{7u, 500u}, {3u, 700u}, {9u, 100u}}) {
+        add.orderId = orderId;
+        add.quantity = quantity;
+        orders_.addOrder(add);
+    }
+    add.orderId = 4;
+    add.side = Side::Ask;
+    add.price = 20'020;
+    orders_.addOrder(add);
+
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {}));
+    ASSERT_EQ(0, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                              restoredOrders_, position_));
+
+    ASSERT_EQ(4u, restoredOrders_.size());
+    const auto id = *restoredSymbols_.find(SYMBOL_B_);
+    std::uint64_t queue[4];
+    ASSERT_EQ(3u, restoredOrders_.ordersAt(id, Side::Bid, 19'990, queue, 4));
+    EXPECT_EQ(7u, queue[0]); /// time priority survives
+    EXPECT_EQ(3u, queue[1]);
+    EXPECT_EQ(9u, queue[2]);
+
+    /// later messages for the restored orders take their quantity back out of the book
+    CancelOrderMessage cancel{};
+    cancel.type = MessageType::CancelOrder;
+    cancel.orderId = 3;
+    restoredOrders_.cancelOrder(cancel);
+    ExecuteOrderMessage execute{};
+    execute.type = MessageType::ExecuteOrder;
+    execute.orderId = 4;
+    execute.quantity = 100;
+    restoredOrders_.executeOrder(execute);
+
+    const auto ladder = restoredBook_.getLadder(SYMBOL_B_);
+    ASSERT_TRUE(ladder.has_value());
+    EXPECT_EQ(600u, (*ladder)->quantityAt(Side::Bid, 19'990));
+    EXPECT_EQ(0u, (*ladder)->levelCount(Side::Ask));
+    EXPECT_EQ(3u, restoredTracker_.getVWAP(SYMBOL_B_)->totalTrades);
+}
+
+TEST_F(SnapshotTest, PreservesSymbolIds) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {}));
+    ASSERT_EQ(0, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                              restoredOrders_, position_));
+
+    ASSERT_EQ(symbols_.size(), restoredSymbols_.size());
+    for (SymbolId id = 0; id < symbols_.size(); ++id) {
+        EXPECT_EQ(symbols_.symbolOf(id), restoredSymbols_.symbolOf(id));
+    }
+}
+
+TEST_F(SnapshotTest, ReplacesPreviousSnapshot) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {1, 1}));
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {2, 2}));
+    ASSERT_EQ(0, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                              restoredOrders_, position_));
+    EXPECT_EQ(2u, position_.messages);
+}
+
+TEST_F(SnapshotTest, RejectsWrongVersion) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {}));
+    auto bytes = readFile();
+    bytes[offsetof(SnapshotHeader, version)] ^= 0xFF;
+    writeFile(bytes);
+
+    errno = 0;
+    EXPECT_EQ(-1, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                               restoredOrders_, position_));
+    EXPECT_EQ(EINVAL, errno);
+    EXPECT_EQ(0u, restoredSymbols_.size());
+}
+
+TEST_F(SnapshotTest, RejectsTruncatedFile) {
+    ASSERT_EQ(0, writeSnapshot(path_.c_str(), symbols_, book_, tracker_, orders_, {}));
+    auto bytes = readFile();
+    bytes.resize(bytes.size() - 1);
+    writeFile(bytes);
+
+    errno = 0;
+    EXPECT_EQ(-1, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                               restoredOrders_, position_));
+    EXPECT_EQ(EINVAL, errno);
+    EXPECT_EQ(0u, restoredBook_.size());
+}
+
+TEST_F(SnapshotTest, MissingFile) {
+    errno = 0;
+    EXPECT_EQ(-1, readSnapshot(path_.c_str(), restoredSymbols_, restoredBook_, restoredTracker_,
+                               restoredOrders_, position_));
+    EXPECT_EQ(ENOENT, errno);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -139,3 +140,56 @@ TEST_F(SPSCQueueStressTest, VariableSizeMessages) {
     producer.join();
     consumer.join();
 }
+
+TEST_F(SPSCQueueStressTest, BulkProducerClaimConsumer) {
+    SPSCQueue<std::size_t, QUEUE_SIZE_> queue;
+    std::atomic<std::size_t> failures{0};
+
+    constexpr std::size_t BATCH = 37; /// deliberately not a divisor of the ring size
+
+    std::thread producer([&]() {
+        std::size_t batch[BATCH];
+        std::size_t next = 0;
+        while (next < NUM_MESSAGES_) {
+            const std::size_t count = std::min(BATCH, NUM_MESSAGES_ - next);
+            for (std::size_t i = 0; i < count; ++i) {
+                batch[i] = next + i;
+            }
+
+            std::size_t sent = 0;
+            while (sent < count) {
+                const std::size_t pushed = queue.enqueueBulk(batch + sent, count - sent);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                sent += pushed;
+            }
+            next += count;
+        }
+    });
+
+    std::thread consumer([&]() {
+        std::size_t expected = 0;
+        std::size_t* slots;
+
+        while (expected < NUM_MESSAGES_) {
+            const std::size_t claimed = queue.claimRead(slots, BATCH);
+            if (claimed == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < claimed; ++i) {
+                if (slots[i] != expected++) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            queue.commitRead(claimed);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(failures.load(), 0) << "Message ordering violated";
+    EXPECT_TRUE(queue.isEmpty());
+}
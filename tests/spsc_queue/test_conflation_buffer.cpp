@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "ringbuffer/conflation_buffer.hpp"
+
+class ConflationBufferTest : public testing::Test {
+  protected:
+    std::vector<int> drainAll() {
+        std::vector<int> out(buffer_.size());
+        out.resize(buffer_.drain(out.data(), out.size()));
+        return out;
+    }
+
+    ConflationBuffer<int> buffer_{4};
+};
+
+TEST_F(ConflationBufferTest, StartsEmpty) {
+    EXPECT_TRUE(buffer_.empty());
+    EXPECT_EQ(0u, buffer_.size());
+    int out;
+    EXPECT_EQ(0u, buffer_.drain(&out, 1));
+}
+
+TEST_F(ConflationBufferTest, KeepsLatestValuePerKey) {
+    EXPECT_FALSE(buffer_.put(1, 10));
+    EXPECT_TRUE(buffer_.put(1, 11));
+    EXPECT_TRUE(buffer_.put(1, 12));
+    EXPECT_EQ(1u, buffer_.size());
+    EXPECT_EQ(std::vector<int>{12}, drainAll());
+    EXPECT_TRUE(buffer_.empty());
+}
+
+TEST_F(ConflationBufferTest, DrainsInFirstDirtyOrder) {
+    buffer_.put(3, 30);
+    buffer_.put(0, 0);
+    buffer_.put(2, 20);
+    buffer_.put(3, 31); /// overwrites in place, keeps its position
+    EXPECT_EQ((std::vector<int>{31, 0, 20}), drainAll());
+}
+
+TEST_F(ConflationBufferTest, PartialDrain) {
+    buffer_.put(0, 0);
+    buffer_.put(1, 10);
+    buffer_.put(2, 20);
+
+    int out[2];
+    ASSERT_EQ(2u, buffer_.drain(out, 2));
+    EXPECT_EQ(0, out[0]);
+    EXPECT_EQ(10, out[1]);
+    EXPECT_EQ(1u, buffer_.size());
+
+    EXPECT_FALSE(buffer_.put(0, 1)); /// drained keys become dirty again
+    EXPECT_EQ((std::vector<int>{20, 1}), drainAll());
+}
+
+TEST_F(ConflationBufferTest, GrowsForLargeKeys) {
+    EXPECT_FALSE(buffer_.put(1'000, 7));
+    EXPECT_TRUE(buffer_.put(1'000, 8));
+    EXPECT_EQ(std::vector<int>{8}, drainAll());
+}
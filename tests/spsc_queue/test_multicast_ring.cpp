@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "ringbuffer/multicast_ring.hpp"
+
+class MulticastRingTest : public testing::Test {
+  protected:
+    static constexpr std::size_t RING_SIZE_ = 8;
+
+    /**
+     * @brief Publishes up to `count` consecutive values starting at `next_`.
+     *
+     * @return The number published.
+     */
+    template <typename Ring> std::size_t publish(Ring& ring, const std::size_t count) {
+        int* slots;
+        const auto claimed = ring.claimWrite(slots, count);
+        for (std::size_t i = 0; i < claimed; ++i) {
+            slots[i] = next_++;
+        }
+        ring.commitWrite(claimed);
+        return claimed;
+    }
+
+    /**
+     * @brief Reads and releases everything `consumer` can read, returning the values in order.
+     */
+    template <typename Ring> static std::vector<int> drain(Ring& ring, const std::size_t consumer) {
+        std::vector<int> values;
+        int* slots;
+        while (const auto claimed = ring.claimRead(consumer, slots, RING_SIZE_)) {
+            values.insert(values.end(), slots, slots + claimed);
+            ring.commitRead(consumer, claimed);
+        }
+        return values;
+    }
+
+    int next_{0};
+};
+
+TEST_F(MulticastRingTest, EveryConsumerSeesEveryElement) {
+    MulticastRing<int, RING_SIZE_> ring{{0, 0, 0}};
+    EXPECT_EQ(3u, ring.consumers());
+    EXPECT_EQ(5u, publish(ring, 5));
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), drain(ring, 0));
+    EXPECT_EQ(3u, publish(ring, RING_SIZE_)); /// up to the end of the ring
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), drain(ring, 1));
+    EXPECT_EQ((std::vector<int>{5, 6, 7}), drain(ring, 0));
+    EXPECT_FALSE(ring.drained(2));
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), drain(ring, 2));
+    EXPECT_TRUE(ring.drained(2));
+}
+
+TEST_F(MulticastRingTest, ProducerWaitsForSlowestConsumer) {
+    MulticastRing<int, RING_SIZE_> ring{{0, 0}};
+    EXPECT_EQ(RING_SIZE_, publish(ring, RING_SIZE_)); /// every slot, unlike `SPSCQueue`
+    drain(ring, 0);
+    EXPECT_EQ(0u, publish(ring, 1)); /// consumer 1 still holds all of them
+
+    int* slots;
+    ASSERT_EQ(RING_SIZE_, ring.claimRead(1, slots, RING_SIZE_));
+    ring.commitRead(1, 3);
+    EXPECT_EQ(3u, publish(ring, RING_SIZE_));
+    EXPECT_EQ(0u, publish(ring, 1));
+    EXPECT_EQ((std::vector<int>{8, 9, 10}), drain(ring, 0));
+}
+
+TEST_F(MulticastRingTest, DownstreamWaitsForUpstream) {
+    /// 0 and 1 read from the producer, 2 after both of them, 3 after 2
+    MulticastRing<int, RING_SIZE_> ring{{0, 0, 0b011, 0b100}};
+    publish(ring, 4);
+
+    int* slots;
+    EXPECT_EQ(0u, ring.claimRead(2, slots, RING_SIZE_));
+    ASSERT_EQ(4u, ring.claimRead(0, slots, RING_SIZE_));
+    ring.commitRead(0, 4);
+    ASSERT_EQ(4u, ring.claimRead(1, slots, RING_SIZE_));
+    ring.commitRead(1, 2);
+    EXPECT_EQ((std::vector<int>{0, 1}), drain(ring, 2)); /// only as far as the slower upstream
+    EXPECT_EQ((std::vector<int>{0, 1}), drain(ring, 3));
+
+    /// the producer is gated by 3 alone, the end of the chain, which has released 2 slots
+    EXPECT_EQ(4u, publish(ring, RING_SIZE_));
+    EXPECT_EQ(2u, publish(ring, RING_SIZE_));
+}
+
+TEST_F(MulticastRingTest, PipelineOfThreadsSeesUpstreamWrites) {
+    constexpr std::size_t NUM_ELEMENTS = 1'000'000;
+    constexpr std::size_t BATCH = 64;
+    struct Element {
+        std::uint64_t value;
+        std::uint64_t doubled; /// written by consumer 0, read by consumer 2
+    };
+    MulticastRing<Element, 1024> ring{{0, 0, 0b011}};
+    std::atomic<bool> producerDone{false};
+
+    std::thread producer([&]() {
+        std::uint64_t next = 0;
+        while (next < NUM_ELEMENTS) {
+            Element* slots;
+            const auto claimed = ring.claimWrite(slots, std::min(BATCH, NUM_ELEMENTS - next));
+            for (std::size_t i = 0; i < claimed; ++i) {
+                slots[i] = {next++, 0};
+            }
+            ring.commitWrite(claimed);
+            if (claimed == 0) {
+                std::this_thread::yield();
+            }
+        }
+        producerDone.store(true, std::memory_order_release);
+    });
+
+    std::vector<std::uint64_t> sums(3);
+    std::vector<std::uint64_t> errors(3);
+    const auto consume = [&](const std::size_t consumer) {
+        std::uint64_t expected = 0;
+        while (true) {
+            Element* slots;
+            const auto claimed = ring.claimRead(consumer, slots, BATCH);
+            if (claimed == 0) {
+                if (producerDone.load(std::memory_order_acquire) && ring.drained(consumer)) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < claimed; ++i) {
+                Element& element = slots[i];
+                errors[consumer] += element.value != expected++;
+                if (consumer == 0) {
+                    element.doubled = 2 * element.value;
+                } else if (consumer == 2) {
+                    errors[consumer] += element.doubled != 2 * element.value;
+                }
+                sums[consumer] += element.value;
+            }
+            ring.commitRead(consumer, claimed);
+        }
+    };
+    std::vector<std::thread> consumers;
+    for (std::size_t i = 0; i < 3; ++i) {
+        consumers.emplace_back(consume, i);
+    }
+
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(0u, errors[i]);
+        EXPECT_EQ(NUM_ELEMENTS * (NUM_ELEMENTS - 1) / 2, sums[i]);
+    }
+}
@@ -0,0 +1,184 @@
+#include <cerrno>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ringbuffer/shm_spsc_queue.hpp"
+
+class ShmSPSCQueueTest : public testing::Test {
+  protected:
+    void TearDown() override {
+        ShmSPSCQueue<std::uint64_t>::remove(name_.c_str());
+    }
+
+    using Queue = ShmSPSCQueue<std::uint64_t>;
+
+    const std::string name_ = "/shm_spsc_queue_test_" + std::to_string(getpid());
+};
+
+TEST_F(ShmSPSCQueueTest, RejectsBadCapacity) {
+    EXPECT_EQ(nullptr, Queue::create(name_.c_str(), 12, ShmRole::Producer));
+    EXPECT_EQ(EINVAL, errno);
+}
+
+TEST_F(ShmSPSCQueueTest, AttachMissing) {
+    EXPECT_EQ(nullptr, Queue::attach(name_.c_str(), ShmRole::Consumer));
+    EXPECT_EQ(ENOENT, errno);
+}
+
+TEST_F(ShmSPSCQueueTest, PassesElementsBetweenEnds) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, consumer);
+    EXPECT_EQ(8u, consumer->capacity());
+
+    for (std::uint64_t i = 1; i < 8; ++i) {
+        EXPECT_TRUE(producer->enqueue(i));
+    }
+    EXPECT_FALSE(producer->enqueue(8)); /// one slot is always left free
+    EXPECT_EQ(7u, consumer->size());
+
+    std::uint64_t value;
+    for (std::uint64_t i = 1; i < 8; ++i) {
+        ASSERT_TRUE(consumer->dequeue(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(consumer->dequeue(value));
+    EXPECT_TRUE(producer->enqueue(8)); /// wraps around
+    EXPECT_TRUE(consumer->dequeue(value));
+    EXPECT_EQ(8u, value);
+}
+
+TEST_F(ShmSPSCQueueTest, RejectsMismatchedLayout) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    EXPECT_EQ(nullptr, ShmSPSCQueue<std::uint32_t>::attach(name_.c_str(), ShmRole::Consumer));
+    EXPECT_EQ(EPROTO, errno);
+}
+
+TEST_F(ShmSPSCQueueTest, OneProcessPerRole) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    EXPECT_EQ(nullptr, Queue::attach(name_.c_str(), ShmRole::Producer));
+    EXPECT_EQ(EBUSY, errno);
+    EXPECT_TRUE(producer->enqueue(1)); /// the failed attach left the holder in place
+    auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, consumer);
+    EXPECT_EQ(PeerState::Attached, consumer->peerState());
+}
+
+TEST_F(ShmSPSCQueueTest, TracksPeerAcrossAttachAndDetach) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    EXPECT_EQ(PeerState::Waiting, producer->peerState());
+
+    auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, consumer);
+    EXPECT_EQ(PeerState::Attached, producer->peerState());
+    EXPECT_EQ(PeerState::Attached, consumer->peerState());
+
+    consumer.reset();
+    EXPECT_EQ(PeerState::Detached, producer->peerState());
+}
+
+TEST_F(ShmSPSCQueueTest, CrossProcess) {
+    constexpr std::uint64_t MESSAGES = 100'000;
+    auto producer = Queue::create(name_.c_str(), 64, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+
+    const pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) { /// consumer: exits 0 if it saw every value in order
+        auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+        if (consumer == nullptr) {
+            _exit(2);
+        }
+        std::uint64_t expected = 0;
+        std::uint64_t value;
+        while (expected < MESSAGES) {
+            if (!consumer->dequeue(value)) {
+                if (consumer->peerState() == PeerState::Dead) {
+                    _exit(3);
+                }
+                usleep(0);
+                continue;
+            }
+            if (value != expected++) {
+                _exit(1);
+            }
+        }
+        consumer.reset();
+        _exit(0);
+    }
+
+    for (std::uint64_t i = 0; i < MESSAGES; ++i) {
+        while (!producer->enqueue(i)) {
+            usleep(0);
+        }
+    }
+    int status;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+    EXPECT_EQ(PeerState::Detached, producer->peerState());
+}
+
+TEST_F(ShmSPSCQueueTest, DetectsDeadPeerAndTakesOver) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    ASSERT_TRUE(producer->enqueue(1));
+    ASSERT_TRUE(producer->enqueue(2));
+
+    const pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) { /// consumer: claims an element, then dies without committing or detaching
+        auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+        std::uint64_t* slot;
+        _exit(consumer != nullptr && consumer->claimRead(slot, 1) == 1 ? 0 : 1);
+    }
+    int status;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    EXPECT_EQ(PeerState::Dead, producer->peerState());
+
+    auto replacement = Queue::attach(name_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, replacement);
+    std::uint64_t value;
+    ASSERT_TRUE(replacement->dequeue(value));
+    EXPECT_EQ(1u, value); /// the uncommitted claim is delivered again
+}
+
+TEST_F(ShmSPSCQueueTest, CreateRefusesLiveRegion) {
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    ASSERT_TRUE(producer->enqueue(7));
+
+    EXPECT_EQ(nullptr, Queue::create(name_.c_str(), 8, ShmRole::Producer));
+    EXPECT_EQ(EBUSY, errno);
+    auto consumer = Queue::attach(name_.c_str(), ShmRole::Consumer);
+    ASSERT_NE(nullptr, consumer);
+    std::uint64_t value;
+    ASSERT_TRUE(consumer->dequeue(value)); /// the live region was left alone
+    EXPECT_EQ(7u, value);
+}
+
+TEST_F(ShmSPSCQueueTest, CreateReplacesDeadRegion) {
+    const pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) { /// creates the region and dies holding it
+        auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+        _exit(producer != nullptr && producer->enqueue(7) ? 0 : 1);
+    }
+    int status;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    auto producer = Queue::create(name_.c_str(), 8, ShmRole::Producer);
+    ASSERT_NE(nullptr, producer);
+    EXPECT_TRUE(producer->isEmpty());
+    EXPECT_EQ(PeerState::Waiting, producer->peerState());
+}
@@ -63,3 +63,98 @@ TEST_F(SPSCQueueTest, IsEmpty) {
     EXPECT_FALSE(queue_.isEmpty());
     EXPECT_TRUE(empty_.isEmpty());
 }
+
+TEST_F(SPSCQueueTest, EnqueueBulk) {
+    SPSCQueue<int, QUEUE_SIZE_> queue;
+    int items[QUEUE_SIZE_] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    EXPECT_EQ(5u, queue.enqueueBulk(items, 5));
+    EXPECT_EQ(2u, queue.enqueueBulk(items + 5, 3)); /// only N-1 slots are usable
+    EXPECT_EQ(0u, queue.enqueueBulk(items, 1));
+    EXPECT_TRUE(queue.isFull());
+
+    int res;
+    for (int i = 1; i < QUEUE_SIZE_; ++i) {
+        EXPECT_TRUE(queue.dequeue(res));
+        EXPECT_EQ(res, i);
+    }
+}
+
+TEST_F(SPSCQueueTest, DequeueBulk) {
+    int res[QUEUE_SIZE_] = {0};
+
+    EXPECT_EQ(3u, queue_.dequeueBulk(res, 3));
+    EXPECT_EQ(res[0], 1);
+    EXPECT_EQ(res[2], 3);
+
+    EXPECT_EQ(5u, queue_.dequeueBulk(res, QUEUE_SIZE_));
+    EXPECT_EQ(res[0], 4);
+    EXPECT_EQ(res[4], 8);
+
+    EXPECT_EQ(0u, queue_.dequeueBulk(res, QUEUE_SIZE_));
+    EXPECT_TRUE(queue_.isEmpty());
+}
+
+TEST_F(SPSCQueueTest, BulkWrapAround) {
+    SPSCQueue<int, QUEUE_SIZE_> queue;
+    int items[6] = {1, 2, 3, 4, 5, 6};
+    int res[6] = {0};
+
+    EXPECT_EQ(6u, queue.enqueueBulk(items, 6));
+    EXPECT_EQ(6u, queue.dequeueBulk(res, 6));
+
+    /// indices now sit at 6, so this batch straddles the end of the ring
+    EXPECT_EQ(6u, queue.enqueueBulk(items, 6));
+    EXPECT_EQ(6u, queue.size());
+    EXPECT_EQ(6u, queue.dequeueBulk(res, 6));
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(res[i], i + 1);
+    }
+}
+
+TEST_F(SPSCQueueTest, ClaimWriteCommit) {
+    SPSCQueue<int, QUEUE_SIZE_> queue;
+    int* slots = nullptr;
+
+    std::size_t claimed = queue.claimWrite(slots, 4);
+    ASSERT_EQ(4u, claimed);
+    for (std::size_t i = 0; i < claimed; ++i) {
+        slots[i] = static_cast<int>(i) + 1;
+    }
+    EXPECT_TRUE(queue.isEmpty()); /// nothing is visible before commit
+
+    queue.commitWrite(claimed);
+    EXPECT_EQ(4u, queue.size());
+
+    /// only three slots are left before the ring is full
+    EXPECT_EQ(3u, queue.claimWrite(slots, QUEUE_SIZE_));
+}
+
+TEST_F(SPSCQueueTest, ClaimReadCommit) {
+    int* slots = nullptr;
+
+    std::size_t claimed = queue_.claimRead(slots, 5);
+    ASSERT_EQ(5u, claimed);
+    EXPECT_EQ(slots[0], 1);
+    EXPECT_EQ(slots[4], 5);
+    EXPECT_EQ(8u, queue_.size()); /// slots stay owned by the consumer until commit
+
+    queue_.commitRead(claimed);
+    EXPECT_EQ(3u, queue_.size());
+
+    EXPECT_EQ(3u, queue_.claimRead(slots, QUEUE_SIZE_));
+    EXPECT_EQ(slots[0], 6);
+}
+
+TEST_F(SPSCQueueTest, ClaimStopsAtRingEnd) {
+    SPSCQueue<int, QUEUE_SIZE_> queue;
+    int items[6] = {1, 2, 3, 4, 5, 6};
+    int res[6];
+    queue.enqueueBulk(items, 6);
+    queue.dequeueBulk(res, 6);
+
+    int* slots = nullptr;
+    EXPECT_EQ(2u, queue.claimWrite(slots, 5)); /// slots 6 and 7 before the wrap
+    queue.commitWrite(2);
+    EXPECT_EQ(5u, queue.claimWrite(slots, 8)); /// slots 0..4, one short of the reader at 6
+}
@@ -0,0 +1,81 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "ringbuffer/spsc_queue.hpp"
+#include "ringbuffer/wait_strategy.hpp"
+
+template <typename Wait> class WaitStrategyTest : public testing::Test {
+  protected:
+    static constexpr std::size_t QUEUE_SIZE_ = 1024;
+    static constexpr std::size_t NUM_MESSAGES_ = 50'000;
+};
+
+using WaitStrategies = testing::Types<BusySpinWait, SpinYieldWait, BackoffWait, FutexWait>;
+TYPED_TEST_SUITE(WaitStrategyTest, WaitStrategies);
+
+TYPED_TEST(WaitStrategyTest, TransfersInOrder) {
+    constexpr std::size_t numMessages = TestFixture::NUM_MESSAGES_;
+    SPSCQueue<std::size_t, TestFixture::QUEUE_SIZE_> queue;
+    TypeParam notEmpty;
+    TypeParam notFull;
+    std::atomic<bool> producerDone{false};
+
+    std::thread producer([&]() {
+        for (std::size_t i = 0; i < numMessages; ++i) {
+            std::size_t value = i;
+            notFull.waitUntil([&]() { return queue.enqueue(value); });
+            notEmpty.notify();
+        }
+        producerDone.store(true, std::memory_order_release);
+        notEmpty.notify();
+    });
+
+    std::size_t expected = 0;
+    while (true) {
+        std::size_t value;
+        bool got = false;
+        notEmpty.waitUntil([&]() {
+            got = queue.dequeue(value);
+            return got || (producerDone.load(std::memory_order_acquire) && queue.isEmpty());
+        });
+        if (!got) {
+            break;
+        }
+        notFull.notify();
+        ASSERT_EQ(expected, value);
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_EQ(numMessages, expected);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TYPED_TEST(WaitStrategyTest, ReadyAttemptReturnsImmediately) {
+    TypeParam wait;
+    int attempts = 0;
+    wait.waitUntil([&]() { return ++attempts > 0; });
+    EXPECT_EQ(1, attempts);
+}
+
+TEST(FutexWaitTest, BlockedWaiterWokenByNotify) {
+    FutexWait wait;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> woken{false};
+
+    std::thread waiter([&]() {
+        wait.waitUntil([&]() { return ready.load(std::memory_order_acquire); });
+        woken.store(true, std::memory_order_release);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); /// let it spin out and block
+    EXPECT_FALSE(woken.load(std::memory_order_acquire));
+
+    ready.store(true, std::memory_order_release);
+    wait.notify();
+    waiter.join();
+    EXPECT_TRUE(woken.load(std::memory_order_acquire));
+}
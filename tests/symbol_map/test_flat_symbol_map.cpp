@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "symbol_map/flat_symbol_map.hpp"
+
+class FlatSymbolMapTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        for (std::uint64_t symbol = 1; symbol <= NUM_SYMBOLS_; ++symbol) {
+            map_[symbol] = symbol * 10;
+        }
+    }
+
+    static constexpr std::uint64_t NUM_SYMBOLS_ = 100;
+    FlatSymbolMap<std::uint64_t> map_;
+    FlatSymbolMap<std::uint64_t> emptyMap_;
+};
+
+TEST_F(FlatSymbolMapTest, DefaultConstructor) {
+    EXPECT_EQ(0u, emptyMap_.size());
+    EXPECT_EQ(nullptr, emptyMap_.find(std::uint64_t{1}));
+}
+
+TEST_F(FlatSymbolMapTest, FindAfterGrowth) {
+    EXPECT_EQ(NUM_SYMBOLS_, map_.size());
+    for (std::uint64_t symbol = 1; symbol <= NUM_SYMBOLS_; ++symbol) {
+        const std::uint64_t* value = map_.find(symbol);
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(*value, symbol * 10);
+    }
+    EXPECT_EQ(nullptr, map_.find(NUM_SYMBOLS_ + 1));
+}
+
+TEST_F(FlatSymbolMapTest, TryEmplace) {
+    auto [value, inserted] = map_.tryEmplace(std::uint64_t{1});
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(*value, std::uint64_t{10});
+
+    std::tie(value, inserted) = map_.tryEmplace(std::uint64_t{0});
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*value, std::uint64_t{0}); /// new values are value-initialized
+    EXPECT_EQ(NUM_SYMBOLS_ + 1, map_.size());
+}
+
+TEST_F(FlatSymbolMapTest, ReservePreventsRehash) {
+    FlatSymbolMap<std::uint64_t> map{1000};
+    const auto capacity = map.capacity();
+    std::uint64_t* first = &map[std::uint64_t{1}];
+
+    for (std::uint64_t symbol = 2; symbol <= 1000; ++symbol) {
+        map[symbol] = symbol;
+    }
+    EXPECT_EQ(capacity, map.capacity());
+    EXPECT_EQ(first, map.find(std::uint64_t{1}));
+}
+
+TEST_F(FlatSymbolMapTest, StableValuesSurviveGrowth) {
+    FlatSymbolMap<std::uint64_t, true> map;
+    std::uint64_t* first = &map[std::uint64_t{1}];
+    *first = 42;
+
+    for (std::uint64_t symbol = 2; symbol <= 10'000; ++symbol) {
+        map[symbol] = symbol;
+    }
+    EXPECT_EQ(first, map.find(std::uint64_t{1}));
+    EXPECT_EQ(*first, std::uint64_t{42});
+    EXPECT_EQ(*map.find(std::uint64_t{9'999}), std::uint64_t{9'999});
+}
+
+TEST_F(FlatSymbolMapTest, AsciiTickers) {
+    const char tickers[][8] = {"AAPL", "AAPM", "AAPN", "GOOGL", "MSFT", "AMZN", "A", "B"};
+    FlatSymbolMap<int> map;
+    int i = 0;
+    for (const auto& ticker : tickers) {
+        std::uint64_t symbol = 0;
+        std::memcpy(&symbol, ticker, sizeof(symbol));
+        map[symbol] = i++;
+    }
+
+    i = 0;
+    for (const auto& ticker : tickers) {
+        std::uint64_t symbol = 0;
+        std::memcpy(&symbol, ticker, sizeof(symbol));
+        ASSERT_NE(nullptr, map.find(symbol));
+        EXPECT_EQ(*map.find(symbol), i++);
+    }
+}
+
+TEST_F(FlatSymbolMapTest, ForEach) {
+    std::uint64_t keySum = 0;
+    std::uint64_t valueSum = 0;
+    map_.forEach([&](std::uint64_t key, const std::uint64_t& value) {
+        keySum += key;
+        valueSum += value;
+    });
+    EXPECT_EQ(keySum, NUM_SYMBOLS_ * (NUM_SYMBOLS_ + 1) / 2);
+    EXPECT_EQ(valueSum, keySum * 10);
+}
+
+TEST_F(FlatSymbolMapTest, Erase) {
+    EXPECT_FALSE(map_.erase(NUM_SYMBOLS_ + 1));
+
+    for (std::uint64_t symbol = 1; symbol <= NUM_SYMBOLS_; symbol += 2) {
+        EXPECT_TRUE(map_.erase(symbol));
+    }
+    EXPECT_EQ(NUM_SYMBOLS_ / 2, map_.size());
+
+    /// remaining keys must still be reachable after entries were shifted into the holes
+    for (std::uint64_t symbol = 1; symbol <= NUM_SYMBOLS_; ++symbol) {
+        if (symbol % 2 == 1) {
+            EXPECT_EQ(nullptr, map_.find(symbol));
+        } else {
+            ASSERT_NE(nullptr, map_.find(symbol));
+            EXPECT_EQ(*map_.find(symbol), symbol * 10);
+        }
+    }
+
+    map_[std::uint64_t{1}] = 7;
+    EXPECT_EQ(*map_.find(std::uint64_t{1}), std::uint64_t{7});
+}
+
+TEST_F(FlatSymbolMapTest, RejectsReservedKey) {
+    using Map = FlatSymbolMap<std::uint64_t>;
+    EXPECT_EQ(nullptr, map_.find(Map::EMPTY_KEY)); /// would otherwise hit an empty slot
+
+    const auto [value, inserted] = map_.tryEmplace(Map::EMPTY_KEY);
+    EXPECT_EQ(nullptr, value);
+    EXPECT_FALSE(inserted);
+    EXPECT_FALSE(map_.erase(Map::EMPTY_KEY));
+    EXPECT_EQ(NUM_SYMBOLS_, map_.size());
+}
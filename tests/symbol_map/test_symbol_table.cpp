@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "symbol_map/symbol_table.hpp"
+
+class SymbolTableTest : public testing::Test {
+  protected:
+    SymbolTable symbols_;
+};
+
+TEST_F(SymbolTableTest, DefaultConstructor) {
+    EXPECT_EQ(0u, symbols_.size());
+    EXPECT_FALSE(symbols_.find(std::uint64_t{1}).has_value());
+}
+
+TEST_F(SymbolTableTest, InternAssignsDenseIds) {
+    EXPECT_EQ(SymbolId{0}, symbols_.intern(std::uint64_t{700}));
+    EXPECT_EQ(SymbolId{1}, symbols_.intern(std::uint64_t{300}));
+    EXPECT_EQ(SymbolId{0}, symbols_.intern(std::uint64_t{700})); /// repeat keeps its ID
+    EXPECT_EQ(SymbolId{2}, symbols_.intern(std::uint64_t{500}));
+    EXPECT_EQ(3u, symbols_.size());
+}
+
+TEST_F(SymbolTableTest, FindAndSymbolOf) {
+    for (std::uint64_t symbol = 1; symbol <= 1000; ++symbol) {
+        symbols_.intern(symbol * 7);
+    }
+
+    auto id = symbols_.find(std::uint64_t{700});
+    ASSERT_TRUE(id.has_value());
+    EXPECT_EQ(SymbolId{99}, *id);
+    EXPECT_EQ(std::uint64_t{700}, symbols_.symbolOf(*id));
+
+    EXPECT_FALSE(symbols_.find(std::uint64_t{701}).has_value());
+}
+
+TEST_F(SymbolTableTest, InternsAllOnesSymbol) {
+    const std::uint64_t allOnes = ~std::uint64_t{0};
+    EXPECT_FALSE(symbols_.find(allOnes).has_value());
+    EXPECT_EQ(SymbolId{0}, symbols_.intern(std::uint64_t{700}));
+    EXPECT_EQ(SymbolId{1}, symbols_.intern(allOnes));
+    EXPECT_EQ(SymbolId{1}, symbols_.intern(allOnes));
+    EXPECT_EQ(SymbolId{2}, symbols_.intern(std::uint64_t{300}));
+
+    ASSERT_TRUE(symbols_.find(allOnes).has_value());
+    EXPECT_EQ(SymbolId{1}, *symbols_.find(allOnes));
+    EXPECT_EQ(allOnes, symbols_.symbolOf(1));
+    EXPECT_EQ(SymbolId{0}, *symbols_.find(std::uint64_t{700}));
+}
@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "messages.hpp"
+#include "symbol_map/symbol_table.hpp"
+#include "vwap_tracker/rolling_vwap.hpp"
+
+class RollingVWAPTest : public testing::Test {
+  protected:
+    /// Window 0 spans 1000 time units in buckets of 100, window 1 spans 10000 in buckets of 1000.
+    static std::vector<RollingVWAP::Window> windows() {
+        return {{"short", 1'000, 10}, {"long", 10'000, 10}};
+    }
+
+    static TradeMessage trade(std::uint64_t timestamp, std::uint64_t price,
+                              std::uint32_t quantity) {
+        TradeMessage msg{};
+        msg.type = MessageType::Trade;
+        msg.timestamp = timestamp;
+        msg.symbol = SYMBOL_;
+        msg.price = price;
+        msg.quantity = quantity;
+        return msg;
+    }
+
+    void add(RollingVWAP& rolling, std::uint64_t timestamp, std::uint64_t price,
+             std::uint32_t quantity) {
+        rolling.addTrade(SYMBOL_, trade(timestamp, price, quantity));
+    }
+
+    static constexpr std::uint64_t SYMBOL_ = 0x4C5041; /// "APL"
+
+    RollingVWAP rolling_{windows()};
+};
+
+TEST_F(RollingVWAPTest, UnknownSymbol) {
+    EXPECT_FALSE(rolling_.getWindow(SYMBOL_, 0, 0).has_value());
+}
+
+TEST_F(RollingVWAPTest, SumsTradesInsideWindow) {
+    add(rolling_, 10'000, 100, 10);
+    add(rolling_, 10'450, 200, 30);
+
+    const auto entry = rolling_.getWindow(SYMBOL_, 0, 10'450);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(100u * 10 + 200u * 30, entry->totalPriceByQuantity);
+    EXPECT_EQ(40u, entry->totalQuantity);
+    EXPECT_EQ(2u, entry->totalTrades);
+}
+
+TEST_F(RollingVWAPTest, ExpiresOldBuckets) {
+    add(rolling_, 10'000, 100, 10);
+    add(rolling_, 10'950, 200, 30); /// still the same short window
+    add(rolling_, 11'050, 300, 50); /// bucket 110 pushes bucket 100 out
+
+    const auto shortWindow = rolling_.getWindow(SYMBOL_, 0, 11'050);
+    ASSERT_TRUE(shortWindow.has_value());
+    EXPECT_EQ(80u, shortWindow->totalQuantity);
+    EXPECT_EQ(2u, shortWindow->totalTrades);
+
+    const auto longWindow = rolling_.getWindow(SYMBOL_, 1, 11'050);
+    ASSERT_TRUE(longWindow.has_value());
+    EXPECT_EQ(90u, longWindow->totalQuantity);
+    EXPECT_EQ(3u, longWindow->totalTrades);
+}
+
+TEST_F(RollingVWAPTest, EvaluatesAtLaterTime) {
+    add(rolling_, 10'000, 100, 10);
+    add(rolling_, 10'500, 200, 30);
+
+    auto entry = rolling_.getWindow(SYMBOL_, 0, 11'200); /// only the second trade is left
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(30u, entry->totalQuantity);
+
+    EXPECT_FALSE(rolling_.getWindow(SYMBOL_, 0, 11'600).has_value());
+    EXPECT_FALSE(rolling_.getWindow(SYMBOL_, 0, 1'000'000).has_value());
+
+    entry = rolling_.getWindow(SYMBOL_, 1, 11'600); /// the long window still has both
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(40u, entry->totalQuantity);
+
+    entry = rolling_.getWindow(SYMBOL_, 0, 0); /// before the latest trade reads as of that trade
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(40u, entry->totalQuantity);
+}
+
+TEST_F(RollingVWAPTest, ClearsRingAfterLongGap) {
+    add(rolling_, 10'000, 100, 10);
+    add(rolling_, 50'000, 200, 30);
+
+    for (std::size_t window = 0; window < 2; ++window) {
+        const auto entry = rolling_.getWindow(SYMBOL_, window, 50'000);
+        ASSERT_TRUE(entry.has_value());
+        EXPECT_EQ(30u, entry->totalQuantity);
+        EXPECT_EQ(1u, entry->totalTrades);
+    }
+}
+
+TEST_F(RollingVWAPTest, LateTrades) {
+    add(rolling_, 10'000, 100, 10);
+    add(rolling_, 9'500, 200, 30); /// late but inside the short window
+    add(rolling_, 8'000, 300, 50); /// too old for the short window, inside the long one
+
+    auto entry = rolling_.getWindow(SYMBOL_, 0, 10'000);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(40u, entry->totalQuantity);
+
+    entry = rolling_.getWindow(SYMBOL_, 1, 10'000);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(90u, entry->totalQuantity);
+}
+
+TEST_F(RollingVWAPTest, NoWindowsIsNoOp) {
+    RollingVWAP rolling{{}};
+    add(rolling, 10'000, 100, 10);
+    EXPECT_FALSE(rolling.getWindow(SYMBOL_, 0, 10'000).has_value());
+    EXPECT_EQ(0u, rolling.latestTimestamp());
+}
+
+TEST_F(RollingVWAPTest, MergeMatchesSequential) {
+    SymbolTable symbols;
+    RollingVWAP first{symbols, windows()};
+    RollingVWAP second{windows()};
+
+    for (std::uint64_t t = 0; t < 30'000; t += 70) {
+        add(rolling_, t, 100 + t % 13, 1 + t % 7);
+        add(t < 20'000 ? first : second, t, 100 + t % 13, 1 + t % 7);
+    }
+    first.mergeFrom(second);
+
+    EXPECT_EQ(rolling_.latestTimestamp(), first.latestTimestamp());
+    for (std::size_t window = 0; window < 2; ++window) {
+        for (const std::uint64_t now : {29'990u, 30'500u, 35'000u}) {
+            const auto expected = rolling_.getWindow(SYMBOL_, window, now);
+            const auto merged = first.getWindow(SYMBOL_, window, now);
+            ASSERT_EQ(expected.has_value(), merged.has_value());
+            if (expected.has_value()) {
+                EXPECT_EQ(expected->totalPriceByQuantity, merged->totalPriceByQuantity);
+                EXPECT_EQ(expected->totalQuantity, merged->totalQuantity);
+                EXPECT_EQ(expected->totalTrades, merged->totalTrades);
+            }
+        }
+    }
+}
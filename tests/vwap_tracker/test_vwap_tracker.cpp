@@ -39,7 +39,7 @@ TEST_F(VWAPTrackerTest, GetVWAPSuccess) {
     auto vwap = tracker_.getVWAP(std::uint64_t{1});
     ASSERT_TRUE(vwap.has_value());
 
-    auto value = *vwap.value();
+    auto value = vwap.value();
     EXPECT_EQ(value.updatedAt, std::uint64_t{1'000'100});
     EXPECT_EQ(value.totalPriceByQuantity, std::uint64_t{4'500'000});
     EXPECT_EQ(value.totalQuantity, std::uint64_t{300});
@@ -54,3 +54,60 @@ TEST_F(VWAPTrackerTest, GetVWAPFailure) {
 TEST_F(VWAPTrackerTest, Size) {
     EXPECT_EQ(1u, tracker_.size());
 }
+
+TEST_F(VWAPTrackerTest, MergeFrom) {
+    VWAPTracker other;
+    TradeMessage msg = getDefaultMsg();
+    msg.timestamp = std::uint64_t{2'000'000};
+    msg.price = std::uint64_t{16'000};
+    other.upsertVWAP(msg.symbol, msg);
+
+    msg.symbol = std::uint64_t{2};
+    other.upsertVWAP(msg.symbol, msg);
+
+    tracker_.mergeFrom(other);
+    EXPECT_EQ(2u, tracker_.size());
+
+    auto vwap = tracker_.getVWAP(std::uint64_t{1});
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_EQ(vwap->updatedAt, std::uint64_t{2'000'000});
+    EXPECT_EQ(vwap->totalPriceByQuantity, std::uint64_t{6'100'000});
+    EXPECT_EQ(vwap->totalQuantity, std::uint64_t{400});
+    EXPECT_EQ(vwap->totalTrades, std::uint32_t{4});
+}
+
+TEST_F(VWAPTrackerTest, MergeLaterFromKeepsLastUpdateTime) {
+    VWAPTracker later;
+    TradeMessage msg = getDefaultMsg();
+    msg.timestamp = std::uint64_t{1}; /// older than the trades in `tracker_`, but later in the feed
+    later.upsertVWAP(msg.symbol, msg);
+
+    tracker_.mergeLaterFrom(later);
+    auto vwap = tracker_.getVWAP(std::uint64_t{1});
+    ASSERT_TRUE(vwap.has_value());
+    EXPECT_EQ(std::uint64_t{1}, vwap->updatedAt);
+    EXPECT_EQ(std::uint64_t{400}, vwap->totalQuantity);
+    EXPECT_EQ(std::uint32_t{4}, vwap->totalTrades);
+}
+
+TEST_F(VWAPTrackerTest, UpsertById) {
+    SymbolTable symbols;
+    VWAPTracker tracker{symbols};
+    TradeMessage msg = getDefaultMsg();
+
+    const SymbolId id = symbols.intern(msg.symbol);
+    tracker.upsertVWAPById(id, msg);
+    tracker.upsertVWAPById(id, msg);
+    EXPECT_EQ(1u, tracker.size());
+
+    auto byId = tracker.getVWAPById(id);
+    ASSERT_TRUE(byId.has_value());
+    EXPECT_EQ(byId->totalQuantity, std::uint64_t{200});
+    EXPECT_EQ(byId->totalTrades, std::uint32_t{2});
+
+    auto bySymbol = tracker.getVWAP(msg.symbol);
+    ASSERT_TRUE(bySymbol.has_value());
+    EXPECT_EQ(bySymbol->totalPriceByQuantity, std::uint64_t{3'000'000});
+
+    EXPECT_FALSE(tracker.getVWAPById(id + 1).has_value());
+}